@@ -0,0 +1,11 @@
+---@meta
+
+--- config API
+---@class config
+config = {}
+
+--- Returns the value for the specified config parameter like `config.getParameter`, but arrays and objects are returned as a proxy userdata. ---
+---@param parameter string
+---@param default Json
+---@return JsonProxy
+function config.getParameterProxy(parameter, default) end
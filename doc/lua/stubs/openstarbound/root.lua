@@ -121,3 +121,8 @@ function root.createHumanoid(name, speciesChoice, genderChoice, bodyColorChoice,
 ---@param effect string
 ---@return JsonObject
 function root.effectConfig(effect) end
+
+--- Returns the contents of the specified JSON asset file like `root.assetJson`, but arrays and objects are returned as a proxy userdata instead of being converted into tables. ---
+---@param assetPath string
+---@return JsonProxy
+function root.assetJsonProxy(assetPath) end
@@ -5,10 +5,11 @@
 
 namespace Star {
 
-AnimatedPartSet::AnimatedPartSet() {}
+AnimatedPartSet::AnimatedPartSet() : m_activeStatesVersion(0) {}
 
 AnimatedPartSet::AnimatedPartSet(Json config, uint8_t animatorVersion) {
   m_animatorVersion = animatorVersion;
+  m_activeStatesVersion = 0;
   for (auto const& stateTypePair : config.get("stateTypes", JsonObject()).iterateObject()) {
     auto const& stateTypeName = stateTypePair.first;
     auto const& stateTypeConfig = stateTypePair.second;
@@ -54,6 +55,7 @@ AnimatedPartSet::AnimatedPartSet(Json config, uint8_t animatorVersion) {
       return b.second.priority < a.second.priority;
     });
 
+  StringMap<Part> parts;
   for (auto const& partPair : config.get("parts", JsonObject()).iterateObject()) {
     auto const& partName = partPair.first;
     auto const& partConfig = partPair.second;
@@ -80,10 +82,16 @@ AnimatedPartSet::AnimatedPartSet(Json config, uint8_t animatorVersion) {
       }
     }
     newPart.activePart.partName = partPair.first;
+    newPart.activePart.propertiesVersion = 0;
     newPart.activePart.setAnimationAffineTransform(Mat3F::identity());
     newPart.activePartDirty = true;
 
-    m_parts[partName] = std::move(newPart);
+    parts[partName] = std::move(newPart);
+  }
+
+  for (auto const& partName : sorted(parts.keys())) {
+    m_partIndices[partName] = m_parts.size();
+    m_parts.append(parts.take(partName));
   }
 
   for (auto const& pair : m_stateTypes)
@@ -98,8 +106,8 @@ void AnimatedPartSet::setStateTypeEnabled(String const& stateTypeName, bool enab
   auto& stateType = m_stateTypes.get(stateTypeName);
   if (stateType.enabled != enabled) {
     stateType.enabled = enabled;
-    for (auto& pair : m_parts)
-      pair.second.activePartDirty = true;
+    for (auto& part : m_parts)
+      part.activePartDirty = true;
   }
 }
 
@@ -110,8 +118,8 @@ void AnimatedPartSet::setEnabledStateTypes(StringList const& stateTypeNames) {
   for (auto const& stateTypeName : stateTypeNames)
     m_stateTypes.get(stateTypeName).enabled = true;
 
-  for (auto& pair : m_parts)
-    pair.second.activePartDirty = true;
+  for (auto& part : m_parts)
+    part.activePartDirty = true;
 }
 
 bool AnimatedPartSet::stateTypeEnabled(String const& stateTypeName) const {
@@ -123,7 +131,11 @@ StringList AnimatedPartSet::states(String const& stateTypeName) const {
 }
 
 StringList AnimatedPartSet::partNames() const {
-  return m_parts.keys();
+  return m_parts.transformed([](Part const& part) { return part.activePart.partName; });
+}
+
+Maybe<size_t> AnimatedPartSet::partIndex(String const& partName) const {
+  return m_partIndices.maybe(partName);
 }
 
 bool AnimatedPartSet::setActiveState(String const& stateTypeName, String const& stateName, bool alwaysStart, bool reverse) {
@@ -136,8 +148,8 @@ bool AnimatedPartSet::setActiveState(String const& stateTypeName, String const&
     stateType.activeStatePointer = stateType.states.get(stateName).get();
 
     stateType.activeStateDirty = true;
-    for (auto& pair : m_parts)
-      pair.second.activePartDirty = true;
+    for (auto& part : m_parts)
+      part.activePartDirty = true;
 
     return true;
   } else {
@@ -150,8 +162,8 @@ void AnimatedPartSet::restartState(String const& stateTypeName) {
   stateType.activeState.timer = 0.0f;
 
   stateType.activeStateDirty = true;
-  for (auto& pair : m_parts)
-    pair.second.activePartDirty = true;
+  for (auto& part : m_parts)
+    part.activePartDirty = true;
 }
 
 AnimatedPartSet::ActiveStateInformation const& AnimatedPartSet::activeState(String const& stateTypeName) const {
@@ -161,7 +173,11 @@ AnimatedPartSet::ActiveStateInformation const& AnimatedPartSet::activeState(Stri
 }
 
 AnimatedPartSet::ActivePartInformation const& AnimatedPartSet::activePart(String const& partName) const {
-  auto& part = const_cast<Part&>(m_parts.get(partName));
+  return activePart(m_partIndices.get(partName));
+}
+
+AnimatedPartSet::ActivePartInformation const& AnimatedPartSet::activePart(size_t partIndex) const {
+  auto& part = const_cast<Part&>(m_parts.at(partIndex));
   const_cast<AnimatedPartSet*>(this)->freshenActivePart(part);
   return part.activePart;
 }
@@ -170,11 +186,11 @@ AnimatedPartSet::State const& AnimatedPartSet::getState(String const& stateTypeN
   return *m_stateTypes.get(stateTypeName).states.get(stateName);
 }
 
-StringMap<AnimatedPartSet::Part> const& AnimatedPartSet::constParts() const {
+List<AnimatedPartSet::Part> const& AnimatedPartSet::constParts() const {
   return m_parts;
 }
 
-StringMap<AnimatedPartSet::Part>& AnimatedPartSet::parts() {
+List<AnimatedPartSet::Part>& AnimatedPartSet::parts() {
   return m_parts;
 }
 
@@ -186,12 +202,18 @@ void AnimatedPartSet::forEachActiveState(function<void(String const&, ActiveStat
 }
 
 void AnimatedPartSet::forEachActivePart(function<void(String const&, ActivePartInformation const&)> callback) const {
-  for (auto const& p : m_parts) {
-    const_cast<AnimatedPartSet*>(this)->freshenActivePart(const_cast<Part&>(p.second));
-    callback(p.first, p.second.activePart);
+  for (auto const& part : m_parts) {
+    const_cast<AnimatedPartSet*>(this)->freshenActivePart(const_cast<Part&>(part));
+    callback(part.activePart.partName, part.activePart);
   }
 }
 
+uint64_t AnimatedPartSet::activeStatesVersion() const {
+  for (auto const& p : m_stateTypes)
+    const_cast<AnimatedPartSet*>(this)->freshenActiveState(const_cast<StateType&>(p.second));
+  return m_activeStatesVersion;
+}
+
 size_t AnimatedPartSet::activeStateIndex(String const& stateTypeName) const {
   auto const& stateType = m_stateTypes.get(stateTypeName);
   return *stateType.states.indexOf(stateType.activeState.stateName);
@@ -228,8 +250,8 @@ void AnimatedPartSet::update(float dt) {
     stateType.activeStateDirty = true;
   }
 
-  for (auto& pair : m_parts)
-    pair.second.activePartDirty = true;
+  for (auto& part : m_parts)
+    part.activePartDirty = true;
 }
 
 void AnimatedPartSet::finishAnimations() {
@@ -253,8 +275,8 @@ void AnimatedPartSet::finishAnimations() {
     stateType.activeStateDirty = true;
   }
 
-  for (auto& pair : m_parts)
-    pair.second.activePartDirty = true;
+  for (auto& part : m_parts)
+    part.activePartDirty = true;
 }
 
 AnimatedPartSet::AnimationMode AnimatedPartSet::stringToAnimationMode(String const& string) {
@@ -292,17 +314,25 @@ void AnimatedPartSet::freshenActiveState(StateType& stateType) {
       }
     }
 
-    activeState.properties = stateType.stateTypeProperties;
-    activeState.properties.merge(state.stateProperties, true);
-
-    activeState.nextProperties = stateType.stateTypeProperties;
-    activeState.nextProperties.merge(state.stateProperties, true);
+    // The properties only depend on the state and frames, which usually stay
+    // the same over many updates.
+    auto propertiesSource = make_tuple(activeState.stateName, activeState.frame, activeState.nextFrame);
+    if (stateType.activePropertiesSource != propertiesSource) {
+      activeState.properties = stateType.stateTypeProperties;
+      activeState.properties.merge(state.stateProperties, true);
+
+      activeState.nextProperties = stateType.stateTypeProperties;
+      activeState.nextProperties.merge(state.stateProperties, true);
+
+      for (auto const& pair : state.stateFrameProperties) {
+        if (activeState.frame < pair.second.size())
+          activeState.properties[pair.first] = pair.second.get(activeState.frame);
+        if (activeState.nextFrame < pair.second.size())
+          activeState.nextProperties[pair.first] = pair.second.get(activeState.nextFrame);
+      }
 
-    for (auto const& pair : state.stateFrameProperties) {
-      if (activeState.frame < pair.second.size())
-        activeState.properties[pair.first] = pair.second.get(activeState.frame);
-      if (activeState.nextFrame < pair.second.size())
-        activeState.nextProperties[pair.first] = pair.second.get(activeState.nextFrame);
+      stateType.activePropertiesSource = std::move(propertiesSource);
+      ++m_activeStatesVersion;
     }
 
     stateType.activeStateDirty = false;
@@ -311,15 +341,15 @@ void AnimatedPartSet::freshenActiveState(StateType& stateType) {
 
 void AnimatedPartSet::freshenActivePart(Part& part) {
   if (part.activePartDirty) {
-    // First reset all the active part information assuming that no state type
-    // x state match exists.
+    // First reset the active state assuming that no state type x state match
+    // exists.
     auto& activePart = part.activePart;
     activePart.activeState = {};
-    activePart.properties = part.partProperties;
-    activePart.nextProperties = part.partProperties;
 
     // Then go through each of the state types and states and look for a part
     // state match in order of priority.
+    PartState const* matchedPartState = nullptr;
+    tuple<String, String, unsigned, unsigned> propertiesSource;
     for (auto& stateTypePair : m_stateTypes) {
       auto const& stateTypeName = stateTypePair.first;
       auto& stateType = stateTypePair.second;
@@ -340,24 +370,39 @@ void AnimatedPartSet::freshenActivePart(Part& part) {
       // If we have a partState match, then set the active state information.
       freshenActiveState(stateType);
       activePart.activeState = stateType.activeState;
-      unsigned frame = stateType.activeState.frame;
-      unsigned nextFrame = stateType.activeState.nextFrame;
+      matchedPartState = partState;
+      propertiesSource = make_tuple(stateTypeName, stateName, stateType.activeState.frame, stateType.activeState.nextFrame);
+
+      // Each part can only have one state type x state match, so we are done.
+      break;
+    }
 
-      // Then set the part state data, as well as any part state frame data if
-      // the current frame is within the list size.
-      activePart.properties.merge(partState->partStateProperties, true);
+    // The properties only depend on the matched state and frames, so they
+    // only need to be rebuilt when those change.
+    if (part.activePropertiesSource != propertiesSource) {
+      activePart.properties = part.partProperties;
+      activePart.nextProperties = part.partProperties;
 
-      activePart.nextProperties.merge(partState->partStateProperties, true);
+      if (matchedPartState) {
+        unsigned frame = get<2>(propertiesSource);
+        unsigned nextFrame = get<3>(propertiesSource);
 
-      for (auto const& pair : partState->partStateFrameProperties) {
-        if (frame < pair.second.size())
-          activePart.properties[pair.first] = pair.second.get(frame);
-        if (nextFrame < pair.second.size())
-          activePart.nextProperties[pair.first] = pair.second.get(nextFrame);
+        // Set the part state data, as well as any part state frame data if
+        // the current frame is within the list size.
+        activePart.properties.merge(matchedPartState->partStateProperties, true);
+
+        activePart.nextProperties.merge(matchedPartState->partStateProperties, true);
+
+        for (auto const& pair : matchedPartState->partStateFrameProperties) {
+          if (frame < pair.second.size())
+            activePart.properties[pair.first] = pair.second.get(frame);
+          if (nextFrame < pair.second.size())
+            activePart.nextProperties[pair.first] = pair.second.get(nextFrame);
+        }
       }
 
-      // Each part can only have one state type x state match, so we are done.
-      break;
+      part.activePropertiesSource = std::move(propertiesSource);
+      ++activePart.propertiesVersion;
     }
     if (version() > 0) {
       auto processTransforms = [](Mat3F mat, JsonArray transforms, JsonObject properties) -> Mat3F {
@@ -439,7 +484,7 @@ Json AnimatedPartSet::getStateFrameProperty(String const & stateTypeName, String
 }
 
 Json AnimatedPartSet::getPartStateFrameProperty(String const & partName, String const & propertyName, String const & stateTypeName, String stateName, int frame) const {
-  auto part = m_parts.get(partName);
+  auto const& part = m_parts.at(m_partIndices.get(partName));
   auto state = part.partStates.get(stateTypeName).get(stateName);
   if (auto frameProperty = state.partStateFrameProperties.maybe(propertyName))
     if (frame < frameProperty.value().size())
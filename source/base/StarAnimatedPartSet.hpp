@@ -60,6 +60,9 @@ public:
     Maybe<ActiveStateInformation> activeState;
     JsonObject properties;
     JsonObject nextProperties;
+    // Incremented whenever properties and nextProperties are rebuilt, so that
+    // values derived from them can be cached.
+    uint64_t propertiesVersion;
 
     Mat3F animationAffineTransform() const;
     void setAnimationAffineTransform(Mat3F const& matrix);
@@ -98,6 +101,9 @@ public:
     ActiveStateInformation activeState;
     State const* activeStatePointer;
     bool activeStateDirty;
+    // The state, frame and next frame the active state properties were last
+    // built from.
+    Maybe<tuple<String, unsigned, unsigned>> activePropertiesSource;
   };
 
   struct PartState {
@@ -111,6 +117,9 @@ public:
 
     ActivePartInformation activePart;
     bool activePartDirty;
+    // The matched state type, state, frame and next frame the active part
+    // properties were last built from.
+    Maybe<tuple<String, String, unsigned, unsigned>> activePropertiesSource;
   };
 
   AnimatedPartSet();
@@ -128,7 +137,10 @@ public:
   // Returns the available states for the given state type.
   StringList states(String const& stateTypeName) const;
 
+  // Parts are kept in order of name, and the index of a part is stable for
+  // the lifetime of the AnimatedPartSet.
   StringList partNames() const;
+  Maybe<size_t> partIndex(String const& partName) const;
 
   // Sets the active state for this state type.  If the state is different than
   // the previously set state, will start the new states animation off at the
@@ -142,10 +154,11 @@ public:
 
   ActiveStateInformation const& activeState(String const& stateTypeName) const;
   ActivePartInformation const& activePart(String const& partName) const;
+  ActivePartInformation const& activePart(size_t partIndex) const;
   State const& getState(String const& stateTypeName, String const& stateName) const;
 
-  StringMap<Part> const& constParts() const;
-  StringMap<Part>& parts();
+  List<Part> const& constParts() const;
+  List<Part>& parts();
 
   // Function will be given the name of each state type, and the
   // ActiveStateInformation for the active state for that state type.
@@ -155,6 +168,9 @@ public:
   // ActivePartInformation for the active part.
   void forEachActivePart(function<void(String const&, ActivePartInformation const&)> callback) const;
 
+  // Incremented whenever the state or frame of any state type changes.
+  uint64_t activeStatesVersion() const;
+
   // Useful for serializing state changes.  Since each set of states for a
   // state type is ordered, it is possible to simply serialize and deserialize
   // the state index for that state type.
@@ -181,7 +197,9 @@ private:
   void freshenActivePart(Part& part);
 
   OrderedHashMap<String, StateType> m_stateTypes;
-  StringMap<Part> m_parts;
+  List<Part> m_parts;
+  StringMap<size_t> m_partIndices;
+  uint64_t m_activeStatesVersion;
 
   uint8_t m_animatorVersion;
 };
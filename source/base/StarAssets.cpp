@@ -147,6 +147,7 @@ Assets::Assets(Settings settings, StringList assetSources) {
 
   m_settings = std::move(settings);
   m_stopThreads = false;
+  m_jsonStringPool = make_shared<JsonStringPool>();
   m_assetSources = std::move(assetSources);
 
   auto luaEngine = LuaEngine::create();
@@ -596,6 +597,29 @@ ImageConstPtr Assets::tryImage(AssetPath const& path) const {
     return {};
 }
 
+ImageConstPtr Assets::image(AssetPathId const& id) const {
+  if (auto image = imageById(id))
+    return image;
+
+  auto imageData = as<ImageData>(getAsset(AssetId{AssetType::Image, id.path()}));
+  MutexLocker assetsLocker(m_assetsMutex);
+  m_imagesById[id] = imageData;
+  return imageData->image;
+}
+
+ImageConstPtr Assets::tryImage(AssetPathId const& id) const {
+  if (auto image = imageById(id))
+    return image;
+
+  auto imageData = as<ImageData>(tryAsset(AssetId{AssetType::Image, id.path()}));
+  if (!imageData)
+    return {};
+
+  MutexLocker assetsLocker(m_assetsMutex);
+  m_imagesById[id] = imageData;
+  return imageData->image;
+}
+
 FramesSpecificationConstPtr Assets::imageFrames(String const& path) const {
   auto components = AssetPath::split(path);
   validatePath(components, false, false);
@@ -691,6 +715,13 @@ void Assets::cleanup() {
       }
     }
   }
+
+  // Images only held here any more have left the cache
+  eraseWhere(m_imagesById, [](auto const& p) {
+      return p.second.unique();
+    });
+
+  m_jsonStringPool->cleanup();
 }
 
 bool Assets::AssetId::operator==(AssetId const& assetId) const {
@@ -1100,7 +1131,7 @@ Json Assets::checkPatchArray(String const& path, AssetSourcePtr const& source, J
 Json Assets::readJson(String const& path) const {
   ByteArray streamData = read(path);
   try {
-    return applyJsonPatches(inputUtf8Json(streamData.begin(), streamData.end(), JsonParseType::Top), path, m_files.get(path).patchSources);
+    return applyJsonPatches(inputUtf8Json(streamData.begin(), streamData.end(), JsonParseType::Top, m_jsonStringPool.get()), path, m_files.get(path).patchSources);
   } catch (std::exception const& e) {
     throw JsonParsingException(strf("Cannot parse json file: {}", path), e);
   }
@@ -1412,4 +1443,13 @@ void Assets::freshen(shared_ptr<AssetData> const& asset) const {
   asset->time = Time::monotonicTime();
 }
 
+ImageConstPtr Assets::imageById(AssetPathId const& id) const {
+  MutexLocker assetsLocker(m_assetsMutex);
+  if (auto imageData = m_imagesById.value(id)) {
+    freshen(imageData);
+    return imageData->image;
+  }
+  return {};
+}
+
 }
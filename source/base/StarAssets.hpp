@@ -16,6 +16,7 @@ STAR_CLASS(Audio);
 STAR_CLASS(Image);
 STAR_STRUCT(FramesSpecification);
 STAR_CLASS(Assets);
+STAR_CLASS(JsonStringPool);
 
 STAR_CLASS(LuaContext);
 
@@ -224,6 +225,11 @@ public:
   // Return the given image *if* it is already loaded, otherwise queue it for
   // loading.
   ImageConstPtr tryImage(AssetPath const& path) const;
+  // As image and tryImage, for an interned path.  Images found by id are
+  // remembered until they leave the cache, so that finding them again does
+  // not hash the path.
+  ImageConstPtr image(AssetPathId const& id) const;
+  ImageConstPtr tryImage(AssetPathId const& id) const;
 
   // Returns the best associated FramesSpecification for a given image path, if
   // it exists.  The given path must not contain sub-paths or directives, and
@@ -318,6 +324,9 @@ private:
   // Updates time on the given asset (with smearing).
   void freshen(shared_ptr<AssetData> const& asset) const;
 
+  // The image already found for the given id, if it is still cached
+  ImageConstPtr imageById(AssetPathId const& id) const;
+
   Settings m_settings;
 
   mutable Mutex m_assetsMutex;
@@ -327,6 +336,10 @@ private:
 
   mutable ConditionVariable m_assetsDone;
   mutable HashMap<AssetId, shared_ptr<AssetData>, AssetIdHash> m_assetsCache;
+  mutable HashMap<AssetPathId, shared_ptr<ImageData>> m_imagesById;
+
+  // Shares repeated string values between loaded json assets
+  JsonStringPoolPtr m_jsonStringPool;
 
   mutable StringMap<String> m_bestFramesFiles;
   mutable StringMap<FramesSpecificationConstPtr> m_framesSpecifications;
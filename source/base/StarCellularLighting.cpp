@@ -205,6 +205,18 @@ void CellularLightIntensityCalculator::begin(Vec2F const& queryPosition) {
   m_lightArray.begin(m_calculationRegion.width(), m_calculationRegion.height());
 }
 
+void CellularLightIntensityCalculator::beginRegion(RectI const& queryRegion) {
+  m_queryRegion = queryRegion;
+  m_queryPosition = Vec2F(queryRegion.min());
+  m_calculationRegion = RectI(m_queryRegion).padded((int)m_lightArray.borderCells());
+
+  m_lightArray.begin(m_calculationRegion.width(), m_calculationRegion.height());
+}
+
+size_t CellularLightIntensityCalculator::borderCells() const {
+  return m_lightArray.borderCells();
+}
+
 RectI CellularLightIntensityCalculator::calculationRegion() const {
   return m_calculationRegion;
 }
@@ -249,4 +261,16 @@ float CellularLightIntensityCalculator::calculate() {
   return lerp(yl, lerp(xl, ll, lr), lerp(xl, ul, ur));
 }
 
+void CellularLightIntensityCalculator::calculateRegion() {
+  Vec2S arrayMin = Vec2S(m_queryRegion.min() - m_calculationRegion.min());
+  Vec2S arrayMax = Vec2S(m_queryRegion.max() - m_calculationRegion.min());
+
+  m_lightArray.calculate(arrayMin[0], arrayMin[1], arrayMax[0], arrayMax[1]);
+}
+
+float CellularLightIntensityCalculator::getLight(Vec2I const& position) const {
+  Vec2S arrayPosition = Vec2S(position - m_calculationRegion.min());
+  return m_lightArray.getLight(arrayPosition[0], arrayPosition[1]);
+}
+
 }
@@ -164,7 +164,13 @@ public:
   void setParameters(Json const& config);
 
   void begin(Vec2F const& queryPosition);
+  // Begins a calculation of the light in every cell of the given region,
+  // rather than at a single point.
+  void beginRegion(RectI const& queryRegion);
 
+  // The distance around the query region that cells and lights can affect it
+  // from.
+  size_t borderCells() const;
   RectI calculationRegion() const;
 
   void setCell(Vec2I const& position, Cell const& cell);
@@ -174,6 +180,10 @@ public:
   void addPointLight(Vec2F const& position, float light, float beam, float beamAngle, float beamAmbience);
 
   float calculate();
+  // Calculates every cell in a region given to beginRegion, after which the
+  // light of each cell can be read with getLight.
+  void calculateRegion();
+  float getLight(Vec2I const& position) const;
 
 private:
   ScalarCellularLightArray m_lightArray;
@@ -7,6 +7,8 @@
 #include "StarOrderedSet.hpp"
 #include "StarRandom.hpp"
 #include "StarBlockAllocator.hpp"
+#include "StarArray.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -38,6 +40,9 @@ struct CellularLiquidWorld {
 
   // Should return an amount between 0.0 and 1.0 as a percentage of liquid
   // drain at this position
+  //
+  // If the engine is given a worker pool, cell and drainLevel will be called
+  // concurrently from the pool's threads, and must only read world state.
   virtual float drainLevel(Vec2I const& location) const;
 
   // Will be called only on cells which for which the cell method returned a
@@ -80,6 +85,22 @@ public:
 
   void setProcessingLimit(Maybe<unsigned> processingLimit);
 
+  // Reseeds the random source used to pick spread directions, the simulation
+  // is reproducible given the same seed and the same world.
+  void setRandomSeed(uint64_t seed);
+
+  // When given a worker pool, the cells active in each update are split into
+  // regions that cannot affect each other within one update, and batches of
+  // regions are simulated in parallel on the pool.  Batches do not depend on
+  // the number of threads and results are merged back in a fixed order, so
+  // parallel updates are just as reproducible, though they do not match a
+  // serial update step for step.  Set to null to update serially.
+  void setWorkerPool(WorkerPool* workerPool);
+  // Number of batches the last update was split into, zero if it was serial.
+  size_t parallelBatches() const;
+  // Number of working chunks kept allocated for later updates.
+  size_t pooledChunks() const;
+
   List<RectI> noProcessingLimitRegions() const;
   void setNoProcessingLimitRegions(List<RectI> noProcessingLimitRegions);
 
@@ -106,11 +127,24 @@ private:
     bool sourceCell;
     float level;
     float pressure;
+  };
 
-    WorkingCell* leftCell;
-    WorkingCell* rightCell;
-    WorkingCell* topCell;
-    WorkingCell* bottomCell;
+  // Working cells are kept in a dense grid of square chunks, so that looking
+  // up a neighbor is an offset into the same chunk nearly every time.  Chunks
+  // are cleared and reused between updates.  After each update the pools keep
+  // at most this many chunks beyond the most that update used, so the chunks
+  // of a flood are freed once it has drained.
+  static int const WorkingChunkBits = 5;
+  static int const WorkingChunkSize = 1 << WorkingChunkBits;
+  static size_t const WorkingChunkCells = WorkingChunkSize * WorkingChunkSize;
+  static size_t const MaxFreeChunks = 16;
+
+  struct WorkingChunk {
+    // Bitmaps of which cells have been read from the world this update, and
+    // which of those read cells are flow or source cells.
+    Array<uint64_t, WorkingChunkCells / 64> loaded;
+    Array<uint64_t, WorkingChunkCells / 64> present;
+    Array<WorkingCell, WorkingChunkCells> cells;
   };
 
   template <typename Key, typename Value>
@@ -122,27 +156,66 @@ private:
   template <typename Value>
   using BAOrderedHashSet = OrderedHashSet<Value, hash<Value>, std::equal_to<Value>, BlockAllocator<Value, 4096>>;
 
+  // The working state of simulating one set of active cells.  Serial updates
+  // use the engine's own simulation, parallel updates use one per batch and
+  // merge their results back into the engine's simulation when finished.
+  struct Simulation {
+    Simulation();
+
+    RandomSource random;
+
+    HashMap<Vec2I, WorkingChunk*> workingChunks;
+    List<unique_ptr<WorkingChunk>> chunkPool;
+    size_t usedChunks;
+    // Most chunks in use at once since the pool was last trimmed
+    size_t peakChunks;
+    Vec2I lastChunkPosition;
+    WorkingChunk* lastChunk;
+
+    List<WorkingCell*> currentActiveCells;
+    BAHashSet<Vec2I> nextActiveCells;
+    BAHashSet<tuple<Vec2I, LiquidId, Vec2I, LiquidId>> liquidInteractions;
+    BAHashSet<tuple<Vec2I, LiquidId, Vec2I>> liquidCollisions;
+  };
+
+  // Index into the update cells of each cell in a chunk, for finding the
+  // regions of a parallel update.
+  static uint32_t const NoRegionCell = highest<uint32_t>();
+  struct RegionChunk {
+    Array<uint32_t, WorkingChunkCells> cells;
+  };
+
+  // Regions are packed in order into batches of at least this many cells, to
+  // keep the per batch overhead low for lots of tiny pools of liquid.
+  static size_t const ParallelBatchCells = 2048;
+
   void setup();
-  void applyPressure();
-  void spreadPressure();
-  void limitPressure();
-  void pressureMove();
-  void spreadOverfill();
-  void levelMove();
-  void findInteractions();
+  void simulate(Simulation& simulation, List<pair<Vec2I, LiquidId>> const& updateCells);
+  void simulateParallel();
+  void applyPressure(Simulation& simulation);
+  void spreadPressure(Simulation& simulation);
+  void limitPressure(Simulation& simulation);
+  void pressureMove(Simulation& simulation);
+  void spreadOverfill(Simulation& simulation);
+  void levelMove(Simulation& simulation);
+  void findInteractions(Simulation& simulation);
   void finish();
 
-  WorkingCell* workingCell(Vec2I p);
-  WorkingCell* adjacentCell(WorkingCell* cell, Adjacency adjacency);
+  WorkingCell* workingCell(Simulation& simulation, Vec2I p);
+  WorkingCell* adjacentCell(Simulation& simulation, WorkingCell* cell, Adjacency adjacency);
+  WorkingChunk* workingChunk(Simulation& simulation, Vec2I const& chunkPosition);
+  void flushWorkingCells(Simulation& simulation);
+  void clearWorkingCells(Simulation& simulation);
+  void trimChunkPools();
 
-  void setPressure(float pressure, WorkingCell& cell);
-  void transferPressure(float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse);
-  void transferLevel(float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse);
-  void setLevel(float level, WorkingCell& cell);
+  void setPressure(Simulation& simulation, float pressure, WorkingCell& cell);
+  void transferPressure(Simulation& simulation, float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse);
+  void transferLevel(Simulation& simulation, float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse);
+  void setLevel(Simulation& simulation, float level, WorkingCell& cell);
 
-  RandomSource m_random;
   LiquidCellEngineParameters m_engineParameters;
   CellularLiquidWorldPtr m_cellWorld;
+  WorkerPool* m_workerPool;
 
   BAHashMap<LiquidId, BAOrderedHashSet<Vec2I>> m_activeCells;
   BAHashMap<LiquidId, unsigned> m_liquidTickDeltas;
@@ -150,11 +223,17 @@ private:
   List<RectI> m_noProcessingLimitRegions;
   uint64_t m_step;
 
-  BAHashMap<Vec2I, Maybe<WorkingCell>> m_workingCells;
-  List<WorkingCell*> m_currentActiveCells;
-  BAHashSet<Vec2I> m_nextActiveCells;
-  BAHashSet<tuple<Vec2I, LiquidId, Vec2I, LiquidId>> m_liquidInteractions;
-  BAHashSet<tuple<Vec2I, LiquidId, Vec2I>> m_liquidCollisions;
+  // Cells to simulate this update, and the liquid they were active for
+  List<pair<Vec2I, LiquidId>> m_updateCells;
+  Simulation m_simulation;
+  List<unique_ptr<Simulation>> m_batchSimulations;
+  List<List<pair<Vec2I, LiquidId>>> m_batchCells;
+  HashMap<Vec2I, RegionChunk*> m_regionChunks;
+  List<unique_ptr<RegionChunk>> m_regionChunkPool;
+  // Region chunks the last update used, zero if it was serial
+  size_t m_usedRegionChunks;
+  size_t m_usedBatches;
+  size_t m_lastUpdateBatches;
 };
 
 template <typename LiquidId>
@@ -178,7 +257,7 @@ void CellularLiquidWorld<LiquidId>::liquidCollision(Vec2I const&, LiquidId, Vec2
 
 template <typename LiquidId>
 LiquidCellEngine<LiquidId>::LiquidCellEngine(LiquidCellEngineParameters parameters, CellularLiquidWorldPtr cellWorld)
-  : m_engineParameters(parameters), m_cellWorld(cellWorld), m_step(0) {}
+  : m_engineParameters(parameters), m_cellWorld(cellWorld), m_workerPool(nullptr), m_step(0), m_usedRegionChunks(0), m_usedBatches(0), m_lastUpdateBatches(0) {}
 
 template <typename LiquidId>
 unsigned LiquidCellEngine<LiquidId>::liquidTickDelta(LiquidId liquid) {
@@ -195,6 +274,29 @@ void LiquidCellEngine<LiquidId>::setProcessingLimit(Maybe<unsigned> processingLi
   m_processingLimit = processingLimit;
 }
 
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::setRandomSeed(uint64_t seed) {
+  m_simulation.random.init(seed);
+}
+
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::setWorkerPool(WorkerPool* workerPool) {
+  m_workerPool = workerPool;
+}
+
+template <typename LiquidId>
+size_t LiquidCellEngine<LiquidId>::parallelBatches() const {
+  return m_lastUpdateBatches;
+}
+
+template <typename LiquidId>
+size_t LiquidCellEngine<LiquidId>::pooledChunks() const {
+  size_t chunks = m_simulation.chunkPool.size() + m_regionChunkPool.size();
+  for (auto const& simulation : m_batchSimulations)
+    chunks += simulation->chunkPool.size();
+  return chunks;
+}
+
 template <typename LiquidId>
 List<RectI> LiquidCellEngine<LiquidId>::noProcessingLimitRegions() const {
   return m_noProcessingLimitRegions;
@@ -207,28 +309,27 @@ void LiquidCellEngine<LiquidId>::setNoProcessingLimitRegions(List<RectI> noProce
 
 template <typename LiquidId>
 void LiquidCellEngine<LiquidId>::visitLocation(Vec2I const& p) {
-  m_nextActiveCells.add(p);
+  m_simulation.nextActiveCells.add(p);
 }
 
 template <typename LiquidId>
 void LiquidCellEngine<LiquidId>::visitRegion(RectI const& region) {
   for (int x = region.xMin(); x < region.xMax(); ++x) {
     for (int y = region.yMin(); y < region.yMax(); ++y)
-      m_nextActiveCells.add({x, y});
+      m_simulation.nextActiveCells.add({x, y});
   }
 }
 
 template <typename LiquidId>
 void LiquidCellEngine<LiquidId>::update() {
   setup();
-  applyPressure();
-  spreadPressure();
-  limitPressure();
-  pressureMove();
-  spreadOverfill();
-  levelMove();
-  findInteractions();
+  if (m_workerPool)
+    simulateParallel();
+  else
+    simulate(m_simulation, m_updateCells);
+  m_lastUpdateBatches = m_usedBatches;
   finish();
+  trimChunkPools();
 
   ++m_step;
 }
@@ -255,12 +356,21 @@ bool LiquidCellEngine<LiquidId>::isActive(Vec2I const& pos) const {
   return false;
 }
 
+template <typename LiquidId>
+LiquidCellEngine<LiquidId>::Simulation::Simulation()
+  : usedChunks(0), peakChunks(0), lastChunk(nullptr) {}
+
 template <typename LiquidId>
 void LiquidCellEngine<LiquidId>::setup() {
   // In case an exception occurred during the last update, clear potentially
   // stale data here
-  m_workingCells.clear();
-  m_currentActiveCells.clear();
+  clearWorkingCells(m_simulation);
+  m_simulation.currentActiveCells.clear();
+  for (size_t i = 0; i < m_usedBatches; ++i)
+    clearWorkingCells(*m_batchSimulations[i]);
+  m_usedBatches = 0;
+  m_usedRegionChunks = 0;
+  m_updateCells.clear();
 
   for (auto& activeCellsPair : m_activeCells) {
     unsigned tickDelta = liquidTickDelta(activeCellsPair.first);
@@ -286,46 +396,202 @@ void LiquidCellEngine<LiquidId>::setup() {
         }
       }
 
-      auto cell = workingCell(pos);
-      if (!cell || cell->liquid != activeCellsPair.first) {
-        activeCellsPair.second.remove(pos);
-      } else {
-        m_currentActiveCells.append(cell);
-        activeCellsPair.second.remove(pos);
-      }
+      m_updateCells.append({pos, activeCellsPair.first});
+      activeCellsPair.second.remove(pos);
     }
   }
+}
 
-  sort(m_currentActiveCells, [](WorkingCell* lhs, WorkingCell* rhs) {
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::simulate(Simulation& simulation, List<pair<Vec2I, LiquidId>> const& updateCells) {
+  for (auto const& p : updateCells) {
+    auto cell = workingCell(simulation, p.first);
+    if (cell && cell->liquid == p.second)
+      simulation.currentActiveCells.append(cell);
+  }
+
+  sort(simulation.currentActiveCells, [](WorkingCell* lhs, WorkingCell* rhs) {
       return lhs->position[1] < rhs->position[1];
     });
+
+  applyPressure(simulation);
+  spreadPressure(simulation);
+  limitPressure(simulation);
+  pressureMove(simulation);
+  spreadOverfill(simulation);
+  levelMove(simulation);
+  findInteractions(simulation);
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::applyPressure() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::simulateParallel() {
+  size_t cellCount = m_updateCells.size();
+  if (cellCount == 0)
+    return;
+
+  // Every pass only touches a cell and its direct neighbors, so two cells can
+  // only affect each other within one update if they are at most two cells
+  // apart.  Join such cells into regions, each region is named by the index of
+  // its first cell.
+  List<size_t> regions(cellCount);
+  auto findRegion = [&regions](size_t i) {
+    while (regions[i] != i) {
+      regions[i] = regions[regions[i]];
+      i = regions[i];
+    }
+    return i;
+  };
+  auto joinRegions = [&](size_t a, size_t b) {
+    a = findRegion(a);
+    b = findRegion(b);
+    if (a < b)
+      regions[b] = a;
+    else if (b < a)
+      regions[a] = b;
+  };
+
+  // Cell indexes are kept in a chunked grid like the working cells, as
+  // looking up every cell's neighbors in a hash map costs as much as a pass.
+  size_t usedRegionChunks = 0;
+  Vec2I lastChunkPosition;
+  RegionChunk* lastChunk = nullptr;
+  auto cellIndex = [&](Vec2I const& p, bool create) -> uint32_t* {
+    Vec2I chunkPosition(p[0] >> WorkingChunkBits, p[1] >> WorkingChunkBits);
+    if (!lastChunk || chunkPosition != lastChunkPosition) {
+      RegionChunk* chunk;
+      if (create) {
+        auto res = m_regionChunks.insert(make_pair(chunkPosition, nullptr));
+        if (res.second) {
+          if (usedRegionChunks == m_regionChunkPool.size()) {
+            m_regionChunkPool.append(make_unique<RegionChunk>());
+            m_regionChunkPool.last()->cells.fill(NoRegionCell);
+          }
+          res.first->second = m_regionChunkPool[usedRegionChunks++].get();
+        }
+        chunk = res.first->second;
+      } else {
+        chunk = m_regionChunks.value(chunkPosition, nullptr);
+        if (!chunk)
+          return nullptr;
+      }
+      lastChunk = chunk;
+      lastChunkPosition = chunkPosition;
+    }
+    return &lastChunk->cells[((p[1] & (WorkingChunkSize - 1)) << WorkingChunkBits) | (p[0] & (WorkingChunkSize - 1))];
+  };
+
+  for (size_t i = 0; i < cellCount; ++i) {
+    regions[i] = i;
+    uint32_t* index = cellIndex(m_updateCells[i].first, true);
+    // The same position may be active for more than one liquid
+    if (*index == NoRegionCell)
+      *index = i;
+    else
+      joinRegions(i, *index);
+  }
+
+  // Only half of the offsets are needed, the other half is covered by
+  // checking from the other cell.
+  static Array<Vec2I, 6> const RegionOffsets{Vec2I(1, 0), Vec2I(2, 0), Vec2I(-1, 1), Vec2I(0, 1), Vec2I(1, 1), Vec2I(0, 2)};
+  for (size_t i = 0; i < cellCount; ++i) {
+    for (auto const& offset : RegionOffsets) {
+      uint32_t* other = cellIndex(m_cellWorld->uniqueLocation(m_updateCells[i].first + offset), false);
+      if (other && *other != NoRegionCell)
+        joinRegions(i, *other);
+    }
+  }
+
+  for (auto const& p : m_updateCells)
+    *cellIndex(p.first, false) = NoRegionCell;
+  m_regionChunks.clear();
+  m_usedRegionChunks = usedRegionChunks;
+
+  // Pack regions in order of their first cell into batches, and give each
+  // batch the cells of its regions in their original order.
+  List<size_t> regionSizes(cellCount, 0);
+  for (size_t i = 0; i < cellCount; ++i)
+    ++regionSizes[findRegion(i)];
+
+  List<size_t> regionBatches(cellCount);
+  size_t batchSize = 0;
+  for (size_t i = 0; i < cellCount; ++i) {
+    if (regions[i] != i)
+      continue;
+
+    if (m_usedBatches == 0 || batchSize >= ParallelBatchCells) {
+      if (m_usedBatches == m_batchSimulations.size()) {
+        m_batchSimulations.append(make_unique<Simulation>());
+        m_batchCells.append({});
+      }
+      m_batchCells[m_usedBatches].clear();
+      ++m_usedBatches;
+      batchSize = 0;
+    }
+
+    batchSize += regionSizes[i];
+    regionBatches[i] = m_usedBatches - 1;
+  }
+
+  for (size_t i = 0; i < cellCount; ++i)
+    m_batchCells[regionBatches[findRegion(i)]].append(m_updateCells[i]);
+
+  for (size_t i = 0; i < m_usedBatches; ++i)
+    m_batchSimulations[i]->random.init(m_simulation.random.randu64());
+
+  // Simulate the first batch on this thread while the pool handles the rest,
+  // and wait for every batch even if one of them fails, as they all refer to
+  // the engine.
+  List<WorkerPoolHandle> handles;
+  for (size_t i = 1; i < m_usedBatches; ++i)
+    handles.append(m_workerPool->addWork([this, i]() {
+        simulate(*m_batchSimulations[i], m_batchCells[i]);
+      }));
+
+  std::exception_ptr exception;
+  try {
+    simulate(*m_batchSimulations[0], m_batchCells[0]);
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  for (auto const& handle : handles) {
+    try {
+      handle.finish();
+    } catch (...) {
+      if (!exception)
+        exception = std::current_exception();
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::applyPressure(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     if (!selfCell->liquid || selfCell->sourceCell)
       continue;
 
-    auto topCell = adjacentCell(selfCell, Adjacency::Top);
+    auto topCell = adjacentCell(simulation, selfCell, Adjacency::Top);
     if (topCell && selfCell->liquid == topCell->liquid)
-      setPressure(max(selfCell->pressure, topCell->pressure + min(topCell->level, 1.0f)), *selfCell);
+      setPressure(simulation, max(selfCell->pressure, topCell->pressure + min(topCell->level, 1.0f)), *selfCell);
   }
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::spreadPressure() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::spreadPressure(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     if (!selfCell->liquid)
       continue;
 
     auto spreadPressure = [&](Adjacency adjacency, float bias) {
-      auto targetCell = adjacentCell(selfCell, adjacency);
+      auto targetCell = adjacentCell(simulation, selfCell, adjacency);
       if (targetCell && !targetCell->sourceCell)
-        transferPressure((selfCell->pressure + bias - targetCell->pressure) * m_engineParameters.pressureEqualizeFactor, *selfCell, *targetCell, true);
+        transferPressure(simulation, (selfCell->pressure + bias - targetCell->pressure) * m_engineParameters.pressureEqualizeFactor, *selfCell, *targetCell, true);
     };
 
-    if (m_random.randb()) {
+    if (simulation.random.randb()) {
       spreadPressure(Adjacency::Left, 0.0f);
       spreadPressure(Adjacency::Right, 0.0f);
     } else {
@@ -339,37 +605,37 @@ void LiquidCellEngine<LiquidId>::spreadPressure() {
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::limitPressure() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::limitPressure(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     float level = min(selfCell->level, 1.0f);
-    auto topCell = adjacentCell(selfCell, Adjacency::Top);
+    auto topCell = adjacentCell(simulation, selfCell, Adjacency::Top);
 
     // Force the pressure to the cell level if there is empty space above,
     // otherwise simply make sure the pressure is at least the level
     if (topCell && !topCell->liquid)
-      setPressure(level, *selfCell);
+      setPressure(simulation, level, *selfCell);
     else
-      setPressure(max(selfCell->pressure, level), *selfCell);
+      setPressure(simulation, max(selfCell->pressure, level), *selfCell);
   }
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::pressureMove() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::pressureMove(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     if (!selfCell->liquid)
       continue;
 
     auto pressureMove = [&](Adjacency adjacency) {
-      auto targetCell = adjacentCell(selfCell, adjacency);
+      auto targetCell = adjacentCell(simulation, selfCell, adjacency);
       if (targetCell && !targetCell->sourceCell && targetCell->level >= selfCell->level) {
         float amount = (selfCell->pressure - targetCell->pressure) * m_engineParameters.pressureMoveFactor;
         amount = min(amount, selfCell->level - (1.0f - m_engineParameters.maximumPressureLevelImbalance));
         amount = min(amount, (1.0f + m_engineParameters.maximumPressureLevelImbalance) - targetCell->level);
-        transferLevel(amount, *selfCell, *targetCell, false);
+        transferLevel(simulation, amount, *selfCell, *targetCell, false);
       }
     };
 
-    if (m_random.randb()) {
+    if (simulation.random.randb()) {
       pressureMove(Adjacency::Left);
       pressureMove(Adjacency::Right);
     } else {
@@ -380,23 +646,23 @@ void LiquidCellEngine<LiquidId>::pressureMove() {
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::spreadOverfill() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::spreadOverfill(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     if (!selfCell->liquid || selfCell->sourceCell)
       continue;
 
     auto spreadOverfill = [&](Adjacency adjacency, float factor) {
       float overfill = selfCell->level - 1.0f;
       if (overfill > 0.0f) {
-        auto targetCell = adjacentCell(selfCell, adjacency);
+        auto targetCell = adjacentCell(simulation, selfCell, adjacency);
         if (targetCell)
-          transferLevel(min(overfill, (selfCell->level - targetCell->level)) * factor, *selfCell, *targetCell, false);
+          transferLevel(simulation, min(overfill, (selfCell->level - targetCell->level)) * factor, *selfCell, *targetCell, false);
       }
     };
 
     spreadOverfill(Adjacency::Top, m_engineParameters.spreadOverfillUpFactor);
 
-    if (m_random.randb()) {
+    if (simulation.random.randb()) {
       spreadOverfill(Adjacency::Left, m_engineParameters.spreadOverfillLateralFactor);
       spreadOverfill(Adjacency::Right, m_engineParameters.spreadOverfillLateralFactor);
     } else {
@@ -409,24 +675,24 @@ void LiquidCellEngine<LiquidId>::spreadOverfill() {
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::levelMove() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::levelMove(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     if (!selfCell->liquid)
       continue;
 
-    auto belowCell = adjacentCell(selfCell, Adjacency::Bottom);
+    auto belowCell = adjacentCell(simulation, selfCell, Adjacency::Bottom);
     if (belowCell)
-      transferLevel(min(1.0f - belowCell->level, selfCell->level), *selfCell, *belowCell, false);
+      transferLevel(simulation, min(1.0f - belowCell->level, selfCell->level), *selfCell, *belowCell, false);
 
-    setLevel(selfCell->level * (1.0f - m_cellWorld->drainLevel(selfCell->position)), *selfCell);
+    setLevel(simulation, selfCell->level * (1.0f - m_cellWorld->drainLevel(selfCell->position)), *selfCell);
 
     auto lateralMove = [&](Adjacency adjacency) {
-      auto targetCell = adjacentCell(selfCell, adjacency);
+      auto targetCell = adjacentCell(simulation, selfCell, adjacency);
       if (targetCell)
-        transferLevel((selfCell->level - targetCell->level) * m_engineParameters.lateralMoveFactor, *selfCell, *targetCell, false);
+        transferLevel(simulation, (selfCell->level - targetCell->level) * m_engineParameters.lateralMoveFactor, *selfCell, *targetCell, false);
     };
 
-    if (m_random.randb()) {
+    if (simulation.random.randb()) {
       lateralMove(Adjacency::Left);
       lateralMove(Adjacency::Right);
     } else {
@@ -437,13 +703,13 @@ void LiquidCellEngine<LiquidId>::levelMove() {
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::findInteractions() {
-  for (auto const& selfCell : m_currentActiveCells) {
+void LiquidCellEngine<LiquidId>::findInteractions(Simulation& simulation) {
+  for (auto const& selfCell : simulation.currentActiveCells) {
     if (!selfCell->liquid)
       continue;
 
     for (auto adjacency : {Adjacency::Bottom, Adjacency::Top, Adjacency::Left, Adjacency::Right}) {
-      auto targetCell = adjacentCell(selfCell, adjacency);
+      auto targetCell = adjacentCell(simulation, selfCell, adjacency);
       if (!targetCell) {
         Vec2I adjacentPos = selfCell->position;
         if (adjacency == Adjacency::Left)
@@ -454,7 +720,7 @@ void LiquidCellEngine<LiquidId>::findInteractions() {
           adjacentPos += Vec2I(0, -1);
         else if (adjacency == Adjacency::Top)
           adjacentPos += Vec2I(0, 1);
-        m_liquidCollisions.add(make_tuple(selfCell->position, *selfCell->liquid, adjacentPos));
+        simulation.liquidCollisions.add(make_tuple(selfCell->position, *selfCell->liquid, adjacentPos));
 
       } else if (targetCell->liquid && *targetCell->liquid != *selfCell->liquid) {
         if (targetCell->level <= m_engineParameters.interactTransformationLevel
@@ -465,11 +731,11 @@ void LiquidCellEngine<LiquidId>::findInteractions() {
             selfCell->liquid = targetCell->liquid;
         } else {
           // Make sure to add the point pair in a predictable order so that any
-          // combination of Vec2I points will be unique in m_liquidInteractions
+          // combination of Vec2I points will be unique in liquidInteractions
           if (selfCell->position < targetCell->position)
-            m_liquidInteractions.add(make_tuple(selfCell->position, *selfCell->liquid, targetCell->position, *targetCell->liquid));
+            simulation.liquidInteractions.add(make_tuple(selfCell->position, *selfCell->liquid, targetCell->position, *targetCell->liquid));
           else
-            m_liquidInteractions.add(make_tuple(targetCell->position, *targetCell->liquid, selfCell->position, *selfCell->liquid));
+            simulation.liquidInteractions.add(make_tuple(targetCell->position, *targetCell->liquid, selfCell->position, *selfCell->liquid));
         }
       }
     }
@@ -478,46 +744,44 @@ void LiquidCellEngine<LiquidId>::findInteractions() {
 
 template <typename LiquidId>
 void LiquidCellEngine<LiquidId>::finish() {
-  m_currentActiveCells.clear();
-
-  for (auto& workingCellPair : take(m_workingCells)) {
-    if (workingCellPair.second && !workingCellPair.second->sourceCell) {
-      if (workingCellPair.second->liquid) {
-        if (workingCellPair.second->level < m_engineParameters.minimumLiquidLevel)
-          workingCellPair.second->level = 0.0f;
-      } else {
-        workingCellPair.second->level = 0.0f;
-      }
-
-      if (workingCellPair.second->level == 0.0f) {
-        workingCellPair.second->liquid = {};
-        workingCellPair.second->pressure = 0.0f;
-      }
-
-      m_cellWorld->setFlow(workingCellPair.second->position, CellularLiquidFlowCell<LiquidId>{
-          workingCellPair.second->liquid, workingCellPair.second->level, workingCellPair.second->pressure});
-    }
+  // The cells touched by separate batches never overlap, so their results
+  // can be applied one batch after another without merging them first.  The
+  // engine's own simulation goes last, it also collects locations visited
+  // while applying the results.
+  List<Simulation*> simulations;
+  for (size_t i = 0; i < m_usedBatches; ++i)
+    simulations.append(m_batchSimulations[i].get());
+  simulations.append(&m_simulation);
+  m_usedBatches = 0;
+
+  for (auto simulation : simulations)
+    flushWorkingCells(*simulation);
+
+  for (auto simulation : simulations) {
+    for (auto const& interaction : take(simulation->liquidInteractions))
+      m_cellWorld->liquidInteraction(get<0>(interaction), get<1>(interaction), get<2>(interaction), get<3>(interaction));
   }
 
-  for (auto const& interaction : take(m_liquidInteractions))
-    m_cellWorld->liquidInteraction(get<0>(interaction), get<1>(interaction), get<2>(interaction), get<3>(interaction));
-
-  for (auto const& interaction : take(m_liquidCollisions))
-    m_cellWorld->liquidCollision(get<0>(interaction), get<1>(interaction), get<2>(interaction));
+  for (auto simulation : simulations) {
+    for (auto const& interaction : take(simulation->liquidCollisions))
+      m_cellWorld->liquidCollision(get<0>(interaction), get<1>(interaction), get<2>(interaction));
+  }
 
-  for (auto const& c : take(m_nextActiveCells)) {
-    auto visit = [this](Vec2I p) {
-      p = m_cellWorld->uniqueLocation(p);
-      auto cell = workingCell(p);
-      if (cell && cell->liquid)
-        m_activeCells[*cell->liquid].add(p);
-    };
+  auto visit = [this](Vec2I p) {
+    p = m_cellWorld->uniqueLocation(p);
+    auto cell = workingCell(m_simulation, p);
+    if (cell && cell->liquid)
+      m_activeCells[*cell->liquid].add(p);
+  };
 
-    visit(c);
-    visit(c + Vec2I(-1, 0));
-    visit(c + Vec2I(1, 0));
-    visit(c + Vec2I(0, -1));
-    visit(c + Vec2I(0, 1));
+  for (auto simulation : simulations) {
+    for (auto const& c : take(simulation->nextActiveCells)) {
+      visit(c);
+      visit(c + Vec2I(-1, 0));
+      visit(c + Vec2I(1, 0));
+      visit(c + Vec2I(0, -1));
+      visit(c + Vec2I(0, 1));
+    }
   }
 
   eraseWhere(m_activeCells, [](auto const& p) {
@@ -526,56 +790,151 @@ void LiquidCellEngine<LiquidId>::finish() {
 }
 
 template <typename LiquidId>
-typename LiquidCellEngine<LiquidId>::WorkingCell* LiquidCellEngine<LiquidId>::workingCell(Vec2I p) {
+typename LiquidCellEngine<LiquidId>::WorkingCell* LiquidCellEngine<LiquidId>::workingCell(Simulation& simulation, Vec2I p) {
   p = m_cellWorld->uniqueLocation(p);
 
-  auto res = m_workingCells.insert(make_pair(p, Maybe<WorkingCell>()));
-  if (res.second) {
+  Vec2I chunkPosition(p[0] >> WorkingChunkBits, p[1] >> WorkingChunkBits);
+  WorkingChunk* chunk = simulation.lastChunk;
+  if (!chunk || chunkPosition != simulation.lastChunkPosition) {
+    chunk = workingChunk(simulation, chunkPosition);
+    simulation.lastChunk = chunk;
+    simulation.lastChunkPosition = chunkPosition;
+  }
+
+  size_t index = ((p[1] & (WorkingChunkSize - 1)) << WorkingChunkBits) | (p[0] & (WorkingChunkSize - 1));
+  uint64_t bit = (uint64_t)1 << (index & 63);
+  uint64_t& loaded = chunk->loaded[index >> 6];
+  if (!(loaded & bit)) {
+    loaded |= bit;
     auto cellData = m_cellWorld->cell(p);
-    if (auto flowCell = cellData.template ptr<CellularLiquidFlowCell<LiquidId>>())
-      res.first->second = WorkingCell{p, flowCell->liquid, false, flowCell->level, flowCell->pressure, nullptr, nullptr, nullptr, nullptr};
-    else if (auto sourceCell = cellData.template ptr<CellularLiquidSourceCell<LiquidId>>())
-      res.first->second = WorkingCell{p, sourceCell->liquid, true, 1.0f, sourceCell->pressure, nullptr, nullptr, nullptr, nullptr};
+    if (auto flowCell = cellData.template ptr<CellularLiquidFlowCell<LiquidId>>()) {
+      chunk->cells[index] = WorkingCell{p, flowCell->liquid, false, flowCell->level, flowCell->pressure};
+      chunk->present[index >> 6] |= bit;
+    } else if (auto sourceCell = cellData.template ptr<CellularLiquidSourceCell<LiquidId>>()) {
+      chunk->cells[index] = WorkingCell{p, sourceCell->liquid, true, 1.0f, sourceCell->pressure};
+      chunk->present[index >> 6] |= bit;
+    }
   }
-  return res.first->second.ptr();
+
+  if (chunk->present[index >> 6] & bit)
+    return &chunk->cells[index];
+  return nullptr;
 }
 
 template <typename LiquidId>
 typename LiquidCellEngine<LiquidId>::WorkingCell* LiquidCellEngine<LiquidId>::adjacentCell(
-    WorkingCell* cell, Adjacency adjacency) {
-  auto getCell = [this](WorkingCell*& cellptr, Vec2I cellPos) {
-    if (cellptr)
-      return cellptr;
-    cellptr = workingCell(cellPos);
-    return cellptr;
-  };
-
+    Simulation& simulation, WorkingCell* cell, Adjacency adjacency) {
   if (adjacency == Adjacency::Left)
-    return getCell(cell->leftCell, cell->position + Vec2I(-1, 0));
+    return workingCell(simulation, cell->position + Vec2I(-1, 0));
   else if (adjacency == Adjacency::Right)
-    return getCell(cell->rightCell, cell->position + Vec2I(1, 0));
+    return workingCell(simulation, cell->position + Vec2I(1, 0));
   else if (adjacency == Adjacency::Bottom)
-    return getCell(cell->bottomCell, cell->position + Vec2I(0, -1));
+    return workingCell(simulation, cell->position + Vec2I(0, -1));
   else if (adjacency == Adjacency::Top)
-    return getCell(cell->topCell, cell->position + Vec2I(0, 1));
+    return workingCell(simulation, cell->position + Vec2I(0, 1));
 
   return nullptr;
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::setPressure(float pressure, WorkingCell& cell) {
+typename LiquidCellEngine<LiquidId>::WorkingChunk* LiquidCellEngine<LiquidId>::workingChunk(Simulation& simulation, Vec2I const& chunkPosition) {
+  auto res = simulation.workingChunks.insert(make_pair(chunkPosition, nullptr));
+  if (res.second) {
+    if (simulation.usedChunks == simulation.chunkPool.size()) {
+      auto chunk = make_unique<WorkingChunk>();
+      chunk->loaded.fill(0);
+      chunk->present.fill(0);
+      simulation.chunkPool.append(std::move(chunk));
+    }
+    res.first->second = simulation.chunkPool[simulation.usedChunks++].get();
+  }
+  return res.first->second;
+}
+
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::flushWorkingCells(Simulation& simulation) {
+  simulation.currentActiveCells.clear();
+
+  for (size_t c = 0; c < simulation.usedChunks; ++c) {
+    auto& chunk = *simulation.chunkPool[c];
+    for (size_t w = 0; w < chunk.present.size(); ++w) {
+      uint64_t bits = chunk.present[w];
+      for (size_t b = 0; bits != 0; ++b, bits >>= 1) {
+        if (!(bits & 1))
+          continue;
+
+        auto& cell = chunk.cells[w * 64 + b];
+        if (cell.sourceCell)
+          continue;
+
+        if (cell.liquid) {
+          if (cell.level < m_engineParameters.minimumLiquidLevel)
+            cell.level = 0.0f;
+        } else {
+          cell.level = 0.0f;
+        }
+
+        if (cell.level == 0.0f) {
+          cell.liquid = {};
+          cell.pressure = 0.0f;
+        }
+
+        m_cellWorld->setFlow(cell.position, CellularLiquidFlowCell<LiquidId>{cell.liquid, cell.level, cell.pressure});
+      }
+    }
+  }
+  clearWorkingCells(simulation);
+}
+
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::clearWorkingCells(Simulation& simulation) {
+  for (size_t c = 0; c < simulation.usedChunks; ++c) {
+    simulation.chunkPool[c]->loaded.fill(0);
+    simulation.chunkPool[c]->present.fill(0);
+  }
+  simulation.peakChunks = max(simulation.peakChunks, simulation.usedChunks);
+  simulation.usedChunks = 0;
+  simulation.workingChunks.clear();
+  simulation.lastChunk = nullptr;
+}
+
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::trimChunkPools() {
+  auto trim = [](Simulation& simulation) {
+    // The engine's own simulation still holds the chunks visited in finish
+    size_t keep = max(simulation.peakChunks, simulation.usedChunks) + MaxFreeChunks;
+    if (simulation.chunkPool.size() > keep)
+      simulation.chunkPool.resize(keep);
+    simulation.peakChunks = 0;
+  };
+
+  trim(m_simulation);
+  // Batch simulations the last update did not need are dropped entirely
+  if (m_batchSimulations.size() > m_lastUpdateBatches) {
+    m_batchSimulations.resize(m_lastUpdateBatches);
+    m_batchCells.resize(m_lastUpdateBatches);
+  }
+  for (auto& simulation : m_batchSimulations)
+    trim(*simulation);
+
+  if (m_regionChunkPool.size() > m_usedRegionChunks + MaxFreeChunks)
+    m_regionChunkPool.resize(m_usedRegionChunks + MaxFreeChunks);
+}
+
+template <typename LiquidId>
+void LiquidCellEngine<LiquidId>::setPressure(Simulation& simulation, float pressure, WorkingCell& cell) {
   if (!cell.liquid || cell.sourceCell)
     return;
 
   if (fabs(cell.pressure - pressure) > m_engineParameters.minimumLivenPressureChange)
-    m_nextActiveCells.add(cell.position);
+    simulation.nextActiveCells.add(cell.position);
   cell.pressure = pressure;
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::transferPressure(float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse) {
+void LiquidCellEngine<LiquidId>::transferPressure(Simulation& simulation, float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse) {
   if (amount < 0.0f && allowReverse) {
-    return transferPressure(-amount, dest, source, false);
+    return transferPressure(simulation, -amount, dest, source, false);
   } else if (amount > 0.0f) {
     if (!source.liquid)
       return;
@@ -595,19 +954,19 @@ void LiquidCellEngine<LiquidId>::transferPressure(float amount, WorkingCell& sou
       dest.pressure += amount;
 
     if (amount > m_engineParameters.minimumLivenPressureChange) {
-      m_nextActiveCells.add(source.position);
-      m_nextActiveCells.add(dest.position);
+      simulation.nextActiveCells.add(source.position);
+      simulation.nextActiveCells.add(dest.position);
     }
   }
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::setLevel(float level, WorkingCell& cell) {
+void LiquidCellEngine<LiquidId>::setLevel(Simulation& simulation, float level, WorkingCell& cell) {
   if (!cell.liquid || cell.sourceCell)
     return;
 
   if (fabs(cell.level - level) > m_engineParameters.minimumLivenLevelChange)
-    m_nextActiveCells.add(cell.position);
+    simulation.nextActiveCells.add(cell.position);
 
   cell.level = level;
 
@@ -618,10 +977,10 @@ void LiquidCellEngine<LiquidId>::setLevel(float level, WorkingCell& cell) {
 }
 
 template <typename LiquidId>
-void LiquidCellEngine<LiquidId>::transferLevel(
+void LiquidCellEngine<LiquidId>::transferLevel(Simulation& simulation,
     float amount, WorkingCell& source, WorkingCell& dest, bool allowReverse) {
   if (amount < 0.0f && allowReverse) {
-    transferLevel(-amount, dest, source, false);
+    transferLevel(simulation, -amount, dest, source, false);
 
   } else if (amount > 0.0f) {
     if (!source.liquid)
@@ -646,8 +1005,8 @@ void LiquidCellEngine<LiquidId>::transferLevel(
       source.liquid = {};
 
     if (amount > m_engineParameters.minimumLivenLevelChange) {
-      m_nextActiveCells.add(source.position);
-      m_nextActiveCells.add(dest.position);
+      simulation.nextActiveCells.add(source.position);
+      simulation.nextActiveCells.add(dest.position);
     }
   }
 }
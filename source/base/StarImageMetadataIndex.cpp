@@ -0,0 +1,139 @@
+#include "StarImageMetadataIndex.hpp"
+#include "StarImage.hpp"
+#include "StarDataStreamDevices.hpp"
+#include "StarDataStreamExtra.hpp"
+
+namespace Star {
+
+bool ImageMetadataIndex::Occupancy::occupied(unsigned x, unsigned y) const {
+  size_t bit = (size_t)y * size[0] + x;
+  return (bits[bit / 8] >> (bit % 8)) & 1;
+}
+
+RectU ImageMetadataIndex::Occupancy::nonEmptySubRegion(RectU const& subRect) const {
+  RectU region = RectU::null();
+  for (unsigned y = subRect.yMin(); y < subRect.yMax(); ++y) {
+    for (unsigned x = subRect.xMin(); x < subRect.xMax(); ++x) {
+      if (occupied(x, y))
+        region.combine(RectU::withSize({x - subRect.xMin(), y - subRect.yMin()}, {1, 1}));
+    }
+  }
+  return region;
+}
+
+ImageMetadataIndex ImageMetadataIndex::build(AssetSource& source, StringList const& assetPaths, BuildProgressCallback progressCallback) {
+  ImageMetadataIndex index;
+  for (size_t i = 0; i < assetPaths.size(); ++i) {
+    String const& assetPath = assetPaths[i];
+    if (!assetPath.endsWith(".png", String::CaseInsensitive))
+      continue;
+
+    if (progressCallback)
+      progressCallback(i, assetPaths.size(), assetPath);
+
+    Image image;
+    try {
+      auto file = source.open(assetPath);
+      if (!Image::isPng(file))
+        continue;
+      image = Image::readPng(file);
+    } catch (StarException const&) {
+      continue;
+    }
+
+    ImageMetadata metadata;
+    metadata.size = image.size();
+    metadata.nonEmptyRegion = RectU::null();
+    metadata.occupancyOffset = index.m_occupancy.size();
+
+    index.m_occupancy.resize(index.m_occupancy.size() + occupancySize(metadata.size), 0);
+    char* bits = index.m_occupancy.ptr() + metadata.occupancyOffset;
+    image.forEachPixel([&metadata, bits](unsigned x, unsigned y, Vec4B const& pixel) {
+        if (pixel[3] > 0) {
+          size_t bit = (size_t)y * metadata.size[0] + x;
+          bits[bit / 8] |= 1 << (bit % 8);
+          metadata.nonEmptyRegion.combine(RectU::withSize({x, y}, {1, 1}));
+        }
+      });
+
+    index.m_images.add(assetPath, std::move(metadata));
+  }
+
+  return index;
+}
+
+ImageMetadataIndex ImageMetadataIndex::open(IODevicePtr device, StreamOffset position) {
+  ImageMetadataIndex index;
+  DataStreamIODevice ds(device);
+  ds.seek(position);
+  ds.readMapContainer(index.m_images, [](DataStream& ds, String& path, ImageMetadata& metadata) {
+      ds.read(path);
+      ds.read(metadata.size);
+      ds.read(metadata.nonEmptyRegion);
+      ds.readVlqU(metadata.occupancyOffset);
+    });
+  index.m_occupancySize = ds.readVlqU();
+  index.m_occupancyStart = ds.pos();
+  index.m_device = std::move(device);
+  return index;
+}
+
+auto ImageMetadataIndex::image(String const& assetPath) const -> ImageMetadata const* {
+  return m_images.ptr(assetPath);
+}
+
+auto ImageMetadataIndex::occupancy(ImageMetadata const& image) const -> Occupancy {
+  Occupancy occupancy;
+  occupancy.size = image.size;
+  size_t size = occupancySize(image.size);
+  if (m_device) {
+    occupancy.bits = ByteArray(size, 0);
+    m_device->readFullAbsolute(m_occupancyStart + image.occupancyOffset, occupancy.bits.ptr(), size);
+  } else {
+    occupancy.bits = m_occupancy.sub(image.occupancyOffset, size);
+  }
+  return occupancy;
+}
+
+StringList ImageMetadataIndex::imagePaths() const {
+  return m_images.keys();
+}
+
+size_t ImageMetadataIndex::size() const {
+  return m_images.size();
+}
+
+size_t ImageMetadataIndex::occupancySize(Vec2U const& size) {
+  return ((size_t)size[0] * size[1] + 7) / 8;
+}
+
+DataStream& operator>>(DataStream& ds, ImageMetadataIndex& index) {
+  index.m_images.clear();
+  ds.readMapContainer(index.m_images, [](DataStream& ds, String& path, ImageMetadataIndex::ImageMetadata& metadata) {
+      ds.read(path);
+      ds.read(metadata.size);
+      ds.read(metadata.nonEmptyRegion);
+      ds.readVlqU(metadata.occupancyOffset);
+    });
+  ds.read(index.m_occupancy);
+  index.m_device.reset();
+  index.m_occupancyStart = 0;
+  index.m_occupancySize = index.m_occupancy.size();
+  return ds;
+}
+
+DataStream& operator<<(DataStream& ds, ImageMetadataIndex const& index) {
+  ds.writeMapContainer(index.m_images, [](DataStream& ds, String const& path, ImageMetadataIndex::ImageMetadata const& metadata) {
+      ds.write(path);
+      ds.write(metadata.size);
+      ds.write(metadata.nonEmptyRegion);
+      ds.writeVlqU(metadata.occupancyOffset);
+    });
+  if (index.m_device)
+    ds.write(index.m_device->readBytesAbsolute(index.m_occupancyStart, index.m_occupancySize));
+  else
+    ds.write(index.m_occupancy);
+  return ds;
+}
+
+}
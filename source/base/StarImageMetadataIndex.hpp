@@ -0,0 +1,79 @@
+#pragma once
+
+#include "StarRect.hpp"
+#include "StarByteArray.hpp"
+#include "StarDataStream.hpp"
+#include "StarAssetSource.hpp"
+
+namespace Star {
+
+STAR_CLASS(ImageMetadataIndex);
+
+// Precomputed size and alpha occupancy for every png image in an asset
+// source, so that image metadata can be answered without decoding the image.
+// Built by asset_packer and stored at the end of packed asset files.
+//
+// The size and non-empty region of every image are small and kept in memory,
+// while the occupancy bits of an index opened from a file are only read from
+// it when an image's occupancy is asked for.
+class ImageMetadataIndex {
+public:
+  struct ImageMetadata {
+    Vec2U size;
+    RectU nonEmptyRegion;
+    // Position of the image's occupancy bits within the index's occupancy
+    // data.
+    uint64_t occupancyOffset;
+  };
+
+  struct Occupancy {
+    // Is the pixel at the given position (in bottom-up image coordinates, the
+    // same as Image) non-transparent?
+    bool occupied(unsigned x, unsigned y) const;
+    // The smallest rect of non-transparent pixels within the given sub rect of
+    // the image, in coordinates relative to the sub rect.
+    RectU nonEmptySubRegion(RectU const& subRect) const;
+
+    Vec2U size;
+    // One bit per pixel, row after row from the bottom of the image.
+    ByteArray bits;
+  };
+
+  typedef function<void(size_t, size_t, String const&)> BuildProgressCallback;
+
+  // Decodes every png image among the given paths in the source.  Images that
+  // fail to decode are left out.
+  static ImageMetadataIndex build(AssetSource& source, StringList const& assetPaths, BuildProgressCallback progressCallback = {});
+
+  // Reads the per image entries of an index written at the given position of
+  // the device, leaving the occupancy data to be read from the device when it
+  // is needed.  The device must support reading from absolute positions from
+  // multiple threads.
+  static ImageMetadataIndex open(IODevicePtr device, StreamOffset position);
+
+  ImageMetadata const* image(String const& assetPath) const;
+  Occupancy occupancy(ImageMetadata const& image) const;
+
+  StringList imagePaths() const;
+  size_t size() const;
+
+private:
+  friend DataStream& operator>>(DataStream& ds, ImageMetadataIndex& index);
+  friend DataStream& operator<<(DataStream& ds, ImageMetadataIndex const& index);
+
+  static size_t occupancySize(Vec2U const& size);
+
+  StringMap<ImageMetadata> m_images;
+
+  // Occupancy data of every image, either held in memory or read from
+  // m_device starting at m_occupancyStart.
+  ByteArray m_occupancy;
+  IODevicePtr m_device;
+  StreamOffset m_occupancyStart = 0;
+  size_t m_occupancySize = 0;
+};
+
+DataStream& operator>>(DataStream& ds, ImageMetadataIndex& index);
+DataStream& operator<<(DataStream& ds, ImageMetadataIndex const& index);
+
+}
@@ -9,7 +9,7 @@
 namespace Star {
 
 void PackedAssetSource::build(DirectoryAssetSource& directorySource, String const& targetPackedFile,
-    StringList const& extensionSorting, BuildProgressCallback progressCallback) {
+    StringList const& extensionSorting, BuildProgressCallback progressCallback, bool includeImageMetadata) {
   FilePtr file = File::open(targetPackedFile, IOMode::ReadWrite | IOMode::Truncate);
 
   DataStreamIODevice ds(file);
@@ -64,6 +64,11 @@ void PackedAssetSource::build(DirectoryAssetSource& directorySource, String cons
   ds.write(directorySource.metadata());
   ds.write(index);
 
+  if (includeImageMetadata) {
+    ds.writeData("IMGMETA", 7);
+    ds.write(ImageMetadataIndex::build(directorySource, assetPaths));
+  }
+
   ds.seek(8);
   ds.write(indexStart);
 }
@@ -83,6 +88,9 @@ PackedAssetSource::PackedAssetSource(String const& filename) {
     throw AssetSourceException("No index header found!");
   ds.read(m_metadata);
   ds.read(m_index);
+
+  if (!ds.atEnd() && ds.readBytes(7) == ByteArray("IMGMETA", 7))
+    m_imageMetadataStart = ds.pos();
 }
 
 JsonObject PackedAssetSource::metadata() const {
@@ -156,6 +164,16 @@ IODevicePtr PackedAssetSource::open(String const& path) {
   return make_shared<AssetReader>(m_packedFile, path, p->first, p->second);
 }
 
+ImageMetadataIndexConstPtr PackedAssetSource::imageMetadataIndex() const {
+  if (!m_imageMetadataStart)
+    return {};
+
+  MutexLocker locker(m_imageMetadataMutex);
+  if (!m_imageMetadataIndex)
+    m_imageMetadataIndex = make_shared<ImageMetadataIndex>(ImageMetadataIndex::open(m_packedFile, *m_imageMetadataStart));
+  return m_imageMetadataIndex;
+}
+
 ByteArray PackedAssetSource::read(String const& path) {
   auto p = m_index.ptr(path);
   if (!p)
@@ -3,6 +3,8 @@
 #include "StarOrderedMap.hpp"
 #include "StarFile.hpp"
 #include "StarDirectoryAssetSource.hpp"
+#include "StarImageMetadataIndex.hpp"
+#include "StarThread.hpp"
 
 namespace Star {
 
@@ -22,8 +24,13 @@ public:
   //
   // If given, 'progressCallback' will be called with the total number of
   // files, the current file number, the file name, and the asset path.
+  //
+  // If 'includeImageMetadata' is set, an ImageMetadataIndex of every png in
+  // the source is appended after the file index.  Readers that do not know
+  // about it ignore it.
   static void build(DirectoryAssetSource& directorySource, String const& targetPackedFile,
-      StringList const& extensionSorting = {}, BuildProgressCallback progressCallback = {});
+      StringList const& extensionSorting = {}, BuildProgressCallback progressCallback = {},
+      bool includeImageMetadata = false);
 
   PackedAssetSource(String const& packedFileName);
 
@@ -33,10 +40,19 @@ public:
   IODevicePtr open(String const& path) override;
   ByteArray read(String const& path) override;
 
+  // The image metadata index stored in this file, if it was built with one.
+  // Its per image entries are read from the file the first time it is asked
+  // for, and the occupancy of an image only when that image needs it.
+  ImageMetadataIndexConstPtr imageMetadataIndex() const;
+
 private:
   FilePtr m_packedFile;
   JsonObject m_metadata;
   OrderedHashMap<String, pair<uint64_t, uint64_t>> m_index;
+
+  Maybe<uint64_t> m_imageMetadataStart;
+  mutable Mutex m_imageMetadataMutex;
+  mutable ImageMetadataIndexConstPtr m_imageMetadataIndex;
 };
 
 }
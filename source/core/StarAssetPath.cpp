@@ -1,5 +1,6 @@
 #include "StarAssetPath.hpp"
 #include "StarLexicalCast.hpp"
+#include "StarThread.hpp"
 
 namespace Star {
 
@@ -187,4 +188,91 @@ DataStream& operator<<(DataStream& ds, AssetPath const& path) {
   return ds;
 }
 
+struct AssetPathId::Entry {
+  AssetPath path;
+  uint32_t value;
+};
+
+struct AssetPathId::Table {
+  Mutex mutex;
+  // The value is kept alongside each entry, so that a dying entry only
+  // removes itself and not an entry interned for the same path since.
+  HashMap<AssetPath, pair<weak_ptr<Entry const>, uint32_t>> entries;
+  List<uint32_t> freeValues;
+  uint32_t nextValue = 1;
+};
+
+// Shared with every entry, so that ids outliving static destruction can still
+// release themselves.
+shared_ptr<AssetPathId::Table> const& AssetPathId::table() {
+  static shared_ptr<Table> table = make_shared<Table>();
+  return table;
+}
+
+AssetPathId AssetPathId::intern(AssetPath const& path) {
+  auto const& table = AssetPathId::table();
+  MutexLocker locker(table->mutex);
+
+  auto& slot = table->entries[path];
+  if (auto entry = slot.first.lock())
+    return AssetPathId(std::move(entry));
+
+  uint32_t value = table->freeValues.empty() ? table->nextValue++ : table->freeValues.takeLast();
+  shared_ptr<Entry const> entry(new Entry{path, value}, [table](Entry const* entry) {
+      {
+        MutexLocker locker(table->mutex);
+        auto i = table->entries.find(entry->path);
+        if (i != table->entries.end() && i->second.second == entry->value)
+          table->entries.erase(i);
+        table->freeValues.append(entry->value);
+      }
+      delete entry;
+    });
+  slot = {entry, value};
+  return AssetPathId(std::move(entry));
+}
+
+size_t AssetPathId::internedCount() {
+  auto const& table = AssetPathId::table();
+  MutexLocker locker(table->mutex);
+  return table->entries.size();
+}
+
+AssetPathId::AssetPathId() {}
+
+AssetPathId::AssetPathId(shared_ptr<Entry const> entry)
+  : m_entry(std::move(entry)) {}
+
+AssetPathId::operator bool() const {
+  return (bool)m_entry;
+}
+
+uint32_t AssetPathId::value() const {
+  return m_entry ? m_entry->value : 0;
+}
+
+AssetPath const& AssetPathId::path() const {
+  return m_entry->path;
+}
+
+bool AssetPathId::operator==(AssetPathId const& rhs) const {
+  return m_entry == rhs.m_entry;
+}
+
+bool AssetPathId::operator!=(AssetPathId const& rhs) const {
+  return m_entry != rhs.m_entry;
+}
+
+std::ostream& operator<<(std::ostream& os, AssetPathId const& rhs) {
+  if (rhs)
+    os << rhs.path();
+  else
+    os << "<null>";
+  return os;
+}
+
+size_t hash<AssetPathId>::operator()(AssetPathId const& s) const {
+  return s.value();
+}
+
 }
@@ -74,6 +74,51 @@ struct hash<AssetPath> {
   size_t operator()(AssetPath const& s) const;
 };
 
+// An AssetPath interned into a process wide table, which numbers it with a
+// small integer so that ids hash and compare in constant time.  A path stays
+// in the table while any id refers to it, after which its number may be
+// reused for a different path.  Interning still hashes the whole path, so ids
+// are only worth it for paths that are kept and looked up many times, like
+// the image of a drawable that is drawn every frame.
+class AssetPathId {
+public:
+  static AssetPathId intern(AssetPath const& path);
+
+  // The number of paths currently in the table
+  static size_t internedCount();
+
+  // Constructs the null id, which refers to no path
+  AssetPathId();
+
+  explicit operator bool() const;
+
+  // Zero for the null id
+  uint32_t value() const;
+  // Must not be called on the null id
+  AssetPath const& path() const;
+
+  bool operator==(AssetPathId const& rhs) const;
+  bool operator!=(AssetPathId const& rhs) const;
+
+private:
+  struct Entry;
+  struct Table;
+
+  static shared_ptr<Table> const& table();
+
+  AssetPathId(shared_ptr<Entry const> entry);
+
+  shared_ptr<Entry const> m_entry;
+};
+
+std::ostream& operator<<(std::ostream& os, AssetPathId const& rhs);
+
+template <>
+struct hash<AssetPathId> {
+  size_t operator()(AssetPathId const& s) const;
+};
+
 }
 
 template <> struct fmt::formatter<Star::AssetPath> : ostream_formatter {};
+template <> struct fmt::formatter<Star::AssetPathId> : ostream_formatter {};
@@ -170,6 +170,11 @@ Json::Json(std::string s) {
   m_data = make_shared<String const>((std::move(s)));
 }
 
+Json::Json(StringConstPtr s) {
+  if (s)
+    m_data = std::move(s);
+}
+
 Json::Json(JsonArray l) {
   m_data = make_shared<JsonArray const>(std::move(l));
 }
@@ -178,6 +183,16 @@ Json::Json(JsonObject m) {
   m_data = make_shared<JsonObject const>(std::move(m));
 }
 
+Json::Json(JsonArrayConstPtr l) {
+  if (l)
+    m_data = std::move(l);
+}
+
+Json::Json(JsonObjectConstPtr m) {
+  if (m)
+    m_data = std::move(m);
+}
+
 double Json::toDouble() const {
   if (type() == Type::Float)
     return m_data.get<double>();
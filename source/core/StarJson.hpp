@@ -74,8 +74,14 @@ public:
   Json(String::Char const*, size_t);
   Json(String);
   Json(std::string);
+  // Shares the given string rather than copying it, null constructs type Null
+  Json(StringConstPtr);
   Json(JsonArray);
   Json(JsonObject);
+  // Share the given container rather than copying it, null constructs type
+  // Null.  The container must not be modified while anything else holds it.
+  Json(JsonArrayConstPtr);
+  Json(JsonObjectConstPtr);
 
   // Float and Int types are convertible between each other.  toDouble,
   // toFloat, toInt, toUInt may be called on either an Int or a Float.  For a
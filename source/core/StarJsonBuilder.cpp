@@ -3,12 +3,46 @@
 
 namespace Star {
 
+Json JsonStringPool::string(String::Char const* s, size_t len) {
+  if (len > MaxPooledSize)
+    return Json(s, len);
+  return string(String(s, len));
+}
+
+Json JsonStringPool::string(String s) {
+  if (s.size() > MaxPooledSize)
+    return Json(std::move(s));
+
+  MutexLocker locker(m_mutex);
+  if (auto p = m_strings.ptr(s))
+    return Json(*p);
+
+  auto shared = make_shared<String const>(s);
+  m_strings.add(std::move(s), shared);
+  return Json(std::move(shared));
+}
+
+size_t JsonStringPool::size() const {
+  MutexLocker locker(m_mutex);
+  return m_strings.size();
+}
+
+void JsonStringPool::cleanup() {
+  MutexLocker locker(m_mutex);
+  eraseWhere(m_strings, [](auto const& pair) {
+      return pair.second.unique();
+    });
+}
+
+JsonBuilderStream::JsonBuilderStream(JsonStringPool* stringPool)
+  : m_stringPool(stringPool) {}
+
 void JsonBuilderStream::beginObject() {
   pushSentry();
 }
 
 void JsonBuilderStream::objectKey(char32_t const* s, size_t len) {
-  push(Json(s, len));
+  m_keys.append(String(s, len));
 }
 
 void JsonBuilderStream::endObject() {
@@ -19,7 +53,7 @@ void JsonBuilderStream::endObject() {
       return;
     } else {
       Json v = pop();
-      String k = pop().toString();
+      String k = m_keys.takeLast();
       if (!object.insert(k, std::move(v)).second)
         throw JsonParsingException(strf("Json object contains a duplicate entry for key '{}'", k));
     }
@@ -44,7 +78,10 @@ void JsonBuilderStream::endArray() {
 }
 
 void JsonBuilderStream::putString(char32_t const* s, size_t len) {
-  push(Json(s, len));
+  if (m_stringPool)
+    push(m_stringPool->string(s, len));
+  else
+    push(Json(s, len));
 }
 
 void JsonBuilderStream::putDouble(char32_t const* s, size_t len) {
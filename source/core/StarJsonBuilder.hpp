@@ -2,11 +2,38 @@
 
 #include "StarJsonParser.hpp"
 #include "StarJson.hpp"
+#include "StarThread.hpp"
 
 namespace Star {
 
+STAR_CLASS(JsonStringPool);
+
+// Shares the storage of identical short string values between Json documents
+// built with it, so that documents repeating the same values (asset names,
+// enum values, directives) hold one copy of each.  Safe to use from several
+// threads at once.
+class JsonStringPool {
+public:
+  // Strings longer than this are never pooled.
+  static size_t const MaxPooledSize = 64;
+
+  Json string(String::Char const* s, size_t len);
+  Json string(String s);
+
+  size_t size() const;
+  // Forgets every pooled string that is no longer used outside of the pool.
+  void cleanup();
+
+private:
+  mutable Mutex m_mutex;
+  StringMap<StringConstPtr> m_strings;
+};
+
 class JsonBuilderStream : public JsonStream {
 public:
+  // If a string pool is given, string values are shared through it.
+  JsonBuilderStream(JsonStringPool* stringPool = nullptr);
+
   virtual void beginObject();
   virtual void objectKey(char32_t const* s, size_t len);
   virtual void endObject();
@@ -34,7 +61,11 @@ private:
   void pushSentry();
   bool isSentry();
 
+  JsonStringPool* m_stringPool;
   List<Maybe<Json>> m_stack;
+  // Object keys are kept apart from the values, so that they never need to
+  // be wrapped in a Json.
+  StringList m_keys;
 };
 
 template <typename Jsonlike>
@@ -50,11 +81,11 @@ public:
 };
 
 template <typename InputIterator>
-Json inputUtf8Json(InputIterator begin, InputIterator end, JsonParseType parseType) {
+Json inputUtf8Json(InputIterator begin, InputIterator end, JsonParseType parseType, JsonStringPool* stringPool = nullptr) {
   typedef U8ToU32Iterator<InputIterator> Utf32Input;
   typedef JsonParser<Utf32Input> Parser;
 
-  JsonBuilderStream stream;
+  JsonBuilderStream stream(stringPool);
   Parser parser(stream);
   Utf32Input wbegin(begin);
   Utf32Input wend(end);
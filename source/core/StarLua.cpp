@@ -88,6 +88,10 @@ bool LuaContext::containsPath(String path) const {
   return engine().contextGetPath(handleIndex(), std::move(path)) != LuaNil;
 }
 
+bool LuaContext::pathIs(String const& path, LuaValue const& value) const {
+  return engine().contextPathIs(handleIndex(), path, value);
+}
+
 void LuaContext::load(char const* contents, size_t size, char const* name) {
   engine().contextLoad(handleIndex(), contents, size, name);
 }
@@ -134,6 +138,42 @@ LuaNullEnforcer::LuaNullEnforcer(LuaNullEnforcer&& other) { m_engine = take(othe
 
 LuaNullEnforcer::~LuaNullEnforcer() { if (m_engine) --m_engine->m_nullTerminated; };
 
+LuaAccountingScope::LuaAccountingScope(LuaEngine& engine, String const& label)
+  : m_engine(nullptr) {
+  if (engine.m_accountingEnabled) {
+    m_engine = &engine;
+    m_engine->pushAccountingScope(label);
+  }
+}
+
+LuaAccountingScope::LuaAccountingScope(LuaEngine& engine)
+  : m_engine(nullptr) {
+  if (engine.m_accountingEnabled && engine.m_accountingAttribution) {
+    m_engine = &engine;
+    m_engine->pushAccountingScope(*engine.m_accountingAttribution);
+  }
+}
+
+LuaAccountingScope::LuaAccountingScope(LuaAccountingScope&& other) { m_engine = take(other.m_engine); }
+
+LuaAccountingScope::~LuaAccountingScope() { if (m_engine) m_engine->popAccountingScope(); }
+
+LuaAccountingAttribution::LuaAccountingAttribution(LuaEngine& engine, shared_ptr<String const> label)
+  : m_engine(nullptr) {
+  if (engine.m_accountingEnabled) {
+    m_engine = &engine;
+    m_previous = std::exchange(m_engine->m_accountingAttribution, std::move(label));
+  }
+}
+
+LuaAccountingAttribution::LuaAccountingAttribution(LuaAccountingAttribution&& other)
+  : m_engine(take(other.m_engine)), m_previous(std::move(other.m_previous)) {}
+
+LuaAccountingAttribution::~LuaAccountingAttribution() {
+  if (m_engine)
+    m_engine->m_accountingAttribution = std::move(m_previous);
+}
+
 LuaValue LuaConverter<Json>::from(LuaEngine& engine, Json const& v) {
   if (v.isType(Json::Type::Null)) {
     return LuaNil;
@@ -169,6 +209,11 @@ Maybe<Json> LuaConverter<Json>::to(LuaEngine&, LuaValue const& v) {
   if (v.is<LuaTable>())
     return LuaDetail::tableToJsonContainer(v.get<LuaTable>());
 
+  if (auto ud = v.ptr<LuaUserData>()) {
+    if (ud->is<LuaJsonProxy>())
+      return ud->get<LuaJsonProxy>().json();
+  }
+
   return {};
 }
 
@@ -206,10 +251,226 @@ Maybe<JsonArray> LuaConverter<JsonArray>::to(LuaEngine& engine, LuaValue v) {
   return {};
 }
 
+LuaValue LuaJsonProxy::from(LuaEngine& engine, Json const& value) {
+  if (value.isType(Json::Type::Array) || value.isType(Json::Type::Object))
+    return engine.createUserData(LuaJsonProxy(value));
+  return engine.luaFrom<Json>(value);
+}
+
+LuaJsonProxy::LuaJsonProxy(Json value)
+  : m_node(make_shared<Node>(Node{std::move(value), {}, {}, make_shared<OwnedContainers>(OwnedContainers{{}, {}, 64})})) {}
+
+LuaJsonProxy::LuaJsonProxy(shared_ptr<Node> node)
+  : m_node(std::move(node)) {}
+
+bool LuaJsonProxy::isContainer() const {
+  return m_node->value.isType(Json::Type::Array) || m_node->value.isType(Json::Type::Object);
+}
+
+Json const& LuaJsonProxy::json() const {
+  share();
+  return m_node->value;
+}
+
+LuaValue LuaJsonProxy::get(LuaEngine& engine, LuaValue const& key) const {
+  auto jkey = jsonKey(key);
+  if (!jkey)
+    return LuaNil;
+
+  Json value;
+  if (jkey->isType(Json::Type::String))
+    value = m_node->value.get(*jkey->stringPtr(), Json());
+  else
+    value = m_node->value.get(jkey->toUInt(), Json());
+
+  if (value.isType(Json::Type::Array) || value.isType(Json::Type::Object))
+    return engine.createUserData(LuaJsonProxy(make_shared<Node>(Node{std::move(value), m_node, jkey.take(), m_node->owned})));
+  return engine.luaFrom<Json>(value);
+}
+
+void LuaJsonProxy::set(LuaEngine& engine, LuaValue const& key, LuaValue const& value) {
+  auto jkey = jsonKey(key);
+  if (!jkey)
+    throw LuaException::format("Invalid key for assignment to Json {} proxy", m_node->value.typeName());
+
+  auto jvalue = engine.luaMaybeTo<Json>(value);
+  if (!jvalue)
+    throw LuaException("Cannot assign a value that is not convertible to Json to a Json proxy");
+
+  if (jkey->isType(Json::Type::String)) {
+    ownContainer(m_node);
+    ownedObject(*m_node)->set(*jkey->stringPtr(), jvalue.take());
+  } else {
+    size_t index = jkey->toUInt();
+    size_t size = m_node->value.size();
+    if (index > size + MaxArrayGap)
+      throw LuaException::format("Index {} is too far past the end of Json array proxy of size {}", index + 1, size);
+    ownContainer(m_node);
+    auto array = ownedArray(*m_node);
+    if (index >= array->size())
+      array->resize(index + 1);
+    (*array)[index] = jvalue.take();
+  }
+}
+
+size_t LuaJsonProxy::length() const {
+  if (m_node->value.isType(Json::Type::Array))
+    return m_node->value.size();
+  return 0;
+}
+
+LuaFunction LuaJsonProxy::iterator(LuaEngine& engine) const {
+  // Iterates over a snapshot of the container, skipping null entries, which
+  // converted tables do not contain either.
+  share();
+  Json container = m_node->value;
+  if (container.isType(Json::Type::Array)) {
+    auto array = container.arrayPtr();
+    auto index = make_shared<size_t>(0);
+    return engine.createFunction([self = *this, array, index](LuaEngine& engine) -> LuaVariadic<LuaValue> {
+        while (*index < array->size()) {
+          size_t i = (*index)++;
+          if (!array->at(i).isNull())
+            return {LuaInt(i + 1), self.get(engine, LuaInt(i + 1))};
+        }
+        return {};
+      });
+  } else {
+    auto object = container.objectPtr();
+    auto it = make_shared<JsonObject::const_iterator>(object->begin());
+    return engine.createFunction([self = *this, object, it](LuaEngine& engine) -> LuaVariadic<LuaValue> {
+        while (*it != object->end()) {
+          auto const& entry = *(*it)++;
+          if (!entry.second.isNull()) {
+            auto key = engine.createString(entry.first);
+            return {key, self.get(engine, key)};
+          }
+        }
+        return {};
+      });
+  }
+}
+
+Maybe<Json> LuaJsonProxy::jsonKey(LuaValue const& key) const {
+  if (m_node->value.isType(Json::Type::Array)) {
+    if (auto i = LuaDetail::asInteger(key)) {
+      if (*i >= 1)
+        return Json(*i - 1);
+    }
+  } else if (auto s = key.ptr<LuaString>()) {
+    return Json(s->toString());
+  }
+  return {};
+}
+
+void LuaJsonProxy::share() const {
+  m_node->owned->objects.clear();
+  m_node->owned->arrays.clear();
+}
+
+shared_ptr<JsonObject> LuaJsonProxy::ownedObject(Node const& node) {
+  // An entry keeps the memory of its container from being reused even once
+  // the container is dropped, so a live container at the same address is
+  // always the owned one.
+  if (auto p = node.owned->objects.ptr(node.value.objectPtr().get()))
+    return p->lock();
+  return {};
+}
+
+shared_ptr<JsonArray> LuaJsonProxy::ownedArray(Node const& node) {
+  if (auto p = node.owned->arrays.ptr(node.value.arrayPtr().get()))
+    return p->lock();
+  return {};
+}
+
+void LuaJsonProxy::ownContainer(shared_ptr<Node> const& node) {
+  auto& owned = *node->owned;
+  Json source = node->value;
+  if (source.isType(Json::Type::Object)) {
+    if (ownedObject(*node))
+      return;
+    auto object = make_shared<JsonObject>(*source.objectPtr());
+    owned.objects[object.get()] = object;
+    node->value = JsonObjectConstPtr(std::move(object));
+  } else {
+    if (ownedArray(*node))
+      return;
+    auto array = make_shared<JsonArray>(*source.arrayPtr());
+    owned.arrays[array.get()] = array;
+    node->value = JsonArrayConstPtr(std::move(array));
+  }
+
+  if (owned.objects.size() + owned.arrays.size() > owned.sweepSize) {
+    auto expired = [](auto const& p) { return p.second.expired(); };
+    eraseWhere(owned.objects, expired);
+    eraseWhere(owned.arrays, expired);
+    owned.sweepSize = max<size_t>(owned.sweepSize, (owned.objects.size() + owned.arrays.size()) * 2);
+  }
+
+  auto parent = node->parent;
+  if (!parent)
+    return;
+
+  // Put the copy in the parent so that writes to it are seen there, unless the
+  // parent has since replaced this entry itself.
+  Json current = node->key.isType(Json::Type::String)
+    ? parent->value.get(*node->key.stringPtr(), Json())
+    : parent->value.get(node->key.toUInt(), Json());
+  bool sameContainer = source.isType(Json::Type::Object)
+    ? current.isType(Json::Type::Object) && current.objectPtr() == source.objectPtr()
+    : current.isType(Json::Type::Array) && current.arrayPtr() == source.arrayPtr();
+  if (!sameContainer) {
+    node->parent.reset();
+    return;
+  }
+
+  ownContainer(parent);
+  if (node->key.isType(Json::Type::String))
+    ownedObject(*parent)->set(*node->key.stringPtr(), node->value);
+  else
+    (*ownedArray(*parent))[node->key.toUInt()] = node->value;
+}
+
+LuaValue LuaConverter<LuaJsonProxy>::from(LuaEngine& engine, LuaJsonProxy const& v) {
+  if (v.isContainer())
+    return engine.createUserData(v);
+  return engine.luaFrom<Json>(v.json());
+}
+
+Maybe<LuaJsonProxy> LuaConverter<LuaJsonProxy>::to(LuaEngine& engine, LuaValue const& v) {
+  if (auto ud = v.ptr<LuaUserData>()) {
+    if (ud->is<LuaJsonProxy>())
+      return ud->get<LuaJsonProxy>();
+  }
+  if (auto json = engine.luaMaybeTo<Json>(v))
+    return LuaJsonProxy(json.take());
+  return {};
+}
+
+LuaMethods<LuaJsonProxy> LuaUserDataMethods<LuaJsonProxy>::make() {
+  LuaMethods<LuaJsonProxy> methods;
+  methods.registerMethod("__index", [](LuaJsonProxy& proxy, LuaEngine& engine, LuaValue const& key) {
+      return proxy.get(engine, key);
+    });
+  methods.registerMethod("__newindex", [](LuaJsonProxy& proxy, LuaEngine& engine, LuaValue const& key, LuaValue const& value) {
+      proxy.set(engine, key, value);
+    });
+  methods.registerMethod("__len", [](LuaJsonProxy& proxy) {
+      return proxy.length();
+    });
+  methods.registerMethod("__pairs", [](LuaJsonProxy& proxy, LuaEngine& engine) {
+      return proxy.iterator(engine);
+    });
+  methods.registerMethod("__tostring", [](LuaJsonProxy& proxy) {
+      return proxy.json().repr();
+    });
+  return methods;
+}
+
 LuaEnginePtr LuaEngine::create(bool safe) {
   LuaEnginePtr self(new LuaEngine);
 
-  self->m_state = lua_newstate(allocate, nullptr);
+  self->m_state = lua_newstate(allocate, self.get());
 
   self->m_scriptDefaultEnvRegistryId = LUA_NOREF;
   self->m_wrappedFunctionMetatableRegistryId = LUA_NOREF;
@@ -217,6 +478,9 @@ LuaEnginePtr LuaEngine::create(bool safe) {
 
   self->m_instructionLimit = 0;
   self->m_profilingEnabled = false;
+  self->m_accountingEnabled = false;
+  self->m_accountingStackSampleInterval = 0;
+  self->m_accountingHookCount = 0;
   self->m_instructionMeasureInterval = 1000;
   self->m_instructionCount = 0;
   self->m_recursionLevel = 0;
@@ -429,6 +693,38 @@ List<LuaProfileEntry> LuaEngine::getProfile() {
   return profileEntries;
 }
 
+void LuaEngine::setAccountingEnabled(bool accountingEnabled, unsigned stackSampleInterval) {
+  m_accountingStackSampleInterval = stackSampleInterval;
+  if (accountingEnabled != m_accountingEnabled) {
+    m_accountingEnabled = accountingEnabled;
+    m_accountingEntries.clear();
+    updateCountHook();
+  }
+}
+
+bool LuaEngine::accountingEnabled() const {
+  return m_accountingEnabled;
+}
+
+LuaAccountingScope LuaEngine::accountingScope(String const& label) {
+  return LuaAccountingScope(*this, label);
+}
+
+LuaAccountingAttribution LuaEngine::accountingAttribution(shared_ptr<String const> label) {
+  return LuaAccountingAttribution(*this, std::move(label));
+}
+
+StringMap<LuaAccountingEntry> LuaEngine::accounting() const {
+  StringMap<LuaAccountingEntry> accounting;
+  for (auto const& p : m_accountingEntries)
+    accounting.add(p.first, *p.second);
+  return accounting;
+}
+
+void LuaEngine::resetAccounting() {
+  m_accountingEntries.clear();
+}
+
 void LuaEngine::setInstructionMeasureInterval(unsigned measureInterval) {
   if (measureInterval != m_instructionMeasureInterval) {
     m_instructionMeasureInterval = measureInterval;
@@ -628,6 +924,15 @@ void LuaEngine::countHook(lua_State* state, lua_Debug* ar) {
     lua_error(state);
   }
 
+  if (!self->m_accountingFrames.empty()) {
+    auto const& entry = self->m_accountingFrames.last().entry;
+    entry->instructions += self->m_instructionMeasureInterval;
+    if (self->m_accountingStackSampleInterval != 0 && ++self->m_accountingHookCount >= self->m_accountingStackSampleInterval) {
+      self->m_accountingHookCount = 0;
+      self->sampleAccountingStack(state, ar, entry.get());
+    }
+  }
+
   if (self->m_profilingEnabled) {
     // find bottom of the stack
     // ar will contain the stack info from the last call that returns 1
@@ -673,7 +978,17 @@ void LuaEngine::countHook(lua_State* state, lua_Debug* ar) {
   }
 }
 
-void* LuaEngine::allocate(void*, void* ptr, size_t oldSize, size_t newSize) {
+void* LuaEngine::allocate(void* userdata, void* ptr, size_t oldSize, size_t newSize) {
+  auto self = (LuaEngine*)userdata;
+  if (!self->m_accountingFrames.empty()) {
+    // When ptr is null, oldSize holds the type of the object being allocated
+    // rather than a size.
+    if (!ptr)
+      self->m_accountingFrames.last().entry->allocatedBytes += newSize;
+    else if (newSize > oldSize)
+      self->m_accountingFrames.last().entry->allocatedBytes += newSize - oldSize;
+  }
+
   if (newSize == 0) {
     Star::free(ptr, oldSize);
     return nullptr;
@@ -1044,6 +1359,41 @@ LuaValue LuaEngine::contextGetPath(int handleIndex, String path) {
   return popLuaValue(m_state);
 }
 
+bool LuaEngine::contextPathIs(int handleIndex, String const& path, LuaValue const& value) {
+  lua_checkstack(m_state, 3);
+  pushHandle(m_state, handleIndex);
+
+  std::string const& utf8Path = path.utf8();
+  size_t subPathStart = 0;
+  while (true) {
+    size_t dot = utf8Path.find('.', subPathStart);
+    if (dot == NPos) {
+      // The common case of a plain global name needs no copy of the path.
+      if (subPathStart == 0)
+        lua_getfield(m_state, -1, utf8Path.c_str());
+      else
+        lua_getfield(m_state, -1, utf8Path.substr(subPathStart).c_str());
+      lua_remove(m_state, -2);
+      break;
+    }
+
+    lua_getfield(m_state, -1, utf8Path.substr(subPathStart, dot - subPathStart).c_str());
+    lua_remove(m_state, -2);
+
+    if (lua_type(m_state, -1) != LUA_TTABLE) {
+      lua_pop(m_state, 1);
+      return value == LuaNil;
+    }
+
+    subPathStart = dot + 1;
+  }
+
+  pushLuaValue(m_state, value);
+  bool equal = lua_rawequal(m_state, -1, -2);
+  lua_pop(m_state, 2);
+  return equal;
+}
+
 void LuaEngine::contextSetPath(int handleIndex, String path, LuaValue const& value) {
   lua_checkstack(m_state, 3);
   pushHandle(m_state, handleIndex);
@@ -1301,12 +1651,40 @@ void LuaEngine::decrementRecursionLevel() {
 }
 
 void LuaEngine::updateCountHook() {
-  if (m_instructionLimit || m_profilingEnabled)
+  if (m_instructionLimit || m_profilingEnabled || m_accountingEnabled)
     lua_sethook(m_state, &LuaEngine::countHook, LUA_MASKCOUNT, m_instructionMeasureInterval);
   else
     lua_sethook(m_state, &LuaEngine::countHook, 0, 0);
 }
 
+void LuaEngine::pushAccountingScope(String const& label) {
+  auto& entry = m_accountingEntries[label];
+  if (!entry)
+    entry = make_shared<LuaAccountingEntry>();
+  ++entry->calls;
+  m_accountingFrames.append(AccountingFrame{entry, Time::monotonicTicks(), 0});
+}
+
+void LuaEngine::popAccountingScope() {
+  starAssert(!m_accountingFrames.empty());
+  auto frame = m_accountingFrames.takeLast();
+  int64_t elapsed = Time::monotonicTicks() - frame.startTicks;
+  frame.entry->time += Time::ticksToSeconds(elapsed - frame.childTicks, Time::monotonicTickFrequency());
+  if (!m_accountingFrames.empty())
+    m_accountingFrames.last().childTicks += elapsed;
+}
+
+void LuaEngine::sampleAccountingStack(lua_State* state, lua_Debug* ar, LuaAccountingEntry* entry) {
+  StringList frames;
+  for (int level = 0; lua_getstack(state, level, ar) == 1; ++level) {
+    if (lua_getinfo(state, "nS", ar) == 0)
+      break;
+    frames.append(String(strf("{}@{}:{}", ar->name ? ar->name : "?", ar->short_src, ar->linedefined)).replace(";", ":"));
+  }
+  frames.reverse();
+  ++entry->stackSamples[frames.join(";")];
+}
+
 int LuaEngine::s_luaInstructionLimitExceptionKey = 0;
 int LuaEngine::s_luaRecursionLimitExceptionKey = 0;
 
@@ -323,6 +323,10 @@ public:
   T getPath(String path) const;
   // Shorthand for getPath != LuaNil
   bool containsPath(String path) const;
+  // Returns true if the value at the given path is raw equal to the given
+  // value, without copying the path or creating a new reference to the value
+  // at the path.
+  bool pathIs(String const& path, LuaValue const& value) const;
   // Will create new tables if the key contains paths that are nil
   template <typename T>
   void setPath(String path, T value);
@@ -423,6 +427,37 @@ private:
   LuaEngine* m_engine;
 };
 
+// Attributes Lua CPU time, instructions and allocations to the given label as
+// long as the scope object is alive.  Scopes may nest, time is only counted
+// towards the innermost scope.
+class LuaAccountingScope {
+public:
+  LuaAccountingScope(LuaEngine& engine, String const& label);
+  // Attributes to the engine's current LuaAccountingAttribution label, does
+  // nothing if there is none.
+  explicit LuaAccountingScope(LuaEngine& engine);
+  LuaAccountingScope(LuaAccountingScope const&) = delete;
+  LuaAccountingScope(LuaAccountingScope&&);
+  ~LuaAccountingScope();
+private:
+  LuaEngine* m_engine;
+};
+
+// Names the label that label-less LuaAccountingScopes attribute to as long as
+// the attribution object is alive.  It does no accounting itself, so work done
+// outside of those scopes (such as C++ entity updates around script calls) is
+// not counted.
+class LuaAccountingAttribution {
+public:
+  LuaAccountingAttribution(LuaEngine& engine, shared_ptr<String const> label);
+  LuaAccountingAttribution(LuaAccountingAttribution const&) = delete;
+  LuaAccountingAttribution(LuaAccountingAttribution&&);
+  ~LuaAccountingAttribution();
+private:
+  LuaEngine* m_engine;
+  shared_ptr<String const> m_previous;
+};
+
 // Types that want to participate in automatic lua conversion should specialize
 // this template and provide static to and from methods on it.  The method
 // signatures will be called like:
@@ -465,6 +500,21 @@ struct LuaProfileEntry {
   HashMap<tuple<String, unsigned>, shared_ptr<LuaProfileEntry>> calls;
 };
 
+struct LuaAccountingEntry {
+  // Number of times the accounting scope was entered
+  uint64_t calls = 0;
+  // Wall clock time spent in the scope, excluding nested scopes, in seconds
+  double time = 0.0;
+  // Instructions executed in the scope, at the granularity of the
+  // instruction measure interval
+  uint64_t instructions = 0;
+  // Bytes requested from the allocator while in the scope
+  uint64_t allocatedBytes = 0;
+  // Sampled call stacks, outermost frame first and separated by ';', the
+  // format expected by flamegraph tooling
+  StringMap<uint64_t> stackSamples;
+};
+
 // This class represents one execution engine in lua, holding a single
 // lua_State.  Multiple contexts can be created, and they will have separate
 // global environments and cannot affect each other.  Individual LuaEngines /
@@ -609,6 +659,24 @@ public:
   // Bytes in use by lua
   size_t memoryUsage() const;
 
+  // Sampling based accounting of where Lua time and memory goes, grouped by
+  // labels given through accountingScope.  Every stackSampleInterval
+  // instruction measure intervals the current Lua stack is sampled for
+  // collapsed stack output.  Disabling accounting clears collected entries.
+  void setAccountingEnabled(bool accountingEnabled, unsigned stackSampleInterval = 10);
+  bool accountingEnabled() const;
+
+  // Starts attributing to the given label, does nothing if accounting is
+  // disabled.
+  LuaAccountingScope accountingScope(String const& label);
+  // Attributes the scripts that open a LuaAccountingScope without a label to
+  // the given label while the returned object is alive, does nothing if
+  // accounting is disabled.
+  LuaAccountingAttribution accountingAttribution(shared_ptr<String const> label);
+
+  StringMap<LuaAccountingEntry> accounting() const;
+  void resetAccounting();
+
   // Enforce null-terminated string conversion as long as the returned enforcer object is in scope.
   LuaNullEnforcer nullTerminate();
   // Disables null-termination enforcement
@@ -624,13 +692,22 @@ private:
   friend class LuaUserData;
   friend class LuaContext;
   friend class LuaNullEnforcer;
+  friend class LuaAccountingScope;
+  friend class LuaAccountingAttribution;
+
+  struct AccountingFrame {
+    shared_ptr<LuaAccountingEntry> entry;
+    int64_t startTicks;
+    int64_t childTicks;
+  };
 
   LuaEngine() = default;
 
   // Get the LuaEngine* out of the lua registry magic entry.  Uses 1 stack
   // space, and does not call lua_checkstack.
   static LuaEngine* luaEnginePtr(lua_State* state);
-  // Counts instructions when instruction limiting is enabled.
+  // Counts instructions when instruction limiting, profiling or accounting is
+  // enabled.
   static void countHook(lua_State* state, lua_Debug* ar);
 
   static void* allocate(void* userdata, void* ptr, size_t oldSize, size_t newSize);
@@ -689,6 +766,7 @@ private:
   LuaDetail::LuaFunctionReturn contextEval(int handleIndex, String const& lua);
 
   LuaValue contextGetPath(int handleIndex, String path);
+  bool contextPathIs(int handleIndex, String const& path, LuaValue const& value);
   void contextSetPath(int handleIndex, String path, LuaValue const& value);
 
   int popHandle(lua_State* state);
@@ -719,6 +797,10 @@ private:
 
   void updateCountHook();
 
+  void pushAccountingScope(String const& label);
+  void popAccountingScope();
+  void sampleAccountingStack(lua_State* state, lua_Debug* ar, LuaAccountingEntry* entry);
+
   // The following fields exist to use their addresses as unique lightuserdata,
   // as is recommended by the lua docs.
   static int s_luaInstructionLimitExceptionKey;
@@ -744,6 +826,12 @@ private:
   unsigned m_recursionLimit;
   int m_nullTerminated;
   HashMap<tuple<String, unsigned>, shared_ptr<LuaProfileEntry>> m_profileEntries;
+  bool m_accountingEnabled;
+  unsigned m_accountingStackSampleInterval;
+  unsigned m_accountingHookCount;
+  StringMap<shared_ptr<LuaAccountingEntry>> m_accountingEntries;
+  List<AccountingFrame> m_accountingFrames;
+  shared_ptr<String const> m_accountingAttribution;
   lua_Debug m_debugInfo;
 };
 
@@ -1097,6 +1185,89 @@ struct LuaConverter<JsonArray> {
   static Maybe<JsonArray> to(LuaEngine& engine, LuaValue v);
 };
 
+// Passes a Json array or object to Lua as a userdata that shares the Json
+// data, rather than deeply converting it into tables.  Indexing converts only
+// the requested entry, and nested containers are returned as further proxies.
+// '#', pairs and ipairs behave as they do on converted tables.  The first
+// assignment to a container copies it, and further assignments change that
+// copy in place, until the Json is next converted back or iterated over.
+// Writes through a nested proxy are seen by the proxy it was read from.
+// Proxies convert back to Json without copying.  Proxies are not tables to
+// type() or the table library, so callbacks opt in by returning LuaJsonProxy
+// instead of Json.
+class LuaJsonProxy {
+public:
+  // Returns the given value as-is if it is not an array or object, otherwise
+  // as a proxy.
+  static LuaValue from(LuaEngine& engine, Json const& value);
+
+  // How far past the end of an array a script may assign, leaving null
+  // entries in between.  Assigning further out is an error, so that a script
+  // cannot allocate an arbitrarily large array with a single assignment.
+  static size_t const MaxArrayGap = 1024;
+
+  explicit LuaJsonProxy(Json value = JsonObject());
+
+  // Is the proxied value an array or an object, rather than a value that Lua
+  // holds directly?
+  bool isContainer() const;
+
+  Json const& json() const;
+
+  LuaValue get(LuaEngine& engine, LuaValue const& key) const;
+  void set(LuaEngine& engine, LuaValue const& key, LuaValue const& value);
+  size_t length() const;
+  LuaFunction iterator(LuaEngine& engine) const;
+
+private:
+  // Containers copied by the proxies of one Json value on assignment.  Only
+  // those proxies hold them, so they are written to in place, until the value
+  // is shared outside of the proxies again and they are all forgotten.
+  struct OwnedContainers {
+    HashMap<JsonObject const*, weak_ptr<JsonObject>> objects;
+    HashMap<JsonArray const*, weak_ptr<JsonArray>> arrays;
+    // Containers that have since been dropped are forgotten once there are
+    // this many.
+    size_t sweepSize;
+  };
+
+  struct Node {
+    Json value;
+    // The proxy this one was read from, and the key it was read at.  Cleared
+    // once the parent no longer holds this container at that key.
+    shared_ptr<Node> parent;
+    Json key;
+    shared_ptr<OwnedContainers> owned;
+  };
+
+  LuaJsonProxy(shared_ptr<Node> node);
+
+  Maybe<Json> jsonKey(LuaValue const& key) const;
+
+  // Forgets every owned container, as the value is about to be shared.
+  void share() const;
+
+  // The container of the node, if it is one it owns.
+  static shared_ptr<JsonObject> ownedObject(Node const& node);
+  static shared_ptr<JsonArray> ownedArray(Node const& node);
+  // Copies the container of the node unless it already owns it, and puts the
+  // copy in its parent in place of the container it was read from.
+  static void ownContainer(shared_ptr<Node> const& node);
+
+  shared_ptr<Node> m_node;
+};
+
+template <>
+struct LuaConverter<LuaJsonProxy> {
+  static LuaValue from(LuaEngine& engine, LuaJsonProxy const& v);
+  static Maybe<LuaJsonProxy> to(LuaEngine& engine, LuaValue const& v);
+};
+
+template <>
+struct LuaUserDataMethods<LuaJsonProxy> {
+  static LuaMethods<LuaJsonProxy> make();
+};
+
 namespace LuaDetail {
   inline LuaHandle::LuaHandle(LuaEnginePtr engine, int handleIndex)
     : engine(std::move(engine)), handleIndex(handleIndex) {}
@@ -0,0 +1,218 @@
+#include "StarMetrics.hpp"
+#include "StarFile.hpp"
+#include "StarMathCommon.hpp"
+
+namespace Star {
+
+EnumMap<MetricType> const MetricTypeNames{
+  {MetricType::Counter, "counter"},
+  {MetricType::Gauge, "gauge"},
+  {MetricType::Histogram, "histogram"}
+};
+
+void MetricsDetail::atomicAdd(atomic<double>& target, double amount) {
+  double current = target.load(std::memory_order_relaxed);
+  while (!target.compare_exchange_weak(current, current + amount, std::memory_order_relaxed))
+    ;
+}
+
+void MetricHistogram::observe(double value) {
+  if (!m_data)
+    return;
+
+  auto const& bounds = m_data->bucketBounds;
+  size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+  m_data->bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+  m_data->count.fetch_add(1, std::memory_order_relaxed);
+  MetricsDetail::atomicAdd(m_data->value, value);
+}
+
+double MetricSnapshot::quantile(double q) const {
+  if (count == 0 || buckets.empty())
+    return 0.0;
+
+  double rank = clamp(q, 0.0, 1.0) * count;
+  double lowerBound = 0.0;
+  uint64_t lowerCount = 0;
+  for (auto const& bucket : buckets) {
+    if ((double)bucket.second >= rank) {
+      // Nothing sensible to interpolate towards in the +Inf bucket.
+      if (std::isinf(bucket.first))
+        return lowerBound;
+      uint64_t inBucket = bucket.second - lowerCount;
+      if (inBucket == 0)
+        return bucket.first;
+      return lowerBound + (bucket.first - lowerBound) * (rank - lowerCount) / inBucket;
+    }
+    lowerBound = bucket.first;
+    lowerCount = bucket.second;
+  }
+  return lowerBound;
+}
+
+MetricCounter Metrics::counter(String const& name, String const& help, MetricLabels const& labels) {
+  MetricCounter counter;
+  counter.m_data = registerMetric(name, help, MetricType::Counter, labels);
+  return counter;
+}
+
+MetricGauge Metrics::gauge(String const& name, String const& help, MetricLabels const& labels) {
+  MetricGauge gauge;
+  gauge.m_data = registerMetric(name, help, MetricType::Gauge, labels);
+  return gauge;
+}
+
+MetricHistogram Metrics::histogram(String const& name, String const& help, List<double> const& buckets, MetricLabels const& labels) {
+  for (size_t i = 1; i < buckets.size(); ++i) {
+    if (buckets[i] <= buckets[i - 1])
+      throw MetricsException::format("Histogram '{}' bucket bounds are not in ascending order", name);
+  }
+
+  RecursiveMutexLocker locker(s_mutex);
+  auto data = registerMetric(name, help, MetricType::Histogram, labels);
+  if (!data->bucketCounts) {
+    data->bucketBounds = buckets;
+    data->bucketCounts.reset(new atomic<uint64_t>[buckets.size() + 1]);
+    for (size_t i = 0; i < buckets.size() + 1; ++i)
+      data->bucketCounts[i] = 0;
+  } else if (data->bucketBounds != buckets) {
+    throw MetricsException::format("Histogram '{}' registered again with different buckets", name);
+  }
+
+  MetricHistogram histogram;
+  histogram.m_data = std::move(data);
+  return histogram;
+}
+
+List<double> Metrics::exponentialBuckets(double start, double factor, size_t count) {
+  List<double> buckets;
+  buckets.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    buckets.append(start);
+    start *= factor;
+  }
+  return buckets;
+}
+
+List<MetricSnapshot> Metrics::snapshot() {
+  List<MetricSnapshot> snapshot;
+
+  RecursiveMutexLocker locker(s_mutex);
+  eraseWhere(s_metrics, [&](auto const& p) {
+      auto data = p.second.lock();
+      if (!data)
+        return true;
+
+      MetricSnapshot& metric = snapshot.emplaceAppend();
+      metric.name = data->name;
+      metric.help = data->help;
+      metric.type = data->type;
+      metric.labels = data->labels;
+      if (data->type == MetricType::Counter) {
+        metric.value = data->count.load(std::memory_order_relaxed);
+        metric.count = 0;
+      } else {
+        metric.value = data->value.load(std::memory_order_relaxed);
+        metric.count = data->count.load(std::memory_order_relaxed);
+      }
+
+      if (data->bucketCounts) {
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < data->bucketBounds.size(); ++i) {
+          cumulative += data->bucketCounts[i].load(std::memory_order_relaxed);
+          metric.buckets.append({data->bucketBounds[i], cumulative});
+        }
+        cumulative += data->bucketCounts[data->bucketBounds.size()].load(std::memory_order_relaxed);
+        metric.buckets.append({std::numeric_limits<double>::infinity(), cumulative});
+        // Observations may land between reading the buckets and the count,
+        // keep the dump self consistent.
+        metric.count = cumulative;
+      }
+      return false;
+    });
+
+  return snapshot;
+}
+
+static String prometheusNumber(double value) {
+  if (std::isnan(value))
+    return "NaN";
+  if (std::isinf(value))
+    return value > 0 ? "+Inf" : "-Inf";
+  return String(strf("{}", value));
+}
+
+static String prometheusLabels(MetricLabels const& labels, Maybe<String> const& le = {}) {
+  if (labels.empty() && !le)
+    return "";
+
+  StringList pairs;
+  for (auto const& p : labels) {
+    String value = p.second.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+    pairs.append(strf("{}=\"{}\"", p.first, value));
+  }
+  if (le)
+    pairs.append(strf("le=\"{}\"", *le));
+  return strf("{{{}}}", pairs.join(","));
+}
+
+String Metrics::prometheusText() {
+  String text;
+  String lastName;
+  for (auto const& metric : snapshot()) {
+    if (metric.name != lastName) {
+      if (!metric.help.empty())
+        text += strf("# HELP {} {}\n", metric.name, metric.help.replace("\\", "\\\\").replace("\n", "\\n"));
+      text += strf("# TYPE {} {}\n", metric.name, MetricTypeNames.getRight(metric.type));
+      lastName = metric.name;
+    }
+
+    if (metric.type == MetricType::Histogram) {
+      for (auto const& bucket : metric.buckets)
+        text += strf("{}_bucket{} {}\n", metric.name, prometheusLabels(metric.labels, prometheusNumber(bucket.first)), bucket.second);
+      text += strf("{}_sum{} {}\n", metric.name, prometheusLabels(metric.labels), prometheusNumber(metric.value));
+      text += strf("{}_count{} {}\n", metric.name, prometheusLabels(metric.labels), metric.count);
+    } else {
+      text += strf("{}{} {}\n", metric.name, prometheusLabels(metric.labels), prometheusNumber(metric.value));
+    }
+  }
+  return text;
+}
+
+void Metrics::writePrometheusFile(String const& path) {
+  File::overwriteFileWithRename(prometheusText(), path);
+}
+
+shared_ptr<MetricsDetail::MetricData> Metrics::registerMetric(String const& name, String const& help, MetricType type, MetricLabels const& labels) {
+  RecursiveMutexLocker locker(s_mutex);
+  auto key = make_pair(name, labels);
+  if (auto existing = s_metrics.value(key).lock()) {
+    if (existing->type != type)
+      throw MetricsException::format("Metric '{}' registered again as a {}, was a {}", name, MetricTypeNames.getRight(type), MetricTypeNames.getRight(existing->type));
+    return existing;
+  }
+
+  // All metrics sharing a name must also share a type to be exported
+  // correctly.
+  for (auto i = s_metrics.lower_bound(make_pair(name, MetricLabels())); i != s_metrics.end() && i->first.first == name; ++i) {
+    if (auto other = i->second.lock()) {
+      if (other->type != type)
+        throw MetricsException::format("Metric '{}' registered as a {}, was a {}", name, MetricTypeNames.getRight(type), MetricTypeNames.getRight(other->type));
+    }
+  }
+
+  auto data = make_shared<MetricsDetail::MetricData>();
+  data->name = name;
+  data->help = help;
+  data->type = type;
+  data->labels = labels;
+  data->count = 0;
+  data->value = 0.0;
+  s_metrics[key] = data;
+  return data;
+}
+
+RecursiveMutex Metrics::s_mutex;
+Map<pair<String, MetricLabels>, weak_ptr<MetricsDetail::MetricData>> Metrics::s_metrics;
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "StarThread.hpp"
+#include "StarMap.hpp"
+#include "StarString.hpp"
+#include "StarBiMap.hpp"
+
+namespace Star {
+
+STAR_EXCEPTION(MetricsException, StarException);
+
+enum class MetricType {
+  Counter,
+  Gauge,
+  Histogram
+};
+extern EnumMap<MetricType> const MetricTypeNames;
+
+typedef Map<String, String> MetricLabels;
+
+namespace MetricsDetail {
+  struct MetricData {
+    String name;
+    String help;
+    MetricType type;
+    MetricLabels labels;
+
+    // Counter value, or histogram observation count
+    atomic<uint64_t> count;
+    // Gauge value, or histogram sum
+    atomic<double> value;
+
+    // Histogram bucket upper bounds, with an implicit final +Inf bucket, and
+    // the non-cumulative observation count of each bucket.
+    List<double> bucketBounds;
+    unique_ptr<atomic<uint64_t>[]> bucketCounts;
+  };
+
+  void atomicAdd(atomic<double>& target, double amount);
+}
+
+// Handles to registered metrics.  Handles are cheap to copy and all updates
+// are lock-free, so they are safe to use from any thread every tick.  Default
+// constructed handles are not registered, and updating them does nothing.
+
+class MetricCounter {
+public:
+  MetricCounter() = default;
+
+  void increment(uint64_t amount = 1);
+  uint64_t value() const;
+
+private:
+  friend class Metrics;
+  shared_ptr<MetricsDetail::MetricData> m_data;
+};
+
+class MetricGauge {
+public:
+  MetricGauge() = default;
+
+  void set(double value);
+  void add(double amount);
+  double value() const;
+
+private:
+  friend class Metrics;
+  shared_ptr<MetricsDetail::MetricData> m_data;
+};
+
+class MetricHistogram {
+public:
+  MetricHistogram() = default;
+
+  void observe(double value);
+
+private:
+  friend class Metrics;
+  shared_ptr<MetricsDetail::MetricData> m_data;
+};
+
+struct MetricSnapshot {
+  String name;
+  String help;
+  MetricType type;
+  MetricLabels labels;
+
+  // Counter or gauge value, or the sum of all histogram observations
+  double value;
+  // Number of histogram observations
+  uint64_t count;
+  // Cumulative histogram counts for each bucket upper bound, the last bound
+  // is always +Inf.
+  List<pair<double, uint64_t>> buckets;
+
+  // Estimates the given quantile of a histogram by interpolating within the
+  // bucket it falls in.
+  double quantile(double q) const;
+};
+
+// Process wide registry of typed metrics, meant to replace LogMap for values
+// that are updated every tick.  Metrics are registered once and stay listed
+// for as long as any handle to them is alive.  Registering the same name and
+// labels again returns a handle to the same metric.
+class Metrics {
+public:
+  static MetricCounter counter(String const& name, String const& help, MetricLabels const& labels = {});
+  static MetricGauge gauge(String const& name, String const& help, MetricLabels const& labels = {});
+  // Bucket bounds are the upper bound of each bucket in ascending order, a
+  // final +Inf bucket is always added.
+  static MetricHistogram histogram(String const& name, String const& help, List<double> const& buckets, MetricLabels const& labels = {});
+
+  // count bucket bounds starting at start, each factor times larger than the
+  // last
+  static List<double> exponentialBuckets(double start, double factor, size_t count);
+
+  // Snapshot of every live metric, sorted by name and labels
+  static List<MetricSnapshot> snapshot();
+
+  // Dumps every live metric in the Prometheus text exposition format
+  static String prometheusText();
+  // Atomically replaces the given file with the Prometheus text dump
+  static void writePrometheusFile(String const& path);
+
+private:
+  static shared_ptr<MetricsDetail::MetricData> registerMetric(String const& name, String const& help, MetricType type, MetricLabels const& labels);
+
+  static RecursiveMutex s_mutex;
+  static Map<pair<String, MetricLabels>, weak_ptr<MetricsDetail::MetricData>> s_metrics;
+};
+
+inline void MetricCounter::increment(uint64_t amount) {
+  if (m_data)
+    m_data->count.fetch_add(amount, std::memory_order_relaxed);
+}
+
+inline uint64_t MetricCounter::value() const {
+  return m_data ? m_data->count.load(std::memory_order_relaxed) : 0;
+}
+
+inline void MetricGauge::set(double value) {
+  if (m_data)
+    m_data->value.store(value, std::memory_order_relaxed);
+}
+
+inline void MetricGauge::add(double amount) {
+  if (m_data)
+    MetricsDetail::atomicAdd(m_data->value, amount);
+}
+
+inline double MetricGauge::value() const {
+  return m_data ? m_data->value.load(std::memory_order_relaxed) : 0.0;
+}
+
+}
@@ -0,0 +1,419 @@
+#pragma once
+
+#include "StarRect.hpp"
+#include "StarMap.hpp"
+#include "StarBlockAllocator.hpp"
+
+namespace Star {
+
+// Variant of SpatialHash2D for a space whose size is known up front.  Sectors
+// are cells of a dense grid, each one a flat list of the entries overlapping
+// it, so finding the entries in a sector needs no hashing.  Rects outside of
+// the grid are stored in the nearest edge cells.
+//
+// Queries do not need to sort their results to remove duplicates, an entry
+// found in several cells is only reported from the first one scanned that it
+// overlaps.  Moving an entry without changing the sectors it covers does not
+// touch the grid at all.
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT = int, size_t AllocatorBlockSize = 4096>
+class SpatialGrid2D {
+public:
+  typedef KeyT Key;
+  typedef ScalarT Scalar;
+  typedef Box<ScalarT, 2> Rect;
+  typedef typename Rect::Coord Coord;
+  typedef ValueT Value;
+  typedef Vector<IntT, 2> Sector;
+  typedef Box<IntT, 2> SectorRange;
+
+  struct Entry {
+    Entry();
+
+    SmallList<Rect, 2> rects;
+    // The range of cells each rect is stored in
+    SmallList<SectorRange, 2> sectors;
+    Value value;
+  };
+
+  typedef StableHashMap<Key, Entry, hash<Key>, std::equal_to<Key>, BlockAllocator<pair<Key const, Entry>, AllocatorBlockSize>> EntryMap;
+
+  // The grid covers the area from the origin to the given size
+  SpatialGrid2D(Scalar const& sectorSize, Coord const& size);
+
+  List<Key> keys() const;
+  List<Value> values() const;
+  EntryMap const& entries() const;
+
+  size_t size() const;
+
+  bool contains(Key const& key) const;
+
+  Value const& get(Key const& key) const;
+  Value& get(Key const& key);
+
+  // Returns default constructed value if key not found
+  Value value(Key const& key) const;
+
+  // Query values from several bounding boxes at once with no duplicates.
+  List<Value> queryValues(Rect const& rect) const;
+  template <typename RectCollection>
+  List<Value> queryValues(RectCollection const& rects) const;
+
+  // Iterate over entries in the given bounding boxes without duplication.  It
+  // is safe to modify rects or add entries from the given callback, but it is
+  // not safe to remove entries from it.
+  template <typename Function>
+  void forEach(Rect const& rect, Function&& function) const;
+  template <typename RectCollection, typename Function>
+  void forEach(RectCollection const& rects, Function&& function) const;
+
+  void set(Key const& key, Coord const& pos);
+  void set(Key const& key, Rect const& rect);
+
+  template <typename RectCollection>
+  void set(Key const& key, RectCollection const& rects);
+
+  void set(Key const& key, Coord const& pos, Value value);
+  void set(Key const& key, Rect const& rect, Value value);
+
+  template <typename RectCollection>
+  void set(Key const& key, RectCollection const& rects, Value value);
+
+  Maybe<Value> remove(Key const& key);
+
+  // Recalculates every item in the grid
+  void setSectorSize(Scalar const& sectorSize);
+
+private:
+  struct CellItem {
+    Entry const* entry;
+    size_t rect;
+  };
+  typedef List<CellItem> Cell;
+
+  struct Query {
+    Rect rect;
+    SectorRange sectors;
+  };
+  typedef SmallList<Query, 2> QueryList;
+
+  SectorRange getSectors(Rect const& r) const;
+  size_t cellIndex(IntT x, IntT y) const;
+
+  // Whether the entry of the given item is found by the query at queryIndex,
+  // and this item in the given cell is the first place that it is found.
+  static bool firstFound(CellItem const& item, Sector const& cell, QueryList const& queries, size_t queryIndex);
+
+  void resizeGrid();
+  void addSpatial(Entry const* entry);
+  void removeSpatial(Entry const* entry);
+
+  template <typename RectCollection>
+  void updateSpatial(Entry* entry, RectCollection const& rects);
+
+  Scalar m_sectorSize;
+  Coord m_size;
+  Sector m_gridSize;
+  List<Cell> m_cells;
+  EntryMap m_entryMap;
+};
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::Entry::Entry()
+  : value() {}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::SpatialGrid2D(Scalar const& sectorSize, Coord const& size)
+  : m_sectorSize(sectorSize), m_size(size) {
+  resizeGrid();
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+List<KeyT> SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::keys() const {
+  return m_entryMap.keys();
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+List<typename SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::Value> SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::values() const {
+  List<Value> values;
+  for (auto const& pair : m_entryMap)
+    values.append(pair.second.value);
+
+  return values;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+typename SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::EntryMap const&
+SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::entries() const {
+  return m_entryMap;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+size_t SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::size() const {
+  return m_entryMap.size();
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+bool SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::contains(Key const& key) const {
+  return m_entryMap.contains(key);
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+typename SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::Value const& SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::get(
+    Key const& key) const {
+  return m_entryMap.get(key).value;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+typename SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::Value& SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::get(
+    Key const& key) {
+  return m_entryMap.get(key).value;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+typename SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::Value SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::value(
+    Key const& key) const {
+  auto iter = m_entryMap.find(key);
+  if (iter == m_entryMap.end())
+    return Value();
+  else
+    return iter->second.value;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+List<ValueT> SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::queryValues(Rect const& rect) const {
+  return queryValues(initializer_list<Rect>{rect});
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+template <typename RectCollection>
+List<ValueT> SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::queryValues(RectCollection const& rects) const {
+  List<Value> values;
+  forEach(rects, [&values](Value const& value) {
+      values.append(value);
+    });
+  return values;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+template <typename Function>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::forEach(Rect const& rect, Function&& function) const {
+  return forEach(initializer_list<Rect>{rect}, forward<Function>(function));
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+template <typename RectCollection, typename Function>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::forEach(RectCollection const& rects, Function&& function) const {
+  QueryList queries;
+  for (Rect const& rect : rects) {
+    if (!rect.isNull())
+      queries.append(Query{rect, getSectors(rect)});
+  }
+
+  // Entries are all found before calling the function, so that it is safe to
+  // add entries from it.
+  SmallList<Entry const*, 32> foundEntries;
+  for (size_t i = 0; i < queries.size(); ++i) {
+    auto const& sectors = queries[i].sectors;
+    for (IntT y = sectors.yMin(); y < sectors.yMax(); ++y) {
+      for (IntT x = sectors.xMin(); x < sectors.xMax(); ++x) {
+        for (auto const& item : m_cells[cellIndex(x, y)]) {
+          if (firstFound(item, Sector(x, y), queries, i))
+            foundEntries.append(item.entry);
+        }
+      }
+    }
+  }
+
+  for (auto const& entry : foundEntries)
+    function(entry->value);
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::set(Key const& key, Coord const& pos) {
+  set(key, initializer_list<Rect>{Rect(pos, pos)});
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::set(Key const& key, Rect const& rect) {
+  set(key, initializer_list<Rect>{rect});
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+template <typename RectCollection>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::set(Key const& key, RectCollection const& rects) {
+  updateSpatial(&m_entryMap.get(key), rects);
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::set(Key const& key, Coord const& pos, Value value) {
+  set(key, initializer_list<Rect>{Rect(pos, pos)}, std::move(value));
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::set(Key const& key, Rect const& rect, Value value) {
+  set(key, initializer_list<Rect>{rect}, std::move(value));
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+template <typename RectCollection>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::set(Key const& key, RectCollection const& rects, Value value) {
+  Entry& entry = m_entryMap[key];
+  entry.value = std::move(value);
+  updateSpatial(&entry, rects);
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+auto SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::remove(Key const& key) -> Maybe<Value> {
+  auto iter = m_entryMap.find(key);
+  if (iter == m_entryMap.end())
+    return {};
+
+  removeSpatial(&iter->second);
+  Maybe<Value> val = std::move(iter->second.value);
+  m_entryMap.erase(iter);
+  return val;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::setSectorSize(Scalar const& sectorSize) {
+  m_sectorSize = sectorSize;
+  resizeGrid();
+  for (auto& pair : m_entryMap) {
+    auto& entry = pair.second;
+    entry.sectors.clear();
+    for (Rect const& rect : entry.rects)
+      entry.sectors.append(getSectors(rect));
+    addSpatial(&entry);
+  }
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+typename SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::SectorRange SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::getSectors(Rect const& r) const {
+  if (r.isNull())
+    return SectorRange::null();
+
+  SectorRange range(
+      floor(r.xMin() / m_sectorSize),
+      floor(r.yMin() / m_sectorSize),
+      ceil(r.xMax() / m_sectorSize),
+      ceil(r.yMax() / m_sectorSize));
+  if (range.isEmpty())
+    return SectorRange::null();
+
+  // Anything outside of the grid goes in the nearest edge cells
+  return SectorRange(
+      clamp<IntT>(range.xMin(), 0, m_gridSize[0] - 1),
+      clamp<IntT>(range.yMin(), 0, m_gridSize[1] - 1),
+      clamp<IntT>(range.xMax(), 1, m_gridSize[0]),
+      clamp<IntT>(range.yMax(), 1, m_gridSize[1]));
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+size_t SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::cellIndex(IntT x, IntT y) const {
+  return (size_t)y * m_gridSize[0] + x;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+bool SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::firstFound(
+    CellItem const& item, Sector const& cell, QueryList const& queries, size_t queryIndex) {
+  Entry const& entry = *item.entry;
+
+  // The entry is found by a query if it is stored in any of the cells the
+  // query scans and any of its rects intersect the query rect, and it is
+  // reported from the first cell scanned that it is stored in.  Returns the
+  // index of the rect the entry is stored under in that cell and the cell
+  // itself, if the entry is found.
+  auto findFirst = [&entry](Query const& query) -> Maybe<pair<size_t, Sector>> {
+    bool intersects = false;
+    for (Rect const& rect : entry.rects) {
+      if (rect.intersects(query.rect)) {
+        intersects = true;
+        break;
+      }
+    }
+    if (!intersects)
+      return {};
+
+    Maybe<pair<size_t, Sector>> first;
+    for (size_t i = 0; i < entry.sectors.size(); ++i) {
+      auto overlap = entry.sectors[i].overlap(query.sectors);
+      if (overlap.isEmpty())
+        continue;
+      Sector start = overlap.min();
+      // Cells are scanned in row order
+      if (!first || start[1] < first->second[1] || (start[1] == first->second[1] && start[0] < first->second[0]))
+        first = make_pair(i, start);
+    }
+    return first;
+  };
+
+  // If an earlier query already found this entry then it has been reported
+  for (size_t i = 0; i < queryIndex; ++i) {
+    if (findFirst(queries[i]))
+      return false;
+  }
+
+  auto first = findFirst(queries[queryIndex]);
+  return first && first->first == item.rect && first->second == cell;
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::resizeGrid() {
+  m_gridSize = Sector(
+      max<IntT>(ceil(m_size[0] / m_sectorSize), 1),
+      max<IntT>(ceil(m_size[1] / m_sectorSize), 1));
+  m_cells.clear();
+  m_cells.resize((size_t)m_gridSize[0] * m_gridSize[1]);
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::addSpatial(Entry const* entry) {
+  for (size_t i = 0; i < entry->sectors.size(); ++i) {
+    auto const& sectors = entry->sectors[i];
+    for (IntT y = sectors.yMin(); y < sectors.yMax(); ++y) {
+      for (IntT x = sectors.xMin(); x < sectors.xMax(); ++x)
+        m_cells[cellIndex(x, y)].append(CellItem{entry, i});
+    }
+  }
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::removeSpatial(Entry const* entry) {
+  for (size_t i = 0; i < entry->sectors.size(); ++i) {
+    auto const& sectors = entry->sectors[i];
+    for (IntT y = sectors.yMin(); y < sectors.yMax(); ++y) {
+      for (IntT x = sectors.xMin(); x < sectors.xMax(); ++x) {
+        auto& cell = m_cells[cellIndex(x, y)];
+        for (size_t j = 0; j < cell.size(); ++j) {
+          if (cell[j].entry == entry && cell[j].rect == i) {
+            cell[j] = cell.last();
+            cell.removeLast();
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename KeyT, typename ScalarT, typename ValueT, typename IntT, size_t AllocatorBlockSize>
+template <typename RectCollection>
+void SpatialGrid2D<KeyT, ScalarT, ValueT, IntT, AllocatorBlockSize>::updateSpatial(Entry* entry, RectCollection const& rects) {
+  SmallList<SectorRange, 2> sectors;
+  for (Rect const& rect : rects)
+    sectors.append(getSectors(rect));
+
+  entry->rects.clear();
+  entry->rects.appendAll(rects);
+
+  // Entries that stay within the same cells only need their rects updated
+  if (sectors == entry->sectors)
+    return;
+
+  removeSpatial(entry);
+  entry->sectors = std::move(sectors);
+  addSpatial(entry);
+}
+
+}
@@ -60,6 +60,7 @@
 #include "StarChatBubbleManager.hpp"
 #include "StarNpc.hpp"
 #include "StarCharSelection.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
@@ -1427,6 +1428,20 @@ void MainInterface::renderDebug() {
     if (clearMap)
       LogMap::clear();
 
+    for (auto const& metric : Metrics::snapshot()) {
+      String key = metric.name;
+      if (!metric.labels.empty()) {
+        StringList labels;
+        for (auto const& label : metric.labels)
+          labels.append(label.second);
+        key += strf("[{}]", labels.join(","));
+      }
+      if (metric.type == MetricType::Histogram)
+        logMapValues[key] = strf("p50 {:.4g}, p99 {:.4g} ({} samples)", metric.quantile(0.5), metric.quantile(0.99), metric.count);
+      else
+        logMapValues[key] = strf("{:.6g}", metric.value);
+    }
+
     List<String> formatted;
     formatted.reserve(logMapValues.size());
 
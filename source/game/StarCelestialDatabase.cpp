@@ -10,6 +10,7 @@
 #include "StarAssets.hpp"
 #include "StarVersioningDatabase.hpp"
 #include "StarIterator.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -54,7 +55,8 @@ RectI CelestialDatabase::chunkRegion(Vec2I const& chunkIndex) const {
   return RectI(chunkIndex * m_baseInformation.chunkSize, (chunkIndex + Vec2I(1, 1)) * m_baseInformation.chunkSize);
 }
 
-CelestialMasterDatabase::CelestialMasterDatabase(Maybe<String> databaseFile) {
+CelestialMasterDatabase::CelestialMasterDatabase(Maybe<String> databaseFile)
+  : m_prefetchPool("CelestialPrefetchWorkerPool") {
   auto assets = Root::singleton().assets();
 
   auto config = assets->json("/celestial.config");
@@ -148,6 +150,10 @@ CelestialMasterDatabase::CelestialMasterDatabase(Maybe<String> databaseFile) {
 
   m_commitInterval = config.getFloat("commitInterval");
   m_commitTimer.restart(m_commitInterval);
+
+  m_chunkPrefetchRadius = config.optInt("chunkPrefetchRadius").value(0);
+  m_maxPrefetchingChunks = config.optUInt("maxPrefetchingChunks").value(16);
+  m_chunkPrefetchThreads = config.optUInt("chunkPrefetchThreads").value(1);
 }
 
 CelestialBaseInformation CelestialMasterDatabase::baseInformation() const {
@@ -155,9 +161,15 @@ CelestialBaseInformation CelestialMasterDatabase::baseInformation() const {
 }
 
 CelestialResponse CelestialMasterDatabase::respondToRequest(CelestialRequest const& request) {
+  if (auto chunkLocation = request.maybeLeft())
+    ensureChunks({*chunkLocation});
+  else if (auto systemLocation = request.maybeRight())
+    ensureChunks({chunkIndexFor(*systemLocation)});
+
   RecursiveMutexLocker locker(m_mutex);
 
   if (auto chunkLocation = request.maybeLeft()) {
+    prefetchChunksAround(*chunkLocation);
     auto chunk = getChunk(*chunkLocation);
     // System objects are sent by separate system requests.
     chunk.systemObjects.clear();
@@ -171,8 +183,14 @@ CelestialResponse CelestialMasterDatabase::respondToRequest(CelestialRequest con
   }
 }
 
+void CelestialMasterDatabase::setChunkPrefetchRadius(int radius) {
+  RecursiveMutexLocker locker(m_mutex);
+  m_chunkPrefetchRadius = radius;
+}
+
 void CelestialMasterDatabase::cleanupAndCommit() {
   RecursiveMutexLocker locker(m_mutex);
+  storeGeneratedChunks();
   m_chunkCache.cleanup();
   if (m_database.isOpen() && m_commitTimer.timeUp()) {
     m_database.commit();
@@ -293,16 +311,14 @@ List<int> CelestialMasterDatabase::childOrbits(CelestialCoordinate const& coordi
 }
 
 List<CelestialCoordinate> CelestialMasterDatabase::scanSystems(RectI const& region, Maybe<StringSet> const& includedTypes) {
+  auto chunkLocations = chunkIndexesFor(region);
+  ensureChunks(chunkLocations);
+
   RecursiveMutexLocker locker(m_mutex);
 
   List<CelestialCoordinate> systems;
-  for (auto const& chunkLocation : chunkIndexesFor(region)) {
-    auto const& chunkData = getChunk(chunkLocation, [&](std::function<void()>&& func) {
-      locker.unlock();
-      func();
-      locker.lock();
-    });
-    locker.unlock();
+  for (auto const& chunkLocation : chunkLocations) {
+    auto const& chunkData = getChunk(chunkLocation);
     for (auto const& pair : chunkData.systemParameters) {
       Vec3I systemLocation = pair.first;
       if (region.contains(systemLocation.vec2())) {
@@ -314,16 +330,18 @@ List<CelestialCoordinate> CelestialMasterDatabase::scanSystems(RectI const& regi
         systems.append(CelestialCoordinate(systemLocation));
       }
     }
-    locker.lock();
   }
   return systems;
 }
 
 List<pair<Vec2I, Vec2I>> CelestialMasterDatabase::scanConstellationLines(RectI const& region) {
+  auto chunkLocations = chunkIndexesFor(region);
+  ensureChunks(chunkLocations);
+
   RecursiveMutexLocker locker(m_mutex);
 
   List<pair<Vec2I, Vec2I>> lines;
-  for (auto const& chunkLocation : chunkIndexesFor(region)) {
+  for (auto const& chunkLocation : chunkLocations) {
     auto const& chunkData = getChunk(chunkLocation);
     for (auto const& constellation : chunkData.constellations) {
       for (auto const& line : constellation) {
@@ -385,40 +403,140 @@ Maybe<CelestialOrbitRegion> CelestialMasterDatabase::orbitRegion(
   return {};
 }
 
-CelestialChunk const& CelestialMasterDatabase::getChunk(Vec2I const& chunkIndex, UnlockDuringFunction unlockDuring) {
-  return m_chunkCache.get(chunkIndex, [&](Vec2I const& chunkIndex) -> CelestialChunk {
-      auto versioningDatabase = Root::singleton().versioningDatabase();
+CelestialChunk const& CelestialMasterDatabase::getChunk(Vec2I const& chunkIndex) {
+  if (auto chunk = m_chunkCache.ptr(chunkIndex))
+    return *chunk;
 
-      if (m_database.isOpen()) {
-        if (auto chunkData = m_database.find(DataStreamBuffer::serialize(chunkIndex))) {
-          auto versionedChunk = DataStreamBuffer::deserialize<VersionedJson>(uncompressData(chunkData.take()));
-          if (!versioningDatabase->versionedJsonCurrent(versionedChunk)) {
-            versionedChunk = versioningDatabase->updateVersionedJson(versionedChunk);
-            DataStreamBuffer ds;
-            ds.write(versionedChunk);
-            VersionedJson::writeSubVersioning(ds, versionedChunk);
-            m_database.insert(DataStreamBuffer::serialize(chunkIndex), compressData(ds.data()));
-          }
-          return CelestialChunk(versionedChunk.content);
-        }
-      }
+  ensureChunks({chunkIndex});
+  storeGeneratedChunks();
+  // Only reached without the chunk if generating it failed on another thread,
+  // in which case try again here.
+  return m_chunkCache.get(chunkIndex, [this](Vec2I const& chunkIndex) {
+      return produceChunk(chunkIndex);
+    });
+}
 
-      CelestialChunk newChunk;
-      auto producer = [&]() { newChunk = produceChunk(chunkIndex); };
-      if (unlockDuring)
-        unlockDuring(producer);
-      else
-        producer();
-      if (m_database.isOpen()) {
-        auto versionedChunk = versioningDatabase->makeCurrentVersionedJson("CelestialChunk", newChunk.toJson());
-        DataStreamBuffer ds;
-        ds.write(versionedChunk);
-        VersionedJson::writeSubVersioning(ds, versionedChunk);
-        m_database.insert(DataStreamBuffer::serialize(chunkIndex), compressData(ds.data()));
+void CelestialMasterDatabase::ensureChunks(List<Vec2I> const& chunkIndexes) {
+  List<Vec2I> claimedChunks;
+  List<Vec2I> awaitedChunks;
+  {
+    RecursiveMutexLocker locker(m_mutex);
+    for (auto const& chunkIndex : chunkIndexes) {
+      if (m_chunkCache.ptr(chunkIndex) || loadStoredChunk(chunkIndex))
+        continue;
+
+      MutexLocker generationLocker(m_generationMutex);
+      if (m_generatedChunks.contains(chunkIndex))
+        continue;
+      if (m_generatingChunks.contains(chunkIndex)) {
+        awaitedChunks.append(chunkIndex);
+      } else {
+        m_generatingChunks.add(chunkIndex);
+        claimedChunks.append(chunkIndex);
       }
+    }
+  }
 
-      return newChunk;
-    });
+  for (size_t i = 0; i < claimedChunks.size(); ++i) {
+    Maybe<CelestialChunk> chunk;
+    try {
+      chunk = produceChunk(claimedChunks[i]);
+    } catch (...) {
+      MutexLocker generationLocker(m_generationMutex);
+      for (size_t j = i; j < claimedChunks.size(); ++j)
+        m_generatingChunks.remove(claimedChunks[j]);
+      m_generationCondition.broadcast();
+      throw;
+    }
+
+    MutexLocker generationLocker(m_generationMutex);
+    m_generatingChunks.remove(claimedChunks[i]);
+    m_generatedChunks[claimedChunks[i]] = chunk.take();
+    m_generationCondition.broadcast();
+  }
+
+  if (!awaitedChunks.empty()) {
+    MutexLocker generationLocker(m_generationMutex);
+    for (auto const& chunkIndex : awaitedChunks) {
+      while (m_generatingChunks.contains(chunkIndex))
+        m_generationCondition.wait(m_generationMutex);
+    }
+  }
+}
+
+bool CelestialMasterDatabase::loadStoredChunk(Vec2I const& chunkIndex) {
+  if (!m_database.isOpen())
+    return false;
+
+  auto chunkData = m_database.find(DataStreamBuffer::serialize(chunkIndex));
+  if (!chunkData)
+    return false;
+
+  auto versioningDatabase = Root::singleton().versioningDatabase();
+  auto versionedChunk = DataStreamBuffer::deserialize<VersionedJson>(uncompressData(chunkData.take()));
+  if (!versioningDatabase->versionedJsonCurrent(versionedChunk)) {
+    versionedChunk = versioningDatabase->updateVersionedJson(versionedChunk);
+    DataStreamBuffer ds;
+    ds.write(versionedChunk);
+    VersionedJson::writeSubVersioning(ds, versionedChunk);
+    m_database.insert(DataStreamBuffer::serialize(chunkIndex), compressData(ds.data()));
+  }
+  m_chunkCache.set(chunkIndex, CelestialChunk(versionedChunk.content));
+  return true;
+}
+
+void CelestialMasterDatabase::storeGeneratedChunks() {
+  HashMap<Vec2I, CelestialChunk> generatedChunks;
+  {
+    MutexLocker generationLocker(m_generationMutex);
+    generatedChunks = take(m_generatedChunks);
+  }
+
+  auto versioningDatabase = Root::singleton().versioningDatabase();
+  for (auto& pair : generatedChunks) {
+    if (m_database.isOpen()) {
+      auto versionedChunk = versioningDatabase->makeCurrentVersionedJson("CelestialChunk", pair.second.toJson());
+      DataStreamBuffer ds;
+      ds.write(versionedChunk);
+      VersionedJson::writeSubVersioning(ds, versionedChunk);
+      m_database.insert(DataStreamBuffer::serialize(pair.first), compressData(ds.data()));
+    }
+    m_chunkCache.set(pair.first, std::move(pair.second));
+  }
+}
+
+void CelestialMasterDatabase::prefetchChunksAround(Vec2I const& chunkIndex) {
+  if (m_chunkPrefetchRadius <= 0 || m_chunkPrefetchThreads == 0)
+    return;
+
+  MutexLocker generationLocker(m_generationMutex);
+  // Started here rather than in the constructor, so that short-lived
+  // databases that never prefetch (such as those made for versioning
+  // updates) never spawn any threads.
+  if (m_prefetchPool.getWorkerCount() == 0)
+    m_prefetchPool.start(m_chunkPrefetchThreads);
+
+  for (int x = -m_chunkPrefetchRadius; x <= m_chunkPrefetchRadius; ++x) {
+    for (int y = -m_chunkPrefetchRadius; y <= m_chunkPrefetchRadius; ++y) {
+      if (m_prefetchingChunks.size() >= m_maxPrefetchingChunks)
+        return;
+
+      Vec2I prefetchIndex = chunkIndex + Vec2I(x, y);
+      if (m_chunkCache.ptr(prefetchIndex) || m_generatingChunks.contains(prefetchIndex)
+          || m_generatedChunks.contains(prefetchIndex) || !m_prefetchingChunks.add(prefetchIndex))
+        continue;
+
+      m_prefetchPool.addWork([this, prefetchIndex]() {
+          try {
+            ensureChunks({prefetchIndex});
+          } catch (std::exception const& e) {
+            Logger::error("CelestialMasterDatabase: failed to prefetch chunk {}: {}", prefetchIndex, outputException(e, false));
+          }
+          MutexLocker generationLocker(m_generationMutex);
+          m_prefetchingChunks.remove(prefetchIndex);
+        });
+    }
+  }
 }
 
 CelestialChunk CelestialMasterDatabase::produceChunk(Vec2I const& chunkIndex) const {
@@ -7,6 +7,7 @@
 #include "StarBTreeDatabase.hpp"
 #include "StarCelestialTypes.hpp"
 #include "StarPerlin.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -74,10 +75,18 @@ public:
   CelestialMasterDatabase(Maybe<String> databaseFile = {});
 
   CelestialBaseInformation baseInformation() const;
+  // Responding to a chunk request also queues generation of the chunks around
+  // it on the database's own prefetch threads.
   CelestialResponse respondToRequest(CelestialRequest const& requests);
 
-  // Unload data that has not been used in the configured TTL time, and
-  // periodically commit to the underlying database if it is in use.
+  // Chunks within this many chunks of a requested chunk are prefetched,
+  // defaults to the configured chunkPrefetchRadius.  0 disables prefetching,
+  // chunks are then only generated on whichever thread first needs them.
+  void setChunkPrefetchRadius(int radius);
+
+  // Unload data that has not been used in the configured TTL time, write
+  // newly generated chunks, and periodically commit to the underlying
+  // database if it is in use.
   void cleanupAndCommit();
 
   // Does this coordinate point to a valid existing object?
@@ -161,8 +170,24 @@ protected:
   static Maybe<CelestialOrbitRegion> orbitRegion(
       List<CelestialOrbitRegion> const& orbitRegions, int planetaryOrbitNumber);
 
-  typedef std::function<void(std::function<void()>&&)>&& UnlockDuringFunction;
-  CelestialChunk const& getChunk(Vec2I const& chunkLocation, UnlockDuringFunction unlockDuring = {});
+  // m_mutex must be held.
+  CelestialChunk const& getChunk(Vec2I const& chunkLocation);
+
+  // Makes sure that every given chunk is either cached, or generated and
+  // waiting to be stored.  Chunks that nobody is generating yet are generated
+  // on the calling thread, chunks that another thread is already generating
+  // are waited on.  Callers should not hold m_mutex, so that generation does
+  // not block other chunk lookups.
+  void ensureChunks(List<Vec2I> const& chunkLocations);
+  // Loads the given chunk from the database into the cache, if it is there.
+  // m_mutex must be held.
+  bool loadStoredChunk(Vec2I const& chunkLocation);
+  // Moves every generated chunk into the cache, and writes them to the
+  // database in one batch.  m_mutex must be held.
+  void storeGeneratedChunks();
+  // Queues the chunks within the prefetch radius around the given chunk for
+  // generation on the prefetch pool.  m_mutex must be held.
+  void prefetchChunksAround(Vec2I const& chunkLocation);
 
   CelestialChunk produceChunk(Vec2I const& chunkLocation) const;
   Maybe<pair<CelestialParameters, HashMap<int, CelestialPlanet>>> produceSystem(
@@ -177,8 +202,29 @@ protected:
   HashTtlCache<Vec2I, CelestialChunk> m_chunkCache;
   BTreeSha256Database m_database;
 
+  // Chunks being generated, generated chunks not yet moved into the cache,
+  // and chunks queued for prefetching.  Guarded by m_generationMutex, which
+  // is locked after m_mutex when both are held.  Chunks are only ever added
+  // to m_generatingChunks while also holding m_mutex, so a chunk is never
+  // generated twice at once.
+  Mutex m_generationMutex;
+  ConditionVariable m_generationCondition;
+  HashSet<Vec2I> m_generatingChunks;
+  HashMap<Vec2I, CelestialChunk> m_generatedChunks;
+  HashSet<Vec2I> m_prefetchingChunks;
+
+  int m_chunkPrefetchRadius;
+  size_t m_maxPrefetchingChunks;
+  unsigned m_chunkPrefetchThreads;
+
   float m_commitInterval;
   Timer m_commitTimer;
+
+  // Prefetching gets its own pool rather than sharing one with client
+  // requests or world creation, so that it can never delay them.  Declared
+  // last, so that its threads are stopped before anything they use is
+  // destroyed.
+  WorkerPool m_prefetchPool;
 };
 
 class CelestialSlaveDatabase : public CelestialDatabase {
@@ -22,6 +22,8 @@
 #include "StarWorldLuaBindings.hpp"
 #include "StarUniverseServerLuaBindings.hpp"
 #include "StarString.hpp"
+#include "StarFile.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
@@ -956,6 +958,116 @@ String CommandProcessor::setEnvironmentBiome(ConnectionId connectionId, String c
   return done ? "set environment biome for world layer" : "failed to set environment biome";
 }
 
+String CommandProcessor::scriptStats(ConnectionId connectionId, String const& argumentString) {
+  if (auto errorMsg = adminCheck(connectionId, "view script statistics"))
+    return *errorMsg;
+
+  auto arguments = m_parser.tokenizeToStringList(argumentString);
+  String action = arguments.empty() ? String() : arguments.at(0);
+
+  // Players act on the world they are in, the server console and rcon act on
+  // every active world.
+  auto forWorlds = [&](function<void(WorldServer*)> worldAction) -> bool {
+    if (connectionId == ServerConnectionId) {
+      m_universe->executeForWorlds([&](WorldId const&, WorldServer* world) { worldAction(world); });
+      return true;
+    }
+    return m_universe->executeForClient(connectionId, [&](WorldServer* world, PlayerPtr const&) { worldAction(world); });
+  };
+
+  if (action == "on" || action == "off") {
+    bool enabled = action == "on";
+    unsigned sampleInterval = Root::singleton().configuration()->get("scriptAccountingStackSampleInterval").toUInt();
+    bool done = forWorlds([&](WorldServer* world) {
+        world->luaRoot()->luaEngine().setAccountingEnabled(enabled, sampleInterval);
+      });
+    return done ? strf("script accounting {}", enabled ? "enabled" : "disabled") : "Invalid client state";
+
+  } else if (action == "reset") {
+    bool done = forWorlds([](WorldServer* world) { world->luaRoot()->luaEngine().resetAccounting(); });
+    return done ? "script accounting reset" : "Invalid client state";
+
+  } else if (action == "export") {
+    String collapsedStacks;
+    size_t samples = 0;
+    bool done = forWorlds([&](WorldServer* world) {
+        String worldFrame = world->worldId().replace(";", ":");
+        for (auto const& p : world->luaRoot()->luaEngine().accounting()) {
+          for (auto const& stack : p.second.stackSamples) {
+            collapsedStacks += strf("{};{};{} {}\n", worldFrame, p.first.replace(";", ":"), stack.first, stack.second);
+            samples += stack.second;
+          }
+        }
+      });
+    if (!done)
+      return "Invalid client state";
+
+    auto fileName = arguments.size() >= 2 ? arguments.at(1) : String("scriptstats.folded");
+    auto maybePath = storageFilePath(fileName);
+    if (!maybePath)
+      return strf("Invalid file name '{}', expected a file name without a directory", fileName);
+    String path = maybePath.take();
+    try {
+      File::writeFile(collapsedStacks, path);
+    } catch (IOException const& e) {
+      return strf("Could not write script stacks to '{}': {}", path, outputException(e, false));
+    }
+    return strf("Wrote {} stack samples to '{}'", samples, path);
+
+  } else {
+    size_t count = 10;
+    if (!action.empty()) {
+      if (auto c = maybeLexicalCast<size_t>(action))
+        count = *c;
+      else
+        return "Usage /scriptstats [count | on | off | reset | export [file]]";
+    }
+
+    List<tuple<String, String, LuaAccountingEntry>> entries;
+    size_t accountingWorlds = 0;
+    bool done = forWorlds([&](WorldServer* world) {
+        auto& luaEngine = world->luaRoot()->luaEngine();
+        if (luaEngine.accountingEnabled())
+          ++accountingWorlds;
+        for (auto& p : luaEngine.accounting())
+          entries.append(make_tuple(world->worldId(), p.first, std::move(p.second)));
+      });
+    if (!done)
+      return "Invalid client state";
+    if (accountingWorlds == 0)
+      return "Script accounting is disabled, enable it with /scriptstats on";
+
+    entries.sort([](auto const& a, auto const& b) { return get<2>(a).time > get<2>(b).time; });
+    String res = strf("Top scripts by time in {} world(s):", accountingWorlds);
+    for (size_t i = 0; i < min(count, entries.size()); ++i) {
+      auto const& entry = get<2>(entries[i]);
+      res += strf("\n{} {}: {:.2f}ms, {} instructions, {:.1f}KiB allocated, {} calls",
+          get<0>(entries[i]), get<1>(entries[i]), entry.time * 1000.0, entry.instructions, entry.allocatedBytes / 1024.0, entry.calls);
+    }
+    return res;
+  }
+}
+
+String CommandProcessor::metrics(ConnectionId connectionId, String const& argumentString) {
+  if (auto errorMsg = adminCheck(connectionId, "view server metrics"))
+    return *errorMsg;
+
+  auto arguments = m_parser.tokenizeToStringList(argumentString);
+  if (arguments.empty())
+    return Metrics::prometheusText();
+
+  auto maybePath = storageFilePath(arguments.at(0));
+  if (!maybePath)
+    return strf("Invalid file name '{}', expected a file name without a directory", arguments.at(0));
+  String path = maybePath.take();
+  try {
+    Metrics::writePrometheusFile(path);
+  } catch (IOException const& e) {
+    return strf("Could not write metrics to '{}': {}", path, outputException(e, false));
+  }
+  return strf("Wrote metrics to '{}'", path);
+}
+
 Maybe<ConnectionId> CommandProcessor::playerCidFromCommand(String const& player, UniverseServer* universe) {
   char const* const UsernamePrefix = "@";
   char const* const CidPrefix = "$";
@@ -980,6 +1092,12 @@ Maybe<ConnectionId> CommandProcessor::playerCidFromCommand(String const& player,
   return universe->findNick(player);
 }
 
+Maybe<String> CommandProcessor::storageFilePath(String const& fileName) {
+  if (fileName.empty() || fileName == "." || fileName == ".." || fileName.contains("/") || fileName.contains("\\") || fileName.contains(":"))
+    return {};
+  return Root::singleton().toStoragePath(fileName);
+}
+
 const StringMap<std::function<String(CommandProcessor*, ConnectionId, String)>> CommandProcessor::s_commandMap = []() {
   StringMap<std::function<String(CommandProcessor*, ConnectionId, String)>> map;
 	
@@ -1030,6 +1148,8 @@ const StringMap<std::function<String(CommandProcessor*, ConnectionId, String)>>
   add("updateplanettype", &CommandProcessor::updatePlanetType);
   add("setweather", &CommandProcessor::setWeather);
   add("setenvironmentbiome", &CommandProcessor::setEnvironmentBiome);
+  add("scriptstats", &CommandProcessor::scriptStats);
+  add("metrics", &CommandProcessor::metrics);
 
   return map;
 }();
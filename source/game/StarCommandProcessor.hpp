@@ -19,6 +19,10 @@ public:
 
 private:
   static Maybe<ConnectionId> playerCidFromCommand(String const& player, UniverseServer* universe);
+  // Storage path for a file name given to a command that writes files, or
+  // nothing if it is not a bare file name (no directory or drive), so commands cannot write outside
+  // of the storage directory.
+  static Maybe<String> storageFilePath(String const& fileName);
 
   String help(ConnectionId connectionId, String const& argumentString);
   String admin(ConnectionId connectionId, String const& argumentString);
@@ -60,6 +64,8 @@ private:
   String updatePlanetType(ConnectionId connectionId, String const& argumentString);
   String setWeather(ConnectionId connectionId, String const& argumentString);
   String setEnvironmentBiome(ConnectionId connectionId, String const& argumentString);
+  String scriptStats(ConnectionId connectionId, String const& argumentString);
+  String metrics(ConnectionId connectionId, String const& argumentString);
 
   static const StringMap<std::function<String(CommandProcessor*, ConnectionId, String)>> s_commandMap;
 
@@ -76,7 +76,7 @@ void DamageManager::update(float dt) {
       damageIt.remove();
   }
 
-  m_world->forAllEntities([&](EntityPtr const& causingEntity) {
+  auto updateCausingEntity = [&](EntityPtr const& causingEntity) {
     for (auto& damageSource : causingEntity->damageSources()) {
       if (damageSource.trackSourceEntity)
         damageSource.translate(causingEntity->position());
@@ -124,7 +124,11 @@ void DamageManager::update(float dt) {
 
     for (auto const& damageNotification : causingEntity->selfDamageNotifications())
       addDamageNotification({causingEntity->entityId(), damageNotification});
-  });
+  };
+
+  // Objects without touch damage or scripted damage sources, intangible
+  // projectiles, plants, drops and stagehands are never visited.
+  m_world->forAllDamageSourceEntities(updateCausingEntity);
 }
 
 void DamageManager::pushRemoteHitRequest(RemoteHitRequest const& remoteHitRequest) {
@@ -13,6 +13,7 @@ Drawable::ImagePart& Drawable::ImagePart::addDirectives(Directives const& direct
   if (!directives)
     return *this;
 
+  imageId = {};
   if (keepImageCenterPosition) {
     auto imageMetadata = Root::singleton().imageMetadataDatabase();
     Vec2F imageSize = Vec2F(imageMetadata->imageSize(image));
@@ -33,6 +34,7 @@ Drawable::ImagePart& Drawable::ImagePart::addDirectivesGroup(DirectivesGroup con
   if (directivesGroup.empty())
     return *this;
 
+  imageId = {};
   if (keepImageCenterPosition) {
     auto imageMetadata = Root::singleton().imageMetadataDatabase();
     Vec2F imageSize = Vec2F(imageMetadata->imageSize(image));
@@ -52,6 +54,7 @@ Drawable::ImagePart& Drawable::ImagePart::addDirectivesGroup(DirectivesGroup con
 }
 
 Drawable::ImagePart& Drawable::ImagePart::removeDirectives(bool keepImageCenterPosition) {
+  imageId = {};
   if (keepImageCenterPosition) {
     auto imageMetadata = Root::singleton().imageMetadataDatabase();
     Vec2F imageSize = Vec2F(imageMetadata->imageSize(image));
@@ -273,6 +276,7 @@ DataStream& operator<<(DataStream& ds, Drawable::PolyPart const& poly) {
 DataStream& operator>>(DataStream& ds, Drawable::ImagePart& image) {
   ds >> image.image;
   ds >> image.transformation;
+  image.imageId = {};
   return ds;
 }
 
@@ -25,6 +25,11 @@ struct Drawable {
     // Transformation of the image in pixel space (0, 0) - (width, height) to
     // the final drawn space
     Mat3F transformation;
+    // If set, the interned id of image, which the renderer looks the texture
+    // up by instead.  Set by producers that keep the same image over many
+    // frames, and never sent over the network.  Cleared by the directives
+    // methods below, and anything else changing image must clear it as well.
+    AssetPathId imageId;
 
     // Add directives to this ImagePart, while optionally keeping the
     // transformed center of the image the same if the directives change the
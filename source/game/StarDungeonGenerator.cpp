@@ -598,6 +598,7 @@ namespace Dungeon {
         reader->readAsset(AssetPath::relativeTo(dungeon->directory(), asset.toString()));
     }
     m_size = m_reader->size();
+    compileTiles();
     scanConnectors();
     scanAnchor();
   }
@@ -638,8 +639,9 @@ namespace Dungeon {
     Vec2I air = {0, size().y()};
     Vec2I ground = {0, 0};
     Vec2I liquid = {0, 0};
-    m_reader->forEachTile([&ground, &air, &liquid](Vec2I tilePos, Tile const& tile) -> bool {
-      for (auto const& rule : tile.rules) {
+    for (auto const& partTile : m_ruleTiles) {
+      Vec2I tilePos = partTile.position;
+      for (auto const& rule : partTile.tile->rules) {
         if (is<WorldGenMustContainSolidRule>(rule) && tilePos.y() > ground.y()) {
           ground = tilePos;
         }
@@ -650,8 +652,7 @@ namespace Dungeon {
           liquid = tilePos;
         }
       }
-      return false;
-    });
+    }
     ground[1] = max(ground[1], liquid[1]);
     if (air.y() < ground.y())
       throw DungeonException::format(
@@ -700,37 +701,38 @@ namespace Dungeon {
     if (m_overrideAllowAlways)
       return true;
 
-    bool result = false;
-    m_reader->forEachTile([&result, pos, &places](Vec2I tilePos, Tile const& tile) -> bool {
-      if (tile.collidesWithPlaces())
-        if (places.contains(pos + tilePos)) {
-          Logger::debug("Tile collided with place at {}", pos + tilePos);
-          result = true;
-          return true;
-        }
-      return false;
-    });
+    for (auto const& tilePos : m_collisionPositions) {
+      if (places.contains(pos + tilePos)) {
+        Logger::debug("Tile collided with place at {}", pos + tilePos);
+        return true;
+      }
+    }
 
-    return result;
+    return false;
   }
 
   bool Part::canPlace(Vec2I pos, DungeonGeneratorWriter* writer) const {
     if (m_overrideAllowAlways)
       return true;
 
-    // Speed up repeated failing calls by first checking the tile that failed
-    // last time (if it did).
-    bool result = true;
-    m_reader->forEachTile([&result, pos, writer](Vec2I tilePos, Tile const& tile) -> bool {
+    // Same checks as Tile::canPlace, but the checks that every tile does are
+    // only done once for each position, and only tiles with rules are
+    // checked further.
+    for (auto const& tilePos : m_tilePositions) {
       Vec2I position = pos + tilePos;
-      if (!tile.canPlace(position, writer)) {
-        result = false;
-        return true;
+      if (writer->otherDungeonPresent(position) || position[1] < 0)
+        return false;
+    }
+
+    for (auto const& partTile : m_ruleTiles) {
+      Vec2I position = pos + partTile.position;
+      for (auto const& rule : partTile.tile->rules) {
+        if (!rule->checkTileCanPlace(position, writer))
+          return false;
       }
-      return false;
-    });
+    }
 
-    return result;
+    return true;
   }
 
   void Part::place(Vec2I pos, Set<Vec2I> const& places, DungeonGeneratorWriter* writer) const {
@@ -747,22 +749,24 @@ namespace Dungeon {
   }
 
   void Part::forEachTile(TileCallback const& callback) const {
-    m_reader->forEachTile(callback);
+    for (auto const& partTile : m_tiles) {
+      if (callback(partTile.position, *partTile.tile))
+        return;
+    }
   }
 
   void Part::placePhase(Vec2I pos, Phase phase, Set<Vec2I> const& places, DungeonGeneratorWriter* writer) const {
-    m_reader->forEachTile([&places, pos, phase, writer](Vec2I tilePos, Tile const& tile) -> bool {
-      Vec2I position = pos + tilePos;
-      if (tile.collidesWithPlaces() || !places.contains(position)) {
+    for (auto const& partTile : m_brushTiles) {
+      Vec2I position = pos + partTile.position;
+      if (partTile.tile->collidesWithPlaces() || !places.contains(position)) {
         try {
-          tile.place(position, phase, writer);
+          partTile.tile->place(position, phase, writer);
         } catch (std::exception const&) {
-          Logger::error("Error at map position {}:", tilePos);
+          Logger::error("Error at map position {}:", partTile.position);
           throw;
         }
       }
-      return false;
-    });
+    }
   }
 
   bool Part::tileUsesPlaces(Vec2I pos) const {
@@ -830,7 +834,7 @@ namespace Dungeon {
 
   void Part::scanConnectors() {
     try {
-      m_reader->forEachTile([this](Vec2I position, Tile const& tile) -> bool {
+      forEachTile([this](Vec2I position, Tile const& tile) -> bool {
         if (tile.connector.isValid()) {
           auto d = tile.connector->direction;
           if (d == Direction::Unknown)
@@ -855,7 +859,7 @@ namespace Dungeon {
     int highestGound = -1;
     int highestLiquid = -1;
     try {
-      m_reader->forEachTile([&](Vec2I pos, Tile const& tile) -> bool {
+      forEachTile([&](Vec2I pos, Tile const& tile) -> bool {
         int x = pos.x(), y = pos.y();
         if (tile.collidesWithPlaces()) {
           cx += x;
@@ -901,6 +905,27 @@ namespace Dungeon {
     m_anchorPoint = {cx, cy};
   }
 
+  void Part::compileTiles() {
+    HashSet<Vec2I> tilePositions;
+    HashSet<Vec2I> collisionPositions;
+    try {
+      m_reader->forEachTile([&](Vec2I pos, Tile const& tile) -> bool {
+        m_tiles.append({pos, &tile});
+        if (!tile.brushes.empty())
+          m_brushTiles.append({pos, &tile});
+        if (!tile.rules.empty())
+          m_ruleTiles.append({pos, &tile});
+        if (tilePositions.add(pos))
+          m_tilePositions.append(pos);
+        if (tile.collidesWithPlaces() && collisionPositions.add(pos))
+          m_collisionPositions.append(pos);
+        return false;
+      });
+    } catch (std::exception& e) {
+      throw DungeonException(strf("Exception {} in part {}", outputException(e, true), m_name));
+    }
+  }
+
   bool WorldGenMustContainSolidRule::checkTileCanPlace(Vec2I position, DungeonGeneratorWriter* writer) const {
     return writer->checkSolid(position, layer);
   }
@@ -593,9 +593,29 @@ namespace Dungeon {
     Direction pickByNeighbours(Vec2I pos) const;
     void scanConnectors();
     void scanAnchor();
+    void compileTiles();
+
+    struct PartTile {
+      Vec2I position;
+      Tile const* tile;
+    };
 
     PartReaderConstPtr m_reader;
 
+    // Every tile of every layer of the part in reader order, flattened once
+    // when the part is loaded so that placement does not have to go back
+    // through the reader.  The tiles themselves are owned by the reader.
+    List<PartTile> m_tiles;
+    // The subset of m_tiles that have brushes, the only ones that do anything
+    // when placed
+    List<PartTile> m_brushTiles;
+    // The subset of m_tiles that have placement rules
+    List<PartTile> m_ruleTiles;
+    // Every distinct position covered by a tile, and every distinct position
+    // covered by a tile that collides with places.
+    List<Vec2I> m_tilePositions;
+    List<Vec2I> m_collisionPositions;
+
     String m_name;
     List<RuleConstPtr> m_rules;
     DungeonDefinition* m_dungeon;
@@ -13,6 +13,7 @@
 #include "StarRoot.hpp"
 #include "StarStagehand.hpp"
 #include "StarVehicleDatabase.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -121,8 +122,6 @@ Json EntityFactory::diskStoreEntity(EntityPtr const& entity) const {
 }
 
 EntityPtr EntityFactory::diskLoadEntity(EntityType type, Json const& diskStore) const {
-  RecursiveMutexLocker locker(m_mutex);
-
   if (type == EntityType::Player) {
     return m_playerFactory->diskLoadPlayer(diskStore);
   } else if (type == EntityType::Monster) {
@@ -145,27 +144,72 @@ EntityPtr EntityFactory::diskLoadEntity(EntityType type, Json const& diskStore)
 }
 
 Json EntityFactory::loadVersionedJson(VersionedJson const& versionedJson, EntityType expectedType) const {
-  RecursiveMutexLocker locker(m_mutex);
-
   String identifier = EntityStorageIdentifiers.getRight(expectedType);
   return m_versioningDatabase->loadVersionedJson(versionedJson, identifier);
 }
 
 VersionedJson EntityFactory::storeVersionedJson(EntityType type, Json const& store) const {
-  RecursiveMutexLocker locker(m_mutex);
-
   String identifier = EntityStorageIdentifiers.getRight(type);
   return m_versioningDatabase->makeCurrentVersionedJson(identifier, store);
 }
 
 EntityPtr EntityFactory::loadVersionedEntity(VersionedJson const& versionedJson) const {
-  RecursiveMutexLocker locker(m_mutex);
-
   EntityType type = EntityStorageIdentifiers.getLeft(versionedJson.identifier);
   auto store = loadVersionedJson(versionedJson, type);
   return diskLoadEntity(type, store);
 }
 
+List<EntityPtr> EntityFactory::loadVersionedEntities(List<VersionedJson> const& versionedJsons,
+    function<void(VersionedJson const&, std::exception const&)> const& errorHandler, WorkerPool* workerPool) const {
+  if (workerPool && versionedJsons.size() > ParallelLoadBatchSize) {
+    List<WorkerPoolPromise<List<EntityPtr>>> batches;
+    for (size_t i = 0; i < versionedJsons.size(); i += ParallelLoadBatchSize) {
+      auto batch = versionedJsons.slice(i, i + ParallelLoadBatchSize);
+      batches.append(workerPool->addProducer<List<EntityPtr>>([this, batch = std::move(batch), errorHandler]() {
+          return loadVersionedEntities(batch, errorHandler);
+        }));
+    }
+
+    // Wait on every batch, even after one has failed, so that none are still
+    // running after we return.
+    List<EntityPtr> entities;
+    std::exception_ptr exception;
+    for (auto& batch : batches) {
+      try {
+        entities.appendAll(std::move(batch.get()));
+      } catch (...) {
+        if (!exception)
+          exception = std::current_exception();
+      }
+    }
+    if (exception)
+      std::rethrow_exception(exception);
+    return entities;
+  }
+
+  List<VersionedJson> validJsons;
+  validJsons.reserve(versionedJsons.size());
+  for (auto const& versionedJson : versionedJsons) {
+    if (EntityStorageIdentifiers.hasRightValue(versionedJson.identifier))
+      validJsons.append(versionedJson);
+    else
+      errorHandler(versionedJson, EntityFactoryException::format("Unknown entity storage identifier '{}'", versionedJson.identifier));
+  }
+
+  List<EntityPtr> entities;
+  entities.reserve(validJsons.size());
+  for (auto const& versionedJson : m_versioningDatabase->updateVersionedJsons(std::move(validJsons), errorHandler)) {
+    if (versionedJson.empty())
+      continue;
+    try {
+      entities.append(diskLoadEntity(EntityStorageIdentifiers.getLeft(versionedJson.identifier), versionedJson.content));
+    } catch (std::exception const& e) {
+      errorHandler(versionedJson, e);
+    }
+  }
+  return entities;
+}
+
 VersionedJson EntityFactory::storeVersionedEntity(EntityPtr const& entityPtr) const {
   return storeVersionedJson(entityPtr->entityType(), diskStoreEntity(entityPtr));
 }
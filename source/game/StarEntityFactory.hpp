@@ -11,11 +11,16 @@ STAR_CLASS(MonsterDatabase);
 STAR_CLASS(ObjectDatabase);
 STAR_CLASS(ProjectileDatabase);
 STAR_CLASS(NpcDatabase);
+STAR_CLASS(WorkerPool);
 
 STAR_CLASS(EntityFactory);
 
 STAR_EXCEPTION(EntityFactoryException, StarException);
 
+// Loading entities from disk stores is safe to do from several threads at
+// once, the databases used to construct them guard their own caches and
+// script contexts.  Storing entities and loading them from net stores are
+// serialized.
 class EntityFactory {
 public:
   EntityFactory();
@@ -33,10 +38,20 @@ public:
   // uses sripts in the VersionedingDatabase to bring the version of the store
   // forward to match the current version.
   EntityPtr loadVersionedEntity(VersionedJson const& versionedJson) const;
+  // Loads a list of stores at once, bringing them all forward in one pass.
+  // Stores that fail to update or load are passed to the errorHandler and
+  // left out of the result.  If a workerPool is given, large lists are split
+  // into batches that are updated and constructed on the pool, the errorHandler
+  // may then be called from the pool's threads.  Either way the entities are
+  // returned in the order of their stores.
+  List<EntityPtr> loadVersionedEntities(List<VersionedJson> const& versionedJsons,
+      function<void(VersionedJson const&, std::exception const&)> const& errorHandler, WorkerPool* workerPool = nullptr) const;
   VersionedJson storeVersionedEntity(EntityPtr const& entityPtr) const;
 
 private:
   static EnumMap<EntityType> const EntityStorageIdentifiers;
+  // Number of stores loaded by each worker pool job in loadVersionedEntities
+  static size_t const ParallelLoadBatchSize = 16;
 
   mutable RecursiveMutex m_mutex;
 
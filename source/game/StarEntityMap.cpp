@@ -10,7 +10,7 @@ int const EntityMap::MaximumEntityBoundBox = 10000;
 
 EntityMap::EntityMap(Vec2U const& worldSize, EntityId beginIdSpace, EntityId endIdSpace)
   : m_geometry(worldSize),
-    m_spatialMap(EntityMapSpatialHashSectorSize),
+    m_spatialMap(EntityMapSpatialHashSectorSize, Vec2F(worldSize)),
     m_nextId(beginIdSpace),
     m_beginIdSpace(beginIdSpace),
     m_endIdSpace(endIdSpace) {}
@@ -68,6 +68,8 @@ void EntityMap::addEntity(EntityPtr entity) {
   if (uniqueId && m_uniqueMap.hasLeftValue(*uniqueId))
     throw EntityMapException::format("Duplicate entity unique id ({}) on entity id ({}) in EntityMap::addEntity", *uniqueId, entityId);
 
+  if (entity->hasDamageSources())
+    m_damageSourceEntities.add(entityId, entity);
   m_spatialMap.set(entityId, m_geometry.splitRect(boundBox, position), std::move(entity));
   if (uniqueId)
     m_uniqueMap.add(*uniqueId, entityId);
@@ -76,6 +78,7 @@ void EntityMap::addEntity(EntityPtr entity) {
 EntityPtr EntityMap::removeEntity(EntityId entityId) {
   if (auto entity = m_spatialMap.remove(entityId)) {
     m_uniqueMap.removeRight(entityId);
+    m_damageSourceEntities.remove(entityId);
     return entity.take();
   }
   return {};
@@ -121,6 +124,13 @@ void EntityMap::updateAllEntities(EntityCallback const& callback, function<bool(
     } else {
       m_uniqueMap.removeRight(entityId);
     }
+
+    if (entity->hasDamageSources()) {
+      if (!m_damageSourceEntities.contains(entityId))
+        m_damageSourceEntities.add(entityId, entity);
+    } else {
+      m_damageSourceEntities.remove(entityId);
+    }
   };
 
   // Even if there is no sort order, we still copy pointers to a temporary
@@ -235,6 +245,14 @@ void EntityMap::forAllEntities(EntityCallback const& callback, function<bool(Ent
   }
 }
 
+void EntityMap::forAllDamageSourceEntities(EntityCallback const& callback) const {
+  // Copied so that it is safe to call addEntity from the callback, which may
+  // rehash the index.
+  List<EntityPtr> entities = m_damageSourceEntities.values();
+  for (auto const& entity : entities)
+    callback(entity);
+}
+
 EntityPtr EntityMap::findEntity(RectF const& boundBox, EntityFilter const& filter) const {
   EntityPtr res;
   forEachEntity(boundBox, [&filter, &res](EntityPtr const& entity) {
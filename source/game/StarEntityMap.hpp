@@ -1,6 +1,6 @@
 #pragma once
 
-#include "StarSpatialHash2D.hpp"
+#include "StarSpatialGrid2D.hpp"
 #include "StarEntity.hpp"
 
 namespace Star {
@@ -72,6 +72,9 @@ public:
 
   // Iterate through all the entities, optionally in the given sort order.
   void forAllEntities(EntityCallback const& callback, function<bool(EntityPtr const&, EntityPtr const&)> sortOrder = {}) const;
+  // Iterate through only the entities that returned true from
+  // Entity::hasDamageSources when they were added or last updated.
+  void forAllDamageSourceEntities(EntityCallback const& callback) const;
 
   // Stops searching when filter returns true, and returns the entity which
   // caused it.
@@ -116,12 +119,15 @@ public:
   List<shared_ptr<EntityT>> atTile(Vec2I const& pos) const;
 
 private:
-  typedef SpatialHash2D<EntityId, float, EntityPtr> SpatialMap;
+  typedef SpatialGrid2D<EntityId, float, EntityPtr> SpatialMap;
 
   WorldGeometry m_geometry;
 
   SpatialMap m_spatialMap;
   BiHashMap<String, EntityId> m_uniqueMap;
+  // Entities that may have damage sources, kept up to date in addEntity and
+  // updateAllEntities.
+  HashMap<EntityId, EntityPtr> m_damageSourceEntities;
 
   EntityId m_nextId;
   EntityId m_beginIdSpace;
@@ -6,6 +6,10 @@ namespace Star {
 
 RenderCallback::~RenderCallback() {}
 
+bool RenderCallback::drawablesWanted() const {
+  return true;
+}
+
 void RenderCallback::addDrawables(List<Drawable> drawables, EntityRenderLayer renderLayer, Vec2F translate) {
   for (auto& drawable : drawables) {
     drawable.translate(translate);
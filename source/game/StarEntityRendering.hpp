@@ -25,6 +25,11 @@ public:
   virtual void addTilePreview(PreviewTile preview) = 0;
   virtual void addOverheadBar(OverheadBar bar) = 0;
 
+  // False if drawables added to this callback will not be drawn, for example
+  // because the entity is off-screen.  Entities may then skip building their
+  // drawables, but should still add everything else.
+  virtual bool drawablesWanted() const;
+
   // Convenience non-virtuals
 
   void addDrawables(List<Drawable> drawables, EntityRenderLayer renderLayer, Vec2F translate = Vec2F());
@@ -103,6 +103,29 @@ PreviewTile::PreviewTile(Vec2I const& position, LiquidId liqId)
     colorVariant(DefaultMaterialColorVariant),
     updateLight(false) {}
 
+bool PreviewTile::operator==(PreviewTile const& rhs) const {
+  return tie(position, foreground, liqId, matId, hueShift, updateMatId, colorVariant, light, updateLight)
+      == tie(rhs.position, rhs.foreground, rhs.liqId, rhs.matId, rhs.hueShift, rhs.updateMatId, rhs.colorVariant, rhs.light, rhs.updateLight);
+}
+
+List<RectI> previewTileChangedRegions(List<PreviewTile> const& previous, List<PreviewTile> const& current) {
+  if (previous == current)
+    return {};
+
+  HashSet<Vec2I> positions;
+  for (auto previewTiles : {&previous, &current}) {
+    for (auto const& previewTile : *previewTiles) {
+      if (previewTile.updateMatId || previewTile.liqId != EmptyLiquidId)
+        positions.add(previewTile.position);
+    }
+  }
+
+  List<RectI> regions;
+  for (auto const& position : positions)
+    regions.append(RectI::withSize(position, Vec2I(1, 1)));
+  return regions;
+}
+
 OverheadBar::OverheadBar() : percentage(0.0f), detailOnly(false) {}
 
 OverheadBar::OverheadBar(Json const& json) {
@@ -55,8 +55,16 @@ struct PreviewTile {
   MaterialColorVariant colorVariant;
   Vec3B light;
   bool updateLight;
+
+  bool operator==(PreviewTile const& rhs) const;
 };
 
+// Returns a single tile region for every tile whose rendered material or
+// liquid is different between two frames of tile previews.  Previews are
+// written over the render tiles without touching the world, so render chunks
+// that were built under them have to be dirtied this way.
+List<RectI> previewTileChangedRegions(List<PreviewTile> const& previous, List<PreviewTile> const& current);
+
 struct OverheadBar {
   OverheadBar();
   OverheadBar(Json const& json);
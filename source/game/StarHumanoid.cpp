@@ -455,6 +455,28 @@ void Humanoid::loadAnimation() {
     m_frontArmRotationPoint = {m_baseConfig.getString("frontArmRotationPart", "frontArm"), m_baseConfig.getString("frontArmRotationPartPoint", "rotationCenter")};
     m_backArmRotationPoint = {m_baseConfig.getString("backArmRotationPart", "backArm"), m_baseConfig.getString("backArmRotationPartPoint", "rotationCenter")};
 
+    auto requirePart = [&](String const& partName) {
+      if (auto handle = m_networkedAnimator.partHandle(partName))
+        return *handle;
+      throw NetworkedAnimatorException::format("Humanoid animation '{}' has no part '{}'", animationPath, partName);
+    };
+    auto requireTransformationGroup = [&](String const& transformationGroup) {
+      if (auto handle = m_networkedAnimator.transformationGroupHandle(transformationGroup))
+        return *handle;
+      throw NetworkedAnimatorException::format("Humanoid animation '{}' has no transformation group '{}'", animationPath, transformationGroup);
+    };
+    m_headRotationPart = requirePart(m_headRotationPoint.first);
+    m_frontArmRotationPart = requirePart(m_frontArmRotationPoint.first);
+    m_backArmRotationPart = requirePart(m_backArmRotationPoint.first);
+    m_frontItemPartHandle = m_networkedAnimator.partHandle(m_frontItemPart);
+    m_backItemPartHandle = m_networkedAnimator.partHandle(m_backItemPart);
+    m_headRotationGroup = requireTransformationGroup("headRotation");
+    m_bodyHeadRotationGroup = requireTransformationGroup("bodyHeadRotation");
+    m_frontArmRotationGroup = requireTransformationGroup("frontArmRotation");
+    m_backArmRotationGroup = requireTransformationGroup("backArmRotation");
+    for (size_t i = 0; i < m_backCosmeticRotationGroups.size(); ++i)
+      m_backCosmeticRotationGroups[i] = m_networkedAnimator.transformationGroupHandle(strf("backCosmetic{}Rotation", i + 1));
+
     m_mouthOffsetPoint = {m_baseConfig.getString("mouthOffsetPart", "head"), m_baseConfig.getString("mouthOffsetPartPoint", "mouthOffset")};
     m_headArmorOffsetPoint = {m_baseConfig.getString("headArmorOffsetPart", "headCosmetic"), m_baseConfig.getString("headArmorOffsetPartPoint", "armorOffset")};
     m_chestArmorOffsetPoint = {m_baseConfig.getString("chestArmorOffsetPart", "chestCosmetic"), m_baseConfig.getString("chestArmorOffsetPartPoint", "armorOffset")};
@@ -957,12 +979,13 @@ List<Drawable> Humanoid::render(bool withItems, bool withRotationAndScale) {
     backArmFrameOffset += m_recoilOffset;
 
   if (m_useAnimation) {
-    m_networkedAnimator.resetLocalTransformationGroup("headRotation");
-    m_networkedAnimator.resetLocalTransformationGroup("bodyHeadRotation");
+    m_networkedAnimator.resetLocalTransformationGroup(m_headRotationGroup);
+    m_networkedAnimator.resetLocalTransformationGroup(m_bodyHeadRotationGroup);
     for (uint8_t i : fashion.wornBacks) {
       if (i == 0)
         break;
-      m_networkedAnimator.resetLocalTransformationGroup("backCosmetic" + toString(i) + "Rotation");
+      if (auto group = m_backCosmeticRotationGroups[size_t(i) - 1])
+        m_networkedAnimator.resetLocalTransformationGroup(*group);
     }
     if (m_headRotation != 0.f) {
       float dir = numericalDirection(m_facingDirection);
@@ -971,27 +994,30 @@ List<Drawable> Humanoid::render(bool withItems, bool withRotationAndScale) {
         -(state() == State::Run ? (fmaxf(headX, 0.f) * 2.f) : headX),
         -(fabsf(m_headRotation / ((float)Constants::pi * 4.f)))
       };
-      auto rotationCenter = jsonToVec2F(m_networkedAnimator.partProperty(m_headRotationPoint.first, m_headRotationPoint.second));
-      auto bodyHeadRotationCenter = networkedAnimator()->partTransformation(m_headRotationPoint.first).transformVec2(rotationCenter);
-      m_networkedAnimator.rotateLocalTransformationGroup("headRotation", m_headRotation * dir, rotationCenter);
-      m_networkedAnimator.translateLocalTransformationGroup("headRotation", translate);
-      m_networkedAnimator.rotateLocalTransformationGroup("bodyHeadRotation", m_headRotation * dir, rotationCenter);
-      m_networkedAnimator.translateLocalTransformationGroup("bodyHeadRotation", translate);
+      auto rotationCenter = jsonToVec2F(m_networkedAnimator.partProperty(m_headRotationPart, m_headRotationPoint.second));
+      auto bodyHeadRotationCenter = m_networkedAnimator.partTransformation(m_headRotationPart).transformVec2(rotationCenter);
+      m_networkedAnimator.rotateLocalTransformationGroup(m_headRotationGroup, m_headRotation * dir, rotationCenter);
+      m_networkedAnimator.translateLocalTransformationGroup(m_headRotationGroup, translate);
+      m_networkedAnimator.rotateLocalTransformationGroup(m_bodyHeadRotationGroup, m_headRotation * dir, rotationCenter);
+      m_networkedAnimator.translateLocalTransformationGroup(m_bodyHeadRotationGroup, translate);
       for (uint8_t i : fashion.wornBacks) {
         if (i == 0)
           break;
         auto& back = fashion.wearables[size_t(i) - 1].get<WornBack>();
-        if (back.rotateWithHead) {
-          m_networkedAnimator.rotateLocalTransformationGroup("backCosmetic" + toString(i) + "Rotation", m_headRotation * dir, bodyHeadRotationCenter);
-          m_networkedAnimator.translateLocalTransformationGroup("backCosmetic" + toString(i) + "Rotation", translate);
+        auto group = m_backCosmeticRotationGroups[size_t(i) - 1];
+        if (back.rotateWithHead && group) {
+          m_networkedAnimator.rotateLocalTransformationGroup(*group, m_headRotation * dir, bodyHeadRotationCenter);
+          m_networkedAnimator.translateLocalTransformationGroup(*group, translate);
         }
       }
     }
 
-    m_networkedAnimator.setPartDrawables(m_backItemPart, {});
-    m_networkedAnimator.resetLocalTransformationGroup("backArmRotation");
-    m_networkedAnimator.setPartDrawables(m_frontItemPart, {});
-    m_networkedAnimator.resetLocalTransformationGroup("frontArmRotation");
+    if (m_backItemPartHandle)
+      m_networkedAnimator.setPartDrawables(*m_backItemPartHandle, {});
+    m_networkedAnimator.resetLocalTransformationGroup(m_backArmRotationGroup);
+    if (m_frontItemPartHandle)
+      m_networkedAnimator.setPartDrawables(*m_frontItemPartHandle, {});
+    m_networkedAnimator.resetLocalTransformationGroup(m_frontArmRotationGroup);
 
     if (dance.isValid()) {
 
@@ -1004,8 +1030,8 @@ List<Drawable> Humanoid::render(bool withItems, bool withRotationAndScale) {
         m_networkedAnimator.setLocalTag("bodyDanceFrame");
       }
 
-      m_networkedAnimator.translateLocalTransformationGroup("backArmRotation", danceStep->backArmOffset / TilePixels);
-      m_networkedAnimator.rotateLocalTransformationGroup("backArmRotation", danceStep->backArmRotation);
+      m_networkedAnimator.translateLocalTransformationGroup(m_backArmRotationGroup, danceStep->backArmOffset / TilePixels);
+      m_networkedAnimator.rotateLocalTransformationGroup(m_backArmRotationGroup, danceStep->backArmRotation);
       if (danceStep->backArmFrame.isValid()) {
         auto danceFrame = danceStep->backArmFrame.value();
         m_networkedAnimator.setLocalTag("backArmDanceFrame", danceFrame);
@@ -1016,8 +1042,8 @@ List<Drawable> Humanoid::render(bool withItems, bool withRotationAndScale) {
       }
       m_networkedAnimator.setLocalState("backArm", "idle");
 
-      m_networkedAnimator.translateLocalTransformationGroup("frontArmRotation", danceStep->frontArmOffset / TilePixels);
-      m_networkedAnimator.rotateLocalTransformationGroup("frontArmRotation", danceStep->frontArmRotation);
+      m_networkedAnimator.translateLocalTransformationGroup(m_frontArmRotationGroup, danceStep->frontArmOffset / TilePixels);
+      m_networkedAnimator.rotateLocalTransformationGroup(m_frontArmRotationGroup, danceStep->frontArmRotation);
       if (danceStep->frontArmFrame.isValid()) {
         auto danceFrame = danceStep->frontArmFrame.value();
         m_networkedAnimator.setLocalTag("frontArmDanceFrame", danceFrame);
@@ -1034,17 +1060,17 @@ List<Drawable> Humanoid::render(bool withItems, bool withRotationAndScale) {
 
       m_networkedAnimator.setLocalState("backArmDance", "idle");
       m_networkedAnimator.setLocalTag("backArmDanceFrame");
-      m_networkedAnimator.rotateLocalTransformationGroup("backArmRotation",
+      m_networkedAnimator.rotateLocalTransformationGroup(m_backArmRotationGroup,
         backHand.angle,
-        jsonToVec2F(m_networkedAnimator.partProperty(m_backArmRotationPoint.first, m_backArmRotationPoint.second))
+        jsonToVec2F(m_networkedAnimator.partProperty(m_backArmRotationPart, m_backArmRotationPoint.second))
       );
       if (backHand.recoil)
-        m_networkedAnimator.translateLocalTransformationGroup("backArmRotation", m_recoilOffset);
+        m_networkedAnimator.translateLocalTransformationGroup(m_backArmRotationGroup, m_recoilOffset);
       if (backHand.holdingItem && withItems) {
         m_networkedAnimator.setLocalTag("backArmFrame", backHand.backFrame);
         m_networkedAnimator.setLocalState("backArm", m_networkedAnimator.hasState("backArm", backHand.backFrame) ? backHand.backFrame : "rotation");
-        if (!m_twoHanded)
-          m_networkedAnimator.setPartDrawables(m_backItemPart, backHand.itemDrawables);
+        if (!m_twoHanded && m_backItemPartHandle)
+          m_networkedAnimator.setPartDrawables(*m_backItemPartHandle, backHand.itemDrawables);
         m_networkedAnimator.setLocalState("backHandItem", backHand.outsideOfHand ? "outside" : "inside");
       } else {
         m_networkedAnimator.setLocalState("backArm", "idle");
@@ -1052,17 +1078,18 @@ List<Drawable> Humanoid::render(bool withItems, bool withRotationAndScale) {
 
       m_networkedAnimator.setLocalState("frontArmDance", "idle");
       m_networkedAnimator.setLocalTag("frontArmDanceFrame");
-      m_networkedAnimator.rotateLocalTransformationGroup("frontArmRotation",
+      m_networkedAnimator.rotateLocalTransformationGroup(m_frontArmRotationGroup,
         frontHand.angle,
-        jsonToVec2F(m_networkedAnimator.partProperty(m_frontArmRotationPoint.first, m_frontArmRotationPoint.second))
+        jsonToVec2F(m_networkedAnimator.partProperty(m_frontArmRotationPart, m_frontArmRotationPoint.second))
       );
       if (frontHand.recoil)
-        m_networkedAnimator.translateLocalTransformationGroup("frontArmRotation", m_recoilOffset);
+        m_networkedAnimator.translateLocalTransformationGroup(m_frontArmRotationGroup, m_recoilOffset);
       if (frontHand.holdingItem && withItems) {
         m_networkedAnimator.setLocalTag("frontArmFrame", frontHand.frontFrame);
         m_networkedAnimator.setLocalState("frontArm", m_networkedAnimator.hasState("frontArm", frontHand.frontFrame) ? frontHand.frontFrame : "rotation");
 
-        m_networkedAnimator.setPartDrawables(m_frontItemPart, frontHand.itemDrawables);
+        if (m_frontItemPartHandle)
+          m_networkedAnimator.setPartDrawables(*m_frontItemPartHandle, frontHand.itemDrawables);
         m_networkedAnimator.setLocalState("frontHandItem", frontHand.outsideOfHand ? "outside" : "inside");
       } else {
         m_networkedAnimator.setLocalState("frontArm", "idle");
@@ -1470,16 +1497,19 @@ List<Drawable> Humanoid::renderPortrait(PortraitMode mode) const {
   if (m_useAnimation) {
     auto portraitAnimator = m_networkedAnimator;
     portraitAnimator.setFlipped(false);
-    portraitAnimator.setPartDrawables(m_frontItemPart, {});
-    portraitAnimator.setPartDrawables(m_backItemPart, {});
-    portraitAnimator.resetLocalTransformationGroup("headRotation");
+    if (m_frontItemPartHandle)
+      portraitAnimator.setPartDrawables(*m_frontItemPartHandle, {});
+    if (m_backItemPartHandle)
+      portraitAnimator.setPartDrawables(*m_backItemPartHandle, {});
+    portraitAnimator.resetLocalTransformationGroup(m_headRotationGroup);
     for (uint8_t i : fashion.wornBacks) {
       if (i == 0)
         break;
-      portraitAnimator.resetLocalTransformationGroup("backCosmetic" + toString(i) + "Rotation");
+      if (auto group = m_backCosmeticRotationGroups[size_t(i) - 1])
+        portraitAnimator.resetLocalTransformationGroup(*group);
     }
-    portraitAnimator.resetLocalTransformationGroup("frontArmRotation");
-    portraitAnimator.resetLocalTransformationGroup("backArmRotation");
+    portraitAnimator.resetLocalTransformationGroup(m_frontArmRotationGroup);
+    portraitAnimator.resetLocalTransformationGroup(m_backArmRotationGroup);
     portraitAnimator.setLocalState("frontArm", "idle");
     portraitAnimator.setLocalState("backArm", "idle");
 
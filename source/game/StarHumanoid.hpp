@@ -474,6 +474,20 @@ private:
   String m_frontItemPart;
   String m_backItemPart;
 
+  // Resolved from the names above whenever the animator is created, since
+  // render() uses them every frame.
+  NetworkedAnimator::PartHandle m_headRotationPart;
+  NetworkedAnimator::PartHandle m_frontArmRotationPart;
+  NetworkedAnimator::PartHandle m_backArmRotationPart;
+  Maybe<NetworkedAnimator::PartHandle> m_frontItemPartHandle;
+  Maybe<NetworkedAnimator::PartHandle> m_backItemPartHandle;
+  NetworkedAnimator::TransformationGroupHandle m_headRotationGroup;
+  NetworkedAnimator::TransformationGroupHandle m_bodyHeadRotationGroup;
+  NetworkedAnimator::TransformationGroupHandle m_frontArmRotationGroup;
+  NetworkedAnimator::TransformationGroupHandle m_backArmRotationGroup;
+  // Indexed by wearable slot
+  Array<Maybe<NetworkedAnimator::TransformationGroupHandle>, 20> m_backCosmeticRotationGroups;
+
   pair<String, String> m_mouthOffsetPoint;
   pair<String, String> m_headArmorOffsetPoint;
   pair<String, String> m_chestArmorOffsetPoint;
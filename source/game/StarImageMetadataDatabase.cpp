@@ -7,10 +7,74 @@
 #include "StarGameTypes.hpp"
 #include "StarRoot.hpp"
 #include "StarAssets.hpp"
+#include "StarPackedAssetSource.hpp"
+#include "StarCasting.hpp"
 
 namespace Star {
 
+namespace {
+  // Image spaces of an image of the given size, where occupied(x, y) says
+  // whether a pixel is non-transparent.
+  template <typename OccupiedFunction>
+  List<Vec2I> calculateImageSpaces(Vec2U size, OccupiedFunction occupied, Vec2F position, float fillLimit, bool flip) {
+    int imageWidth = size[0];
+    int imageHeight = size[1];
+
+    Vec2I min((position / TilePixels).floor());
+    Vec2I max(((Vec2F(imageWidth, imageHeight) + position) / TilePixels).ceil());
+
+    List<Vec2I> spaces;
+
+    for (int yspace = min[1]; yspace < max[1]; ++yspace) {
+      for (int xspace = min[0]; xspace < max[0]; ++xspace) {
+        float fillRatio = 0.0f;
+
+        for (int y = 0; y < (int)TilePixels; ++y) {
+          int ypixel = round(yspace * (int)TilePixels + y - position[1]);
+          if (ypixel < 0 || ypixel >= imageHeight)
+            continue;
+
+          for (int x = 0; x < (int)TilePixels; ++x) {
+            int xpixel = round(xspace * (int)TilePixels + x - position[0]);
+            if (flip)
+              xpixel = imageWidth - 1 - xpixel;
+
+            if (xpixel < 0 || xpixel >= imageWidth)
+              continue;
+
+            if (occupied(xpixel, ypixel))
+              fillRatio += 1.0f / square(TilePixels);
+          }
+        }
+
+        if (fillRatio >= fillLimit)
+          spaces.append(Vec2I(xspace, yspace));
+      }
+    }
+
+    return spaces;
+  }
+}
+
 ImageMetadataDatabase::ImageMetadataDatabase() {
+  auto assets = Root::singleton().assets();
+  for (auto const& path : assets->scanExtension("png")) {
+    auto descriptor = assets->assetDescriptor(path);
+    // Patched images no longer match what was indexed
+    if (!descriptor || !descriptor->patchSources.empty())
+      continue;
+    auto packedSource = as<PackedAssetSource>(descriptor->source);
+    if (!packedSource)
+      continue;
+    if (auto index = packedSource->imageMetadataIndex()) {
+      if (auto image = index->image(descriptor->sourceName)) {
+        m_indexedImages.add(path, IndexedImage{index.get(), image});
+        if (!m_imageIndexes.contains(index))
+          m_imageIndexes.append(index);
+      }
+    }
+  }
+
   MutexLocker locker(m_mutex);
   int timeSmear = 2000;
   int64_t timeToLive = 60000;
@@ -23,6 +87,9 @@ ImageMetadataDatabase::ImageMetadataDatabase() {
 }
 
 Vec2U ImageMetadataDatabase::imageSize(AssetPath const& path) const {
+  if (auto indexed = indexedImage(path))
+    return indexed->rect.size();
+
   MutexLocker locker(m_mutex);
   if (auto cached = m_sizeCache.ptr(path))
     return *cached;
@@ -53,40 +120,17 @@ List<Vec2I> ImageMetadataDatabase::imageSpaces(AssetPath const& path, Vec2F posi
 
   locker.unlock();
 
-  auto image = Root::singleton().assets()->image(filteredPath);
-  int imageWidth = image->width();
-  int imageHeight = image->height();
-
-  Vec2I min((position / TilePixels).floor());
-  Vec2I max(((Vec2F(imageWidth, imageHeight) + position) / TilePixels).ceil());
-
   List<Vec2I> spaces;
-
-  for (int yspace = min[1]; yspace < max[1]; ++yspace) {
-    for (int xspace = min[0]; xspace < max[0]; ++xspace) {
-      float fillRatio = 0.0f;
-
-      for (int y = 0; y < (int)TilePixels; ++y) {
-        int ypixel = round(yspace * (int)TilePixels + y - position[1]);
-        if (ypixel < 0 || ypixel >= imageHeight)
-          continue;
-
-        for (int x = 0; x < (int)TilePixels; ++x) {
-          int xpixel = round(xspace * (int)TilePixels + x - position[0]);
-          if (flip)
-            xpixel = imageWidth - 1 - xpixel;
-
-          if (xpixel < 0 || xpixel >= imageWidth)
-            continue;
-
-          if (image->get(xpixel, ypixel)[3] > 0)
-            fillRatio += 1.0f / square(TilePixels);
-        }
-      }
-
-      if (fillRatio >= fillLimit)
-        spaces.append(Vec2I(xspace, yspace));
-    }
+  if (auto indexed = indexedImage(filteredPath)) {
+    auto occupancy = indexed->image.index->occupancy(*indexed->image.image);
+    spaces = calculateImageSpaces(indexed->rect.size(), [&occupancy, min = indexed->rect.min()](int x, int y) {
+        return occupancy.occupied(min[0] + x, min[1] + y);
+      }, position, fillLimit, flip);
+  } else {
+    auto image = Root::singleton().assets()->image(filteredPath);
+    spaces = calculateImageSpaces(image->size(), [&image](int x, int y) {
+        return image->get(x, y)[3] > 0;
+      }, position, fillLimit, flip);
   }
 
   locker.lock();
@@ -97,25 +141,33 @@ List<Vec2I> ImageMetadataDatabase::imageSpaces(AssetPath const& path, Vec2F posi
 }
 
 RectU ImageMetadataDatabase::nonEmptyRegion(AssetPath const& path) const {
+  auto filteredPath = filterProcessing(path);
+  auto indexed = indexedImage(filteredPath);
+  if (indexed && indexed->rect.size() == indexed->image.image->size)
+    return indexed->image.image->nonEmptyRegion;
+
   MutexLocker locker(m_mutex);
-  
+
   if (auto cached = m_regionCache.ptr(path)) {
     return *cached;
   }
 
-  auto filteredPath = filterProcessing(path);
   if (auto cached = m_regionCache.ptr(filteredPath)) {
     m_regionCache.set(path, *cached);
     return *cached;
   }
 
   locker.unlock();
-  auto image = Root::singleton().assets()->image(filteredPath);
   RectU region = RectU::null();
-  image->forEachPixel([&region](unsigned x, unsigned y, Vec4B const& pixel) {
-    if (pixel[3] > 0)
-      region.combine(RectU::withSize({x, y}, {1, 1}));
-  });
+  if (indexed) {
+    region = indexed->image.index->occupancy(*indexed->image.image).nonEmptySubRegion(indexed->rect);
+  } else {
+    auto image = Root::singleton().assets()->image(filteredPath);
+    image->forEachPixel([&region](unsigned x, unsigned y, Vec4B const& pixel) {
+      if (pixel[3] > 0)
+        region.combine(RectU::withSize({x, y}, {1, 1}));
+    });
+  }
 
   locker.lock();
   m_regionCache.set(path, region);
@@ -155,6 +207,29 @@ AssetPath ImageMetadataDatabase::filterProcessing(AssetPath const& path) {
   return newPath;
 }
 
+auto ImageMetadataDatabase::indexedImage(AssetPath const& path) const -> Maybe<IndexedFrame> {
+  if (!path.directives.empty())
+    return {};
+
+  auto indexed = m_indexedImages.ptr(path.basePath);
+  if (!indexed)
+    return {};
+
+  auto image = indexed->image;
+  if (!path.subPath)
+    return IndexedFrame{*indexed, RectU(Vec2U(), image->size)};
+
+  auto frames = Root::singleton().assets()->imageFrames(path.basePath);
+  if (!frames)
+    return {};
+  auto frameRect = frames->getRect(*path.subPath);
+  if (!frameRect || frameRect->xMax() > image->size[0] || frameRect->yMax() > image->size[1])
+    return {};
+
+  // Frame specifications use top down image coordinates
+  return IndexedFrame{*indexed, RectU::withSize(Vec2U(frameRect->xMin(), image->size[1] - frameRect->yMax()), frameRect->size())};
+}
+
 Vec2U ImageMetadataDatabase::calculateImageSize(AssetPath const& path) const {
   // Carefully calculate an image's size while trying not to actually load it.
   // In error cases, this will fall back to calling Assets::image, so that image
@@ -180,6 +255,8 @@ Vec2U ImageMetadataDatabase::calculateImageSize(AssetPath const& path) const {
       imageSize = rect->size();
     else
       return fallback();
+  } else if (auto indexed = m_indexedImages.ptr(path.basePath)) {
+    imageSize = indexed->image->size;
   } else {
     // We ensure that the base image size is cached even when given directives,
     // so we don't have to call Image::readPngMetadata on the same file more
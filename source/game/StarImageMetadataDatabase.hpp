@@ -6,6 +6,7 @@
 #include "StarThread.hpp"
 #include "StarAssetPath.hpp"
 #include "StarTtlCache.hpp"
+#include "StarImageMetadataIndex.hpp"
 
 namespace Star {
 
@@ -14,6 +15,12 @@ STAR_CLASS(ImageMetadataDatabase);
 // Caches image size, image spaces, and nonEmptyRegion completely until a
 // reload, does not expire cached values in a TTL based way like Assets,
 // because they are expensive to compute and cheap to keep around.
+//
+// Images that come unpatched from a packed asset file with an image metadata
+// index are answered from the index without decoding the image.  Sizes and
+// whole image non-empty regions are answered straight from it without taking
+// the cache lock, image spaces and frame regions are calculated from the
+// occupancy read from the index and cached like any other.
 class ImageMetadataDatabase {
 public:
   ImageMetadataDatabase();
@@ -27,11 +34,30 @@ private:
   // non-empty regions.
   static AssetPath filterProcessing(AssetPath const& path);
 
+  struct IndexedImage {
+    ImageMetadataIndex const* index;
+    ImageMetadataIndex::ImageMetadata const* image;
+  };
+
+  struct IndexedFrame {
+    IndexedImage image;
+    // The rect of the path's frame within the image.
+    RectU rect;
+  };
+
+  // The indexed metadata for the base image of the path and its frame, if the
+  // image is indexed and the path has no directives.
+  Maybe<IndexedFrame> indexedImage(AssetPath const& path) const;
+
   Vec2U calculateImageSize(AssetPath const& path) const;
 
   // Path, position, fillLimit, and flip
   typedef tuple<AssetPath, Vec2I, float, bool> SpacesEntry;
 
+  // Never changed after construction.
+  CaseInsensitiveStringMap<IndexedImage> m_indexedImages;
+  List<ImageMetadataIndexConstPtr> m_imageIndexes;
+
   mutable Mutex m_mutex;
   mutable HashTtlCache<AssetPath, Vec2U> m_sizeCache;
   mutable HashTtlCache<SpacesEntry, List<Vec2I>> m_spacesCache;
@@ -143,12 +143,32 @@ ItemDatabase::ItemDatabase()
 }
 
 void ItemDatabase::cleanup() {
-  {
-    MutexLocker locker(m_cacheMutex);
-    m_itemCache.cleanup([](ItemCacheEntry const&, ItemPtr const& item) {
+  for (auto& shard : m_itemCacheShards) {
+    MutexLocker locker(shard.mutex);
+    shard.items.cleanup([](ItemCacheEntry const&, ItemPtr const& item) {
       return !item.unique();
     });
   }
+
+  for (auto& shard : m_prototypeShards) {
+    WriteLocker locker(shard.mutex);
+    eraseWhere(shard.prototypes, [](auto& pair) {
+        if (!pair.second.config.unique()) {
+          pair.second.unused = false;
+          return false;
+        }
+        if (pair.second.unused)
+          return true;
+        pair.second.unused = true;
+        return false;
+      });
+  }
+}
+
+bool ItemDatabase::hasCachedPrototype(String const& itemName) const {
+  auto& shard = m_prototypeShards[hash<String>()(itemName) % CacheShardCount];
+  ReadLocker locker(shard.mutex);
+  return shard.prototypes.contains(itemName);
 }
 
 ItemPtr ItemDatabase::diskLoad(Json const& diskStore) const {
@@ -197,10 +217,8 @@ ItemDatabase::ItemConfig ItemDatabase::itemConfig(String const& itemName, Json p
   auto const& data = itemData(itemName);
 
   ItemConfig itemConfig;
-  if (data.assetsConfig)
-    itemConfig.config = Root::singleton().assets()->json(*data.assetsConfig);
+  itemConfig.config = itemPrototype(itemName);
   itemConfig.directory = data.directory;
-  itemConfig.config = jsonMerge(itemConfig.config, data.customConfig);
   itemConfig.parameters = parameters;
 
   if (auto builder = itemConfig.config.optString("builder")) {
@@ -228,18 +246,19 @@ ItemPtr ItemDatabase::itemShared(ItemDescriptor descriptor, Maybe<float> level,
     return {};
 
   ItemCacheEntry entry{ descriptor, level, seed };
-  MutexLocker locker(m_cacheMutex);
-  if (ItemPtr* cached = m_itemCache.ptr(entry))
-    return *cached;
-  else {
-    locker.unlock();
+  {
+    auto& shard = m_itemCacheShards[hash<ItemCacheEntry>()(entry) % CacheShardCount];
+    MutexLocker locker(shard.mutex);
+    if (ItemPtr* cached = shard.items.ptr(entry))
+      return *cached;
+  }
 
-    ItemPtr item = tryCreateItem(descriptor, level, seed);
-    get<2>(entry) = item->parameters().optUInt("seed"); // Seed could've been changed by the buildscript
+  ItemPtr item = tryCreateItem(descriptor, level, seed);
+  get<2>(entry) = item->parameters().optUInt("seed"); // Seed could've been changed by the buildscript
 
-    locker.lock();
-    return m_itemCache.get(entry, [&](ItemCacheEntry const&) -> ItemPtr { return std::move(item); });
-  }
+  auto& shard = m_itemCacheShards[hash<ItemCacheEntry>()(entry) % CacheShardCount];
+  MutexLocker locker(shard.mutex);
+  return shard.items.get(entry, [&](ItemCacheEntry const&) -> ItemPtr { return std::move(item); });
 }
 
 ItemPtr ItemDatabase::item(ItemDescriptor descriptor, Maybe<float> level, Maybe<uint64_t> seed, bool ignoreInvalid) const {
@@ -557,6 +576,24 @@ ItemDatabase::ItemData const& ItemDatabase::itemData(String const& name) const {
   throw ItemException::format("No such item '{}'", name);
 }
 
+Json ItemDatabase::itemPrototype(String const& name) const {
+  auto& shard = m_prototypeShards[hash<String>()(name) % CacheShardCount];
+  {
+    ReadLocker locker(shard.mutex);
+    if (auto prototype = shard.prototypes.ptr(name))
+      return prototype->config;
+  }
+
+  auto const& data = itemData(name);
+  Json prototype;
+  if (data.assetsConfig)
+    prototype = Root::singleton().assets()->json(*data.assetsConfig);
+  prototype = jsonMerge(prototype, data.customConfig);
+
+  WriteLocker locker(shard.mutex);
+  return shard.prototypes.insert(name, Prototype{std::move(prototype)}).first->second.config;
+}
+
 ItemRecipe ItemDatabase::makeRecipe(List<ItemDescriptor> inputs, ItemDescriptor output, float duration, StringSet groups) const {
   ItemRecipe res;
   res.inputs = std::move(inputs);
@@ -75,8 +75,13 @@ public:
 
   ItemDatabase();
 
+  // Drops shared items that are no longer in use, and the merged config
+  // prototypes that no item has shared since the previous cleanup.
   void cleanup();
 
+  // Is the merged config for the given item name currently held for sharing?
+  bool hasCachedPrototype(String const& itemName) const;
+
   // Load an item based on item descriptor.  If loadItem is called with a
   // live ptr, and the ptr matches the descriptor read, then no new item is
   // constructed.  If ItemT is some other type than Item, then loadItem will
@@ -166,6 +171,11 @@ private:
   ItemPtr tryCreateItem(ItemDescriptor const& descriptor, Maybe<float> level = {}, Maybe<uint64_t> seed = {}, bool ignoreInvalid = false) const;
 
   ItemData const& itemData(String const& name) const;
+  // The asset config of the given item merged with its custom config.  Built
+  // once per item and shared by every item of that name that is not
+  // rebuilt by a builder script, items only carry their own parameters.
+  // Dropped again by cleanup once no item has shared it for a while.
+  Json itemPrototype(String const& name) const;
   ItemRecipe makeRecipe(List<ItemDescriptor> inputs, ItemDescriptor output, float duration, StringSet groups) const;
 
   void addItemSet(ItemType type, String const& extension);
@@ -186,8 +196,29 @@ private:
 
   typedef tuple<ItemDescriptor, Maybe<float>, Maybe<uint64_t>> ItemCacheEntry;
 
-  mutable Mutex m_cacheMutex;
-  mutable HashTtlCache<ItemCacheEntry, ItemPtr> m_itemCache;
+  // Prototypes and shared items are split into shards by hash, each with its
+  // own lock, so that threads looking up different items do not contend.
+  static size_t const CacheShardCount = 16;
+
+  struct Prototype {
+    Json config;
+    // Set by cleanup when only the shard held the config, the prototype is
+    // dropped if that is still the case on the next cleanup.
+    bool unused = false;
+  };
+
+  struct PrototypeShard {
+    ReadersWriterMutex mutex;
+    StringMap<Prototype> prototypes;
+  };
+
+  struct ItemCacheShard {
+    Mutex mutex;
+    HashTtlCache<ItemCacheEntry, ItemPtr> items;
+  };
+
+  mutable Array<PrototypeShard, CacheShardCount> m_prototypeShards;
+  mutable Array<ItemCacheShard, CacheShardCount> m_itemCacheShards;
 };
 
 template <typename ItemT>
@@ -327,6 +327,9 @@ bool ItemDrop::shouldDestroy() const {
 }
 
 void ItemDrop::render(RenderCallback* renderCallback) {
+  if (!renderCallback->drawablesWanted())
+    return;
+
   if (m_mode.get() != Mode::Taken && m_drawRarityBeam) {
     Color beamColor;
     switch (m_item->rarity()) {
@@ -404,7 +407,7 @@ void ItemDrop::setIntangibleTime(float intangibleTime) {
 bool ItemDrop::canTake() const {
   if (m_mode.get() == Mode::Available && m_owningEntity.get() == NullEntityId && !m_item->empty()) {
     if (isMaster())
-      if (auto res = m_scriptComponent.invoke<bool>("canTake"))
+      if (auto res = m_scriptComponent.invoke<bool>(m_canTakeFunction))
         return *res;
     return true;
   }
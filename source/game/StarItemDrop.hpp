@@ -143,6 +143,7 @@ private:
   ClientEntityMode m_clientEntityMode;
   
   mutable LuaMessageHandlingComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>> m_scriptComponent;
+  mutable LuaBaseComponent::FunctionHandle m_canTakeFunction{"canTake"};
   Maybe<Mode> m_overrideMode;
 };
 
@@ -0,0 +1,119 @@
+#include "StarLightLevelCache.hpp"
+#include "StarInterpolation.hpp"
+
+namespace Star {
+
+LightLevelCache::LightLevelCache(WorldGeometry const& geometry, Json const& lightingConfig, CellSetter cellSetter, LightHasher lightHasher)
+  : m_geometry(geometry), m_cellSetter(std::move(cellSetter)), m_lightHasher(std::move(lightHasher)) {
+  m_calculator.setParameters(lightingConfig);
+  m_invalidationRange = (int)m_calculator.borderCells() + 1;
+  m_stalenessBudget = 0.0;
+  m_currentTime = 0.0;
+}
+
+double LightLevelCache::stalenessBudget() const {
+  return m_stalenessBudget;
+}
+
+void LightLevelCache::setStalenessBudget(double stalenessBudget) {
+  m_stalenessBudget = stalenessBudget;
+  if (m_stalenessBudget <= 0.0)
+    m_sectors.clear();
+}
+
+void LightLevelCache::update(double currentTime) {
+  m_currentTime = currentTime;
+  eraseWhere(m_sectors, [this](auto const& pair) {
+      return m_currentTime - pair.second.calculatedAt >= m_stalenessBudget
+          || m_lightHasher(pair.second.calculationRegion) != pair.second.lightHash;
+    });
+}
+
+float LightLevelCache::lightLevel(Vec2F const& position) {
+  if (position[1] < 0 || position[1] >= m_geometry.height())
+    return 0;
+
+  // tileEach can't handle rects that are WAY out of range.
+  Vec2F pos = m_geometry.xwrap(position);
+
+  if (m_stalenessBudget <= 0.0) {
+    m_calculator.begin(pos);
+    m_cellSetter(m_calculator);
+    return m_calculator.calculate();
+  }
+
+  Vec2I sector = Vec2I::floor(pos / (float)SectorSize);
+  auto const& cached = cachedSector(sector);
+
+  Vec2I cell = Vec2I::floor(pos - Vec2F::filled(0.5f));
+  Vec2S index = Vec2S(cell - sectorRegion(sector).min());
+
+  float ll = cached.light(index[0], index[1]);
+  float lr = cached.light(index[0] + 1, index[1]);
+  float ul = cached.light(index[0], index[1] + 1);
+  float ur = cached.light(index[0] + 1, index[1] + 1);
+
+  float xl = pos[0] - 0.5f - cell[0];
+  float yl = pos[1] - 0.5f - cell[1];
+
+  return lerp(yl, lerp(xl, ll, lr), lerp(xl, ul, ur));
+}
+
+List<float> LightLevelCache::lightLevels(List<Vec2F> const& positions) {
+  List<float> levels;
+  levels.reserve(positions.size());
+  for (auto const& position : positions)
+    levels.append(lightLevel(position));
+  return levels;
+}
+
+void LightLevelCache::invalidate(RectI const& region) {
+  if (m_sectors.empty())
+    return;
+
+  for (auto const& split : m_geometry.splitRect(region.padded(m_invalidationRange))) {
+    Vec2I minSector = Vec2I::floor(Vec2F(split.min()) / (float)SectorSize);
+    Vec2I maxSector = Vec2I::floor(Vec2F(split.max() - Vec2I(1, 1)) / (float)SectorSize);
+    for (int x = minSector[0]; x <= maxSector[0]; ++x) {
+      for (int y = minSector[1]; y <= maxSector[1]; ++y)
+        m_sectors.remove({x, y});
+    }
+  }
+}
+
+void LightLevelCache::clear() {
+  m_sectors.clear();
+}
+
+size_t LightLevelCache::cachedSectorCount() const {
+  return m_sectors.size();
+}
+
+RectI LightLevelCache::sectorRegion(Vec2I const& sector) {
+  return RectI::withSize(sector * SectorSize, Vec2I::filled(SectorSize)).padded(1);
+}
+
+auto LightLevelCache::cachedSector(Vec2I const& sector) -> CachedSector const& {
+  if (auto cached = m_sectors.ptr(sector)) {
+    if (m_currentTime - cached->calculatedAt < m_stalenessBudget)
+      return *cached;
+  }
+
+  RectI region = sectorRegion(sector);
+  m_calculator.beginRegion(region);
+  m_cellSetter(m_calculator);
+  m_calculator.calculateRegion();
+
+  auto& cached = m_sectors[sector];
+  cached.calculatedAt = m_currentTime;
+  cached.calculationRegion = m_calculator.calculationRegion();
+  cached.lightHash = m_lightHasher(cached.calculationRegion);
+  cached.light.resize(Array2S(region.size()));
+  for (int x = 0; x < region.width(); ++x) {
+    for (int y = 0; y < region.height(); ++y)
+      cached.light(x, y) = m_calculator.getLight(region.min() + Vec2I(x, y));
+  }
+  return cached;
+}
+
+}
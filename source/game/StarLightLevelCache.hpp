@@ -0,0 +1,77 @@
+#pragma once
+
+#include "StarCellularLighting.hpp"
+#include "StarWorldGeometry.hpp"
+#include "StarMultiArray.hpp"
+#include "StarGameTypes.hpp"
+
+namespace Star {
+
+STAR_CLASS(LightLevelCache);
+
+// Answers light level queries from scalar light levels cached for a whole
+// sector at a time, by interpolating between cached cells rather than running
+// the light spread calculation once for every query.  Sectors are calculated
+// on their first query, and again once they have been invalidated by a tile
+// change nearby, once the light sources or environment light they were
+// calculated with have changed, or once they are older than the staleness
+// budget.
+class LightLevelCache {
+public:
+  // Sets the cells and light sources of the calculation region of an already
+  // begun calculation.
+  typedef function<void(CellularLightIntensityCalculator&)> CellSetter;
+  // Hashes the inputs other than tiles that light in the given calculation
+  // region depends on, such as its light sources and the environment light.
+  typedef function<size_t(RectI const&)> LightHasher;
+
+  static int const SectorSize = WorldSectorSize;
+
+  LightLevelCache(WorldGeometry const& geometry, Json const& lightingConfig, CellSetter cellSetter, LightHasher lightHasher);
+
+  // Sectors that were calculated more than this many seconds ago are
+  // calculated again on their next query.  If zero, nothing is cached and
+  // every query runs its own calculation.
+  double stalenessBudget() const;
+  void setStalenessBudget(double stalenessBudget);
+
+  // Sets the current time used for the staleness budget, and drops sectors
+  // that are past it or whose light hash has changed.
+  void update(double currentTime);
+
+  float lightLevel(Vec2F const& position);
+  List<float> lightLevels(List<Vec2F> const& positions);
+
+  // Drops every cached sector that changes to the tiles in the given region
+  // could light differently.
+  void invalidate(RectI const& region);
+  void clear();
+
+  size_t cachedSectorCount() const;
+
+private:
+  struct CachedSector {
+    double calculatedAt;
+    RectI calculationRegion;
+    size_t lightHash;
+    // Light in every cell of the sector and in a one cell border around it,
+    // so that any position in the sector can be interpolated.
+    MultiArray<float, 2> light;
+  };
+
+  static RectI sectorRegion(Vec2I const& sector);
+
+  CachedSector const& cachedSector(Vec2I const& sector);
+
+  WorldGeometry m_geometry;
+  CellSetter m_cellSetter;
+  LightHasher m_lightHasher;
+  CellularLightIntensityCalculator m_calculator;
+  int m_invalidationRange;
+
+  double m_stalenessBudget;
+  double m_currentTime;
+  HashMap<Vec2I, CachedSector> m_sectors;
+};
+
+}
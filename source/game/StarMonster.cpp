@@ -22,6 +22,13 @@
 
 namespace Star {
 
+namespace {
+  // Read every tick, so looked up by id rather than by name
+  StatId const HealthResource = *internStatName("health");
+  StatId const InvulnerableStat = *internStatName("invulnerable");
+  StatId const PowerMultiplierStat = *internStatName("powerMultiplier");
+}
+
 Monster::Monster(MonsterVariant const& monsterVariant, Maybe<float> level) {
   m_monsterLevel = level;
 
@@ -51,6 +58,7 @@ Monster::Monster(MonsterVariant const& monsterVariant, Maybe<float> level) {
 
   m_scriptComponent.setScripts(m_monsterVariant.parameters.optArray("scripts").apply(jsonToStringList).value(m_monsterVariant.scripts));
   m_scriptComponent.setUpdateDelta(m_monsterVariant.initialScriptDelta);
+  m_scriptComponent.setUpdateLodEnabled(m_monsterVariant.parameters.getBool("scriptUpdateLod", true));
 
   auto movementParameters = ActorMovementParameters::sensibleDefaults().merge(ActorMovementParameters(monsterVariant.movementSettings));
   if (movementParameters.standingPoly)
@@ -235,7 +243,7 @@ String Monster::description() const {
 }
 
 Maybe<HitType> Monster::queryHit(DamageSource const& source) const {
-  if (!inWorld() || m_knockedOut || m_statusController->statPositive("invulnerable"))
+  if (!inWorld() || m_knockedOut || m_statusController->statPositive(InvulnerableStat))
     return {};
 
   if (source.intersectsWithPoly(world()->geometry(), hitPoly().get()))
@@ -270,7 +278,7 @@ List<DamageNotification> Monster::applyDamage(DamageRequest const& damage) {
       });
   }
 
-  if (!m_statusController->resourcePositive("health"))
+  if (!m_statusController->resourcePositive(HealthResource))
     m_deathDamageSourceKinds.add(damage.damageSourceKind);
 
   return notifications;
@@ -280,6 +288,11 @@ List<DamageNotification> Monster::selfDamageNotifications() {
   return m_statusController->pullSelfDamageNotifications();
 }
 
+bool Monster::hasDamageSources() const {
+  // Self damage notifications are pulled from the status controller every step.
+  return true;
+}
+
 List<DamageSource> Monster::damageSources() const {
   List<DamageSource> damageSources = m_damageSources.get();
 
@@ -288,7 +301,7 @@ List<DamageSource> Monster::damageSources() const {
     DamageSource damageSource(m_monsterVariant.touchDamageConfig);
     if (auto damagePoly = damageSource.damageArea.ptr<PolyF>())
       damagePoly->rotate(m_movementController->rotation());
-    damageSource.damage *= m_monsterVariant.touchDamageMultiplier * levelPowerMultiplier * m_statusController->stat("powerMultiplier");
+    damageSource.damage *= m_monsterVariant.touchDamageMultiplier * levelPowerMultiplier * m_statusController->stat(PowerMultiplierStat);
     damageSource.sourceEntityId = entityId();
     damageSource.team = getTeam();
     damageSources.append(damageSource);
@@ -301,7 +314,7 @@ List<DamageSource> Monster::damageSources() const {
 
     String anchorPart = pair.second.getString("anchorPart");
     DamageSource ds = DamageSource(pair.second.get("damageSource"));
-    ds.damage *= levelPowerMultiplier * m_statusController->stat("powerMultiplier");
+    ds.damage *= levelPowerMultiplier * m_statusController->stat(PowerMultiplierStat);
     ds.damageArea.call([this,&anchorPart](auto& poly) {
       poly.transform(m_networkedAnimator.partTransformation(anchorPart));
       if (m_networkedAnimator.flipped())
@@ -355,9 +368,9 @@ List<DamageSource> Monster::damageSources() const {
 }
 
 bool Monster::shouldDie() {
-  if (auto res = m_scriptComponent.invoke<bool>("shouldDie"))
+  if (auto res = m_scriptComponent.invoke<bool>(m_shouldDieFunction))
     return *res;
-  else if (!m_statusController->resourcePositive("health") || m_scriptComponent.error())
+  else if (!m_statusController->resourcePositive(HealthResource) || m_scriptComponent.error())
     return true;
   else
     return false;
@@ -491,23 +504,29 @@ void Monster::update(float dt, uint64_t) {
 }
 
 void Monster::render(RenderCallback* renderCallback) {
-  for (auto& drawable : m_networkedAnimator.drawables(position())) {
-    if (drawable.isImage())
-      drawable.imagePart().addDirectivesGroup(m_statusController->parentDirectives(), true);
-    renderCallback->addDrawable(std::move(drawable), m_monsterVariant.renderLayer);
+  bool drawablesWanted = renderCallback->drawablesWanted();
+  if (drawablesWanted) {
+    for (auto& drawable : m_networkedAnimator.drawables(position())) {
+      if (drawable.isImage())
+        drawable.imagePart().addDirectivesGroup(m_statusController->parentDirectives(), true);
+      renderCallback->addDrawable(std::move(drawable), m_monsterVariant.renderLayer);
+    }
   }
 
   renderCallback->addAudios(m_networkedAnimatorDynamicTarget.pullNewAudios());
   renderCallback->addParticles(m_networkedAnimatorDynamicTarget.pullNewParticles());
 
-  renderCallback->addDrawables(m_statusController->drawables(), m_monsterVariant.renderLayer);
+  if (drawablesWanted)
+    renderCallback->addDrawables(m_statusController->drawables(), m_monsterVariant.renderLayer);
   renderCallback->addParticles(m_statusController->pullNewParticles());
   renderCallback->addAudios(m_statusController->pullNewAudios());
 
   m_effectEmitter.render(renderCallback);
 
-  for (auto drawablePair : m_scriptedAnimator.drawables())
-    renderCallback->addDrawable(drawablePair.first, drawablePair.second.value(m_monsterVariant.renderLayer));
+  if (drawablesWanted) {
+    for (auto drawablePair : m_scriptedAnimator.drawables())
+      renderCallback->addDrawable(drawablePair.first, drawablePair.second.value(m_monsterVariant.renderLayer));
+  }
   renderCallback->addAudios(m_scriptedAnimator.pullNewAudios());
   renderCallback->addParticles(m_scriptedAnimator.pullNewParticles());
 }
@@ -534,7 +553,7 @@ float Monster::maxHealth() const {
 }
 
 float Monster::health() const {
-  return m_statusController->resource("health");
+  return m_statusController->resource(HealthResource);
 }
 
 DamageBarType Monster::damageBar() const {
@@ -834,6 +853,10 @@ Maybe<LuaValue> Monster::evalScript(String const& code) {
   return m_scriptComponent.eval(code);
 }
 
+void Monster::setScriptUpdateDeltaScale(unsigned scale) {
+  m_scriptComponent.setUpdateDeltaScale(scale);
+}
+
 Vec2F Monster::mouthPosition() const {
   return mouthOffset() + position();
 }
@@ -851,7 +874,7 @@ List<PhysicsForceRegion> Monster::forceRegions() const {
 }
 
 InteractAction Monster::interact(InteractRequest const& request) {
-  auto result = m_scriptComponent.invoke<Json>("interact", JsonObject{{"sourceId", request.sourceId}, {"sourcePosition", jsonFromVec2F(request.sourcePosition)}}).value();
+  auto result = m_scriptComponent.invoke<Json>(m_interactFunction, JsonObject{{"sourceId", request.sourceId}, {"sourcePosition", jsonFromVec2F(request.sourcePosition)}}).value();
 
   if (result.isNull())
     return {};
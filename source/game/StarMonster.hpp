@@ -83,6 +83,7 @@ public:
   List<DamageNotification> selfDamageNotifications() override;
 
   List<DamageSource> damageSources() const override;
+  bool hasDamageSources() const override;
 
   bool shouldDie();
   void knockout();
@@ -121,6 +122,7 @@ public:
 
   Maybe<LuaValue> callScript(String const& func, LuaVariadic<LuaValue> const& args) override;
   Maybe<LuaValue> evalScript(String const& code) override;
+  void setScriptUpdateDeltaScale(unsigned scale) override;
 
   virtual Vec2F mouthPosition() const override;
   virtual Vec2F mouthPosition(bool ignoreAdjustments) const override;
@@ -184,6 +186,8 @@ private:
 
   List<BehaviorStatePtr> m_behaviors;
   mutable LuaMessageHandlingComponent<LuaStorableComponent<LuaActorMovementComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>>>> m_scriptComponent;
+  mutable LuaBaseComponent::FunctionHandle m_shouldDieFunction{"shouldDie"};
+  LuaBaseComponent::FunctionHandle m_interactFunction{"interact"};
   LuaAnimationComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>> m_scriptedAnimator;
 
   NetElementData<List<PhysicsForceRegion>> m_physicsForces;
@@ -71,7 +71,9 @@ NetworkedAnimator::NetworkedAnimator() {
   m_flippedRelativeCenterLine.set(0.0f);
   m_animationRate.set(1.0f);
   m_animatorVersion = 0;
+  m_tagsVersion = 0;
   setupNetStates();
+  setupHandles();
 }
 
 NetworkedAnimator::NetworkedAnimator(Json config, String relativePath) : NetworkedAnimator() {
@@ -238,7 +240,12 @@ NetworkedAnimator::NetworkedAnimator(Json config, String relativePath) : Network
 
   m_stateInfo.sortByKey();
 
+  size_t partCount = m_animatedParts.constParts().size();
+  m_partDrawables.resize(partCount);
+  m_resolvedParts.resize(partCount);
+
   setupNetStates();
+  setupHandles();
 }
 
 NetworkedAnimator::NetworkedAnimator(NetworkedAnimator&& animator) {
@@ -266,11 +273,13 @@ NetworkedAnimator& NetworkedAnimator::operator=(NetworkedAnimator&& animator) {
   m_animationRate = std::move(animator.m_animationRate);
   m_globalTags = std::move(animator.m_globalTags);
   m_partTags = std::move(animator.m_partTags);
-  m_cachedPartDrawables = std::move(animator.m_cachedPartDrawables);
   m_partDrawables = std::move(animator.m_partDrawables);
+  m_resolvedParts = std::move(animator.m_resolvedParts);
   m_localTags = std::move(animator.m_localTags);
+  m_tagsVersion = animator.m_tagsVersion;
   m_animatorVersion = std::move(animator.m_animatorVersion);
   setupNetStates();
+  setupHandles();
 
   return *this;
 }
@@ -292,11 +301,13 @@ NetworkedAnimator& NetworkedAnimator::operator=(NetworkedAnimator const& animato
   m_animationRate = animator.m_animationRate;
   m_globalTags = animator.m_globalTags;
   m_partTags = animator.m_partTags;
-  m_cachedPartDrawables = animator.m_cachedPartDrawables;
   m_partDrawables = animator.m_partDrawables;
+  m_resolvedParts = animator.m_resolvedParts;
   m_localTags = animator.m_localTags;
+  m_tagsVersion = animator.m_tagsVersion;
   m_animatorVersion = animator.m_animatorVersion;
   setupNetStates();
+  setupHandles();
 
   return *this;
 }
@@ -359,11 +370,11 @@ bool NetworkedAnimator::hasState(String const & stateType, Maybe<String> const &
   return false;
 }
 
-StringMap<AnimatedPartSet::Part> const& NetworkedAnimator::constParts() const {
+List<AnimatedPartSet::Part> const& NetworkedAnimator::constParts() const {
   return m_animatedParts.constParts();
 }
 
-StringMap<AnimatedPartSet::Part>& NetworkedAnimator::parts() {
+List<AnimatedPartSet::Part>& NetworkedAnimator::parts() {
   return m_animatedParts.parts();
 }
 
@@ -371,6 +382,10 @@ StringList NetworkedAnimator::partNames() const {
   return m_animatedParts.partNames();
 }
 
+auto NetworkedAnimator::partHandle(String const& partName) const -> Maybe<PartHandle> {
+  return m_animatedParts.partIndex(partName);
+}
+
 Json NetworkedAnimator::stateProperty(String const& stateType, String const& propertyName, Maybe<String> state, Maybe<int> frame) const {
   if (state.isValid())
     return m_animatedParts.getStateFrameProperty(stateType, propertyName, *state, *frame);
@@ -389,6 +404,10 @@ Json NetworkedAnimator::partNextProperty(String const& partName, String const& p
   return m_animatedParts.activePart(partName).nextProperties.value(propertyName);
 }
 
+Json NetworkedAnimator::partProperty(PartHandle partHandle, String const& propertyName) const {
+  return m_animatedParts.activePart(partHandle).properties.value(propertyName);
+}
+
 Mat3F NetworkedAnimator::globalTransformation() const {
   Mat3F transformation = Mat3F::scaling(m_zoom.get());
   if (m_flipped.get())
@@ -398,31 +417,46 @@ Mat3F NetworkedAnimator::globalTransformation() const {
 
 Mat3F NetworkedAnimator::groupTransformation(StringList const& transformationGroups) const {
   auto mat = Mat3F::identity();
-  for (auto const& tg : transformationGroups)
-    mat = m_transformationGroups.get(tg).affineTransform() * m_transformationGroups.get(tg).localAffineTransform() * m_transformationGroups.get(tg).animationAffineTransform() * mat;
+  for (auto const& tg : transformationGroups) {
+    auto const& group = *m_transformationGroupsByHandle[m_transformationGroupHandles.get(tg)];
+    mat = group.affineTransform() * group.localAffineTransform() * group.animationAffineTransform() * mat;
+  }
+  return mat;
+}
+
+Mat3F NetworkedAnimator::groupTransformation(List<TransformationGroupHandle> const& transformationGroups) const {
+  auto mat = Mat3F::identity();
+  for (auto tg : transformationGroups) {
+    auto const& group = *m_transformationGroupsByHandle.at(tg);
+    mat = group.affineTransform() * group.localAffineTransform() * group.animationAffineTransform() * mat;
+  }
   return mat;
 }
 
 Mat3F NetworkedAnimator::partTransformation(String const& partName) const {
-  auto const& part = m_animatedParts.activePart(partName);
+  return partTransformation(m_animatedParts.partIndex(partName).get());
+}
+
+Mat3F NetworkedAnimator::partTransformation(PartHandle partHandle) const {
+  auto const& part = m_animatedParts.activePart(partHandle);
+  auto const& resolved = resolvedPart(partHandle);
   Mat3F transformation = Mat3F::identity();
 
-  if (auto offset = part.properties.value("offset").opt().apply(jsonToVec2F))
-    transformation = Mat3F::translation(*offset) * transformation;
+  if (resolved.offset)
+    transformation = Mat3F::translation(*resolved.offset) * transformation;
 
   transformation = part.animationAffineTransform() * transformation;
 
-  auto transformationGroups = jsonToStringList(part.properties.value("transformationGroups", JsonArray()));
-  transformation = groupTransformation(transformationGroups) * transformation;
+  transformation = groupTransformation(resolved.transformationGroups) * transformation;
 
-  if (auto rotationGroupName = part.properties.value("rotationGroup").optString()) {
-    auto const& rotationGroup = m_rotationGroups.get(*rotationGroupName);
-    Vec2F rotationCenter = part.properties.value("rotationCenter").opt().apply(jsonToVec2F).value(rotationGroup.rotationCenter);
+  if (resolved.rotationGroup) {
+    auto const& rotationGroup = m_rotationGroups.get(*resolved.rotationGroup);
+    Vec2F rotationCenter = resolved.rotationCenter.value(rotationGroup.rotationCenter);
     transformation = Mat3F::rotation(rotationGroup.currentAngle, rotationCenter) * transformation;
   }
 
-  if (auto anchorPart = part.properties.ptr("anchorPart"))
-    transformation = partTransformation(anchorPart->toString()) * transformation;
+  if (resolved.anchorPart)
+    transformation = partTransformation(*resolved.anchorPart) * transformation;
 
   return transformation;
 }
@@ -431,13 +465,21 @@ Mat3F NetworkedAnimator::finalPartTransformation(String const& partName) const {
   return globalTransformation() * partTransformation(partName);
 }
 
+Mat3F NetworkedAnimator::finalPartTransformation(PartHandle partHandle) const {
+  return globalTransformation() * partTransformation(partHandle);
+}
+
 Maybe<Vec2F> NetworkedAnimator::partPoint(String const& partName, String const& propertyName) const {
-  auto const& part = m_animatedParts.activePart(partName);
+  return partPoint(m_animatedParts.partIndex(partName).get(), propertyName);
+}
+
+Maybe<Vec2F> NetworkedAnimator::partPoint(PartHandle partHandle, String const& propertyName) const {
+  auto const& part = m_animatedParts.activePart(partHandle);
   auto property = part.properties.value(propertyName);
   if (!property)
     return {};
 
-  return finalPartTransformation(partName).transformVec2(jsonToVec2F(property));
+  return finalPartTransformation(partHandle).transformVec2(jsonToVec2F(property));
 }
 
 Maybe<PolyF> NetworkedAnimator::partPoly(String const& partName, String const& propertyName) const {
@@ -452,14 +494,22 @@ Maybe<PolyF> NetworkedAnimator::partPoly(String const& partName, String const& p
 }
 
 void NetworkedAnimator::setGlobalTag(String tagName, Maybe<String> tagValue) {
-  if (tagValue)
+  // Objects set their image key tags every frame, so as with local tags only
+  // invalidate cached drawables on an actual change.
+  if (tagValue) {
+    auto existing = m_globalTags.ptr(tagName);
+    if (existing && *existing == *tagValue)
+      return;
     m_globalTags.set(std::move(tagName), std::move(*tagValue));
-  else
-    m_globalTags.remove(tagName);
+  } else if (!m_globalTags.remove(tagName)) {
+    return;
+  }
+  ++m_tagsVersion;
 }
 
 void NetworkedAnimator::removeGlobalTag(String const& tagName) {
-  m_globalTags.remove(tagName);
+  if (m_globalTags.remove(tagName))
+    ++m_tagsVersion;
 }
 
 String const* NetworkedAnimator::globalTagPtr(String const& tagName) const {
@@ -468,25 +518,54 @@ String const* NetworkedAnimator::globalTagPtr(String const& tagName) const {
 
 
 void NetworkedAnimator::setPartTag(String const& partType, String tagName, Maybe<String> tagValue) {
-  if (tagValue)
-    m_partTags[partType].set(std::move(tagName), std::move(*tagValue));
-  else
-    m_partTags[partType].remove(tagName);
+  auto& partTags = m_partTags[partType];
+  if (tagValue) {
+    auto existing = partTags.ptr(tagName);
+    if (existing && *existing == *tagValue)
+      return;
+    partTags.set(std::move(tagName), std::move(*tagValue));
+  } else if (!partTags.remove(tagName)) {
+    return;
+  }
+  ++m_tagsVersion;
 }
 
 void NetworkedAnimator::setLocalTag(String tagName, Maybe<String> tagValue) {
-  if (tagValue)
-    m_localTags.set(tagName, *tagValue);
-  else
-    m_localTags.remove(tagName);
+  // Local tags are usually set to the same value every frame, so only
+  // invalidate cached drawables on an actual change.
+  if (tagValue) {
+    auto existing = m_localTags.find(tagName);
+    if (existing == m_localTags.end()) {
+      m_localTags.add(std::move(tagName), std::move(*tagValue));
+    } else if (existing->second != *tagValue) {
+      existing->second = std::move(*tagValue);
+    } else {
+      return;
+    }
+  } else if (!m_localTags.remove(tagName)) {
+    return;
+  }
+  ++m_tagsVersion;
 }
 
 void NetworkedAnimator::setPartDrawables(String const& partName, List<Drawable> drawables) {
-  m_partDrawables.set(partName, drawables);
+  if (auto partHandle = m_animatedParts.partIndex(partName))
+    setPartDrawables(*partHandle, std::move(drawables));
 }
+
 void NetworkedAnimator::addPartDrawables(String const& partName, List<Drawable> drawables) {
-  m_partDrawables.ptr(partName)->appendAll(drawables);
+  if (auto partHandle = m_animatedParts.partIndex(partName))
+    addPartDrawables(*partHandle, std::move(drawables));
 }
+
+void NetworkedAnimator::setPartDrawables(PartHandle partHandle, List<Drawable> drawables) {
+  m_partDrawables.at(partHandle) = std::move(drawables);
+}
+
+void NetworkedAnimator::addPartDrawables(PartHandle partHandle, List<Drawable> drawables) {
+  m_partDrawables.at(partHandle).appendAll(std::move(drawables));
+}
+
 String NetworkedAnimator::applyPartTags(String const& partName, String apply) const {
   HashMap<String, String> animationTags = m_localTags;
   Maybe<unsigned> frame;
@@ -596,90 +675,167 @@ float NetworkedAnimator::currentRotationAngle(String const& rotationGroup) const
 }
 
 bool NetworkedAnimator::hasTransformationGroup(String const& transformationGroup) const {
-  return m_transformationGroups.contains(transformationGroup);
+  return m_transformationGroupHandles.contains(transformationGroup);
+}
+
+auto NetworkedAnimator::transformationGroupHandle(String const& transformationGroup) const -> Maybe<TransformationGroupHandle> {
+  return m_transformationGroupHandles.maybe(transformationGroup);
 }
 
 void NetworkedAnimator::translateTransformationGroup(String const& transformationGroup, Vec2F const& translation) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setAffineTransform(Mat3F::translation(translation) * group.affineTransform());
+  translateTransformationGroup(m_transformationGroupHandles.get(transformationGroup), translation);
 }
 
 void NetworkedAnimator::rotateTransformationGroup(
     String const& transformationGroup, float rotation, Vec2F const& rotationCenter) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setAffineTransform(Mat3F::rotation(rotation, rotationCenter) * group.affineTransform());
+  rotateTransformationGroup(m_transformationGroupHandles.get(transformationGroup), rotation, rotationCenter);
 }
 
 void NetworkedAnimator::scaleTransformationGroup(
     String const& transformationGroup, float scale, Vec2F const& scaleCenter) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.affineTransform());
+  scaleTransformationGroup(m_transformationGroupHandles.get(transformationGroup), scale, scaleCenter);
 }
 
 void NetworkedAnimator::scaleTransformationGroup(
     String const& transformationGroup, Vec2F const& scale, Vec2F const& scaleCenter) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.affineTransform());
+  scaleTransformationGroup(m_transformationGroupHandles.get(transformationGroup), scale, scaleCenter);
 }
 
 void NetworkedAnimator::transformTransformationGroup(
     String const& transformationGroup, float a, float b, float c, float d, float tx, float ty) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  Mat3F transform = Mat3F(a, b, tx, c, d, ty, 0, 0, 1);
-  group.setAffineTransform(transform * group.affineTransform());
+  transformTransformationGroup(m_transformationGroupHandles.get(transformationGroup), a, b, c, d, tx, ty);
 }
 
 void NetworkedAnimator::resetTransformationGroup(String const& transformationGroup) {
-  m_transformationGroups.get(transformationGroup).setAffineTransform(Mat3F::identity());
+  resetTransformationGroup(m_transformationGroupHandles.get(transformationGroup));
 }
 
 void NetworkedAnimator::setTransformationGroup(String const& transformationGroup, Mat3F transform) {
-  m_transformationGroups.get(transformationGroup).setAffineTransform(transform);
+  setTransformationGroup(m_transformationGroupHandles.get(transformationGroup), transform);
 }
 
 Mat3F NetworkedAnimator::getTransformationGroup(String const& transformationGroup) {
-  return m_transformationGroups.get(transformationGroup).affineTransform();
+  return getTransformationGroup(m_transformationGroupHandles.get(transformationGroup));
 }
+
 void NetworkedAnimator::translateLocalTransformationGroup(String const& transformationGroup, Vec2F const& translation) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setLocalAffineTransform(Mat3F::translation(translation) * group.localAffineTransform());
+  translateLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup), translation);
 }
 
 void NetworkedAnimator::rotateLocalTransformationGroup(
     String const& transformationGroup, float rotation, Vec2F const& rotationCenter) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setLocalAffineTransform(Mat3F::rotation(rotation, rotationCenter) * group.localAffineTransform());
+  rotateLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup), rotation, rotationCenter);
 }
 
 void NetworkedAnimator::scaleLocalTransformationGroup(
     String const& transformationGroup, float scale, Vec2F const& scaleCenter) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setLocalAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.localAffineTransform());
+  scaleLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup), scale, scaleCenter);
 }
 
 void NetworkedAnimator::scaleLocalTransformationGroup(
     String const& transformationGroup, Vec2F const& scale, Vec2F const& scaleCenter) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  group.setLocalAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.localAffineTransform());
+  scaleLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup), scale, scaleCenter);
 }
 
 void NetworkedAnimator::transformLocalTransformationGroup(
     String const& transformationGroup, float a, float b, float c, float d, float tx, float ty) {
-  auto& group = m_transformationGroups.get(transformationGroup);
-  Mat3F transform = Mat3F(a, b, tx, c, d, ty, 0, 0, 1);
-  group.setLocalAffineTransform(transform * group.localAffineTransform());
+  transformLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup), a, b, c, d, tx, ty);
 }
 
 void NetworkedAnimator::resetLocalTransformationGroup(String const& transformationGroup) {
-  m_transformationGroups.get(transformationGroup).setLocalAffineTransform(Mat3F::identity());
+  resetLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup));
 }
 
 void NetworkedAnimator::setLocalTransformationGroup(String const& transformationGroup, Mat3F transform) {
-  m_transformationGroups.get(transformationGroup).setLocalAffineTransform(transform);
+  setLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup), transform);
 }
 
 Mat3F NetworkedAnimator::getLocalTransformationGroup(String const& transformationGroup) {
-  return m_transformationGroups.get(transformationGroup).localAffineTransform();
+  return getLocalTransformationGroup(m_transformationGroupHandles.get(transformationGroup));
+}
+
+void NetworkedAnimator::translateTransformationGroup(TransformationGroupHandle transformationGroup, Vec2F const& translation) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setAffineTransform(Mat3F::translation(translation) * group.affineTransform());
+}
+
+void NetworkedAnimator::rotateTransformationGroup(
+    TransformationGroupHandle transformationGroup, float rotation, Vec2F const& rotationCenter) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setAffineTransform(Mat3F::rotation(rotation, rotationCenter) * group.affineTransform());
+}
+
+void NetworkedAnimator::scaleTransformationGroup(
+    TransformationGroupHandle transformationGroup, float scale, Vec2F const& scaleCenter) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.affineTransform());
+}
+
+void NetworkedAnimator::scaleTransformationGroup(
+    TransformationGroupHandle transformationGroup, Vec2F const& scale, Vec2F const& scaleCenter) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.affineTransform());
+}
+
+void NetworkedAnimator::transformTransformationGroup(
+    TransformationGroupHandle transformationGroup, float a, float b, float c, float d, float tx, float ty) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  Mat3F transform = Mat3F(a, b, tx, c, d, ty, 0, 0, 1);
+  group.setAffineTransform(transform * group.affineTransform());
+}
+
+void NetworkedAnimator::resetTransformationGroup(TransformationGroupHandle transformationGroup) {
+  m_transformationGroupsByHandle.at(transformationGroup)->setAffineTransform(Mat3F::identity());
+}
+
+void NetworkedAnimator::setTransformationGroup(TransformationGroupHandle transformationGroup, Mat3F transform) {
+  m_transformationGroupsByHandle.at(transformationGroup)->setAffineTransform(transform);
+}
+
+Mat3F NetworkedAnimator::getTransformationGroup(TransformationGroupHandle transformationGroup) {
+  return m_transformationGroupsByHandle.at(transformationGroup)->affineTransform();
+}
+
+void NetworkedAnimator::translateLocalTransformationGroup(TransformationGroupHandle transformationGroup, Vec2F const& translation) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setLocalAffineTransform(Mat3F::translation(translation) * group.localAffineTransform());
+}
+
+void NetworkedAnimator::rotateLocalTransformationGroup(
+    TransformationGroupHandle transformationGroup, float rotation, Vec2F const& rotationCenter) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setLocalAffineTransform(Mat3F::rotation(rotation, rotationCenter) * group.localAffineTransform());
+}
+
+void NetworkedAnimator::scaleLocalTransformationGroup(
+    TransformationGroupHandle transformationGroup, float scale, Vec2F const& scaleCenter) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setLocalAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.localAffineTransform());
+}
+
+void NetworkedAnimator::scaleLocalTransformationGroup(
+    TransformationGroupHandle transformationGroup, Vec2F const& scale, Vec2F const& scaleCenter) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  group.setLocalAffineTransform(Mat3F::scaling(scale, scaleCenter) * group.localAffineTransform());
+}
+
+void NetworkedAnimator::transformLocalTransformationGroup(
+    TransformationGroupHandle transformationGroup, float a, float b, float c, float d, float tx, float ty) {
+  auto& group = *m_transformationGroupsByHandle.at(transformationGroup);
+  Mat3F transform = Mat3F(a, b, tx, c, d, ty, 0, 0, 1);
+  group.setLocalAffineTransform(transform * group.localAffineTransform());
+}
+
+void NetworkedAnimator::resetLocalTransformationGroup(TransformationGroupHandle transformationGroup) {
+  m_transformationGroupsByHandle.at(transformationGroup)->setLocalAffineTransform(Mat3F::identity());
+}
+
+void NetworkedAnimator::setLocalTransformationGroup(TransformationGroupHandle transformationGroup, Mat3F transform) {
+  m_transformationGroupsByHandle.at(transformationGroup)->setLocalAffineTransform(transform);
+}
+
+Mat3F NetworkedAnimator::getLocalTransformationGroup(TransformationGroupHandle transformationGroup) {
+  return m_transformationGroupsByHandle.at(transformationGroup)->localAffineTransform();
 }
 
 bool NetworkedAnimator::hasParticleEmitter(String const& emitterName) const {
@@ -799,178 +955,163 @@ List<pair<Drawable, float>> NetworkedAnimator::drawablesWithZLevel(Vec2F const&
       }
     }
   }
-  HashMap<String, String> animationTags = m_localTags;
-  if (version() > 0) {
-    animationTags.set("relativePath", m_relativePath);
-    for (auto& stateTypeName : m_animatedParts.stateTypes()) {
-      auto& activeState = m_animatedParts.activeState(stateTypeName);
-      unsigned stateFrame = activeState.frame;
-      Maybe<unsigned> frame;
-      String frameStr;
-      String frameIndexStr;
 
-      frame = stateFrame;
-      frameStr = static_cast<String>(toString(stateFrame + 1));
-      frameIndexStr = static_cast<String>(toString(stateFrame));
-      if (frame) {
-        animationTags.set(stateTypeName + "_frame", frameStr);
-        animationTags.set(stateTypeName + "_frameIndex", frameIndexStr);
-      }
-      animationTags.set(stateTypeName + "_state", activeState.stateName);
+  bool flipped = m_flipped.get();
+  uint64_t statesVersion = version() > 0 ? m_animatedParts.activeStatesVersion() : 0;
 
-      if (auto p = activeState.properties.ptr("animationTags")) {
-        for (auto tag : p->iterateObject())
-          if (!animationTags.contains(tag.first))
-            animationTags.set(tag.first, tag.second.toString());
+  // Only needed when a part drawable has to be rebuilt, so built on first use.
+  Maybe<HashMap<String, String>> animationTags;
+  auto getAnimationTags = [&]() -> HashMap<String, String> const& {
+    if (animationTags)
+      return *animationTags;
+
+    animationTags = m_localTags;
+    if (version() > 0) {
+      animationTags->set("relativePath", m_relativePath);
+      for (auto& stateTypeName : m_animatedParts.stateTypes()) {
+        auto& activeState = m_animatedParts.activeState(stateTypeName);
+        unsigned stateFrame = activeState.frame;
+        animationTags->set(stateTypeName + "_frame", static_cast<String>(toString(stateFrame + 1)));
+        animationTags->set(stateTypeName + "_frameIndex", static_cast<String>(toString(stateFrame)));
+        animationTags->set(stateTypeName + "_state", activeState.stateName);
+
+        if (auto p = activeState.properties.ptr("animationTags")) {
+          for (auto tag : p->iterateObject())
+            if (!animationTags->contains(tag.first))
+              animationTags->set(tag.first, tag.second.toString());
+        }
       }
     }
-  }
+    return *animationTags;
+  };
 
-  List<tuple<AnimatedPartSet::ActivePartInformation const*, String const*, float>> parts;
+  List<pair<PartHandle, float>> parts;
   parts.reserve(partCount);
-  int drawableCount = 0;
-  m_animatedParts.forEachActivePart([&](String const& partName, AnimatedPartSet::ActivePartInformation const& activePart) {
-    Maybe<float> maybeZLevel;
-    if (m_flipped.get()) {
-      if (auto maybeFlipped = activePart.properties.value("flippedZLevel").optFloat())
-        maybeZLevel = *maybeFlipped;
-    }
-    if (!maybeZLevel)
-      maybeZLevel = activePart.properties.value("zLevel").optFloat();
-
-    if (auto drawables = m_partDrawables.contains(partName))
-      drawableCount += m_partDrawables.get(partName).size();
-    parts.append(make_tuple(&activePart, &partName, maybeZLevel.value(0.0f)));
-  });
+  size_t drawableCount = 0;
+  for (PartHandle partHandle = 0; partHandle < partCount; ++partHandle) {
+    auto const& resolved = resolvedPart(partHandle);
+    float zLevel = flipped ? resolved.flippedZLevel.value(resolved.zLevel) : resolved.zLevel;
+    drawableCount += m_partDrawables[partHandle].size();
+    parts.append({partHandle, zLevel});
+  }
 
-  sort(parts, [](auto const& a, auto const& b) { return get<2>(a) < get<2>(b); });
+  stableSort(parts, [](auto const& a, auto const& b) { return a.second < b.second; });
 
   List<pair<Drawable, float>> drawables;
   drawables.reserve(partCount + drawableCount);
-  for (auto& entry : parts) {
-    auto& activePart = *get<0>(entry);
-    auto& partName = *get<1>(entry);
-    // Make sure we don't copy the original image
-    String fallback = "";
-    Json jImage = activePart.properties.value("image", {});
-    if (version() > 0 && m_flipped.get()) {
-      if (auto maybeFlipped = activePart.properties.value("flippedImage").optString())
-        jImage = *maybeFlipped;
-    }
-
-    String const& image = jImage.isType(Json::Type::String) ? *jImage.stringPtr() : fallback;
-
-    bool centered = activePart.properties.value("centered").optBool().value(true);
-    bool fullbright = activePart.properties.value("fullbright").optBool().value(false);
-
-    size_t originalDirectivesSize = baseProcessingDirectives.size();
-
-    auto const& partTags = m_partTags.get(partName);
-
-    if (auto directives = activePart.properties.value("processingDirectives").optString()) {
-      if (version() > 0){
-        directives = directives->maybeLookupTagsView([&](StringView tag) -> StringView {
-          if (auto p = animationTags.ptr(tag)) {
-            return StringView(*p);
-          } else if (auto p = partTags.ptr(tag)) {
-            return StringView(*p);
-          } else if (auto p = m_globalTags.ptr(tag)) {
-            return StringView(*p);
-          }
-          return StringView("default");
-        });
+  for (auto const& entry : parts) {
+    PartHandle partHandle = entry.first;
+    auto const& activePart = m_animatedParts.activePart(partHandle);
+    auto& resolved = m_resolvedParts[partHandle];
+
+    auto drawableSource = make_tuple(activePart.propertiesVersion, m_tagsVersion, statesVersion, flipped);
+    if (resolved.drawableSource != drawableSource) {
+      auto const& partTags = m_partTags.get(activePart.partName);
+      auto lookupTag = [&](StringView tag) -> StringView {
+        if (auto p = getAnimationTags().ptr(tag)) {
+          return StringView(*p);
+        } else if (auto p = partTags.ptr(tag)) {
+          return StringView(*p);
+        } else if (auto p = m_globalTags.ptr(tag)) {
+          return StringView(*p);
+        }
+        return StringView("default");
+      };
+
+      resolved.processingDirectives.clear();
+      if (auto directives = activePart.properties.value("processingDirectives").optString()) {
+        if (version() > 0)
+          directives = directives->maybeLookupTagsView(lookupTag);
+        resolved.processingDirectives.append(*directives);
       }
-      baseProcessingDirectives.append(*directives);
-    }
-
-    Maybe<unsigned> frame;
-    String frameStr;
-    String frameIndexStr;
-    if (activePart.activeState) {
-      unsigned stateFrame = activePart.activeState->frame;
-      frame = stateFrame;
-      frameStr = static_cast<String>(toString(stateFrame + 1));
-      frameIndexStr = static_cast<String>(toString(stateFrame));
 
-      if (auto directives = activePart.activeState->properties.value("processingDirectives").optString()) {
-        if (version() > 0){
-          directives = directives->maybeLookupTagsView([&](StringView tag) -> StringView {
-            if (auto p = animationTags.ptr(tag)) {
-              return StringView(*p);
-            } else if (auto p = partTags.ptr(tag)) {
-              return StringView(*p);
-            } else if (auto p = m_globalTags.ptr(tag)) {
-              return StringView(*p);
-            }
-            return StringView("default");
-          });
+      Maybe<unsigned> frame;
+      String frameStr;
+      String frameIndexStr;
+      if (activePart.activeState) {
+        unsigned stateFrame = activePart.activeState->frame;
+        frame = stateFrame;
+        frameStr = static_cast<String>(toString(stateFrame + 1));
+        frameIndexStr = static_cast<String>(toString(stateFrame));
+
+        if (auto directives = activePart.activeState->properties.value("processingDirectives").optString()) {
+          if (version() > 0)
+            directives = directives->maybeLookupTagsView(lookupTag);
+          resolved.processingDirectives.append(*directives);
         }
-        baseProcessingDirectives.append(*directives);
       }
-    }
 
-    Maybe<String> processedImage = image.maybeLookupTagsView([&](StringView tag) -> StringView {
-      if (tag == "frame") {
-        if (frame)
-          return frameStr;
-      } else if (tag == "frameIndex") {
-        if (frame)
-          return frameIndexStr;
-      } else if (auto p = animationTags.ptr(tag)) {
-        return StringView(*p);
-      } else if (auto p = partTags.ptr(tag)) {
-        return StringView(*p);
-      } else if (auto p = m_globalTags.ptr(tag)) {
-        return StringView(*p);
+      // Make sure we don't copy the original image
+      String fallback = "";
+      Json jImage = activePart.properties.value("image", {});
+      if (version() > 0 && flipped) {
+        if (auto maybeFlipped = activePart.properties.value("flippedImage").optString())
+          jImage = *maybeFlipped;
       }
+      String const& image = jImage.isType(Json::Type::String) ? *jImage.stringPtr() : fallback;
+
+      Maybe<String> processedImage = image.maybeLookupTagsView([&](StringView tag) -> StringView {
+        if (tag == "frame") {
+          if (frame)
+            return frameStr;
+        } else if (tag == "frameIndex") {
+          if (frame)
+            return frameIndexStr;
+        } else {
+          return lookupTag(tag);
+        }
 
-      return StringView("default");
-    });
-    String const& usedImage = processedImage ? processedImage.get() : image;
-
-    auto transformation = globalTransformation() * partTransformation(partName);
-    transformation.translate(position);
+        return StringView("default");
+      });
+      String const& usedImage = processedImage ? processedImage.get() : image;
 
-    if (!usedImage.empty() && usedImage[0] != ':' && usedImage[0] != '?') {
-      size_t hash = hashOf(usedImage);
-      auto find = m_cachedPartDrawables.find(partName);
-      if (find == m_cachedPartDrawables.end() || find->second.first != hash) {
+      resolved.imageDrawable.reset();
+      resolved.imageIdDirectives.reset();
+      resolved.imageId = {};
+      if (!usedImage.empty() && usedImage[0] != ':' && usedImage[0] != '?') {
         String relativeImage;
         if (usedImage[0] != '/')
           relativeImage = AssetPath::relativeTo(m_relativePath, usedImage);
 
-        Drawable drawable = Drawable::makeImage(!relativeImage.empty() ? relativeImage : usedImage, 1.0f / TilePixels, centered, Vec2F());
-        if (find == m_cachedPartDrawables.end())
-          find = m_cachedPartDrawables.emplace(partName, std::pair{ hash, std::move(drawable) }).first;
-        else {
-          find->second.first = hash;
-          find->second.second = std::move(drawable);
-        }
+        resolved.imageDrawable = Drawable::makeImage(!relativeImage.empty() ? relativeImage : usedImage, 1.0f / TilePixels, resolved.centered, Vec2F());
       }
 
-      Drawable drawable = find->second.second;
+      resolved.drawableSource = drawableSource;
+    }
+
+    auto transformation = globalTransformation() * partTransformation(partHandle);
+    transformation.translate(position);
+
+    if (resolved.imageDrawable) {
+      Drawable drawable = *resolved.imageDrawable;
       auto& imagePart = drawable.imagePart();
       for (Directives const& directives : baseProcessingDirectives)
-        imagePart.addDirectives(directives, centered);
-      drawable.fullbright = fullbright;
+        imagePart.addDirectives(directives, resolved.centered);
+      for (Directives const& directives : resolved.processingDirectives)
+        imagePart.addDirectives(directives, resolved.centered);
+      if (resolved.imageIdDirectives != baseProcessingDirectives) {
+        resolved.imageId = AssetPathId::intern(imagePart.image);
+        resolved.imageIdDirectives = baseProcessingDirectives;
+      }
+      imagePart.imageId = resolved.imageId;
+      drawable.fullbright = resolved.fullbright;
       drawable.transform(transformation);
-      drawables.append({std::move(drawable), get<2>(entry)});
+      drawables.append({std::move(drawable), entry.second});
     }
 
-    if (m_partDrawables.contains(partName)) {
-      auto partDrawables = m_partDrawables.get(partName);
-      Drawable::transformAll(partDrawables, transformation);
-      for (auto drawable : partDrawables) {
-      drawables.append({drawable, get<2>(entry)});
-      }
+    for (auto drawable : m_partDrawables[partHandle]) {
+      drawable.transform(transformation);
+      drawables.append({std::move(drawable), entry.second});
     }
-
-    baseProcessingDirectives.resize(originalDirectivesSize);
   }
 
   return drawables;
 }
 
+uint64_t NetworkedAnimator::tagsVersion() const {
+  return m_tagsVersion;
+}
+
 List<LightSource> NetworkedAnimator::lightSources(Vec2F const& translate) const {
   List<LightSource> lightSources;
   for (auto const& pair : m_lights) {
@@ -1332,6 +1473,42 @@ Mat3F NetworkedAnimator::TransformationGroup::animationAffineTransform() const {
     );
 }
 
+auto NetworkedAnimator::resolvedPart(PartHandle partHandle) const -> ResolvedPart const& {
+  auto const& activePart = m_animatedParts.activePart(partHandle);
+  auto& resolved = m_resolvedParts.at(partHandle);
+  if (resolved.propertiesVersion == activePart.propertiesVersion)
+    return resolved;
+
+  auto const& properties = activePart.properties;
+  resolved.offset = properties.value("offset").opt().apply(jsonToVec2F);
+
+  resolved.transformationGroups.clear();
+  for (auto const& transformationGroup : properties.value("transformationGroups", JsonArray()).iterateArray()) {
+    if (auto handle = m_transformationGroupHandles.maybe(transformationGroup.toString()))
+      resolved.transformationGroups.append(*handle);
+    else
+      throw NetworkedAnimatorException::format("No such transformation group '{}' in part '{}'", transformationGroup.toString(), activePart.partName);
+  }
+
+  resolved.rotationGroup = properties.value("rotationGroup").optString();
+  resolved.rotationCenter = properties.value("rotationCenter").opt().apply(jsonToVec2F);
+
+  resolved.anchorPart = {};
+  if (auto anchorPart = properties.value("anchorPart").optString()) {
+    resolved.anchorPart = m_animatedParts.partIndex(*anchorPart);
+    if (!resolved.anchorPart)
+      throw NetworkedAnimatorException::format("No such anchor part '{}' in part '{}'", *anchorPart, activePart.partName);
+  }
+
+  resolved.zLevel = properties.value("zLevel").optFloat().value(0.0f);
+  resolved.flippedZLevel = properties.value("flippedZLevel").optFloat();
+  resolved.centered = properties.value("centered").optBool().value(true);
+  resolved.fullbright = properties.value("fullbright").optBool().value(false);
+
+  resolved.propertiesVersion = activePart.propertiesVersion;
+  return resolved;
+}
+
 void NetworkedAnimator::setupNetStates() {
   clearNetElements();
 
@@ -1428,7 +1605,24 @@ void NetworkedAnimator::setupNetStates() {
 
 }
 
+void NetworkedAnimator::setupHandles() {
+  m_transformationGroupsByHandle.clear();
+  m_transformationGroupHandles.clear();
+  for (auto& pair : m_transformationGroups) {
+    m_transformationGroupHandles.add(pair.first, m_transformationGroupsByHandle.size());
+    m_transformationGroupsByHandle.append(&pair.second);
+  }
+}
+
 void NetworkedAnimator::netElementsNeedLoad(bool initial) {
+  // Only throw away cached part drawables when a tag actually changed
+  // remotely.  Every map is pulled so that none is left flagged as updated.
+  bool tagsUpdated = m_globalTags.pullUpdated();
+  for (auto& pair : m_partTags)
+    tagsUpdated |= pair.second.pullUpdated();
+  if (tagsUpdated || initial)
+    ++m_tagsVersion;
+
   for (auto& pair : m_stateInfo) {
     if (pair.second.startedEvent.pullOccurred() || initial)
       m_animatedParts.setActiveStateIndex(pair.first, pair.second.stateIndex.get(), true, pair.second.reverse.get());
@@ -62,6 +62,12 @@ public:
     HashMap<AudioInstancePtr, Vec2F> currentAudioBasePositions;
   };
 
+  // Parts and transformation groups can be looked up once by name and then
+  // referred to by handle in code that runs every frame.  Handles stay valid
+  // for the lifetime of the animator and any copies of it.
+  typedef size_t PartHandle;
+  typedef size_t TransformationGroupHandle;
+
   NetworkedAnimator();
   // If passed a string as config, NetworkedAnimator will interpret this as a
   // config path, otherwise it is interpreted as the literal config.
@@ -93,9 +99,10 @@ public:
 
   bool hasState(String const& stateType, Maybe<String> const& state = {}) const;
 
-  StringMap<AnimatedPartSet::Part> const& constParts() const;
-  StringMap<AnimatedPartSet::Part>& parts();
+  List<AnimatedPartSet::Part> const& constParts() const;
+  List<AnimatedPartSet::Part>& parts();
   StringList partNames() const;
+  Maybe<PartHandle> partHandle(String const& partName) const;
 
   // Queries, if it exists, a property value from the underlying
   // AnimatedPartSet for the given state or part.  If the property does not
@@ -104,25 +111,30 @@ public:
   Json stateNextProperty(String const& stateType, String const& propertyName) const;
   Json partProperty(String const& partName, String const& propertyName, Maybe<String> stateType = {}, Maybe<String> state = {}, Maybe<int> frame = {}) const;
   Json partNextProperty(String const & partName, String const & propertyName) const;
+  Json partProperty(PartHandle partHandle, String const& propertyName) const;
 
   // Returns the transformation from flipping and zooming that is applied to
   // all parts in the NetworkedAnimator.
   Mat3F globalTransformation() const;
   // The transformation applied from the given set of transformation groups
   Mat3F groupTransformation(StringList const& transformationGroups) const;
+  Mat3F groupTransformation(List<TransformationGroupHandle> const& transformationGroups) const;
   // The transformation that is applied to the given part NOT including the
   // global transformation
   Mat3F partTransformation(String const& partName) const;
+  Mat3F partTransformation(PartHandle partHandle) const;
   // Returns the total transformation for the given part, which includes the
   // globalTransformation, as well as the part rotation, scaling, and
   // translation.
   Mat3F finalPartTransformation(String const& partName) const;
+  Mat3F finalPartTransformation(PartHandle partHandle) const;
 
   // partPoint / partPoly takes a propertyName and looks up the associated part
   // property and interprets is a Vec2F or a PolyF, then applies the final part
   // transformation and returns it.
   Maybe<Vec2F> partPoint(String const& partName, String const& propertyName) const;
   Maybe<PolyF> partPoly(String const& partName, String const& propertyName) const;
+  Maybe<Vec2F> partPoint(PartHandle partHandle, String const& propertyName) const;
 
   // Every part image can have one or more <tag> directives in it, which if set
   // here will be replaced by the tag value when constructing Drawables.  All
@@ -134,8 +146,11 @@ public:
   void setPartTag(String const& partType, String tagName, Maybe<String> tagValue = {});
   void setLocalTag(String tagName, Maybe<String> tagValue = {});
 
+  // Drawables set for parts that do not exist are ignored.
   void setPartDrawables(String const& partName, List<Drawable> drawables);
   void addPartDrawables(String const& partName, List<Drawable> drawables);
+  void setPartDrawables(PartHandle partHandle, List<Drawable> drawables);
+  void addPartDrawables(PartHandle partHandle, List<Drawable> drawables);
 
   String applyPartTags(String const& partName, String apply) const;
 
@@ -160,6 +175,7 @@ public:
   // Transformation groups can be used for arbitrary part transforamtions.
   // They apply immediately, and are optionally interpolated on slaves.
   bool hasTransformationGroup(String const& transformationGroup) const;
+  Maybe<TransformationGroupHandle> transformationGroupHandle(String const& transformationGroup) const;
   void translateTransformationGroup(String const& transformationGroup, Vec2F const& translation);
   void rotateTransformationGroup(String const& transformationGroup, float rotation, Vec2F const& rotationCenter = Vec2F());
   void scaleTransformationGroup(String const& transformationGroup, float scale, Vec2F const& scaleCenter = Vec2F());
@@ -178,6 +194,24 @@ public:
   void setLocalTransformationGroup(String const& transformationGroup, Mat3F transform);
   Mat3F getLocalTransformationGroup(String const& transformationGroup);
 
+  void translateTransformationGroup(TransformationGroupHandle transformationGroup, Vec2F const& translation);
+  void rotateTransformationGroup(TransformationGroupHandle transformationGroup, float rotation, Vec2F const& rotationCenter = Vec2F());
+  void scaleTransformationGroup(TransformationGroupHandle transformationGroup, float scale, Vec2F const& scaleCenter = Vec2F());
+  void scaleTransformationGroup(TransformationGroupHandle transformationGroup, Vec2F const& scale, Vec2F const& scaleCenter = Vec2F());
+  void transformTransformationGroup(TransformationGroupHandle transformationGroup, float a, float b, float c, float d, float tx, float ty);
+  void resetTransformationGroup(TransformationGroupHandle transformationGroup);
+  void setTransformationGroup(TransformationGroupHandle transformationGroup, Mat3F transform);
+  Mat3F getTransformationGroup(TransformationGroupHandle transformationGroup);
+
+  void translateLocalTransformationGroup(TransformationGroupHandle transformationGroup, Vec2F const& translation);
+  void rotateLocalTransformationGroup(TransformationGroupHandle transformationGroup, float rotation, Vec2F const& rotationCenter = Vec2F());
+  void scaleLocalTransformationGroup(TransformationGroupHandle transformationGroup, float scale, Vec2F const& scaleCenter = Vec2F());
+  void scaleLocalTransformationGroup(TransformationGroupHandle transformationGroup, Vec2F const& scale, Vec2F const& scaleCenter = Vec2F());
+  void transformLocalTransformationGroup(TransformationGroupHandle transformationGroup, float a, float b, float c, float d, float tx, float ty);
+  void resetLocalTransformationGroup(TransformationGroupHandle transformationGroup);
+  void setLocalTransformationGroup(TransformationGroupHandle transformationGroup, Mat3F transform);
+  Mat3F getLocalTransformationGroup(TransformationGroupHandle transformationGroup);
+
   bool hasParticleEmitter(String const& emitterName) const;
   // Active particle emitters emit over time based on emission rate/variance.
   void setParticleEmitterActive(String const& emitterName, bool active);
@@ -221,6 +255,9 @@ public:
 
   List<Drawable> drawables(Vec2F const& translate = Vec2F()) const;
   List<pair<Drawable, float>> drawablesWithZLevel(Vec2F const& translate = Vec2F()) const;
+  // Changes whenever a tag changes, which rebuilds every cached part image
+  // drawable.
+  uint64_t tagsVersion() const;
 
   List<LightSource> lightSources(Vec2F const& translate = Vec2F()) const;
 
@@ -352,7 +389,40 @@ private:
     NetElementBool reverse;
   };
 
+  // The part properties read every frame, resolved from the active part
+  // properties whenever they change.
+  struct ResolvedPart {
+    // propertiesVersion of the active part these were resolved from, 0 if
+    // never resolved.
+    uint64_t propertiesVersion = 0;
+
+    Maybe<Vec2F> offset;
+    List<TransformationGroupHandle> transformationGroups;
+    Maybe<String> rotationGroup;
+    Maybe<Vec2F> rotationCenter;
+    Maybe<PartHandle> anchorPart;
+    float zLevel;
+    Maybe<float> flippedZLevel;
+    bool centered;
+    bool fullbright;
+
+    // The part image drawable and processing directives with all tags
+    // applied, valid as long as the part properties, tags, active states and
+    // flip are the same as when they were built.
+    Maybe<tuple<uint64_t, uint64_t, uint64_t, bool>> drawableSource;
+    Maybe<Drawable> imageDrawable;
+    List<Directives> processingDirectives;
+    // Interned image of the drawn part drawable, with the base processing
+    // directives it was interned with, cleared whenever imageDrawable is
+    // rebuilt.
+    Maybe<List<Directives>> imageIdDirectives;
+    AssetPathId imageId;
+  };
+
+  ResolvedPart const& resolvedPart(PartHandle partHandle) const;
+
   void setupNetStates();
+  void setupHandles();
 
   void netElementsNeedLoad(bool full) override;
   void netElementsNeedStore() override;
@@ -382,10 +452,17 @@ private:
   NetElementHashMap<String, String> m_globalTags;
   StableStringMap<NetElementHashMap<String, String>> m_partTags;
   HashMap<String, String> m_localTags;
+  // Incremented whenever any tag may have changed.
+  uint64_t m_tagsVersion;
 
-  HashMap<String,List<Drawable>> m_partDrawables;
+  // Indexed by PartHandle
+  List<List<Drawable>> m_partDrawables;
+  mutable List<ResolvedPart> m_resolvedParts;
 
-  mutable StringMap<std::pair<size_t, Drawable>> m_cachedPartDrawables;
+  // Indexed by TransformationGroupHandle, pointing into m_transformationGroups
+  // and rebuilt whenever it is copied or moved.
+  List<TransformationGroup*> m_transformationGroupsByHandle;
+  StringMap<TransformationGroupHandle> m_transformationGroupHandles;
 };
 
 }
@@ -32,6 +32,13 @@
 
 namespace Star {
 
+namespace {
+  // Read every tick, so looked up by id rather than by name
+  StatId const HealthResource = *internStatName("health");
+  StatId const InvulnerableStat = *internStatName("invulnerable");
+  StatId const PowerMultiplierStat = *internStatName("powerMultiplier");
+}
+
 Npc::Npc(NpcVariant const& npcVariant) {
 
   m_netHumanoid.addNetElement(make_shared<NetHumanoid>(npcVariant.humanoidIdentity, npcVariant.humanoidParameters, npcVariant.uniqueHumanoidConfig ? npcVariant.humanoidConfig : Json()));
@@ -66,6 +73,7 @@ Npc::Npc(NpcVariant const& npcVariant) {
 
   m_scriptComponent.setScripts(m_npcVariant.scripts);
   m_scriptComponent.setUpdateDelta(m_npcVariant.initialScriptDelta);
+  m_scriptComponent.setUpdateLodEnabled(m_npcVariant.scriptConfig.getBool("scriptUpdateLod", true));
   auto movementParameters = ActorMovementParameters(jsonMerge(humanoid()->defaultMovementParameters(), m_npcVariant.movementParameters));
   if (!movementParameters.physicsEffectCategories)
     movementParameters.physicsEffectCategories = StringSet({"npc"});
@@ -326,7 +334,7 @@ Json Npc::scriptConfigParameter(String const& parameterName, Json const& default
 }
 
 Maybe<HitType> Npc::queryHit(DamageSource const& source) const {
-  if (!inWorld() || !m_statusController->resourcePositive("health") || m_statusController->statPositive("invulnerable"))
+  if (!inWorld() || !m_statusController->resourcePositive(HealthResource) || m_statusController->statPositive(InvulnerableStat))
     return {};
 
   if (m_tools->queryShieldHit(source))
@@ -370,9 +378,9 @@ List<DamageNotification> Npc::selfDamageNotifications() {
 }
 
 bool Npc::shouldDestroy() const {
-  if (auto res = m_scriptComponent.invoke<bool>("shouldDie"))
+  if (auto res = m_scriptComponent.invoke<bool>(m_shouldDieFunction))
     return *res;
-  else if (!m_statusController->resourcePositive("health") || m_scriptComponent.error())
+  else if (!m_statusController->resourcePositive(HealthResource) || m_scriptComponent.error())
     return true;
   else
     return false;
@@ -508,28 +516,32 @@ void Npc::render(RenderCallback* renderCallback) {
   if (auto loungeAnchor = as<LoungeAnchor>(m_movementController->entityAnchor()))
     renderLayer = loungeAnchor->loungeRenderLayer;
 
-  m_tools->setupHumanoidHandItemDrawables(*humanoid());
+  bool drawablesWanted = renderCallback->drawablesWanted();
+  if (drawablesWanted) {
+    m_tools->setupHumanoidHandItemDrawables(*humanoid());
 
-  DirectivesGroup humanoidDirectives;
-  Vec2F scale = Vec2F::filled(1.f);
-  for (auto& directives : m_statusController->parentDirectives().list()) {
-    auto result = Humanoid::extractScaleFromDirectives(directives);
-    scale = scale.piecewiseMultiply(result.first);
-    humanoidDirectives.append(result.second);
-  }
-  humanoid()->setScale(scale);
+    DirectivesGroup humanoidDirectives;
+    Vec2F scale = Vec2F::filled(1.f);
+    for (auto& directives : m_statusController->parentDirectives().list()) {
+      auto result = Humanoid::extractScaleFromDirectives(directives);
+      scale = scale.piecewiseMultiply(result.first);
+      humanoidDirectives.append(result.second);
+    }
+    humanoid()->setScale(scale);
 
-  for (auto& drawable : humanoid()->render()) {
-    drawable.translate(position());
-    if (drawable.isImage())
-      drawable.imagePart().addDirectivesGroup(humanoidDirectives, true);
-    renderCallback->addDrawable(std::move(drawable), renderLayer);
+    for (auto& drawable : humanoid()->render()) {
+      drawable.translate(position());
+      if (drawable.isImage())
+        drawable.imagePart().addDirectivesGroup(humanoidDirectives, true);
+      renderCallback->addDrawable(std::move(drawable), renderLayer);
+    }
   }
 
   renderCallback->addParticles(m_humanoidDynamicTarget.pullNewParticles());
   renderCallback->addAudios(m_humanoidDynamicTarget.pullNewAudios());
 
-  renderCallback->addDrawables(m_statusController->drawables(), renderLayer);
+  if (drawablesWanted)
+    renderCallback->addDrawables(m_statusController->drawables(), renderLayer);
   renderCallback->addParticles(m_statusController->pullNewParticles());
   renderCallback->addAudios(m_statusController->pullNewAudios());
 
@@ -537,7 +549,8 @@ void Npc::render(RenderCallback* renderCallback) {
 
   m_tools->render(renderCallback, inToolRange(), m_shifting.get(), renderLayer);
 
-  renderCallback->addDrawables(m_tools->renderObjectPreviews(aimPosition(), walkingDirection(), inToolRange(), favoriteColor()), renderLayer);
+  if (drawablesWanted)
+    renderCallback->addDrawables(m_tools->renderObjectPreviews(aimPosition(), walkingDirection(), inToolRange(), favoriteColor()), renderLayer);
 
   m_effectEmitter->render(renderCallback);
   m_songbook->render(renderCallback);
@@ -556,7 +569,7 @@ float Npc::maxHealth() const {
 }
 
 float Npc::health() const {
-  return m_statusController->resource("health");
+  return m_statusController->resource(HealthResource);
 }
 
 DamageBarType Npc::damageBar() const {
@@ -603,6 +616,10 @@ Maybe<LuaValue> Npc::evalScript(String const& code) {
   return m_scriptComponent.eval(code);
 }
 
+void Npc::setScriptUpdateDeltaScale(unsigned scale) {
+  m_scriptComponent.setUpdateDeltaScale(scale);
+}
+
 Vec2F Npc::getAbsolutePosition(Vec2F relativePosition) const {
   if (humanoid()->facingDirection() == Direction::Left)
     relativePosition[0] *= -1;
@@ -1056,7 +1073,7 @@ bool Npc::isInteractive() const {
 }
 
 InteractAction Npc::interact(InteractRequest const& request) {
-  auto result = m_scriptComponent.invoke<Json>("interact",
+  auto result = m_scriptComponent.invoke<Json>(m_interactFunction,
       JsonObject{{"sourceId", request.sourceId}, {"sourcePosition", jsonFromVec2F(request.sourcePosition)}}).value();
 
   if (result.isNull())
@@ -1211,7 +1228,7 @@ ActiveUniqueStatusEffectSummary Npc::activeUniqueStatusEffectSummary() const {
 }
 
 float Npc::powerMultiplier() const {
-  return m_statusController->stat("powerMultiplier");
+  return m_statusController->stat(PowerMultiplierStat);
 }
 
 bool Npc::fullEnergy() const {
@@ -1275,6 +1292,11 @@ void Npc::playEmote(HumanoidEmote emote) {
   addEmote(emote);
 }
 
+bool Npc::hasDamageSources() const {
+  // Self damage notifications are pulled from the status controller every step.
+  return true;
+}
+
 List<DamageSource> Npc::damageSources() const {
   auto damageSources = m_tools->damageSources();
 
@@ -1286,7 +1308,7 @@ List<DamageSource> Npc::damageSources() const {
     DamageSource damageSource(config);
     if (auto damagePoly = damageSource.damageArea.ptr<PolyF>())
       damagePoly->rotate(m_movementController->rotation());
-    damageSource.damage *= m_statusController->stat("powerMultiplier");
+    damageSource.damage *= m_statusController->stat(PowerMultiplierStat);
     damageSources.append(damageSource);
   }
 
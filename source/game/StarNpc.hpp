@@ -117,6 +117,7 @@ public:
 
   Maybe<LuaValue> callScript(String const& func, LuaVariadic<LuaValue> const& args) override;
   Maybe<LuaValue> evalScript(String const& code) override;
+  void setScriptUpdateDeltaScale(unsigned scale) override;
 
   Vec2F mouthPosition() const override;
   Vec2F mouthPosition(bool ignoreAdjustments) const override;
@@ -174,6 +175,7 @@ public:
   void playEmote(HumanoidEmote emote) override;
 
   List<DamageSource> damageSources() const override;
+  bool hasDamageSources() const override;
 
   List<PhysicsForceRegion> forceRegions() const override;
 
@@ -275,6 +277,8 @@ private:
 
   List<BehaviorStatePtr> m_behaviors;
   mutable LuaMessageHandlingComponent<LuaStorableComponent<LuaActorMovementComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>>>> m_scriptComponent;
+  mutable LuaBaseComponent::FunctionHandle m_shouldDieFunction{"shouldDie"};
+  LuaBaseComponent::FunctionHandle m_interactFunction{"interact"};
 
   List<ChatAction> m_pendingChatActions;
   NetElementEvent m_newChatMessageEvent;
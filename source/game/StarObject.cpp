@@ -216,6 +216,7 @@ void Object::init(World* world, EntityId entityId, EntityMode mode) {
     else
       m_scriptComponent.setScripts(m_config->scripts);
     m_scriptComponent.setUpdateDelta(configValue("scriptDelta", 5).toInt());
+    m_scriptComponent.setUpdateLodEnabled(configValue("scriptUpdateLod", true).toBool());
 
     m_scriptComponent.addCallbacks("object", makeObjectCallbacks());
     m_scriptComponent.addCallbacks("config", LuaBindings::makeConfigCallbacks(bind(&Object::configValue, this, _1, _2)));
@@ -442,15 +443,17 @@ void Object::render(RenderCallback* renderCallback) {
   renderCallback->addAudios(m_networkedAnimatorDynamicTarget.pullNewAudios());
   renderCallback->addParticles(m_networkedAnimatorDynamicTarget.pullNewParticles());
 
-  if (m_networkedAnimator->constParts().size() > 0) {
-    renderCallback->addDrawables(m_networkedAnimator->drawables(position() + m_animationPosition + damageShake()), renderLayer());
-  } else {
-    if (m_orientationIndex != NPos)
-      renderCallback->addDrawables(orientationDrawables(m_orientationIndex), renderLayer(), position());
-  }
+  if (renderCallback->drawablesWanted()) {
+    if (m_networkedAnimator->constParts().size() > 0) {
+      renderCallback->addDrawables(m_networkedAnimator->drawables(position() + m_animationPosition + damageShake()), renderLayer());
+    } else {
+      if (m_orientationIndex != NPos)
+        renderCallback->addDrawables(orientationDrawables(m_orientationIndex), renderLayer(), position());
+    }
 
-  for (auto drawablePair : m_scriptedAnimator.drawables())
-    renderCallback->addDrawable(drawablePair.first, drawablePair.second.value(renderLayer()));
+    for (auto drawablePair : m_scriptedAnimator.drawables())
+      renderCallback->addDrawable(drawablePair.first, drawablePair.second.value(renderLayer()));
+  }
   renderCallback->addParticles(m_scriptedAnimator.pullNewParticles());
   renderCallback->addAudios(m_scriptedAnimator.pullNewAudios());
 }
@@ -1136,19 +1139,36 @@ LuaCallbacks Object::makeAnimatorObjectCallbacks() {
 List<DamageSource> Object::damageSources() const {
   auto damageSources = m_damageSources.get();
 
-  if (auto orientation = currentOrientation()) {
-    Json touchDamageConfig = jsonMerge(m_config->touchDamageConfig, orientation->touchDamageConfig);
-    if (!touchDamageConfig.isNull()) {
-      DamageSource ds(touchDamageConfig);
-      ds.sourceEntityId = entityId();
-      ds.team = getTeam();
-      damageSources.append(ds);
-    }
+  if (auto touchDamage = touchDamageSource()) {
+    DamageSource ds = *touchDamage;
+    ds.sourceEntityId = entityId();
+    ds.team = getTeam();
+    damageSources.append(std::move(ds));
   }
 
   return damageSources;
 }
 
+bool Object::hasDamageSources() const {
+  return !m_damageSources.get().empty() || touchDamageSource();
+}
+
+DamageSource const* Object::touchDamageSource() const {
+  auto orientation = currentOrientation();
+  if (!orientation)
+    return nullptr;
+
+  if (!m_touchDamageSourceCache || m_touchDamageSourceCache->first != m_orientationIndex) {
+    Maybe<DamageSource> touchDamageSource;
+    Json touchDamageConfig = jsonMerge(m_config->touchDamageConfig, orientation->touchDamageConfig);
+    if (!touchDamageConfig.isNull())
+      touchDamageSource = DamageSource(touchDamageConfig);
+    m_touchDamageSourceCache = make_pair(m_orientationIndex, std::move(touchDamageSource));
+  }
+
+  return m_touchDamageSourceCache->second.ptr();
+}
+
 List<PersistentStatusEffect> Object::statusEffects() const {
   return m_config->statusEffects;
 }
@@ -1224,7 +1244,7 @@ bool Object::isInteractive() const {
 InteractAction Object::interact(InteractRequest const& request) {
   Vec2F diff = world()->geometry().diff(request.sourcePosition, position());
   auto result = m_scriptComponent.invoke<Json>(
-      "onInteraction", JsonObject{{"source", JsonArray{diff[0], diff[1]}}, {"sourceId", request.sourceId}});
+      m_onInteractionFunction, JsonObject{{"source", JsonArray{diff[0], diff[1]}}, {"sourceId", request.sourceId}});
 
   if (result) {
     if (result->isNull())
@@ -1256,6 +1276,10 @@ Maybe<LuaValue> Object::evalScript(String const& code) {
   return m_scriptComponent.eval(code);
 }
 
+void Object::setScriptUpdateDeltaScale(unsigned scale) {
+  m_scriptComponent.setUpdateDeltaScale(scale);
+}
+
 Vec2F Object::mouthPosition() const {
   if (auto orientation = currentOrientation()) {
     auto pos = position() + Vec2F(orientation->boundBox.center()[0], orientation->boundBox.max()[1]);
@@ -1334,6 +1358,9 @@ List<Drawable> Object::orientationDrawables(size_t orientationIndex) const {
       }
 
       imagePart.addDirectives(m_directives);
+      // The drawables are kept until the orientation or directives change, so
+      // the renderer can find their textures by id.
+      imagePart.imageId = AssetPathId::intern(imagePart.image);
 
       if (orientation->flipImages)
         drawable.scale(Vec2F(-1, 1), drawable.boundBox(false).center() - drawable.position);
@@ -98,6 +98,7 @@ public:
   virtual PolyF statusEffectArea() const override;
 
   virtual List<DamageSource> damageSources() const override;
+  virtual bool hasDamageSources() const override;
 
   virtual Maybe<HitType> queryHit(DamageSource const& source) const override;
   Maybe<PolyF> hitPoly() const override;
@@ -115,6 +116,7 @@ public:
 
   Maybe<LuaValue> callScript(String const& func, LuaVariadic<LuaValue> const& args) override;
   Maybe<LuaValue> evalScript(String const& code) override;
+  void setScriptUpdateDeltaScale(unsigned scale) override;
 
   virtual Vec2F mouthPosition() const override;
   virtual Vec2F mouthPosition(bool ignoreAdjustments) const override;
@@ -173,6 +175,7 @@ protected:
   PolyF volume() const;
 
   LuaMessageHandlingComponent<LuaStorableComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>>> m_scriptComponent;
+  LuaBaseComponent::FunctionHandle m_onInteractionFunction{"onInteraction"};
   mutable LuaAnimationComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>> m_scriptedAnimator;
 
   NetElementTopGroup m_netGroup;
@@ -203,6 +206,8 @@ private:
 
   void ensureNetSetup();
   List<Drawable> orientationDrawables(size_t orientationIndex) const;
+  // Touch damage source of the current orientation, if it has any
+  DamageSource const* touchDamageSource() const;
 
   void addChatMessage(String const& message, Json const& config, String const& portrait = "");
 
@@ -281,6 +286,8 @@ private:
   NetElementHashMap<String, Json> m_scriptedAnimationParameters;
 
   NetElementData<List<DamageSource>> m_damageSources;
+  // Touch damage source of the orientation with the given index
+  mutable Maybe<pair<size_t, Maybe<DamageSource>>> m_touchDamageSourceCache;
 
   ClientEntityMode m_clientEntityMode;
 };
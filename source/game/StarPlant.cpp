@@ -742,25 +742,27 @@ void Plant::update(float dt, uint64_t) {
 void Plant::render(RenderCallback* renderCallback) {
   float damageXOffset = Random::randf(-0.1f, 0.1f) * m_tileDamageStatus.damageEffectPercentage();
 
-  for (auto const& plantPiece : m_pieces) {
-    auto size = Vec2F(plantPiece.imageSize) / TilePixels;
-
-    Vec2F offset = plantPiece.offset;
-    if ((m_ceiling && offset[1] <= m_tileDamageY) || (!m_ceiling && offset[1] + size[1] >= m_tileDamageY))
-      offset[0] += damageXOffset;
-
-    auto drawable = Drawable::makeImage(plantPiece.imagePath, 1.0f / TilePixels, false, offset);
-    if (plantPiece.flip)
-      drawable.scale(Vec2F(-1, 1));
-
-    if (plantPiece.rotationType == RotateCrownBranch || plantPiece.rotationType == RotateCrownLeaves) {
-      drawable.rotate(branchRotation(m_tilePosition[0], plantPiece.rotationOffset * 1.4f) * 0.7f, plantPiece.offset + Vec2F(size[0] / 2.0f, 0));
-      drawable.translate(Vec2F(0, -0.40f));
-    } else if (plantPiece.rotationType == RotateBranch || plantPiece.rotationType == RotateLeaves) {
-      drawable.rotate(branchRotation(m_tilePosition[0], plantPiece.rotationOffset * 1.4f), plantPiece.offset + Vec2F(size) / 2.0f);
+  if (renderCallback->drawablesWanted()) {
+    for (auto const& plantPiece : m_pieces) {
+      auto size = Vec2F(plantPiece.imageSize) / TilePixels;
+
+      Vec2F offset = plantPiece.offset;
+      if ((m_ceiling && offset[1] <= m_tileDamageY) || (!m_ceiling && offset[1] + size[1] >= m_tileDamageY))
+        offset[0] += damageXOffset;
+
+      auto drawable = Drawable::makeImage(plantPiece.imagePath, 1.0f / TilePixels, false, offset);
+      if (plantPiece.flip)
+        drawable.scale(Vec2F(-1, 1));
+
+      if (plantPiece.rotationType == RotateCrownBranch || plantPiece.rotationType == RotateCrownLeaves) {
+        drawable.rotate(branchRotation(m_tilePosition[0], plantPiece.rotationOffset * 1.4f) * 0.7f, plantPiece.offset + Vec2F(size[0] / 2.0f, 0));
+        drawable.translate(Vec2F(0, -0.40f));
+      } else if (plantPiece.rotationType == RotateBranch || plantPiece.rotationType == RotateLeaves) {
+        drawable.rotate(branchRotation(m_tilePosition[0], plantPiece.rotationOffset * 1.4f), plantPiece.offset + Vec2F(size) / 2.0f);
+      }
+      drawable.translate(position());
+      renderCallback->addDrawable(std::move(drawable), RenderLayerPlant);
     }
-    drawable.translate(position());
-    renderCallback->addDrawable(std::move(drawable), RenderLayerPlant);
   }
 
   if (m_tileDamageEvent) {
@@ -43,6 +43,13 @@
 
 namespace Star {
 
+namespace {
+  // Read every tick, so looked up by id rather than by name
+  StatId const HealthResource = *internStatName("health");
+  StatId const InvulnerableStat = *internStatName("invulnerable");
+  StatId const PowerMultiplierStat = *internStatName("powerMultiplier");
+}
+
 EnumMap<Player::State> const Player::StateNames{
   {Player::State::Idle, "idle"},
   {Player::State::Walk, "walk"},
@@ -512,11 +519,11 @@ ActiveUniqueStatusEffectSummary Player::activeUniqueStatusEffectSummary() const
 }
 
 float Player::powerMultiplier() const {
-  return m_statusController->stat("powerMultiplier");
+  return m_statusController->stat(PowerMultiplierStat);
 }
 
 bool Player::isDead() const {
-  return !m_statusController->resourcePositive("health");
+  return !m_statusController->resourcePositive(HealthResource);
 }
 
 void Player::kill() {
@@ -564,7 +571,7 @@ RectF Player::metaBoundBox() const {
 }
 
 Maybe<HitType> Player::queryHit(DamageSource const& source) const {
-  if (!inWorld() || isDead() || m_isAdmin || isTeleporting() || m_statusController->statPositive("invulnerable"))
+  if (!inWorld() || isDead() || m_isAdmin || isTeleporting() || m_statusController->statPositive(InvulnerableStat))
     return {};
 
   if (m_tools->queryShieldHit(source))
@@ -609,6 +616,11 @@ void Player::damagedOther(DamageNotification const& damage) {
   m_statusController->damagedOther(damage);
 }
 
+bool Player::hasDamageSources() const {
+  // Self damage notifications are pulled from the status controller every step.
+  return true;
+}
+
 List<DamageSource> Player::damageSources() const {
   return m_damageSources;
 }
@@ -1244,7 +1256,8 @@ void Player::render(RenderCallback* renderCallback) {
   auto loungeAnchor = as<LoungeAnchor>(m_movementController->entityAnchor());
   EntityRenderLayer renderLayer = loungeAnchor ? loungeAnchor->loungeRenderLayer : RenderLayerPlayer;
 
-  renderCallback->addDrawables(drawables(), renderLayer);
+  if (renderCallback->drawablesWanted())
+    renderCallback->addDrawables(drawables(), renderLayer);
   if (!isTeleporting())
     renderCallback->addOverheadBars(bars(), position());
   renderCallback->addParticles(particles());
@@ -1662,7 +1675,7 @@ uint64_t Player::currency(String const& currencyType) const {
 }
 
 float Player::health() const {
-  return m_statusController->resource("health");
+  return m_statusController->resource(HealthResource);
 }
 
 float Player::maxHealth() const {
@@ -136,6 +136,7 @@ public:
   void damagedOther(DamageNotification const& damage) override;
 
   List<DamageSource> damageSources() const override;
+  bool hasDamageSources() const override;
 
   bool shouldDestroy() const override;
   void destroy(RenderCallback* renderCallback) override;
@@ -168,7 +168,7 @@ void Projectile::disableInterpolation() {
 }
 
 bool Projectile::shouldDestroy() const {
-  if (auto res = m_scriptComponent.invoke<bool>("shouldDestroy"))
+  if (auto res = m_scriptComponent.invoke<bool>(m_shouldDestroyFunction))
     return *res;
   return m_timeToLive <= 0.0f;
 }
@@ -192,31 +192,21 @@ void Projectile::destroy(RenderCallback* renderCallback) {
 }
 
 List<DamageSource> Projectile::damageSources() const {
-  if (m_onlyHitTerrain)
-    return {};
-
-  float time_per_frame = m_animationCycle / m_config->frameNumber;
-  if ((m_config->intangibleWindup && m_animationTimer < time_per_frame * m_config->windupFrames)
-      || (m_config->intangibleWinddown && m_timeToLive < time_per_frame * m_config->winddownFrames))
+  if (!hasDamageSources())
     return {};
 
   EntityDamageTeam sourceTeam = getTeam();
 
-  auto statusEffects = m_config->statusEffects;
-  statusEffects.appendAll(m_parameters.getArray("statusEffects", {}).transformed(jsonToEphemeralStatusEffect));
-
-  float knockbackMagnitude = m_parameters.getFloat("knockback", m_config->knockback);
-
   DamageSource::Knockback knockback;
-  if (m_parameters.getBool("knockbackDirectional", m_config->knockbackDirectional))
-    knockback = Vec2F::withAngle(m_movementController->rotation()) * knockbackMagnitude;
+  if (m_knockbackDirectional)
+    knockback = Vec2F::withAngle(m_movementController->rotation()) * m_knockback;
   else
-    knockback = knockbackMagnitude;
+    knockback = m_knockback;
 
   List<DamageSource> res;
   auto addDamageSource = [&](DamageSource::DamageArea damageArea) {
     res.append(DamageSource(m_damageType, damageArea, m_power * m_powerMultiplier, true, m_sourceEntity, sourceTeam,
-        m_damageRepeatGroup, m_damageRepeatTimeout, m_damageKind, statusEffects, knockback, m_rayCheckToSource));
+        m_damageRepeatGroup, m_damageRepeatTimeout, m_damageKind, m_statusEffects, knockback, m_rayCheckToSource));
   };
 
   Vec2F positionDelta = world()->geometry().diff(m_travelLine.min(), m_travelLine.max());
@@ -243,6 +233,15 @@ List<DamageSource> Projectile::damageSources() const {
   return res;
 }
 
+bool Projectile::hasDamageSources() const {
+  if (m_onlyHitTerrain)
+    return false;
+
+  float time_per_frame = m_animationCycle / m_config->frameNumber;
+  return !((m_config->intangibleWindup && m_animationTimer < time_per_frame * m_config->windupFrames)
+      || (m_config->intangibleWinddown && m_timeToLive < time_per_frame * m_config->winddownFrames));
+}
+
 void Projectile::hitOther(EntityId entity, DamageRequest const&) {
   if (!m_parameters.getBool("piercing", m_config->piercing)) {
     auto victimEntity = world()->entity(entity);
@@ -372,6 +371,9 @@ void Projectile::render(RenderCallback* renderCallback) {
 
   m_effectEmitter->render(renderCallback);
 
+  if (!renderCallback->drawablesWanted())
+    return;
+
   String image = strf("{}:{}{}", m_config->image, m_frame, m_imageSuffix);
   Drawable drawable = Drawable::makeImage(image, 1.0f / TilePixels, true, Vec2F());
   drawable.imagePart().addDirectives(m_imageDirectives, true);
@@ -943,6 +945,10 @@ void Projectile::setup() {
   }
   m_damageRepeatGroup = m_parameters.optString("damageRepeatGroup").orMaybe(m_config->damageRepeatGroup);
   m_damageRepeatTimeout = m_parameters.optFloat("damageRepeatTimeout").orMaybe(m_config->damageRepeatTimeout);
+  m_statusEffects = m_config->statusEffects;
+  m_statusEffects.appendAll(m_parameters.getArray("statusEffects", {}).transformed(jsonToEphemeralStatusEffect));
+  m_knockback = m_parameters.getFloat("knockback", m_config->knockback);
+  m_knockbackDirectional = m_parameters.getBool("knockbackDirectional", m_config->knockbackDirectional);
 
   m_falldown = m_parameters.getBool("falldown", m_config->falldown);
 
@@ -56,6 +56,7 @@ public:
   void destroy(RenderCallback* renderCallback) override;
 
   List<DamageSource> damageSources() const override;
+  bool hasDamageSources() const override;
   void hitOther(EntityId targetEntityId, DamageRequest const& dr) override;
 
   void update(float dt, uint64_t currentStep) override;
@@ -148,6 +149,9 @@ private:
   DamageType m_damageType;
   Maybe<String> m_damageRepeatGroup;
   Maybe<float> m_damageRepeatTimeout;
+  List<EphemeralStatusEffect> m_statusEffects;
+  float m_knockback;
+  bool m_knockbackDirectional;
 
   bool m_rayCheckToSource;
   bool m_falldown;
@@ -185,6 +189,7 @@ private:
   Vec2I m_lastNonCollidingTile;
 
   mutable LuaMessageHandlingComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>> m_scriptComponent;
+  mutable LuaBaseComponent::FunctionHandle m_shouldDestroyFunction{"shouldDestroy"};
 
   OrderedHashMap<String, PhysicsForceConfig> m_physicsForces;
   OrderedHashMap<String, PhysicsCollisionConfig> m_physicsCollisions;
@@ -72,6 +72,11 @@ R"JSON(
       "scriptInstructionLimit" : 10000000,
       "scriptProfilingEnabled" : false,
       "scriptInstructionMeasureInterval" : 10000,
+      "scriptAccountingEnabled" : false,
+      "scriptAccountingStackSampleInterval" : 10,
+
+      "metricsFile" : null,
+      "metricsFileInterval" : 15,
 
       "allowAdminCommands" : true,
       "allowAdminCommandsFromAnyone" : false,
@@ -115,6 +115,10 @@ Maybe<LuaValue> Stagehand::evalScript(String const& code) {
   return m_scriptComponent.eval(code);
 }
 
+void Stagehand::setScriptUpdateDeltaScale(unsigned scale) {
+  m_scriptComponent.setUpdateDeltaScale(scale);
+}
+
 Json Stagehand::configValue(String const& name, Json const& def) const {
   return m_config.query(name, def);
 }
@@ -155,6 +159,7 @@ void Stagehand::readConfig(Json config) {
   if (m_scripted) {
     m_scriptComponent.setScripts(jsonToStringList(m_config.getArray("scripts", JsonArray())));
     m_scriptComponent.setUpdateDelta(m_config.getInt("scriptDelta", 5));
+    m_scriptComponent.setUpdateLodEnabled(m_config.getBool("scriptUpdateLod", true));
 
     if (m_config.contains("scriptStorage"))
       m_scriptComponent.setScriptStorage(m_config.getObject("scriptStorage"));
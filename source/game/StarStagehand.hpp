@@ -44,6 +44,7 @@ public:
 
   Maybe<LuaValue> callScript(String const& func, LuaVariadic<LuaValue> const& args) override;
   Maybe<LuaValue> evalScript(String const& code) override;
+  void setScriptUpdateDeltaScale(unsigned scale) override;
 
   String typeName() const;
   
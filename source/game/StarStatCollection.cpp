@@ -59,10 +59,18 @@ float StatCollection::stat(String const& statName) const {
   return m_stats.statEffectiveValue(statName);
 }
 
+float StatCollection::stat(StatId statId) const {
+  return m_stats.statEffectiveValue(statId);
+}
+
 bool StatCollection::statPositive(String const& statName) const {
   return stat(statName) > 0.0f;
 }
 
+bool StatCollection::statPositive(StatId statId) const {
+  return stat(statId) > 0.0f;
+}
+
 StringList StatCollection::resourceNames() const {
   return m_stats.resourceNames();
 }
@@ -75,10 +83,18 @@ float StatCollection::resource(String const& resourceName) const {
   return m_stats.resourceValue(resourceName);
 }
 
+float StatCollection::resource(StatId resourceId) const {
+  return m_stats.resourceValue(resourceId);
+}
+
 bool StatCollection::resourcePositive(String const& resourceName) const {
   return resource(resourceName) > 0.0f;
 }
 
+bool StatCollection::resourcePositive(StatId resourceId) const {
+  return resource(resourceId) > 0.0f;
+}
+
 void StatCollection::setResource(String const& resourceName, float value) {
   m_stats.setResourceValue(resourceName, value);
 }
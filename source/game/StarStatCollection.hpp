@@ -14,14 +14,18 @@ public:
 
   StringList statNames() const;
   float stat(String const& statName) const;
+  float stat(StatId statId) const;
   // Returns true if the stat is strictly greater than zero
   bool statPositive(String const& statName) const;
+  bool statPositive(StatId statId) const;
 
   StringList resourceNames() const;
   bool isResource(String const& resourceName) const;
   float resource(String const& resourceName) const;
+  float resource(StatId resourceId) const;
   // Returns true if the resource is strictly greater than zero
   bool resourcePositive(String const& resourceName) const;
+  bool resourcePositive(StatId resourceId) const;
 
   void setResource(String const& resourceName, float value);
   void modifyResource(String const& resourceName, float amount);
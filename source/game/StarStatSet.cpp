@@ -4,47 +4,75 @@
 namespace Star {
 
 void StatSet::addStat(String statName, float baseValue) {
-  if (!m_baseStats.insert(std::move(statName), baseValue).second)
+  StatId statId = resolveStatName(statName);
+  auto& stat = addStatSlot(statId);
+  if (stat.isBase)
     throw StatusException::format("Added duplicate stat named '{}' in StatSet", statName);
-  update(0.0f);
+  stat.isBase = true;
+  stat.baseValue = baseValue;
+  markDirty(statId);
+  recalculateDirtyStats();
 }
 
 void StatSet::removeStat(String const& statName) {
-  if (!m_baseStats.remove(statName))
+  auto statId = findStatId(statName);
+  auto stat = statId ? getStat(*statId) : nullptr;
+  if (!stat || !stat->isBase)
     throw StatusException::format("No such base stat '{}' in StatSet", statName);
-  update(0.0f);
+  auto& baseStat = statAt(*statId);
+  baseStat.isBase = false;
+  baseStat.baseValue = 0.0f;
+  markDirty(*statId);
+  recalculateDirtyStats();
 }
 
 StringList StatSet::baseStatNames() const {
-  return m_baseStats.keys();
+  StringList names;
+  for (auto const& p : m_stats) {
+    if (p.second.isBase)
+      names.append(statName(p.first));
+  }
+  return names;
 }
 
 bool StatSet::isBaseStat(String const& statName) const {
-  return m_baseStats.contains(statName);
+  if (auto statId = findStatId(statName)) {
+    if (auto stat = getStat(*statId))
+      return stat->isBase;
+  }
+  return false;
 }
 
 float StatSet::statBaseValue(String const& statName) const {
-  if (auto s = m_baseStats.ptr(statName))
-    return *s;
+  if (auto statId = findStatId(statName)) {
+    auto stat = getStat(*statId);
+    if (stat && stat->isBase)
+      return stat->baseValue;
+  }
   throw StatusException::format("No such base stat '{}' in StatSet", statName);
 }
 
 void StatSet::setStatBaseValue(String const& statName, float value) {
-  if (auto s = m_baseStats.ptr(statName)) {
-    if (*s != value) {
-      *s = value;
-      update(0.0f);
+  if (auto statId = findStatId(statName)) {
+    auto stat = getStat(*statId);
+    if (stat && stat->isBase) {
+      if (stat->baseValue != value) {
+        statAt(*statId).baseValue = value;
+        markDirty(*statId);
+        recalculateDirtyStats();
+      }
+      return;
     }
-  } else {
-    throw StatusException::format("No such base stat '{}' in StatSet", statName);
   }
+  throw StatusException::format("No such base stat '{}' in StatSet", statName);
 }
 
 StatModifierGroupId StatSet::addStatModifierGroup(List<StatModifier> modifiers) {
-  bool empty = modifiers.empty();
+  auto resolved = resolveModifiers(modifiers);
   auto id = m_statModifierGroups.add(std::move(modifiers));
-  if (!empty)
-    update(0.0f);
+  addModifierGroupStats(resolved);
+  m_resolvedModifierGroups[id] = std::move(resolved);
+  recalculateDirtyStats();
   return id;
 }
 
@@ -57,17 +85,22 @@ List<StatModifier> StatSet::statModifierGroup(StatModifierGroupId modifierGroupI
 }
 
 void StatSet::addStatModifierGroup(StatModifierGroupId groupId, List<StatModifier> modifiers) {
-  bool empty = modifiers.empty();
+  auto resolved = resolveModifiers(modifiers);
   m_statModifierGroups.add(groupId, std::move(modifiers));
-  if (!empty)
-    update(0.0f);
+  addModifierGroupStats(resolved);
+  m_resolvedModifierGroups[groupId] = std::move(resolved);
+  recalculateDirtyStats();
 }
 
 bool StatSet::setStatModifierGroup(StatModifierGroupId groupId, List<StatModifier> modifiers) {
   auto& list = m_statModifierGroups.get(groupId);
   if (list != modifiers) {
+    auto& resolved = m_resolvedModifierGroups[groupId];
+    removeModifierGroupStats(resolved);
+    resolved = resolveModifiers(modifiers);
+    addModifierGroupStats(resolved);
     list = std::move(modifiers);
-    update(0.0f);
+    recalculateDirtyStats();
     return true;
   }
 
@@ -76,7 +109,8 @@ bool StatSet::setStatModifierGroup(StatModifierGroupId groupId, List<StatModifie
 
 bool StatSet::removeStatModifierGroup(StatModifierGroupId modifierSetId) {
   if (m_statModifierGroups.remove(modifierSetId)) {
-    update(0.0f);
+    removeModifierGroupStats(m_resolvedModifierGroups.take(modifierSetId));
+    recalculateDirtyStats();
     return true;
   }
   return false;
@@ -84,8 +118,11 @@ bool StatSet::removeStatModifierGroup(StatModifierGroupId modifierSetId) {
 
 void StatSet::clearStatModifiers() {
   if (!m_statModifierGroups.empty()) {
+    for (auto const& p : m_resolvedModifierGroups)
+      removeModifierGroupStats(p.second);
     m_statModifierGroups.clear();
-    update(0.0f);
+    m_resolvedModifierGroups.clear();
+    recalculateDirtyStats();
   }
 }
 
@@ -95,42 +132,80 @@ StatModifierGroupMap const& StatSet::allStatModifierGroups() const {
 
 void StatSet::setAllStatModifierGroups(StatModifierGroupMap map) {
   if (m_statModifierGroups != map) {
+    for (auto const& p : m_resolvedModifierGroups)
+      removeModifierGroupStats(p.second);
+    m_resolvedModifierGroups.clear();
+
     m_statModifierGroups = std::move(map);
-    update(0.0f);
+    for (auto const& p : m_statModifierGroups) {
+      auto resolved = resolveModifiers(p.second);
+      addModifierGroupStats(resolved);
+      m_resolvedModifierGroups.add(p.first, std::move(resolved));
+    }
+    recalculateDirtyStats();
   }
 }
 
 StringList StatSet::effectiveStatNames() const {
-  return m_effectiveStats.keys();
+  StringList names;
+  for (auto const& p : m_stats) {
+    if (p.second.isEffective())
+      names.append(statName(p.first));
+  }
+  return names;
 }
 
 bool StatSet::isEffectiveStat(String const& statName) const {
-  return m_effectiveStats.contains(statName);
+  if (auto statId = findStatId(statName)) {
+    if (auto stat = getStat(*statId))
+      return stat->isEffective();
+  }
+  return false;
 }
 
 float StatSet::statEffectiveValue(String const& statName) const {
-  // All stat values will be added to m_effectiveStats regardless of whether a
-  // modifier is applied for it.
-  if (auto modified = m_effectiveStats.ptr(statName))
-    return modified->effectiveModifiedValue;
+  if (auto statId = findStatId(statName))
+    return statEffectiveValue(*statId);
+  return 0.0f;
+}
+
+float StatSet::statEffectiveValue(StatId statId) const {
+  // Stats that are neither base stats nor modified have no effective value.
+  auto stat = getStat(statId);
+  if (stat && stat->isEffective())
+    return stat->effectiveModifiedValue;
   else
     return 0.0f;
 }
 
 void StatSet::addResource(String resourceName, MVariant<String, float> max, MVariant<String, float> delta) {
-  auto pair = m_resources.insert({std::move(resourceName), Resource{std::move(max), std::move(delta), false, 0.0f, {}}});
+  auto resolveStat = [this](MVariant<String, float> const& statOrValue) -> MVariant<StatId, float> {
+    if (auto statName = statOrValue.ptr<String>())
+      return resolveStatName(*statName);
+    else if (auto value = statOrValue.ptr<float>())
+      return *value;
+    return {};
+  };
+
+  auto resolvedMax = resolveStat(max);
+  auto resolvedDelta = resolveStat(delta);
+  auto pair = m_resources.insert({resolveStatName(resourceName), Resource{std::move(max), std::move(delta), resolvedMax, resolvedDelta, false, 0.0f, {}}});
   if (!pair.second)
     throw StatusException::format("Added duplicate resource named '{}' in StatSet", resourceName);
-  update(0.0f);
+  updateResources(0.0f);
 }
 
 void StatSet::removeResource(String const& resourceName) {
-  if (!m_resources.remove(resourceName))
+  auto resourceId = findStatId(resourceName);
+  if (!resourceId || !m_resources.remove(*resourceId))
     throw StatusException::format("No such resource named '{}' in StatSet", resourceName);
 }
 
 StringList StatSet::resourceNames() const {
-  return m_resources.keys();
+  StringList names;
+  for (auto const& p : m_resources)
+    names.append(statName(p.first));
+  return names;
 }
 
 MVariant<String, float> StatSet::resourceMax(String const& resourceName) const {
@@ -142,11 +217,23 @@ MVariant<String, float> StatSet::resourceDelta(String const& resourceName) const
 }
 
 bool StatSet::isResource(String const& resourceName) const {
-  return m_resources.contains(resourceName);
+  if (auto resourceId = findStatId(resourceName))
+    return isResource(*resourceId);
+  return false;
+}
+
+bool StatSet::isResource(StatId resourceId) const {
+  return m_resources.contains(resourceId);
 }
 
 float StatSet::resourceValue(String const& resourceName) const {
-  if (auto r = m_resources.ptr(resourceName))
+  if (auto resourceId = findStatId(resourceName))
+    return resourceValue(*resourceId);
+  return 0.0f;
+}
+
+float StatSet::resourceValue(StatId resourceId) const {
+  if (auto r = m_resources.ptr(resourceId))
     return r->value;
   return 0.0f;
 }
@@ -161,10 +248,12 @@ float StatSet::modifyResourceValue(String const& resourceName, float amount) {
 }
 
 float StatSet::giveResourceValue(String const& resourceName, float amount) {
-  if (auto r = m_resources.ptr(resourceName)) {
-    float previousValue = r->value;
-    r->setValue(r->value + amount);
-    return r->value - previousValue;
+  if (auto resourceId = findStatId(resourceName)) {
+    if (auto r = m_resources.ptr(*resourceId)) {
+      float previousValue = r->value;
+      r->setValue(r->value + amount);
+      return r->value - previousValue;
+    }
   }
   return 0;
 }
@@ -212,6 +301,101 @@ float StatSet::modifyResourcePercentage(String const& resourceName, float resour
 }
 
 void StatSet::update(float dt) {
+  // Stats are kept up to date as they and their modifiers change, so only the
+  // resources need to be ticked.
+  updateResources(dt);
+}
+
+bool StatSet::Stat::isEffective() const {
+  return isBase || modifierCount != 0;
+}
+
+float StatSet::Resource::setValue(float v) {
+  if (maxValue)
+    value = clamp(v, 0.0f, *maxValue);
+  else
+    value = Star::max(v, 0.0f);
+  return value;
+}
+
+List<StatSet::ResolvedModifier> StatSet::resolveModifiers(List<StatModifier> const& modifiers) {
+  List<ResolvedModifier> resolved;
+  resolved.reserve(modifiers.size());
+  for (auto const& modifier : modifiers) {
+    if (auto baseMultiplier = modifier.ptr<StatBaseMultiplier>())
+      resolved.append({ResolvedModifier::Type::BaseMultiplier, resolveStatName(baseMultiplier->statName), baseMultiplier->baseMultiplier});
+    else if (auto valueModifier = modifier.ptr<StatValueModifier>())
+      resolved.append({ResolvedModifier::Type::Value, resolveStatName(valueModifier->statName), valueModifier->value});
+    else if (auto effectiveMultiplier = modifier.ptr<StatEffectiveMultiplier>())
+      resolved.append({ResolvedModifier::Type::EffectiveMultiplier, resolveStatName(effectiveMultiplier->statName), effectiveMultiplier->effectiveMultiplier});
+  }
+  return resolved;
+}
+
+StatId StatSet::resolveStatName(String const& statName) {
+  if (auto statId = internStatName(statName))
+    return *statId;
+  if (auto statId = m_localStatIds.maybe(statName))
+    return *statId;
+  StatId statId = MaxInternedStatNames + m_localStatNames.size();
+  m_localStatNames.append(statName);
+  m_localStatIds.add(statName, statId);
+  return statId;
+}
+
+Maybe<StatId> StatSet::findStatId(String const& statName) const {
+  if (auto statId = findStatName(statName))
+    return statId;
+  return m_localStatIds.maybe(statName);
+}
+
+String const& StatSet::statName(StatId statId) const {
+  if (statId < MaxInternedStatNames)
+    return internedStatName(statId);
+  return m_localStatNames.at(statId - MaxInternedStatNames);
+}
+
+StatSet::Stat const* StatSet::getStat(StatId statId) const {
+  auto i = std::lower_bound(m_stats.begin(), m_stats.end(), statId, [](auto const& p, StatId id) { return p.first < id; });
+  if (i != m_stats.end() && i->first == statId)
+    return &i->second;
+  return nullptr;
+}
+
+StatSet::Stat& StatSet::statAt(StatId statId) {
+  return *const_cast<Stat*>(const_cast<StatSet const*>(this)->getStat(statId));
+}
+
+StatSet::Stat& StatSet::addStatSlot(StatId statId) {
+  auto i = std::lower_bound(m_stats.begin(), m_stats.end(), statId, [](auto const& p, StatId id) { return p.first < id; });
+  if (i == m_stats.end() || i->first != statId)
+    i = m_stats.insert(i, {statId, Stat()});
+  return i->second;
+}
+
+void StatSet::markDirty(StatId statId) {
+  auto& stat = addStatSlot(statId);
+  if (!stat.dirty) {
+    stat.dirty = true;
+    m_dirtyStats.append(statId);
+  }
+}
+
+void StatSet::addModifierGroupStats(List<ResolvedModifier> const& modifiers) {
+  for (auto const& modifier : modifiers) {
+    ++addStatSlot(modifier.statId).modifierCount;
+    markDirty(modifier.statId);
+  }
+}
+
+void StatSet::removeModifierGroupStats(List<ResolvedModifier> const& modifiers) {
+  for (auto const& modifier : modifiers) {
+    --statAt(modifier.statId).modifierCount;
+    markDirty(modifier.statId);
+  }
+}
+
+void StatSet::recalculateDirtyStats() {
   // We use two intermediate values for calculating the effective stat value.
   // The baseModifiedValue represents the application of the base percentage
   // modifiers and the value modifiers, which only depend on the baseValue.
@@ -219,55 +403,71 @@ void StatSet::update(float dt) {
   // modifiers successively on the baseModifiedValue, causing them to stack with
   // each other in addition to base multipliers and value modifiers
 
-  // First, clear the modified values to get rid of temporary stats applied
-  // from modifiers that may no longer be there
-  m_effectiveStats.clear();
-
-  // Then we do all the StatValueModifiers and StatBaseMultipliers and
-  // compute the baseModifiedValue
+  if (m_dirtyStats.empty())
+    return;
 
-  for (auto& p : m_baseStats) {
-    auto& stat = m_effectiveStats[p.first];
-    stat.baseValue = p.second;
+  for (StatId statId : m_dirtyStats) {
+    auto& stat = statAt(statId);
     stat.baseModifiedValue = stat.baseValue;
   }
 
+  // First we do all the StatValueModifiers and StatBaseMultipliers and
+  // compute the baseModifiedValue
+
   for (auto const& p : m_statModifierGroups) {
-    for (auto const& modifier : p.second) {
-      if (auto baseMultiplier = modifier.ptr<StatBaseMultiplier>()) {
-        auto& stat = m_effectiveStats[baseMultiplier->statName];
-        stat.baseModifiedValue += (baseMultiplier->baseMultiplier - 1.0f) * stat.baseValue;
-      } else if (auto valueModifier = modifier.ptr<StatValueModifier>()) {
-        auto& stat = m_effectiveStats[valueModifier->statName];
-        stat.baseModifiedValue += valueModifier->value;
-      }
+    for (auto const& modifier : m_resolvedModifierGroups.get(p.first)) {
+      auto& stat = statAt(modifier.statId);
+      if (!stat.dirty)
+        continue;
+      if (modifier.type == ResolvedModifier::Type::BaseMultiplier)
+        stat.baseModifiedValue += (modifier.value - 1.0f) * stat.baseValue;
+      else if (modifier.type == ResolvedModifier::Type::Value)
+        stat.baseModifiedValue += modifier.value;
     }
   }
 
   // Then we do all the StatEffectiveMultipliers and compute the
   // final effectiveModifiedValue
 
-  for (auto& p : m_effectiveStats)
-    p.second.effectiveModifiedValue = p.second.baseModifiedValue;
+  for (StatId statId : m_dirtyStats) {
+    auto& stat = statAt(statId);
+    stat.effectiveModifiedValue = stat.baseModifiedValue;
+  }
 
   for (auto const& p : m_statModifierGroups) {
-    for (auto const& modifier : p.second) {
-      if (auto effectiveMultiplier = modifier.ptr<StatEffectiveMultiplier>()) {
-        auto& stat = m_effectiveStats[effectiveMultiplier->statName];
-        stat.effectiveModifiedValue *= effectiveMultiplier->effectiveMultiplier;
-      }
+    for (auto const& modifier : m_resolvedModifierGroups.get(p.first)) {
+      auto& stat = statAt(modifier.statId);
+      if (stat.dirty && modifier.type == ResolvedModifier::Type::EffectiveMultiplier)
+        stat.effectiveModifiedValue *= modifier.value;
     }
   }
 
-  // Then update all the resources due to charging and percentage tracking,
-  // after updating the stats.
+  bool removeStats = false;
+  for (StatId statId : m_dirtyStats) {
+    auto& stat = statAt(statId);
+    stat.dirty = false;
+    removeStats |= !stat.isEffective();
+  }
+  m_dirtyStats.clear();
+
+  if (removeStats)
+    m_stats.filter([](auto const& p) { return p.second.isEffective(); });
+
+  // Resources with a max stat track its percentage
+  updateResources(0.0f);
+}
+
+void StatSet::updateResources(float dt) {
+  auto statOrValue = [this](MVariant<StatId, float> const& resolved) -> Maybe<float> {
+    if (auto statId = resolved.ptr<StatId>())
+      return statEffectiveValue(*statId);
+    else if (auto value = resolved.ptr<float>())
+      return *value;
+    return {};
+  };
 
   for (auto& p : m_resources) {
-    Maybe<float> newMaxValue;
-    if (p.second.max.is<String>())
-      newMaxValue = statEffectiveValue(p.second.max.get<String>());
-    else if (p.second.max.is<float>())
-      newMaxValue = p.second.max.get<float>();
+    Maybe<float> newMaxValue = statOrValue(p.second.resolvedMax);
 
     // If the resource has a maximum value, rather than keeping the absolute
     // value of the resource the same between updates, the resource value
@@ -280,33 +480,25 @@ void StatSet::update(float dt) {
       p.second.value = clamp(p.second.value, 0.0f, *p.second.maxValue);
 
     if (dt != 0.0f) {
-      float delta = 0.0f;
-      if (p.second.delta.is<String>())
-        delta = statEffectiveValue(p.second.delta.get<String>());
-      else if (p.second.delta.is<float>())
-        delta = p.second.delta.get<float>();
+      float delta = statOrValue(p.second.resolvedDelta).value();
       p.second.setValue(p.second.value + delta * dt);
     }
   }
 }
 
-float StatSet::Resource::setValue(float v) {
-  if (maxValue)
-    value = clamp(v, 0.0f, *maxValue);
-  else
-    value = Star::max(v, 0.0f);
-  return value;
-}
-
 StatSet::Resource const& StatSet::getResource(String const& resourceName) const {
-  if (auto r = m_resources.ptr(resourceName))
-    return *r;
+  if (auto resourceId = findStatId(resourceName)) {
+    if (auto r = m_resources.ptr(*resourceId))
+      return *r;
+  }
   throw StatusException::format("No such resource '{}' in StatSet", resourceName);
 }
 
 StatSet::Resource& StatSet::getResource(String const& resourceName) {
-  if (auto r = m_resources.ptr(resourceName))
-    return *r;
+  if (auto resourceId = findStatId(resourceName)) {
+    if (auto r = m_resources.ptr(*resourceId))
+      return *r;
+  }
   throw StatusException::format("No such resource '{}' in StatSet", resourceName);
 }
 
@@ -314,16 +506,18 @@ bool StatSet::consumeResourceValue(String const& resourceName, float amount, boo
   if (amount < 0.0f)
     throw StatusException::format("StatSet, consumeResource called with negative amount '{}' {}", resourceName, amount);
 
-  if (auto r = m_resources.ptr(resourceName)) {
-    if (r->locked)
-      return false;
-
-    if (r->value >= amount) {
-      r->setValue(r->value - amount);
-      return true;
-    } else if (r->value > 0.0f && allowOverConsume) {
-      r->setValue(0.0f);
-      return true;
+  if (auto resourceId = findStatId(resourceName)) {
+    if (auto r = m_resources.ptr(*resourceId)) {
+      if (r->locked)
+        return false;
+
+      if (r->value >= amount) {
+        r->setValue(r->value - amount);
+        return true;
+      } else if (r->value > 0.0f && allowOverConsume) {
+        r->setValue(0.0f);
+        return true;
+      }
     }
   }
   return false;
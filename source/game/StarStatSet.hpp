@@ -31,6 +31,12 @@ STAR_CLASS(StatSet);
 // if "health" is a stat with a max of 100, and the current health value is 50,
 // and the max health stat is changed to 200 through any means, the health
 // value will automatically update to 100.
+//
+// Stat and resource names are interned (see internStatName), each set keeps
+// only the stats it has in a list sorted by StatId, and effective values are
+// only recalculated for the stats that a changed modifier group touches, so
+// reading stats and ticking the set never hashes a name.  Names that cannot
+// be interned because the table is full get ids local to the set instead.
 class StatSet {
 public:
   void addStat(String statName, float baseValue = 0.0f);
@@ -66,6 +72,7 @@ public:
   // stat value if a modifier is applied, or 0.0.  This is to support stats that
   // may come only from modifiers and have no base value.
   float statEffectiveValue(String const& statName) const;
+  float statEffectiveValue(StatId statId) const;
 
   void addResource(String resourceName, MVariant<String, float> max = {}, MVariant<String, float> delta = {});
   void removeResource(String const& resourceName);
@@ -75,10 +82,12 @@ public:
 
   StringList resourceNames() const;
   bool isResource(String const& resourceName) const;
+  bool isResource(StatId resourceId) const;
 
   // Will never throw, returns either the resource value, or 0.0 for a missing
   // resource
   float resourceValue(String const& resourceName) const;
+  float resourceValue(StatId resourceId) const;
 
   float setResourceValue(String const& resourceName, float value);
   float modifyResourceValue(String const& resourceName, float amount);
@@ -115,18 +124,40 @@ public:
   void update(float dt);
 
 private:
-  struct EffectiveStat {
-    float baseValue;
+  struct Stat {
+    bool isBase = false;
+    // Set while the stat is waiting to be recalculated
+    bool dirty = false;
+    // Number of modifiers across all modifier groups that apply to this stat
+    uint32_t modifierCount = 0;
+    float baseValue = 0.0f;
     // Value with just the base percent modifiers applied and the value
     // modifiers
-    float baseModifiedValue;
+    float baseModifiedValue = 0.0f;
     // Final modified value that includes the effective modifiers.
-    float effectiveModifiedValue;
+    float effectiveModifiedValue = 0.0f;
+
+    bool isEffective() const;
+  };
+
+  // A StatModifier with its stat name resolved to a StatId
+  struct ResolvedModifier {
+    enum class Type : uint8_t {
+      Value,
+      BaseMultiplier,
+      EffectiveMultiplier
+    };
+
+    Type type;
+    StatId statId;
+    float value;
   };
 
   struct Resource {
     MVariant<String, float> max;
     MVariant<String, float> delta;
+    MVariant<StatId, float> resolvedMax;
+    MVariant<StatId, float> resolvedDelta;
     bool locked;
     float value;
     Maybe<float> maxValue;
@@ -136,15 +167,45 @@ private:
     float setValue(float v);
   };
 
+  // Returns the interned id for the name, or an id local to this set at or
+  // above MaxInternedStatNames when the name table is full.
+  StatId resolveStatName(String const& statName);
+  Maybe<StatId> findStatId(String const& statName) const;
+  String const& statName(StatId statId) const;
+
+  List<ResolvedModifier> resolveModifiers(List<StatModifier> const& modifiers);
+
+  Stat const* getStat(StatId statId) const;
+  // The stat must exist
+  Stat& statAt(StatId statId);
+  Stat& addStatSlot(StatId statId);
+  void markDirty(StatId statId);
+
+  // Adds or removes the contribution of a modifier group to the modifier
+  // counts, marking every stat it touches as dirty.
+  void addModifierGroupStats(List<ResolvedModifier> const& modifiers);
+  void removeModifierGroupStats(List<ResolvedModifier> const& modifiers);
+
+  // Recalculates every dirty stat from scratch, applying modifiers in group
+  // order so that results are the same as a full recalculation, then updates
+  // resources that track stats.
+  void recalculateDirtyStats();
+  void updateResources(float dt);
+
   Resource const& getResource(String const& resourceName) const;
   Resource& getResource(String const& resourceName);
 
   bool consumeResourceValue(String const& resourceName, float amount, bool allowOverConsume);
 
-  StringMap<float> m_baseStats;
-  StringMap<EffectiveStat> m_effectiveStats;
+  // Sorted by StatId, stats that are neither base stats nor modified are
+  // removed.
+  List<pair<StatId, Stat>> m_stats;
+  StringList m_localStatNames;
+  StringMap<StatId> m_localStatIds;
+  List<StatId> m_dirtyStats;
   StatModifierGroupMap m_statModifierGroups;
-  StringMap<Resource> m_resources;
+  HashMap<StatModifierGroupId, List<ResolvedModifier>> m_resolvedModifierGroups;
+  HashMap<StatId, Resource> m_resources;
 };
 
 }
@@ -14,6 +14,11 @@
 
 namespace Star {
 
+namespace {
+  // Read every tick, so looked up by id rather than by name
+  StatId const StatusImmunityStat = *internStatName("statusImmunity");
+}
+
 StatusController::StatusController(Json const& config) : m_statCollection(config) {
   m_parentEntity = nullptr;
   m_movementController = nullptr;
@@ -169,6 +174,22 @@ bool StatusController::resourcePositive(String const& resourceName) const {
   return m_statCollection.resourcePositive(resourceName);
 }
 
+float StatusController::stat(StatId statId) const {
+  return m_statCollection.stat(statId);
+}
+
+bool StatusController::statPositive(StatId statId) const {
+  return m_statCollection.statPositive(statId);
+}
+
+float StatusController::resource(StatId resourceId) const {
+  return m_statCollection.resource(resourceId);
+}
+
+bool StatusController::resourcePositive(StatId resourceId) const {
+  return m_statCollection.resourcePositive(resourceId);
+}
+
 void StatusController::setResource(String const& resourceName, float value) {
   m_statCollection.setResource(resourceName, value);
 }
@@ -486,7 +507,7 @@ void StatusController::tickMaster(float dt) {
   m_recentDamageGiven.tick(1);
   m_recentDamageTaken.tick(1);
 
-  bool statusImmune = statPositive("statusImmunity");
+  bool statusImmune = statPositive(StatusImmunityStat);
 
   if (!statusImmune && m_movementController->liquidPercentage() > m_minimumLiquidStatusEffectPercentage) {
     auto liquidsDatabase = Root::singleton().liquidsDatabase();
@@ -532,7 +553,7 @@ void StatusController::tickMaster(float dt) {
     auto metadata = m_uniqueEffectMetadata.getNetElement(uniqueEffect.metadataId);
     if (metadata->duration && *metadata->duration <= 0.0f)
       removeUniqueEffect(key);
-    else if ((metadata->duration && statPositive("statusImmunity")) || (uniqueEffect.effectConfig.blockingStat && statPositive(*uniqueEffect.effectConfig.blockingStat)))
+    else if ((metadata->duration && statPositive(StatusImmunityStat)) || (uniqueEffect.effectConfig.blockingStat && statPositive(*uniqueEffect.effectConfig.blockingStat)))
       removeUniqueEffect(key);
   }
 
@@ -570,7 +591,7 @@ List<LightSource> StatusController::lightSources() const {
 }
 
 List<OverheadBar> StatusController::overheadBars() {
-  if (auto bars = m_primaryScript.invoke<JsonArray>("overheadBars"))
+  if (auto bars = m_primaryScript.invoke<JsonArray>(m_overheadBarsFunction))
     return bars->transformed(construct<OverheadBar>());
   return {};
 }
@@ -720,7 +741,7 @@ bool StatusController::addUniqueEffect(
   auto statusEffectDatabase = Root::singleton().statusEffectDatabase();
   if (statusEffectDatabase->isUniqueEffect(effect)) {
     auto effectConfig = statusEffectDatabase->uniqueEffectConfig(effect);
-    if ((duration && statPositive("statusImmunity")) || (effectConfig.blockingStat && statPositive(*effectConfig.blockingStat)))
+    if ((duration && statPositive(StatusImmunityStat)) || (effectConfig.blockingStat && statPositive(*effectConfig.blockingStat)))
       return false;
 
     auto& uniqueEffect = m_uniqueEffects[effect];
@@ -36,6 +36,13 @@ public:
   // Returns true if the resource is strictly greater than zero
   bool resourcePositive(String const& resourceName) const;
 
+  // Versions of the above taking interned names, for callers that look up
+  // the same stats often.
+  float stat(StatId statId) const;
+  bool statPositive(StatId statId) const;
+  float resource(StatId resourceId) const;
+  bool resourcePositive(StatId resourceId) const;
+
   void setResource(String const& resourceName, float value);
   void modifyResource(String const& resourceName, float amount);
 
@@ -229,6 +236,7 @@ private:
 
   Maybe<String> m_primaryAnimationConfig;
   StatScript m_primaryScript;
+  LuaBaseComponent::FunctionHandle m_overheadBarsFunction{"overheadBars"};
   Directives m_primaryDirectives;
   EffectAnimatorGroup::ElementId m_primaryAnimatorId;
 
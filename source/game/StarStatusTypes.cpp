@@ -1,9 +1,86 @@
 #include "StarStatusTypes.hpp"
 #include "StarJsonExtra.hpp"
 #include "StarDataStreamExtra.hpp"
+#include "StarThread.hpp"
+#include "StarArray.hpp"
 
 namespace Star {
 
+namespace {
+  // Names are appended into fixed size chunks that are never moved or freed,
+  // and published by bumping count, so any name below count can be read
+  // without locking.
+  struct StatNameTable {
+    static size_t const ChunkSize = 256;
+    static size_t const MaxChunks = MaxInternedStatNames / ChunkSize;
+
+    Mutex mutex;
+    Array<unique_ptr<String[]>, MaxChunks> chunks;
+    atomic<StatId> count{0};
+
+    String const& name(StatId statId) const {
+      return chunks[statId / ChunkSize][statId % ChunkSize];
+    }
+  };
+
+  StatNameTable& statNameTable() {
+    static StatNameTable table;
+    return table;
+  }
+
+  // Each thread indexes the names it has seen by name, catching up with the
+  // names interned since its last lookup, so lookups never lock and no index
+  // is ever rebuilt from scratch.
+  struct StatNameIndex {
+    StringMap<StatId> ids;
+    StatId count = 0;
+  };
+
+  StringMap<StatId> const& statNameIds() {
+    static thread_local StatNameIndex index;
+
+    auto& table = statNameTable();
+    StatId count = table.count.load(std::memory_order_acquire);
+    for (; index.count < count; ++index.count)
+      index.ids.add(table.name(index.count), index.count);
+    return index.ids;
+  }
+}
+
+Maybe<StatId> internStatName(String const& statName) {
+  if (auto id = statNameIds().ptr(statName))
+    return *id;
+
+  auto& table = statNameTable();
+  MutexLocker locker(table.mutex);
+  // Another thread may have interned the same name since our lookup, and
+  // nothing can be interned while the lock is held.
+  if (auto id = statNameIds().ptr(statName))
+    return *id;
+
+  StatId count = table.count.load(std::memory_order_relaxed);
+
+  size_t chunk = count / StatNameTable::ChunkSize;
+  if (chunk >= StatNameTable::MaxChunks)
+    return {};
+  if (!table.chunks[chunk])
+    table.chunks[chunk].reset(new String[StatNameTable::ChunkSize]);
+  table.chunks[chunk][count % StatNameTable::ChunkSize] = statName;
+  table.count.store(count + 1, std::memory_order_release);
+  return count;
+}
+
+Maybe<StatId> findStatName(String const& statName) {
+  return statNameIds().maybe(statName);
+}
+
+String const& internedStatName(StatId statId) {
+  auto& table = statNameTable();
+  if (statId >= table.count.load(std::memory_order_acquire))
+    throw StatusException::format("No interned stat name with id {}", statId);
+  return table.name(statId);
+}
+
 bool StatBaseMultiplier::operator==(StatBaseMultiplier const& rhs) const {
   return tie(statName, baseMultiplier) == tie(rhs.statName, rhs.baseMultiplier);
 }
@@ -9,6 +9,25 @@ namespace Star {
 
 STAR_EXCEPTION(StatusException, StarException);
 
+// Small identifier for a stat or resource name interned in the process-wide
+// stat name table.  Ids are dense, starting from zero, and never reused.
+typedef uint32_t StatId;
+
+// The table holds at most this many names.  Ids at or above it are never
+// handed out by the table, so callers can use them for names of their own.
+StatId const MaxInternedStatNames = 1024 * 256;
+
+// Returns the id for the given stat or resource name, adding it to the table
+// if it has not been interned before.  Returns nothing once the table is
+// full, in which case the caller has to keep using the name itself.
+Maybe<StatId> internStatName(String const& statName);
+// Returns the id for the given name only if it has already been interned,
+// never grows the table.
+Maybe<StatId> findStatName(String const& statName);
+// Returns the name for an id returned by internStatName.  The reference stays
+// valid for the lifetime of the process.
+String const& internedStatName(StatId statId);
+
 // Multipliers act exactly the way you'd expect: 0.0 is a 100% reduction of the
 // base stat, while 2.0 is a 100% increase. Since these are *base* multipliers
 // they do not interact with each other, thus stacking a 0.0 and a 2.0 leaves
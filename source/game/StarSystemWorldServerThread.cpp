@@ -1,6 +1,7 @@
 #include "StarSystemWorldServerThread.hpp"
 #include "StarTickRateMonitor.hpp"
 #include "StarNetPackets.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
@@ -52,9 +53,10 @@ void SystemWorldServerThread::setPause(shared_ptr<const atomic<bool>> pause) {
 
 void SystemWorldServerThread::run() {
   TickRateApproacher tickApproacher(1.0 / SystemWorldTimestep, 0.5);
+  auto updateRateMetric = Metrics::gauge("server_system_update_rate_hertz", "System world update rate", {{"system", toString(m_systemLocation)}});
 
   while (!m_stop) {
-    LogMap::set(strf("system_{}_update_rate", m_systemLocation), strf("{:4.2f}Hz", tickApproacher.rate()));
+    updateRateMetric.set(tickApproacher.rate());
 
     update();
 
@@ -10,6 +10,7 @@
 #include "StarFile.hpp"
 #include "StarJsonExtra.hpp"
 #include "StarLogging.hpp"
+#include "StarMetrics.hpp"
 #include "StarRoot.hpp"
 #include "StarSecureRandom.hpp"
 #include "StarSha256.hpp"
@@ -394,6 +395,17 @@ bool UniverseServer::executeForClient(ConnectionId clientId, function<void(World
   return success;
 }
 
+void UniverseServer::executeForWorlds(function<void(WorldId const&, WorldServer*)> action) {
+  RecursiveMutexLocker locker(m_mainLock);
+  for (auto const& worldId : m_worlds.keys()) {
+    if (auto world = getWorld(worldId)) {
+      locker.unlock();
+      world->executeAction([&worldId, &action](WorldServerThread*, WorldServer* worldServer) { action(worldId, worldServer); });
+      locker.lock();
+    }
+  }
+}
+
 void UniverseServer::disconnectClient(ConnectionId clientId, String const& reason) {
   RecursiveMutexLocker locker(m_mainLock);
   m_pendingDisconnections.add(clientId, reason);
@@ -551,6 +563,18 @@ void UniverseServer::run() {
 
   TcpServerPtr tcpServer;
 
+  auto universeTimeMetric = Metrics::gauge("server_universe_time_seconds", "Universe clock time");
+  auto clientsMetric = Metrics::gauge("server_clients", "Connected clients");
+  auto worldsMetric = Metrics::gauge("server_active_worlds", "Active worlds");
+
+  // When set, the metrics registry is periodically dumped to this file in the
+  // Prometheus text format, for use with a textfile collector.
+  Maybe<String> metricsFile;
+  if (auto file = Root::singleton().configuration()->get("metricsFile").optString())
+    metricsFile = Root::singleton().toStoragePath(*file);
+  double metricsFileInterval = Root::singleton().configuration()->get("metricsFileInterval").toDouble();
+  Timer metricsFileTimer = Timer::withTime(metricsFileInterval);
+
   while (!m_stop) {
     if (m_tcpState == TcpState::Yes && !tcpServer) {
       auto& root = Root::singleton();
@@ -584,7 +608,19 @@ void UniverseServer::run() {
       tcpServer.reset();
     }
 
-    LogMap::set("universe_time", m_universeClock->time());
+    universeTimeMetric.set(m_universeClock->time());
+    clientsMetric.set(numberOfClients());
+    worldsMetric.set(activeWorlds().size());
+
+    if (metricsFile && metricsFileTimer.timeUp()) {
+      metricsFileTimer.restart(metricsFileInterval);
+      try {
+        Metrics::writePrometheusFile(*metricsFile);
+      } catch (std::exception const& e) {
+        Logger::error("UniverseServer: could not write metrics to '{}': {}", *metricsFile, outputException(e, false));
+        metricsFile.reset();
+      }
+    }
 
     try {
       updateLua();
@@ -98,6 +98,9 @@ public:
   // Returns true if function was called, false if client was not found or in
   // an invalid connection state.
   bool executeForClient(ConnectionId clientId, function<void(WorldServer*, PlayerPtr)> action);
+  // Executes the given function on every active world in turn, in a thread
+  // safe way.
+  void executeForWorlds(function<void(WorldId const&, WorldServer*)> action);
   void disconnectClient(ConnectionId clientId, String const& reason);
   void banUser(ConnectionId clientId, String const& reason, pair<bool, bool> banType, Maybe<int> timeout);
   bool unbanIp(String const& addressString);
@@ -181,7 +181,7 @@ List<DamageNotification> Vehicle::applyDamage(DamageRequest const& damage) {
 }
 
 List<DamageNotification> Vehicle::selfDamageNotifications() {
-  return m_scriptComponent.invoke<List<DamageNotification>>("selfDamageNotifications").value();
+  return m_scriptComponent.invoke<List<DamageNotification>>(m_selfDamageNotificationsFunction).value();
 }
 
 void Vehicle::init(World* world, EntityId entityId, EntityMode mode) {
@@ -414,7 +414,7 @@ bool Vehicle::isInteractive() const {
 }
 
 InteractAction Vehicle::interact(InteractRequest const& request) {
-  auto result = m_scriptComponent.invoke<Json>("onInteraction", JsonObject{
+  auto result = m_scriptComponent.invoke<Json>(m_onInteractionFunction, JsonObject{
       {"sourceId", request.sourceId},
       {"sourcePosition", jsonFromVec2F(request.sourcePosition)},
       {"interactPosition", jsonFromVec2F(request.interactPosition)}
@@ -520,6 +520,11 @@ List<PhysicsForceRegion> Vehicle::forceRegions() const {
   return forces;
 }
 
+bool Vehicle::hasDamageSources() const {
+  // Self damage notifications come from the vehicle script every step.
+  return true;
+}
+
 List<DamageSource> Vehicle::damageSources() const {
   List<DamageSource> sources;
   for (auto const& p : m_damageSources) {
@@ -30,6 +30,7 @@ public:
   ClientEntityMode clientEntityMode() const override;
 
   List<DamageSource> damageSources() const override;
+  bool hasDamageSources() const override;
   Maybe<HitType> queryHit(DamageSource const& source) const override;
   Maybe<PolyF> hitPoly() const override;
 
@@ -158,6 +159,8 @@ private:
   NetworkedAnimator m_networkedAnimator;
   NetworkedAnimator::DynamicTarget m_networkedAnimatorDynamicTarget;
   LuaMessageHandlingComponent<LuaStorableComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>>> m_scriptComponent;
+  LuaBaseComponent::FunctionHandle m_selfDamageNotificationsFunction{"selfDamageNotifications"};
+  LuaBaseComponent::FunctionHandle m_onInteractionFunction{"onInteraction"};
   
   LuaAnimationComponent<LuaUpdatableComponent<LuaWorldComponent<LuaBaseComponent>>> m_scriptedAnimator;
   NetElementHashMap<String, Json> m_scriptedAnimationParameters;
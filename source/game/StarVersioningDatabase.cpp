@@ -187,21 +187,81 @@ VersioningDatabase::VersioningDatabase() {
 }
 
 VersionedJson VersioningDatabase::makeCurrentVersionedJson(String const& identifier, Json const& content) const {
-  RecursiveMutexLocker locker(m_mutex);
   return VersionedJson{identifier, m_currentVersions.get(identifier), content, m_currentSubVersions.value(identifier)};
 }
 
 bool VersioningDatabase::versionedJsonCurrent(VersionedJson const& versionedJson) const {
-  RecursiveMutexLocker locker(m_mutex);
-  return (versionedJson.version == m_currentVersions.get(versionedJson.identifier))
-  && (versionedJson.subVersions == m_currentSubVersions.value(versionedJson.identifier));
+  if (versionedJson.version != m_currentVersions.get(versionedJson.identifier))
+    return false;
+  if (auto currentSubVersions = m_currentSubVersions.ptr(versionedJson.identifier))
+    return versionedJson.subVersions == *currentSubVersions;
+  return versionedJson.subVersions.empty();
 }
 
 VersionedJson VersioningDatabase::updateVersionedJson(VersionedJson const& versionedJson) const {
-  RecursiveMutexLocker locker(m_mutex);
+  if (m_currentVersions.contains(versionedJson.identifier) && versionedJsonCurrent(versionedJson))
+    return versionedJson;
 
-  auto& root = Root::singleton();
   CelestialMasterDatabase celestialDatabase;
+  auto luaRoot = acquireLuaRoot();
+  auto releaseGuard = finally([&]() { releaseLuaRoot(std::move(luaRoot)); });
+  return runUpdateScripts(versionedJson, *luaRoot, celestialDatabase);
+}
+
+List<VersionedJson> VersioningDatabase::updateVersionedJsons(List<VersionedJson> versionedJsons, UpdateErrorHandler const& errorHandler) const {
+  unique_ptr<CelestialMasterDatabase> celestialDatabase;
+  LuaRootPtr luaRoot;
+  auto releaseGuard = finally([&]() {
+      if (luaRoot)
+        releaseLuaRoot(std::move(luaRoot));
+    });
+
+  for (auto& versionedJson : versionedJsons) {
+    try {
+      if (m_currentVersions.contains(versionedJson.identifier) && versionedJsonCurrent(versionedJson))
+        continue;
+
+      if (!luaRoot) {
+        celestialDatabase = make_unique<CelestialMasterDatabase>();
+        luaRoot = acquireLuaRoot();
+      }
+      versionedJson = runUpdateScripts(versionedJson, *luaRoot, *celestialDatabase);
+    } catch (std::exception const& e) {
+      if (!errorHandler)
+        throw;
+      errorHandler(versionedJson, e);
+      versionedJson.content = Json();
+    }
+  }
+
+  return versionedJsons;
+}
+
+Json VersioningDatabase::loadVersionedJson(VersionedJson const& versionedJson, String const& expectedIdentifier) const {
+  versionedJson.expectIdentifier(expectedIdentifier);
+  if (versionedJsonCurrent(versionedJson))
+    return versionedJson.content;
+  return updateVersionedJson(versionedJson).content;
+}
+
+LuaRootPtr VersioningDatabase::acquireLuaRoot() const {
+  {
+    MutexLocker locker(m_luaRootsMutex);
+    if (!m_freeLuaRoots.empty())
+      return m_freeLuaRoots.takeLast();
+  }
+  // Constructing a root is slow enough that it should not hold up other
+  // threads returning theirs.
+  return make_shared<LuaRoot>();
+}
+
+void VersioningDatabase::releaseLuaRoot(LuaRootPtr luaRoot) const {
+  MutexLocker locker(m_luaRootsMutex);
+  m_freeLuaRoots.append(std::move(luaRoot));
+}
+
+VersionedJson VersioningDatabase::runUpdateScripts(VersionedJson const& versionedJson, LuaRoot& luaRoot, CelestialMasterDatabase& celestialDatabase) const {
+  auto& root = Root::singleton();
 
   VersionedJson result = versionedJson;
   Maybe<VersionNumber> targetVersion = m_currentVersions.maybe(versionedJson.identifier);
@@ -222,7 +282,7 @@ VersionedJson VersioningDatabase::updateVersionedJson(VersionedJson const& versi
             break;
 
           if (subVersionUpdateScript.fromVersion == result.subVersions.value(subVersionScripts.first)) {
-            auto scriptContext = m_luaRoot.createContext();
+            auto scriptContext = luaRoot.createContext();
             scriptContext.load(*root.assets()->bytes(subVersionUpdateScript.script), subVersionUpdateScript.script);
             scriptContext.setCallbacks("root", LuaBindings::makeRootCallbacks());
             scriptContext.setCallbacks("sb", LuaBindings::makeUtilityCallbacks());
@@ -246,7 +306,7 @@ VersionedJson VersioningDatabase::updateVersionedJson(VersionedJson const& versi
         break;
 
       if (updateScript.fromVersion == result.version) {
-        auto scriptContext = m_luaRoot.createContext();
+        auto scriptContext = luaRoot.createContext();
         scriptContext.load(*root.assets()->bytes(updateScript.script), updateScript.script);
         scriptContext.setCallbacks("root", LuaBindings::makeRootCallbacks());
         scriptContext.setCallbacks("sb", LuaBindings::makeUtilityCallbacks());
@@ -284,13 +344,6 @@ VersionedJson VersioningDatabase::updateVersionedJson(VersionedJson const& versi
   return result;
 }
 
-Json VersioningDatabase::loadVersionedJson(VersionedJson const& versionedJson, String const& expectedIdentifier) const {
-  versionedJson.expectIdentifier(expectedIdentifier);
-  if (versionedJsonCurrent(versionedJson))
-    return versionedJson.content;
-  return updateVersionedJson(versionedJson).content;
-}
-
 LuaCallbacks VersioningDatabase::makeVersioningCallbacks() const {
   LuaCallbacks versioningCallbacks;
 
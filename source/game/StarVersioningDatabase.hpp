@@ -10,6 +10,7 @@ namespace Star {
 
 STAR_STRUCT(VersionedJson);
 STAR_CLASS(VersioningDatabase);
+STAR_CLASS(CelestialMasterDatabase);
 
 STAR_EXCEPTION(VersionedJsonException, StarException);
 STAR_EXCEPTION(VersioningDatabaseException, StarException);
@@ -47,8 +48,13 @@ struct VersionedJson {
 DataStream& operator>>(DataStream& ds, VersionedJson& versionedJson);
 DataStream& operator<<(DataStream& ds, VersionedJson const& versionedJson);
 
+// Update scripts are run in a pool of Lua roots, one is taken for each update
+// in progress, so that several threads can bring stores forward at the same
+// time.  Stores that are already current never touch the pool or take a lock.
 class VersioningDatabase {
 public:
+  typedef function<void(VersionedJson const&, std::exception const&)> UpdateErrorHandler;
+
   VersioningDatabase();
 
   // Converts the given content Json to a VersionedJson by marking it with the
@@ -65,6 +71,11 @@ public:
   // VersionedJson, otherwise throws VersioningDatabaseException.
   VersionedJson updateVersionedJson(VersionedJson const& versionedJson) const;
 
+  // Brings every given versioned json up to date, reusing one Lua root for
+  // the whole list.  If an errorHandler is given, entries that fail to update
+  // are passed to it and returned empty instead of throwing.
+  List<VersionedJson> updateVersionedJsons(List<VersionedJson> versionedJsons, UpdateErrorHandler const& errorHandler = {}) const;
+
   // Convenience method, checkts the versionedJson expected identifier and then
   // brings the given versionedJson up to date and returns the content.
   Json loadVersionedJson(VersionedJson const& versionedJson, String const& expectedIdentifier) const;
@@ -76,10 +87,14 @@ private:
     VersionNumber toVersion;
   };
 
+  LuaRootPtr acquireLuaRoot() const;
+  void releaseLuaRoot(LuaRootPtr luaRoot) const;
+
+  VersionedJson runUpdateScripts(VersionedJson const& versionedJson, LuaRoot& luaRoot, CelestialMasterDatabase& celestialDatabase) const;
   LuaCallbacks makeVersioningCallbacks() const;
 
-  mutable RecursiveMutex m_mutex;
-  mutable LuaRoot m_luaRoot;
+  mutable Mutex m_luaRootsMutex;
+  mutable List<LuaRootPtr> m_freeLuaRoots;
 
   StringMap<VersionNumber> m_currentVersions;
   StringMap<List<VersionUpdateScript>> m_versionUpdateScripts;
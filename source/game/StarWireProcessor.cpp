@@ -8,36 +8,115 @@ namespace Star {
 
 WireProcessor::WireProcessor(WorldStoragePtr worldStorage) {
   m_worldStorage = worldStorage;
+  m_lastEvaluatedCount = 0;
+
+  // Pick up any wire entities that were loaded before we were created
+  m_worldStorage->entityMap()->forAllEntities([&](EntityPtr const& entity) {
+    if (auto wireEntity = as<WireEntity>(entity))
+      m_addedWireEntities.append(wireEntity);
+  });
+}
+
+void WireProcessor::wireEntityAdded(WireEntityPtr const& wireEntity) {
+  m_addedWireEntities.append(wireEntity);
+}
+
+void WireProcessor::wiresChanged(Vec2I const& tilePosition) {
+  m_changedWires.append(tilePosition);
 }
 
 void WireProcessor::process() {
-  // First, populate all the working entities that are already live
-  m_worldStorage->entityMap()->forAllEntities([&](EntityPtr const& entity) {
-    if (auto wireEntity = as<WireEntity>(entity.get()))
+  // First, take the current output states of all the working entities, and
+  // find any that have left the world since the last step.  Only entities
+  // connected to an output that changed need to be evaluated this step.
+  List<Vec2I> removedEntities;
+  for (auto& p : m_workingWireEntities) {
+    auto& wes = p.second;
+    if (!wes.wireEntity->inWorld()) {
+      removedEntities.append(p.first);
+      continue;
+    }
+
+    bool outputsChanged = false;
+    for (size_t i = 0; i < wes.outputStates.size(); ++i) {
+      bool state = wes.wireEntity->nodeState({WireDirection::Output, i});
+      if (wes.outputStates[i] != state) {
+        wes.outputStates[i] = state;
+        outputsChanged = true;
+      }
+    }
+
+    if (outputsChanged) {
+      for (auto const& dependent : wes.dependents) {
+        if (auto dependentState = m_workingWireEntities.ptr(dependent))
+          markNeedsEvaluation(*dependentState, dependent);
+      }
+    }
+  }
+
+  // Removing an entity, adding one, or changing its wires means that its
+  // network has to be scanned again.
+  for (auto const& pos : removedEntities) {
+    invalidateNetwork(pos);
+    m_workingWireEntities.remove(pos);
+  }
+
+  for (auto const& wireEntity : take(m_addedWireEntities)) {
+    if (wireEntity->inWorld())
       populateWorking(wireEntity);
-  });
+  }
 
-  // Then, scan the network of each entity in the working set.  This may, as a
-  // side effect, load further unconnected wire entities. Because our policy is
-  // to try as hard as possible to make sure that the entire wire entity
-  // network to be loaded at once or not at all, we need to make sure that each
-  // new disconnected entity also has its network loaded and so on.  Thus, if
-  // the working entities size changes during scanning, simply scan the whole
-  // thing again until the size stops changing.
-  while (true) {
-    size_t oldWorkingSize = m_workingWireEntities.size();
-    for (auto const& p : m_workingWireEntities.keys()) {
-      if (!m_workingWireEntities.get(p).networkLoaded)
-        loadNetwork(p);
+  for (auto const& pos : take(m_changedWires))
+    invalidateNetwork(pos);
+
+  // Then, scan the network of each entity in the working set that is not
+  // part of a scanned network.  This may, as a side effect, load further
+  // unconnected wire entities. Because our policy is to try as hard as
+  // possible to make sure that the entire wire entity network to be loaded at
+  // once or not at all, we need to make sure that each new disconnected
+  // entity also has its network loaded and so on, so keep scanning until no
+  // new entities are found.
+  while (!m_unscannedWireEntities.empty()) {
+    for (auto const& pos : take(m_unscannedWireEntities)) {
+      auto wes = m_workingWireEntities.ptr(pos);
+      if (wes && !wes->networkLoaded)
+        loadNetwork(pos);
     }
-    if (m_workingWireEntities.size() == oldWorkingSize)
-      break;
   }
 
-  for (auto const& p : m_workingWireEntities)
-    p.second.wireEntity->evaluate(this);
+  // Set the sector ttl for each entire network to be equal to the highest
+  // entry, so that the entire network either lives or dies together, but
+  // without artificially extending the lifetime of the network.
+  for (auto const& network : m_networks) {
+    Maybe<float> highestTtl;
+    for (auto const& sector : network->sectors) {
+      if (auto ttl = m_worldStorage->sectorTimeToLive(sector)) {
+        if (highestTtl)
+          highestTtl = max(*highestTtl, *ttl);
+        else
+          highestTtl = *ttl;
+      }
+    }
 
-  m_workingWireEntities.clear();
+    if (highestTtl) {
+      for (auto const& sector : network->sectors)
+        m_worldStorage->setSectorTimeToLive(sector, *highestTtl);
+    }
+  }
+
+  m_lastEvaluatedCount = 0;
+  for (auto const& pos : take(m_pendingEvaluation)) {
+    auto wes = m_workingWireEntities.ptr(pos);
+    if (!wes || !wes->needsEvaluation)
+      continue;
+
+    wes->needsEvaluation = false;
+    // Evaluating an entity may run scripts that remove other entities
+    if (wes->wireEntity->inWorld()) {
+      wes->wireEntity->evaluate(this);
+      ++m_lastEvaluatedCount;
+    }
+  }
 }
 
 bool WireProcessor::readInputConnection(WireConnection const& connection) {
@@ -46,8 +125,20 @@ bool WireProcessor::readInputConnection(WireConnection const& connection) {
   return false;
 }
 
-void WireProcessor::populateWorking(WireEntity* wireEntity) {
-  auto p = m_workingWireEntities.insert(wireEntity->tilePosition(), WireEntityState{nullptr, {}, false});
+size_t WireProcessor::wireEntityCount() const {
+  return m_workingWireEntities.size();
+}
+
+size_t WireProcessor::networkCount() const {
+  return m_networks.size();
+}
+
+size_t WireProcessor::lastEvaluatedCount() const {
+  return m_lastEvaluatedCount;
+}
+
+void WireProcessor::populateWorking(WireEntityPtr const& wireEntity) {
+  auto p = m_workingWireEntities.insert(wireEntity->tilePosition(), WireEntityState{nullptr, {}, false, false, {}, {}});
   if (!p.second) {
     if (p.first->second.wireEntity != wireEntity)
       Logger::debug("Multiple wire entities share tile position: {}", wireEntity->position());
@@ -59,11 +150,12 @@ void WireProcessor::populateWorking(WireEntity* wireEntity) {
   wes.outputStates.resize(outputNodeCount);
   for (size_t i = 0; i < outputNodeCount; ++i)
     wes.outputStates[i] = wes.wireEntity->nodeState({WireDirection::Output, i});
+  markNeedsEvaluation(wes, p.first->first);
+  m_unscannedWireEntities.append(p.first->first);
 }
 
 void WireProcessor::loadNetwork(Vec2I tilePosition) {
-  HashSet<WorldStorage::Sector> networkSectors;
-  Maybe<float> highestTtl;
+  auto network = make_shared<WireNetwork>();
 
   // Recursively load a given WireEntity at the given position.  Returns true
   // if that wire entity was found.
@@ -75,16 +167,10 @@ void WireProcessor::loadNetwork(Vec2I tilePosition) {
     if (!sector)
       return false;
 
-    if (m_worldStorage->sectorLoadLevel(*sector) == SectorLoadLevel::Loaded) {
-      auto ttl = *m_worldStorage->sectorTimeToLive(*sector);
-      if (highestTtl)
-        highestTtl = max(*highestTtl, ttl);
-      else
-        highestTtl = ttl;
-    } else {
+    if (m_worldStorage->sectorLoadLevel(*sector) != SectorLoadLevel::Loaded) {
       m_worldStorage->loadSector(*sector);
       m_worldStorage->entityMap()->forEachEntity(RectF(*m_worldStorage->regionForSector(*sector)), [&](EntityPtr const& entity) {
-          if (auto wireEntity = as<WireEntity>(entity.get()))
+          if (auto wireEntity = as<WireEntity>(entity))
             populateWorking(wireEntity);
         });
     }
@@ -92,11 +178,18 @@ void WireProcessor::loadNetwork(Vec2I tilePosition) {
     auto wes = m_workingWireEntities.ptr(pos);
     if (!wes)
       return false;
-    if (wes->networkLoaded)
-      return true;
+    if (wes->networkLoaded) {
+      if (wes->network == network)
+        return true;
+      // This entity was part of another network that is now connected to this
+      // one, scan it all again as part of this network.
+      invalidateNetwork(pos);
+    }
 
     wes->networkLoaded = true;
-    networkSectors.add(*sector);
+    wes->network = network;
+    network->members.append(pos);
+    network->sectors.add(*sector);
 
     // Recursively descend into all the inbound and outbound nodes, and if we
     // ever cannot load the wire entity for a connection, go ahead and remove
@@ -120,12 +213,46 @@ void WireProcessor::loadNetwork(Vec2I tilePosition) {
 
   doLoad(tilePosition);
 
-  // Set the sector ttl for the entire network to be equal to the highest
-  // entry, so that the entire network either lives or dies together, but
-  // without artificially extending the lifetime of the network.
-  if (highestTtl) {
-    for (auto const& sector : networkSectors)
-      m_worldStorage->setSectorTimeToLive(sector, *highestTtl);
+  // Now that the connections are final, record which entities read from the
+  // outputs of each entity.  Every connected entity is in this network.
+  for (auto const& pos : network->members) {
+    auto& wes = m_workingWireEntities.get(pos);
+    size_t inboundNodeCount = wes.wireEntity->nodeCount(WireDirection::Input);
+    for (size_t i = 0; i < inboundNodeCount; ++i) {
+      for (auto const& connection : wes.wireEntity->connectionsForNode({WireDirection::Input, i})) {
+        if (auto source = m_workingWireEntities.ptr(connection.entityLocation)) {
+          if (!source->dependents.contains(pos))
+            source->dependents.append(pos);
+        }
+      }
+    }
+  }
+
+  m_networks.add(std::move(network));
+}
+
+void WireProcessor::invalidateNetwork(Vec2I const& tilePosition) {
+  auto wes = m_workingWireEntities.ptr(tilePosition);
+  if (!wes || !wes->network)
+    return;
+
+  auto network = take(wes->network);
+  m_networks.remove(network);
+  for (auto const& member : network->members) {
+    if (auto memberState = m_workingWireEntities.ptr(member)) {
+      memberState->networkLoaded = false;
+      memberState->network.reset();
+      memberState->dependents.clear();
+      markNeedsEvaluation(*memberState, member);
+      m_unscannedWireEntities.append(member);
+    }
+  }
+}
+
+void WireProcessor::markNeedsEvaluation(WireEntityState& state, Vec2I const& tilePosition) {
+  if (!state.needsEvaluation) {
+    state.needsEvaluation = true;
+    m_pendingEvaluation.append(tilePosition);
   }
 }
 
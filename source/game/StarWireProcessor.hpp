@@ -1,41 +1,84 @@
 #pragma once
 
 #include "StarWiring.hpp"
+#include "StarWorldStorage.hpp"
 
 namespace Star {
 
 STAR_CLASS(WireEntity);
-STAR_CLASS(WorldStorage);
 
 STAR_CLASS(WireProcessor);
 
 // Propogates WireEntity signals, and keeps networks of WireEntities alive
 // together.
+//
+// Wire entities and their networks are kept between steps, a network is only
+// scanned again when one of its entities is added or removed or its wires are
+// changed.  Each step, only entities with an input connected to an output
+// that has changed since the last step are evaluated.
 class WireProcessor : public WireCoordinator {
 public:
   WireProcessor(WorldStoragePtr worldStorage);
 
+  // Must be called whenever a WireEntity is added to the world, it will be
+  // picked up on the next call to process.  Removed entities are noticed
+  // automatically.
+  void wireEntityAdded(WireEntityPtr const& wireEntity);
+  // Must be called whenever wires are connected to or disconnected from the
+  // entity at the given tile position, its network will be scanned again on
+  // the next call to process.
+  void wiresChanged(Vec2I const& tilePosition);
+
   void process();
 
   bool readInputConnection(WireConnection const& connection) override;
 
+  size_t wireEntityCount() const;
+  size_t networkCount() const;
+  // Number of entities evaluated during the last call to process
+  size_t lastEvaluatedCount() const;
+
 private:
+  struct WireNetwork {
+    List<Vec2I> members;
+    HashSet<WorldStorage::Sector> sectors;
+  };
+  typedef shared_ptr<WireNetwork> WireNetworkPtr;
+
   struct WireEntityState {
-    WireEntity* wireEntity;
+    WireEntityPtr wireEntity;
     List<bool> outputStates;
+    // Set once the network this entity is a part of has been scanned
     bool networkLoaded;
+    // Set when an input of this entity may have changed since it was last
+    // evaluated
+    bool needsEvaluation;
+    WireNetworkPtr network;
+    // Entities with an input connected to any of this entity's outputs
+    List<Vec2I> dependents;
   };
 
   // Add the given WireEntity to the working entities set, populating inbound /
   // outbound nodes and states.
-  void populateWorking(WireEntity* wireEntity);
+  void populateWorking(WireEntityPtr const& wireEntity);
   // Scans a wire network, starting at an entity at the given position, while
   // also loading any unloaded entries in the network and marking each entry as
   // now having been 'networkLoaded'.
   void loadNetwork(Vec2I tilePosition);
+  // Forgets the network of the entity at the given position, if it has one,
+  // so that it will be scanned again.
+  void invalidateNetwork(Vec2I const& tilePosition);
+  void markNeedsEvaluation(WireEntityState& state, Vec2I const& tilePosition);
 
   WorldStoragePtr m_worldStorage;
   StableHashMap<Vec2I, WireEntityState> m_workingWireEntities;
+  HashSet<WireNetworkPtr> m_networks;
+
+  List<WireEntityPtr> m_addedWireEntities;
+  List<Vec2I> m_changedWires;
+  List<Vec2I> m_unscannedWireEntities;
+  List<Vec2I> m_pendingEvaluation;
+  size_t m_lastEvaluatedCount;
 };
 
 }
@@ -21,6 +21,7 @@
 #include "StarStoredFunctions.hpp"
 #include "StarInspectableEntity.hpp"
 #include "StarCurve25519.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -28,6 +29,22 @@ const std::string SECRET_BROADCAST_PUBLIC_KEY = "SecretBroadcastPublicKey";
 const std::string SECRET_BROADCAST_PREFIX = "\0Broadcast\0"s;
 
 const float WorldClient::DropDist = 6.0f;
+
+// Number of entities rendered in one job when entities are rendered on worker
+// threads.
+static size_t const EntityRenderBatchSize = 64;
+
+// Past this many changed tile regions between frames, the renderer is told
+// that every tile has changed instead.
+static size_t const MaxChangedRenderRegions = 4096;
+
+// Entity render worker threads are shared by every client world in the
+// process, and are started by the first world that uses them.
+static WorkerPool& entityRenderWorkerPool(unsigned threadCount) {
+  static WorkerPool workerPool("EntityRenderWorkerPool", threadCount);
+  return workerPool;
+}
+
 WorldClient::WorldClient(PlayerPtr mainPlayer, LuaRootPtr luaRoot) {
   auto& root = Root::singleton();
   auto assets = root.assets();
@@ -78,6 +95,12 @@ WorldClient::WorldClient(PlayerPtr mainPlayer, LuaRootPtr luaRoot) {
 
   m_damageNotificationBatchDuration = m_clientConfig.getFloat("damageNotificationBatchDuration");
 
+  m_entityRenderPadding = m_clientConfig.getInt("entityRenderPadding", 8);
+  m_lightPadding = 0;
+  m_entityRenderWorkerPool = nullptr;
+  if (unsigned renderThreads = m_clientConfig.getUInt("entityRenderWorkerThreads", 0))
+    m_entityRenderWorkerPool = &entityRenderWorkerPool(renderThreads);
+
   m_ambientSounds.setTrackFadeInTime(assets->json("/interface.config:ambientTrackFadeInTime").toFloat());
   m_ambientSounds.setTrackSwitchGrace(assets->json("/interface.config:ambientTrackSwitchGrace").toFloat());
 
@@ -92,6 +115,8 @@ WorldClient::WorldClient(PlayerPtr mainPlayer, LuaRootPtr luaRoot) {
   m_stopLightingThread = false;
   m_pendingLightReady = false;
 
+  m_renderTilesReset = true;
+
   clearWorld();
 }
 
@@ -135,7 +160,7 @@ void WorldClient::reviveMainPlayer() {
   if (inWorld() && mainPlayerDead()) {
     m_mainPlayer->revive(m_playerStart);
     m_mainPlayer->init(this, m_entityMap->reserveEntityId(), EntityMode::Master);
-    m_entityMap->addEntity(m_mainPlayer);
+    insertEntity(m_mainPlayer);
   }
 }
 
@@ -195,6 +220,11 @@ void WorldClient::removeEntity(EntityId entityId, bool andDie) {
   }
 
   m_entityMap->removeEntity(entityId);
+  auto renderPosition = std::lower_bound(m_renderOrder.begin(), m_renderOrder.end(), entityId, [](EntityPtr const& entity, EntityId entityId) {
+      return entity->entityId() < entityId;
+    });
+  if (renderPosition != m_renderOrder.end() && *renderPosition == entity)
+    m_renderOrder.erase(renderPosition);
   entity->uninit();
 }
 
@@ -228,6 +258,10 @@ void WorldClient::forAllEntities(EntityCallback callback) const {
   m_entityMap->forAllEntities(callback);
 }
 
+void WorldClient::forAllDamageSourceEntities(EntityCallback callback) const {
+  m_entityMap->forAllDamageSourceEntities(callback);
+}
+
 void WorldClient::forEachEntity(RectF const& boundBox, EntityCallback callback) const {
   if (!inWorld())
     return;
@@ -490,8 +524,18 @@ void WorldClient::render(WorldRenderData& renderData, unsigned bufferTiles) {
 
   renderData.geometry = m_geometry;
 
+  RectI window = m_clientState.window();
+  RectI tileRange = window.padded(bufferTiles);
+  renderData.tileMinPosition = tileRange.min();
+  renderData.changedTerrainRegions = take(m_changedRenderTerrain);
+  renderData.changedLiquidRegions = take(m_changedRenderLiquid);
+  renderData.tilesReset = take(m_renderTilesReset);
+
+  // Light sources further outside of the light range than light can spread
+  // have no effect, entities are also padded here because their lights may
+  // sit outside of their bound boxes.
   ClientRenderCallback lightingRenderCallback;
-  m_entityMap->forAllEntities([&](EntityPtr const& entity) {
+  m_entityMap->forEachEntity(RectF(window.padded(1 + m_lightPadding + m_entityRenderPadding)), [&](EntityPtr const& entity) {
     if (m_startupHiddenEntities.contains(entity->entityId()))
       return;
 
@@ -500,10 +544,6 @@ void WorldClient::render(WorldRenderData& renderData, unsigned bufferTiles) {
 
   renderLightSources = std::move(lightingRenderCallback.lightSources);
 
-  RectI window = m_clientState.window();
-  RectI tileRange = window.padded(bufferTiles);
-  renderData.tileMinPosition = tileRange.min();
-
   if (!m_fullBright) {
     {
       MutexLocker m_prepLocker(m_lightMapPrepMutex);
@@ -538,16 +578,83 @@ void WorldClient::render(WorldRenderData& renderData, unsigned bufferTiles) {
       if (auto& globalDirectives = parameters->globalDirectives)
         directives = &globalDirectives.get();
   }
-  m_entityMap->forAllEntities([&](EntityPtr const& entity) {
-      if (m_startupHiddenEntities.contains(entity->entityId()))
-        return;
+  // Every entity is rendered every frame so that the particles, sounds and
+  // tile previews it queues up are played on time, but entities away from
+  // the render window are asked not to build drawables.
+  RectF drawableRange = RectF(tileRange.padded(m_entityRenderPadding));
+  m_renderEntities.clear();
+  for (auto const& entity : m_renderOrder) {
+    if (m_startupHiddenEntities.contains(entity->entityId()))
+      continue;
+    auto& entry = m_renderEntities.emplaceAppend(RenderEntity{entity, {}, {}});
+    entry.renderCallback.drawDrawables = m_geometry.rectIntersectsRect(drawableRange, entity->metaBoundBox().translated(entity->position()));
+  }
 
-      ClientRenderCallback renderCallback;
+  auto renderEntity = [](RenderEntity& entry) {
+    try {
+      entry.entity->render(&entry.renderCallback);
+    } catch (StarException const&) {
+      entry.renderException = std::current_exception();
+    }
+  };
 
-      try { entity->render(&renderCallback); }
-      catch (StarException const& e) {
+  // Objects and plants only touch their own state when rendering, so they may
+  // be rendered on worker threads while every other entity is rendered here.
+  auto renderInParallel = [&](RenderEntity const& entry) {
+    if (!m_entityRenderWorkerPool)
+      return false;
+    auto type = entry.entity->entityType();
+    return type == EntityType::Object || type == EntityType::Plant;
+  };
+
+  List<RenderEntity*> parallelRenderEntities;
+  List<WorkerPoolHandle> renderJobs;
+  if (m_entityRenderWorkerPool) {
+    for (auto& entry : m_renderEntities) {
+      if (renderInParallel(entry))
+        parallelRenderEntities.append(&entry);
+    }
+    for (size_t i = 0; i < parallelRenderEntities.size(); i += EntityRenderBatchSize) {
+      renderJobs.append(m_entityRenderWorkerPool->addWork([&parallelRenderEntities, &renderEntity, i]() {
+          size_t end = min(i + EntityRenderBatchSize, parallelRenderEntities.size());
+          for (size_t j = i; j < end; ++j)
+            renderEntity(*parallelRenderEntities[j]);
+        }));
+    }
+  }
+
+  // Every job must be finished before anything is thrown, the jobs reference
+  // the render entity list.
+  std::exception_ptr renderError;
+  try {
+    for (auto& entry : m_renderEntities) {
+      if (!renderInParallel(entry))
+        renderEntity(entry);
+    }
+  } catch (...) {
+    renderError = std::current_exception();
+  }
+  for (auto const& job : renderJobs) {
+    try {
+      job.finish();
+    } catch (...) {
+      if (!renderError)
+        renderError = std::current_exception();
+    }
+  }
+  if (renderError)
+    std::rethrow_exception(renderError);
+
+  for (auto& entry : m_renderEntities) {
+    auto const& entity = entry.entity;
+    auto& renderCallback = entry.renderCallback;
+
+    if (entry.renderException) {
+      try {
+        std::rethrow_exception(entry.renderException);
+      } catch (StarException const& e) {
         if (entity->isMaster()) // this is YOUR problem!!
-          throw e; 
+          throw;
         else { // this is THEIR problem!!
           auto issue = printException(e, true);
           auto hash = hashOf(issue);
@@ -565,8 +672,9 @@ void WorldClient::render(WorldRenderData& renderData, unsigned bufferTiles) {
           renderCallback.addDrawable(std::move(drawable), RenderLayerMiddleParticle);
         }
       }
-      
+    }
 
+    if (renderCallback.drawDrawables) {
       EntityDrawables ed;
       for (auto& p : renderCallback.drawables) {
         if (directives) {
@@ -593,21 +701,21 @@ void WorldClient::render(WorldRenderData& renderData, unsigned bufferTiles) {
         }
       }
       renderData.entityDrawables.append(std::move(ed));
+    }
 
-      if (directives) {
-        int directiveIndex = unsigned(entity->entityId()) % directives->size();
-        for (auto& p : renderCallback.particles)
-          p.directives.append(directives->get(directiveIndex));
-      }
-      
-      m_particles->addParticles(std::move(renderCallback.particles));
-      m_samples.appendAll(std::move(renderCallback.audios));
-      m_previewTiles.appendAll(std::move(renderCallback.previewTiles));
-      renderData.overheadBars.appendAll(std::move(renderCallback.overheadBars));
+    if (directives) {
+      int directiveIndex = unsigned(entity->entityId()) % directives->size();
+      for (auto& p : renderCallback.particles)
+        p.directives.append(directives->get(directiveIndex));
+    }
 
-    }, [](EntityPtr const& a, EntityPtr const& b) {
-      return a->entityId() < b->entityId();
-    });
+    m_particles->addParticles(std::move(renderCallback.particles));
+    m_samples.appendAll(std::move(renderCallback.audios));
+    m_previewTiles.appendAll(std::move(renderCallback.previewTiles));
+    renderData.overheadBars.appendAll(std::move(renderCallback.overheadBars));
+  }
+  // Entities are not kept alive past the frame
+  m_renderEntities.clear();
 
   m_tileArray->tileEachTo(renderData.tiles, tileRange, [&](RenderTile& renderTile, Vec2I const&, ClientTile const& clientTile) {
       renderTile.foreground = clientTile.foreground;
@@ -680,6 +788,17 @@ void WorldClient::render(WorldRenderData& renderData, unsigned bufferTiles) {
     }
   }
 
+  // The chunks under both the old and the new previews are dirtied in this
+  // frame's render data, since the previews above were already written into
+  // its tiles.
+  if (!renderData.tilesReset) {
+    for (auto const& region : previewTileChangedRegions(m_renderedPreviewTiles, m_previewTiles)) {
+      renderData.changedTerrainRegions.append(region);
+      renderData.changedLiquidRegions.append(region);
+    }
+  }
+  m_renderedPreviewTiles = m_previewTiles;
+
   renderData.particles = &m_particles->particles();
   LogMap::set("client_render_particle_count", renderData.particles->size());
 
@@ -832,7 +951,7 @@ void WorldClient::handleIncomingPackets(List<PacketPtr> const& packets) {
       auto entity = entityFactory->netLoadEntity(entityCreate->entityType, entityCreate->storeData, netRules);
       entity->readNetState(entityCreate->firstNetState, 0.0f, netRules);
       entity->init(this, entityCreate->entityId, EntityMode::Slave);
-      m_entityMap->addEntity(entity);
+      insertEntity(entity);
 
       if (m_interpolationTracker.interpolationEnabled()) {
         entity->enableInterpolation(m_interpolationTracker.extrapolationHint());
@@ -893,9 +1012,13 @@ void WorldClient::handleIncomingPackets(List<PacketPtr> const& packets) {
           readNetTile({x, y}, tileArrayUpdate->array(x - tileRegion.xMin(), y - tileRegion.yMin()), false);
       }
       dirtyCollision(tileRegion);
+      dirtyRenderTerrain(tileRegion);
+      dirtyRenderLiquid(tileRegion);
 
     } else if (auto tileUpdate = as<TileUpdatePacket>(packet)) {
       readNetTile(tileUpdate->position, tileUpdate->tile);
+      dirtyRenderTerrain(RectI::withSize(tileUpdate->position, {1, 1}));
+      dirtyRenderLiquid(RectI::withSize(tileUpdate->position, {1, 1}));
 
     } else if (auto tileDamageUpdate = as<TileDamageUpdatePacket>(packet)) {
       if (ClientTile* tile = m_tileArray->modifyTile(tileDamageUpdate->position)) {
@@ -905,6 +1028,7 @@ void WorldClient::handleIncomingPackets(List<PacketPtr> const& packets) {
           tile->backgroundDamage = tileDamageUpdate->tileDamage;
 
         m_damagedBlocks.add(tileDamageUpdate->position);
+        dirtyRenderTerrain(RectI::withSize(tileDamageUpdate->position, {1, 1}));
       }
 
     } else if (auto tileModificationFailure = as<TileModificationFailurePacket>(packet)) {
@@ -949,6 +1073,9 @@ void WorldClient::handleIncomingPackets(List<PacketPtr> const& packets) {
 
           if (!p)
             m_predictedTiles.erase(findPrediction);
+
+          dirtyRenderTerrain(RectI::withSize(modification.first, {1, 1}));
+          dirtyRenderLiquid(RectI::withSize(modification.first, {1, 1}));
         }
 
         if (auto placeMaterial = modification.second.ptr<PlaceMaterial>()) {
@@ -961,9 +1088,11 @@ void WorldClient::handleIncomingPackets(List<PacketPtr> const& packets) {
       }
 
     } else if (auto liquidUpdate = as<TileLiquidUpdatePacket>(packet)) {
-      m_predictedTiles.remove(liquidUpdate->position);
+      if (m_predictedTiles.remove(liquidUpdate->position))
+        dirtyRenderTerrain(RectI::withSize(liquidUpdate->position, {1, 1}));
       if (ClientTile* tile = m_tileArray->modifyTile(liquidUpdate->position))
         tile->liquid = liquidUpdate->liquidUpdate.liquidLevel();
+      dirtyRenderLiquid(RectI::withSize(liquidUpdate->position, {1, 1}));
 
     } else if (auto giveItem = as<GiveItemPacket>(packet)) {
       tryGiveMainPlayerItem(itemDatabase->item(giveItem->item));
@@ -1150,6 +1279,8 @@ void WorldClient::update(float dt) {
     SpatialLogger::logPoly("world", poly, Color::Cyan.mix(Color::Red, expiry).toRgba());
     if (expiry >= 1.0f) {
       dirtyCollision(RectI::withSize(pair.first, { 1, 1 }));
+      dirtyRenderTerrain(RectI::withSize(pair.first, {1, 1}));
+      dirtyRenderLiquid(RectI::withSize(pair.first, {1, 1}));
       return true;
     } else {
       return false;
@@ -1315,8 +1446,11 @@ void WorldClient::update(float dt) {
 
   auto loadedSectors = m_tileArray->loadedSectors();
   for (auto sector : loadedSectors) {
-    if (!neededSectors.contains(sector))
+    if (!neededSectors.contains(sector)) {
       m_tileArray->unloadSector(sector);
+      dirtyRenderTerrain(m_tileArray->sectorRegion(sector));
+      dirtyRenderLiquid(m_tileArray->sectorRegion(sector));
+    }
   }
 
   if (m_collisionDebug)
@@ -1388,7 +1522,7 @@ void WorldClient::addEntity(EntityPtr const& entity, EntityId entityId) {
 
   if (entity->clientEntityMode() != ClientEntityMode::ClientSlaveOnly) {
     entity->init(this, m_entityMap->reserveEntityId(entityId), EntityMode::Master);
-    m_entityMap->addEntity(entity);
+    insertEntity(entity);
     notifyEntityCreate(entity);
   } else {
     auto entityFactory = Root::singleton().entityFactory();
@@ -1447,6 +1581,7 @@ void WorldClient::collectLiquid(List<Vec2I> const& tilePositions, LiquidId liqui
     auto& p = m_predictedTiles[pos];
     auto const& tile = m_tileArray->tile(pos);
     if ((p.liquid ? p.liquid->liquid : tile.liquid.liquid) == liquidId) {
+      dirtyRenderLiquid(RectI::withSize(pos, {1, 1}));
       if (!p.liquid)
         p.liquid.emplace(tile.liquid.liquid, tile.liquid.level);
       auto& liquid = *p.liquid;
@@ -1853,14 +1988,16 @@ void WorldClient::initWorld(WorldStartPacket const& startPacket) {
   m_weather.readUpdate(startPacket.weatherData, m_clientState.netCompatibilityRules());
 
   m_lightingCalculator.setMonochrome(Root::singleton().configuration()->get("monochromeLighting").toBool());
-  m_lightingCalculator.setParameters(assets->json("/lighting.config:lighting"));
+  auto lightingConfig = assets->json("/lighting.config:lighting");
+  m_lightingCalculator.setParameters(lightingConfig);
   m_lightIntensityCalculator.setParameters(assets->json("/lighting.config:intensity"));
+  m_lightPadding = ceil(max(lightingConfig.getFloat("spreadMaxAir"), lightingConfig.getFloat("pointMaxAir")));
 
   m_inWorld = true;
   
   if (!m_mainPlayer->isDead()) {
     m_mainPlayer->init(this, m_entityMap->reserveEntityId(), EntityMode::Master);
-    m_entityMap->addEntity(m_mainPlayer);
+    insertEntity(m_mainPlayer);
   }
   m_mainPlayer->moveTo(startPacket.playerStart);
   if (const auto& parameters = m_worldTemplate->worldParameters())
@@ -1900,6 +2037,10 @@ void WorldClient::clearWorld() {
   m_worldProperties.clear();
 
   m_tileArray.reset();
+  m_changedRenderTerrain.clear();
+  m_changedRenderLiquid.clear();
+  m_renderTilesReset = true;
+  m_renderedPreviewTiles.clear();
 
   m_damageManager.reset();
 
@@ -1945,6 +2086,14 @@ void WorldClient::notifyEntityCreate(EntityPtr const& entity) {
   }
 }
 
+void WorldClient::insertEntity(EntityPtr const& entity) {
+  m_entityMap->addEntity(entity);
+  auto renderPosition = std::lower_bound(m_renderOrder.begin(), m_renderOrder.end(), entity->entityId(), [](EntityPtr const& entity, EntityId entityId) {
+      return entity->entityId() < entityId;
+    });
+  m_renderOrder.insert(renderPosition, entity);
+}
+
 Vec2I WorldClient::environmentBiomeTrackPosition() const {
   if (!inWorld())
     return {};
@@ -2088,6 +2237,34 @@ void WorldClient::dirtyCollision(RectI const& region) {
   }
 }
 
+void WorldClient::dirtyRenderTerrain(RectI const& region) {
+  if (m_renderTilesReset)
+    return;
+
+  if (m_changedRenderTerrain.size() >= MaxChangedRenderRegions) {
+    m_changedRenderTerrain.clear();
+    m_changedRenderLiquid.clear();
+    m_renderTilesReset = true;
+    return;
+  }
+
+  m_changedRenderTerrain.append(region);
+}
+
+void WorldClient::dirtyRenderLiquid(RectI const& region) {
+  if (m_renderTilesReset)
+    return;
+
+  if (m_changedRenderLiquid.size() >= MaxChangedRenderRegions) {
+    m_changedRenderTerrain.clear();
+    m_changedRenderLiquid.clear();
+    m_renderTilesReset = true;
+    return;
+  }
+
+  m_changedRenderLiquid.append(region);
+}
+
 void WorldClient::freshenCollision(RectI const& region) {
   if (!inWorld())
     return;
@@ -2259,7 +2436,8 @@ bool WorldClient::handleSecretBroadcast(PlayerPtr player, StringView broadcast)
 
 
 void WorldClient::ClientRenderCallback::addDrawable(Drawable drawable, EntityRenderLayer renderLayer) {
-  drawables[renderLayer].append(std::move(drawable));
+  if (drawDrawables)
+    drawables[renderLayer].append(std::move(drawable));
 }
 
 void WorldClient::ClientRenderCallback::addLightSource(LightSource lightSource) {
@@ -2282,6 +2460,10 @@ void WorldClient::ClientRenderCallback::addOverheadBar(OverheadBar bar) {
   overheadBars.append(std::move(bar));
 }
 
+bool WorldClient::ClientRenderCallback::drawablesWanted() const {
+  return drawDrawables;
+}
+
 double WorldClient::epochTime() const {
   if (!inWorld())
     return 0;
@@ -2411,6 +2593,8 @@ void WorldClient::informTilePrediction(Vec2I const& pos, TileModification const&
   auto now = Time::monotonicMilliseconds();
   auto& p = m_predictedTiles[pos];
   p.time = now;
+  dirtyRenderTerrain(RectI::withSize(pos, {1, 1}));
+  dirtyRenderLiquid(RectI::withSize(pos, {1, 1}));
   if (auto placeMaterial = modification.ptr<PlaceMaterial>()) {
     if (placeMaterial->layer == TileLayer::Foreground) {
       auto materialDatabase = Root::singleton().materialDatabase();
@@ -33,6 +33,7 @@ STAR_CLASS(CelestialLog);
 STAR_CLASS(ClientContext);
 STAR_CLASS(PlayerStorage);
 STAR_STRUCT(OverheadBar);
+STAR_CLASS(WorkerPool);
 
 STAR_EXCEPTION(WorldClientException, StarException);
 
@@ -59,6 +60,7 @@ public:
   void addEntity(EntityPtr const& entity, EntityId entityId = NullEntityId) override;
   EntityPtr closestEntity(Vec2F const& center, float radius, EntityFilter selector = EntityFilter()) const override;
   void forAllEntities(EntityCallback entityCallback) const override;
+  void forAllDamageSourceEntities(EntityCallback entityCallback) const override;
   void forEachEntity(RectF const& boundBox, EntityCallback callback) const override;
   void forEachEntityLine(Vec2F const& begin, Vec2F const& end, EntityCallback callback) const override;
   void forEachEntityAtTile(Vec2I const& pos, EntityCallbackOf<TileEntity> entityCallback) const override;
@@ -193,7 +195,10 @@ private:
     void addAudio(AudioInstancePtr audio) override;
     void addTilePreview(PreviewTile preview) override;
     void addOverheadBar(OverheadBar bar) override;
+    bool drawablesWanted() const override;
 
+    // Drawables added while false are discarded
+    bool drawDrawables = true;
     Map<EntityRenderLayer, List<Drawable>> drawables;
     List<LightSource> lightSources;
     List<Particle> particles;
@@ -202,6 +207,12 @@ private:
     List<OverheadBar> overheadBars;
   };
 
+  struct RenderEntity {
+    EntityPtr entity;
+    ClientRenderCallback renderCallback;
+    std::exception_ptr renderException;
+  };
+
   struct DamageNumber {
     float amount;
     Vec2F position;
@@ -227,6 +238,8 @@ private:
   void tryGiveMainPlayerItem(ItemPtr item, bool silent = false);
 
   void notifyEntityCreate(EntityPtr const& entity);
+  // Adds the entity to the entity map and to the render order
+  void insertEntity(EntityPtr const& entity);
 
   // Queues pending (step based) updates to server,
   void queueUpdatePackets(bool sendEntityUpdates);
@@ -249,6 +262,10 @@ private:
   // based on transparency rules.
   bool readNetTile(Vec2I const& pos, NetTile const& netTile, bool updateCollision = true);
   void dirtyCollision(RectI const& region);
+  // Reports changed tiles to the renderer with the next render data, so that
+  // it only rebuilds what it has cached from those tiles.
+  void dirtyRenderTerrain(RectI const& region);
+  void dirtyRenderLiquid(RectI const& region);
   void freshenCollision(RectI const& region);
   void renderCollisionDebug();
 
@@ -295,6 +312,8 @@ private:
   atomic<bool> m_pendingLightReady;
   Vec2I m_lightMinPosition;
   List<PreviewTile> m_previewTiles;
+  // The previews that the current render chunks were built with
+  List<PreviewTile> m_renderedPreviewTiles;
 
   SkyPtr m_sky;
 
@@ -368,6 +387,9 @@ private:
 
   int m_modifiedTilePredictionTimeout;
   HashMap<Vec2I, PredictedTile> m_predictedTiles;
+  List<RectI> m_changedRenderTerrain;
+  List<RectI> m_changedRenderLiquid;
+  bool m_renderTilesReset;
   HashSet<EntityId> m_startupHiddenEntities;
 
   HashMap<DungeonId, float> m_dungeonIdGravity;
@@ -384,6 +406,18 @@ private:
 
   // used to keep track of already-printed stack traces caused by remote entities, so they don't clog the log
   HashSet<uint64_t> m_entityExceptionsLogged;
+
+  int m_entityRenderPadding;
+  // How far outside of the lit region light sources still have an effect,
+  // from the lighting config.
+  int m_lightPadding;
+  WorkerPool* m_entityRenderWorkerPool;
+  // Kept between frames so that their storage is reused
+  List<RenderEntity> m_renderEntities;
+  // Every entity in the entity map, in entity id order, which is the order
+  // they are rendered in.  Kept up to date as entities are added and removed
+  // so it never has to be sorted.
+  List<EntityPtr> m_renderOrder;
 };
 
 }
@@ -498,7 +498,9 @@ void DungeonGeneratorWorld::connectWireGroup(List<Vec2I> const& wireGroup) {
       auto in = m_worldServer->atTile<WireEntity>(inbound.entityLocation).first();
       in->addNodeConnection({WireDirection::Input, inbound.nodeIndex}, outbound);
       out->addNodeConnection({WireDirection::Output, outbound.nodeIndex}, inbound);
+      m_worldServer->wiresChanged(inbound.entityLocation);
     }
+    m_worldServer->wiresChanged(outbound.entityLocation);
   }
 }
 
@@ -701,6 +703,8 @@ void WorldGenerator::initEntity(WorldStorage*, EntityId entityId, EntityPtr cons
   entity->init(m_worldServer, entityId, EntityMode::Master);
   if (auto tileEntity = as<TileEntity>(entity))
     m_worldServer->updateTileEntityTiles(tileEntity, false, false);
+  if (auto wireEntity = as<WireEntity>(entity))
+    m_worldServer->wireEntityAdded(wireEntity);
 }
 
 void WorldGenerator::destructEntity(WorldStorage*, EntityPtr const& entity) {
@@ -74,9 +74,19 @@ namespace WorldImpl {
   template <typename TileSectorArray>
   bool breathable(World const* world, shared_ptr<TileSectorArray> const& tileSectorArray, WorldTemplateConstPtr const& worldTemplate, Vec2F const& pos);
 
+  // Sets the cells and light sources of the calculation region of an already
+  // begun light intensity calculation.
+  template <typename TileSectorArray>
+  void setLightIntensityCells(shared_ptr<TileSectorArray> const& tileSectorArray, EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
+      WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, CellularLightIntensityCalculator& lighting);
   template <typename TileSectorArray>
   float lightLevel(shared_ptr<TileSectorArray> const& tileSectorArray, EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
       WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, CellularLightIntensityCalculator& lighting, Vec2F pos);
+  // Hashes the light sources and environment light that setLightIntensityCells
+  // would use for the given calculation region, the environment light at the
+  // precision it is stored with.
+  size_t lightIntensityHash(EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
+      WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, RectI const& calculationRegion);
 
   InteractiveEntityPtr getInteractiveInRange(WorldGeometry const& geometry, EntityMapPtr const& entityMap,
       Vec2F const& targetPosition, Vec2F const& sourcePosition, float maxRange);
@@ -454,21 +464,13 @@ namespace WorldImpl {
   }
 
   template <typename TileSectorArray>
-  float lightLevel(shared_ptr<TileSectorArray> const& tileSectorArray, EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
-      WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, CellularLightIntensityCalculator& lighting, Vec2F pos) {
-    if (pos[1] < 0 || pos[1] >= worldGeometry.height())
-      return 0;
-
-    // tileEach can't handle rects that are WAY out of range.
-    pos = worldGeometry.xwrap(pos);
-
+  void setLightIntensityCells(shared_ptr<TileSectorArray> const& tileSectorArray, EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
+      WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, CellularLightIntensityCalculator& lighting) {
     Vec3F environmentLight = sky->environmentLight().toRgbF();
     float undergroundLevel = worldTemplate->undergroundLevel();
     auto materialDatabase = Root::singleton().materialDatabase();
     auto liquidsDatabase = Root::singleton().liquidsDatabase();
 
-    lighting.begin(pos);
-
     // Each column in tileEvalColumns is guaranteed to be no larger than the
     // sector size.
     CellularLightIntensityCalculator::Cell lightingCellColumn[WorldSectorSize];
@@ -501,7 +503,34 @@ namespace WorldImpl {
           lighting.addPointLight(position, light.color.sum() / 3.0f, light.pointBeam, light.beamAngle, light.beamAmbience);
       }
     }
+  }
+
+  inline size_t lightIntensityHash(EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
+      WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, RectI const& calculationRegion) {
+    size_t hash = 0;
+    if (calculationRegion.yMax() > worldTemplate->undergroundLevel())
+      hash = hashOf(sky->environmentLight().toRgb());
+
+    for (auto const& entity : entityMap->entityQuery(RectF(calculationRegion))) {
+      for (auto const& light : entity->lightSources()) {
+        Vec2F position = worldGeometry.nearestTo(Vec2F(calculationRegion.min()), light.position);
+        hashCombine(hash, hashOf(position, light.color, (int)light.type, light.pointBeam, light.beamAngle, light.beamAmbience));
+      }
+    }
+    return hash;
+  }
+
+  template <typename TileSectorArray>
+  float lightLevel(shared_ptr<TileSectorArray> const& tileSectorArray, EntityMapPtr const& entityMap, WorldGeometry const& worldGeometry,
+      WorldTemplateConstPtr const& worldTemplate, SkyConstPtr const& sky, CellularLightIntensityCalculator& lighting, Vec2F pos) {
+    if (pos[1] < 0 || pos[1] >= worldGeometry.height())
+      return 0;
 
+    // tileEach can't handle rects that are WAY out of range.
+    pos = worldGeometry.xwrap(pos);
+
+    lighting.begin(pos);
+    setLightIntensityCells(tileSectorArray, entityMap, worldGeometry, worldTemplate, sky, lighting);
     return lighting.calculate();
   }
 
@@ -26,6 +26,12 @@ struct WorldRenderData {
 
   Vec2I tileMinPosition;
   RenderTileArray tiles;
+  // Tile regions that have changed since the previous frame, so that data
+  // built from the tiles can be kept until they change.  If tilesReset is
+  // set, every tile may have changed.
+  List<RectI> changedTerrainRegions;
+  List<RectI> changedLiquidRegions;
+  bool tilesReset = true;
   Vec2I lightMinPosition;
   Lightmap lightMap;
 
@@ -49,6 +55,9 @@ struct WorldRenderData {
 
 inline void WorldRenderData::clear() {
   tiles.resize({0, 0}); // keep reserved
+  changedTerrainRegions.clear();
+  changedLiquidRegions.clear();
+  tilesReset = false;
 
   entityDrawables.clear();
   particles = nullptr;
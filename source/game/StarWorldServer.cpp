@@ -16,14 +16,19 @@
 #include "StarItemBag.hpp"
 #include "StarPhysicsEntity.hpp"
 #include "StarProjectile.hpp"
+#include "StarMonster.hpp"
+#include "StarNpc.hpp"
 #include "StarPlayer.hpp"
 #include "StarEntityFactory.hpp"
 #include "StarBiomeDatabase.hpp"
 #include "StarLiquidTypes.hpp"
+#include "StarLightLevelCache.hpp"
+#include "StarScriptedEntity.hpp"
 #include "StarFallingBlocksAgent.hpp"
 #include "StarWarpTargetEntity.hpp"
 #include "StarUniverseSettings.hpp"
 #include "StarUniverseServerLuaBindings.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -34,6 +39,20 @@ EnumMap<WorldServerFidelity> const WorldServerFidelityNames{
   {WorldServerFidelity::High, "high"}
 };
 
+// Liquid worker threads are shared by every world in the process, and are
+// started by the first world that uses them.
+static WorkerPool& liquidWorkerPool(unsigned threadCount) {
+  static WorkerPool workerPool("LiquidWorkerPool", threadCount);
+  return workerPool;
+}
+
+// Likewise for the threads that version and construct stored entities when
+// sectors are loaded.
+static WorkerPool& entityLoadWorkerPool(unsigned threadCount) {
+  static WorkerPool workerPool("EntityLoadWorkerPool", threadCount);
+  return workerPool;
+}
+
 WorldServer::WorldServer(WorldTemplatePtr const& worldTemplate, IODevicePtr storage) {
   m_worldTemplate = worldTemplate;
   m_worldStorage = make_shared<WorldStorage>(m_worldTemplate->size(), storage, make_shared<WorldGenerator>(this));
@@ -83,6 +102,7 @@ WorldServer::~WorldServer() {
 
 void WorldServer::setWorldId(String worldId) {
   m_worldId = std::move(worldId);
+  registerMetrics();
 }
 
 String const& WorldServer::worldId() const {
@@ -489,8 +509,10 @@ void WorldServer::handleIncomingPackets(ConnectionId clientId, List<PacketPtr> c
           wireEntity->removeNodeConnection(disconnectWires->wireNode, connection);
           for (auto connectedEntity : atTile<WireEntity>(connection.entityLocation))
             connectedEntity->removeNodeConnection({otherWireDirection(disconnectWires->wireNode.direction), connection.nodeIndex}, WireConnection{disconnectWires->entityPosition, disconnectWires->wireNode.nodeIndex});
+          wiresChanged(connection.entityLocation);
         }
       }
+      wiresChanged(disconnectWires->entityPosition);
 
     } else if (auto connectWire = as<ConnectWirePacket>(packet)) {
       for (auto source : atTile<WireEntity>(connectWire->inputConnection.entityLocation)) {
@@ -499,6 +521,8 @@ void WorldServer::handleIncomingPackets(ConnectionId clientId, List<PacketPtr> c
           target->addNodeConnection(WireNode{WireDirection::Output, connectWire->outputConnection.nodeIndex}, connectWire->inputConnection);
         }
       }
+      wiresChanged(connectWire->inputConnection.entityLocation);
+      wiresChanged(connectWire->outputConnection.entityLocation);
 
     } else if (auto findUniqueEntity = as<FindUniqueEntityPacket>(packet)) {
       clientInfo->outgoingPackets.append(make_shared<FindUniqueEntityResponsePacket>(findUniqueEntity->uniqueEntityId,
@@ -515,6 +539,7 @@ void WorldServer::handleIncomingPackets(ConnectionId clientId, List<PacketPtr> c
         clientInfo->outgoingPackets.append(make_shared<EntityMessageResponsePacket>(makeLeft("Unknown entity"), entityMessagePacket->uuid));
       } else {
         if (entity->isMaster()) {
+          auto accounting = scriptAccountingAttribution(entity);
           auto response = entity->receiveMessage(clientId, entityMessagePacket->message, entityMessagePacket->args);
           if (response)
             clientInfo->outgoingPackets.append(make_shared<EntityMessageResponsePacket>(makeRight(response.take()), entityMessagePacket->uuid));
@@ -587,6 +612,7 @@ bool WorldServer::sendPacket(ConnectionId clientId, PacketPtr const& packet) {
 Maybe<Json> WorldServer::receiveMessage(ConnectionId fromConnection, String const& message, JsonArray const& args) {
   Maybe<Json> result;
   for (auto& p : m_scriptContexts) {
+    auto accounting = scriptAccountingAttribution(p.first);
     result = p.second->handleMessage(message, fromConnection == ServerConnectionId, args);
     if (result)
       break;
@@ -623,6 +649,7 @@ float WorldServer::expiryTime() {
 void WorldServer::update(float dt) {
   m_currentTime += dt;
   ++m_currentStep;
+  m_lightLevelCache->update(m_currentTime);
   for (auto const& pair : m_clientInfo)
     pair.second->interpolationTracker.update(m_currentTime);
 
@@ -643,9 +670,25 @@ void WorldServer::update(float dt) {
   if (doBreakChecks)
     m_needsGlobalBreakCheck = false;
 
+  List<RectF> lodWindows;
+  if (m_scriptUpdateLodEnabled) {
+    lodWindows = m_scriptUpdateLodWindows;
+    for (auto const& pair : m_clientInfo)
+      lodWindows.append(RectF(pair.second->clientState.window()));
+  }
+
   List<EntityId> toRemove;
   m_entityMap->updateAllEntities([&](EntityPtr const& entity) {
-      entity->update(dt, m_currentStep);
+      if (m_scriptUpdateLodEnabled && entity->isMaster()) {
+        auto type = entity->entityType();
+        if (type == EntityType::Monster || type == EntityType::Npc || type == EntityType::Object || type == EntityType::Stagehand)
+          as<ScriptedEntity>(entity)->setScriptUpdateDeltaScale(scriptUpdateDeltaScale(entity->position(), lodWindows));
+      }
+
+      {
+        auto accounting = scriptAccountingAttribution(entity);
+        entity->update(dt, m_currentStep);
+      }
 
       if (auto tileEntity = as<TileEntity>(entity)) {
         // Only do break checks on objects if all sectors the object touches
@@ -662,8 +705,10 @@ void WorldServer::update(float dt) {
       return a->entityType() < b->entityType();
     });
 
-  for (auto& pair : m_scriptContexts)
+  for (auto& pair : m_scriptContexts) {
+    auto accounting = scriptAccountingAttribution(pair.first);
     pair.second->update(pair.second->updateDt(dt));
+  }
 
   updateDamage(dt);
   if (shouldRunThisStep("wiringUpdate"))
@@ -731,10 +776,12 @@ void WorldServer::update(float dt) {
 
   m_expiryTimer.tick(dt);
 
-  LogMap::set(strf("server_{}_entities", m_worldId), strf("{} in {} sectors", m_entityMap->size(), m_tileArray->loadedSectorCount()));
-  LogMap::set(strf("server_{}_time", m_worldId), strf("age = {:4.2f}, day = {:4.2f}/{:4.2f}s", epochTime(), timeOfDay(), dayLength()));
-  LogMap::set(strf("server_{}_active_liquid", m_worldId), m_liquidEngine->activeCells());
-  LogMap::set(strf("server_{}_lua_mem", m_worldId), m_luaRoot->luaMemoryUsage());
+  m_metrics.entities.set(m_entityMap->size());
+  m_metrics.sectors.set(m_tileArray->loadedSectorCount());
+  m_metrics.epochTime.set(epochTime());
+  m_metrics.timeOfDay.set(timeOfDay());
+  m_metrics.activeLiquid.set(m_liquidEngine->activeCells());
+  m_metrics.luaMemory.set(m_luaRoot->luaMemoryUsage());
 }
 
 WorldGeometry WorldServer::geometry() const {
@@ -781,6 +828,8 @@ void WorldServer::addEntity(EntityPtr const& entity, EntityId entityId) {
 
   if (auto tileEntity = as<TileEntity>(entity))
     updateTileEntityTiles(tileEntity);
+  if (auto wireEntity = as<WireEntity>(entity))
+    wireEntityAdded(wireEntity);
 }
 
 EntityPtr WorldServer::closestEntity(Vec2F const& center, float radius, EntityFilter selector) const {
@@ -791,6 +840,10 @@ void WorldServer::forAllEntities(EntityCallback callback) const {
   m_entityMap->forAllEntities(callback);
 }
 
+void WorldServer::forAllDamageSourceEntities(EntityCallback callback) const {
+  m_entityMap->forAllDamageSourceEntities(callback);
+}
+
 void WorldServer::forEachEntity(RectF const& boundBox, EntityCallback callback) const {
   m_entityMap->forEachEntity(boundBox, callback);
 }
@@ -1354,6 +1407,26 @@ void WorldServer::setTileProtectionEnabled(bool enabled) {
   m_tileProtectionEnabled = enabled;
 }
 
+void WorldServer::setLightLevelStalenessBudget(double seconds) {
+  m_lightLevelCache->setStalenessBudget(seconds);
+}
+
+bool WorldServer::scriptUpdateLodEnabled() const {
+  return m_scriptUpdateLodEnabled;
+}
+
+void WorldServer::setScriptUpdateLodEnabled(bool enabled) {
+  if (m_scriptUpdateLodEnabled && !enabled) {
+    for (auto const& entity : m_entityMap->all<ScriptedEntity>())
+      entity->setScriptUpdateDeltaScale(1);
+  }
+  m_scriptUpdateLodEnabled = enabled;
+}
+
+void WorldServer::setScriptUpdateLodWindows(List<RectF> windows) {
+  m_scriptUpdateLodWindows = std::move(windows);
+}
+
 void WorldServer::setDungeonId(RectI const& tileArea, DungeonId dungeonId) {
   for (int x = tileArea.xMin(); x < tileArea.xMax(); ++x) {
     for (int y = tileArea.yMin(); y < tileArea.yMax(); ++y) {
@@ -1397,10 +1470,14 @@ void WorldServer::init(bool firstTime) {
   auto assets = root.assets();
   auto liquidsDatabase = root.liquidsDatabase();
 
+  registerMetrics();
+
   m_serverConfig = assets->json("/worldserver.config");
   setFidelity(WorldServerFidelity::Medium);
 
   m_worldStorage->setFloatingDungeonWorld(isFloatingDungeonWorld());
+  if (unsigned entityLoadThreads = m_serverConfig.optUInt("entityLoadWorkerThreads").value(0))
+    m_worldStorage->setEntityLoadWorkerPool(&entityLoadWorkerPool(entityLoadThreads));
 
   m_currentTime = 0;
   m_currentStep = 0;
@@ -1417,7 +1494,19 @@ void WorldServer::init(bool firstTime) {
 
   m_sky = make_shared<Sky>(m_worldTemplate->skyParameters(), false);
 
-  m_lightIntensityCalculator.setParameters(assets->json("/lighting.config:intensity"));
+  m_lightLevelCache = make_shared<LightLevelCache>(m_geometry, assets->json("/lighting.config:intensity"), [this](CellularLightIntensityCalculator& lighting) {
+      WorldImpl::setLightIntensityCells(m_tileArray, m_entityMap, m_geometry, m_worldTemplate, m_sky, lighting);
+    }, [this](RectI const& calculationRegion) {
+      return WorldImpl::lightIntensityHash(m_entityMap, m_geometry, m_worldTemplate, m_sky, calculationRegion);
+    });
+  m_lightLevelCache->setStalenessBudget(m_serverConfig.optFloat("lightLevelCacheStaleness").value(0.5f));
+
+  auto scriptUpdateLod = m_serverConfig.get("scriptUpdateLod", JsonObject());
+  m_scriptUpdateLodEnabled = scriptUpdateLod.getBool("enabled", false);
+  m_scriptUpdateLodLevels.clear();
+  for (auto const& level : scriptUpdateLod.getArray("levels", {}))
+    m_scriptUpdateLodLevels.append({level.getFloat(0), level.getUInt(1)});
+  sortByComputedValue(m_scriptUpdateLodLevels, [](pair<float, unsigned> const& level) { return level.first; });
 
   m_entityMessageResponses = {};
 
@@ -1431,6 +1520,8 @@ void WorldServer::init(bool firstTime) {
   m_liquidEngine = make_shared<LiquidCellEngine<LiquidId>>(liquidsDatabase->liquidEngineParameters(), make_shared<LiquidWorld>(this));
   for (auto liquidSettings : liquidsDatabase->allLiquidSettings())
     m_liquidEngine->setLiquidTickDelta(liquidSettings->id, liquidSettings->tickDelta);
+  if (unsigned liquidThreads = m_serverConfig.optUInt("liquidEngineWorkerThreads").value(0))
+    m_liquidEngine->setWorkerPool(&liquidWorkerPool(liquidThreads));
 
   m_fallingBlocksAgent = make_shared<FallingBlocksAgent>(make_shared<FallingBlocksWorld>(this));
 
@@ -2142,7 +2233,27 @@ void WorldServer::checkEntityBreaks(RectF const& rect) {
     tileEntity->checkBroken();
 }
 
+unsigned WorldServer::scriptUpdateDeltaScale(Vec2F const& position, List<RectF> const& clientWindows) const {
+  // Worlds without clients keep running at the full rate, farms, timers and
+  // wiring on them are left running on purpose.
+  if (clientWindows.empty())
+    return 1;
+
+  float distance = highest<float>();
+  for (auto const& window : clientWindows)
+    distance = min(distance, vmag(m_geometry.diffToNearestCoordInBox(window, position)));
+
+  unsigned scale = 1;
+  for (auto const& level : m_scriptUpdateLodLevels) {
+    if (distance < level.first)
+      break;
+    scale = level.second;
+  }
+  return scale;
+}
+
 void WorldServer::queueTileUpdates(Vec2I const& pos) {
+  m_lightLevelCache->invalidate(RectI::withSize(pos, {1, 1}));
   for (auto const& pair : m_clientInfo) {
     if (pair.second->activeSectors.contains(m_tileArray->sectorFor(pos)))
       pair.second->pendingTileUpdates.add(pos);
@@ -2218,6 +2329,8 @@ void WorldServer::removeEntity(EntityId entityId, bool andDie) {
   if (!entity)
     return;
 
+  auto accounting = scriptAccountingAttribution(entity);
+
   if (auto tileEntity = as<TileEntity>(entity))
     updateTileEntityTiles(tileEntity, true);
 
@@ -2235,6 +2348,7 @@ void WorldServer::removeEntity(EntityId entityId, bool andDie) {
 
   m_entityMap->removeEntity(entityId);
   entity->uninit();
+  m_scriptAccountingLabels.remove(entityId);
 }
 
 float WorldServer::windLevel(Vec2F const& pos) const {
@@ -2242,7 +2356,11 @@ float WorldServer::windLevel(Vec2F const& pos) const {
 }
 
 float WorldServer::lightLevel(Vec2F const& pos) const {
-  return WorldImpl::lightLevel(m_tileArray, m_entityMap, m_geometry, m_worldTemplate, m_sky, m_lightIntensityCalculator, pos);
+  return m_lightLevelCache->lightLevel(pos);
+}
+
+List<float> WorldServer::lightLevels(List<Vec2F> const& positions) const {
+  return m_lightLevelCache->lightLevels(positions);
 }
 
 void WorldServer::setDungeonBreathable(DungeonId dungeonId, Maybe<bool> breathable) {
@@ -2366,6 +2484,50 @@ float WorldServer::timeOfDay() const {
   return m_sky->timeOfDay();
 }
 
+void WorldServer::registerMetrics() {
+  MetricLabels labels = {{"world", m_worldId}};
+  m_metrics.entities = Metrics::gauge("server_world_entities", "Entities in the world", labels);
+  m_metrics.sectors = Metrics::gauge("server_world_loaded_sectors", "Loaded tile sectors", labels);
+  m_metrics.activeLiquid = Metrics::gauge("server_world_active_liquid_cells", "Liquid cells being simulated", labels);
+  m_metrics.luaMemory = Metrics::gauge("server_world_lua_memory_bytes", "Memory used by the world Lua engine", labels);
+  m_metrics.epochTime = Metrics::gauge("server_world_epoch_time_seconds", "World age", labels);
+  m_metrics.timeOfDay = Metrics::gauge("server_world_time_of_day_seconds", "Time into the current world day", labels);
+}
+
+Maybe<LuaAccountingAttribution> WorldServer::scriptAccountingAttribution(EntityPtr const& entity) {
+  auto& luaEngine = m_luaRoot->luaEngine();
+  if (!luaEngine.accountingEnabled() || !is<ScriptedEntity>(entity))
+    return {};
+
+  auto uniqueId = entity->uniqueId();
+  auto& label = m_scriptAccountingLabels[entity->entityId()];
+  if (!label.label || label.uniqueId != uniqueId) {
+    String name;
+    if (auto monster = as<Monster>(entity))
+      name = monster->typeName();
+    else if (auto npc = as<Npc>(entity))
+      name = npc->npcType();
+    else
+      name = entity->name();
+    String text = strf("{}:{}", EntityTypeNames.getRight(entity->entityType()), name);
+    if (uniqueId)
+      text = strf("{}:{}", text, *uniqueId);
+    label.uniqueId = std::move(uniqueId);
+    label.label = make_shared<String const>(std::move(text));
+  }
+  return luaEngine.accountingAttribution(label.label);
+}
+
+Maybe<LuaAccountingAttribution> WorldServer::scriptAccountingAttribution(String const& contextName) {
+  auto& luaEngine = m_luaRoot->luaEngine();
+  if (!luaEngine.accountingEnabled())
+    return {};
+  auto& label = m_scriptContextAccountingLabels[contextName];
+  if (!label)
+    label = make_shared<String const>(strf("world:{}", contextName));
+  return luaEngine.accountingAttribution(label);
+}
+
 LuaRootPtr WorldServer::luaRoot() {
   return m_luaRoot;
 }
@@ -2387,6 +2549,7 @@ RpcPromise<Json> WorldServer::sendEntityMessage(Variant<EntityId, String> const&
   if (!entity) {
     return RpcPromise<Json>::createFailed("Unknown entity");
   } else if (entity->isMaster()) {
+    auto accounting = scriptAccountingAttribution(entity);
     if (auto resp = entity->receiveMessage(ServerConnectionId, message, args))
       return RpcPromise<Json>::createFulfilled(resp.take());
     else
@@ -2654,6 +2817,16 @@ void WorldServer::wire(Vec2I const& outputPosition, size_t outputIndex, Vec2I co
       target->addNodeConnection(WireNode{WireDirection::Output, output.nodeIndex}, input);
     }
   }
+  wiresChanged(input.entityLocation);
+  wiresChanged(output.entityLocation);
+}
+
+void WorldServer::wireEntityAdded(WireEntityPtr const& wireEntity) {
+  m_wireProcessor->wireEntityAdded(wireEntity);
+}
+
+void WorldServer::wiresChanged(Vec2I const& tilePosition) {
+  m_wireProcessor->wiresChanged(tilePosition);
 }
 
 }
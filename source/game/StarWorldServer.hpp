@@ -15,6 +15,7 @@
 #include "StarWorldRenderData.hpp"
 #include "StarWarping.hpp"
 #include "StarRpcThreadPromise.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
@@ -28,8 +29,10 @@ STAR_CLASS(EntityMap);
 STAR_CLASS(WorldStorage);
 STAR_CLASS(FallingBlocksAgent);
 STAR_CLASS(DungeonDefinition);
+STAR_CLASS(LightLevelCache);
 STAR_CLASS(WorldServer);
 STAR_CLASS(TileEntity);
+STAR_CLASS(WireEntity);
 STAR_CLASS(UniverseSettings);
 STAR_CLASS(UniverseServer);
 
@@ -144,6 +147,7 @@ public:
   void addEntity(EntityPtr const& entity, EntityId entityId = NullEntityId) override;
   EntityPtr closestEntity(Vec2F const& center, float radius, EntityFilter selector = EntityFilter()) const override;
   void forAllEntities(EntityCallback entityCallback) const override;
+  void forAllDamageSourceEntities(EntityCallback entityCallback) const override;
   void forEachEntity(RectF const& boundBox, EntityCallback callback) const override;
   void forEachEntityLine(Vec2F const& begin, Vec2F const& end, EntityCallback callback) const override;
   void forEachEntityAtTile(Vec2I const& pos, EntityCallbackOf<TileEntity> entityCallback) const override;
@@ -194,6 +198,19 @@ public:
   // used to globally, temporarily disable protection for certain operations
   void setTileProtectionEnabled(bool enabled);
 
+  // Light level queries are answered from per sector light levels that are
+  // at most this many seconds old, zero calculates every query separately.
+  void setLightLevelStalenessBudget(double seconds);
+  List<float> lightLevels(List<Vec2F> const& positions) const;
+
+  // Scripts of entities far away from every client window are updated less
+  // often, configured by "scriptUpdateLod" in worldserver.config.
+  bool scriptUpdateLodEnabled() const;
+  void setScriptUpdateLodEnabled(bool enabled);
+  // Additional windows that count as client windows for the script update
+  // LOD, for simulating clients without connecting any.
+  void setScriptUpdateLodWindows(List<RectF> windows);
+
   void setDungeonGravity(DungeonId dungeonId, Maybe<float> gravity);
   void setDungeonBreathable(DungeonId dungeonId, Maybe<bool> breathable);
 
@@ -229,6 +246,11 @@ public:
 
   void updateTileEntityTiles(TileEntityPtr const& object, bool removing = false, bool checkBreaks = true);
 
+  // Wire networks are kept between wiring updates, any wire entity added to
+  // the world and any change to wires must be reported here.
+  void wireEntityAdded(WireEntityPtr const& wireEntity);
+  void wiresChanged(Vec2I const& tilePosition);
+
   bool isVisibleToPlayer(RectF const& region) const;
   void activateLiquidRegion(RectI const& region);
   void activateLiquidLocation(Vec2I const& location);
@@ -326,6 +348,8 @@ private:
   typedef function<ServerTile const& (Vec2I)> ServerTileGetter;
 
   void init(bool firstTime);
+  // (Re-)registers the per world metrics under the current world id
+  void registerMetrics();
 
   // Returns nothing if the processing defined by the given configuration entry
   // should not run this tick, if it should run this tick, returns the number
@@ -337,6 +361,19 @@ private:
   // Queues pending (step based) updates to the given player
   void queueUpdatePackets(ConnectionId clientId, bool sendRemoteUpdates);
   void updateDamage(float dt);
+  // Script update delta scale for an entity at the given position
+  unsigned scriptUpdateDeltaScale(Vec2F const& position, List<RectF> const& clientWindows) const;
+
+  // Attributes the Lua work of the given entity or world script context to
+  // it while the returned object is alive, returns nothing when script
+  // accounting is off or the entity is not scripted.  Only the time spent in
+  // script invokes is counted, not the C++ work around them.  Entities are
+  // grouped by type and config name, and told apart by unique id if they
+  // have one, so the set of labels stays bounded by the world's unique
+  // entities rather than every entity that ever updated.  Labels are built
+  // once per entity and context.
+  Maybe<LuaAccountingAttribution> scriptAccountingAttribution(EntityPtr const& entity);
+  Maybe<LuaAccountingAttribution> scriptAccountingAttribution(String const& contextName);
 
   void updateDamagedBlocks(float dt);
 
@@ -388,10 +425,27 @@ private:
 
   StringMap<ScriptComponentPtr> m_scriptContexts;
 
+  struct ScriptAccountingLabel {
+    Maybe<String> uniqueId;
+    shared_ptr<String const> label;
+  };
+  HashMap<EntityId, ScriptAccountingLabel> m_scriptAccountingLabels;
+  StringMap<shared_ptr<String const>> m_scriptContextAccountingLabels;
+
+  struct WorldMetrics {
+    MetricGauge entities;
+    MetricGauge sectors;
+    MetricGauge activeLiquid;
+    MetricGauge luaMemory;
+    MetricGauge epochTime;
+    MetricGauge timeOfDay;
+  };
+  WorldMetrics m_metrics;
+
   WorldGeometry m_geometry;
   double m_currentTime;
   uint64_t m_currentStep;
-  mutable CellularLightIntensityCalculator m_lightIntensityCalculator;
+  LightLevelCachePtr m_lightLevelCache;
   SkyPtr m_sky;
 
   ServerWeather m_weather;
@@ -426,6 +480,12 @@ private:
   StableHashSet<DungeonId> m_protectedDungeonIds;
   bool m_tileProtectionEnabled;
 
+  bool m_scriptUpdateLodEnabled;
+  // Distance from the nearest client window, and the script update delta
+  // scale beyond it, in increasing order of distance
+  List<pair<float, unsigned>> m_scriptUpdateLodLevels;
+  List<RectF> m_scriptUpdateLodWindows;
+
   HashMap<Uuid, pair<ConnectionId, MVariant<ConnectionId, RpcPromiseKeeper<Json>>>> m_entityMessageResponses;
 
   List<PhysicsForceRegion> m_forceRegions;
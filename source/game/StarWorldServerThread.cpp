@@ -5,6 +5,7 @@
 #include "StarLogging.hpp"
 #include "StarAssets.hpp"
 #include "StarPlayer.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
@@ -221,12 +222,20 @@ void WorldServerThread::run() {
     double fidelityScore = 0.0;
     WorldServerFidelity automaticFidelity = WorldServerFidelity::Medium;
 
+    MetricLabels metricLabels = {{"world", printWorldId(m_worldId)}};
+    auto fidelityMetric = Metrics::gauge("server_world_fidelity", "World fidelity, from 0 (minimum) to 3 (high)", metricLabels);
+    auto updateRateMetric = Metrics::gauge("server_world_update_rate_hertz", "World update rate", metricLabels);
+    auto tickTimeMetric = Metrics::histogram("server_world_tick_seconds", "Time taken by each world tick",
+        Metrics::exponentialBuckets(0.001, 2, 11), metricLabels);
+
     while (!m_stop && !m_errorOccurred) {
       auto fidelity = lockedFidelity.value(automaticFidelity);
-      LogMap::set(strf("server_{}_fidelity", m_worldId), WorldServerFidelityNames.getRight(fidelity));
-      LogMap::set(strf("server_{}_update", m_worldId), strf("{:4.2f}Hz", tickApproacher.rate()));
+      fidelityMetric.set((int)fidelity);
+      updateRateMetric.set(tickApproacher.rate());
 
+      double tickStart = Time::monotonicTime();
       update(fidelity);
+      tickTimeMetric.observe(Time::monotonicTime() - tickStart);
       tickApproacher.setTargetTickRate(1.0f / ServerGlobalTimestep);
       tickApproacher.tick();
 
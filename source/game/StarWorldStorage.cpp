@@ -14,6 +14,77 @@
 
 namespace Star {
 
+ColdSectorStores::ColdSectorStores(size_t budget)
+  : m_budget(budget), m_residentBytes(0), m_retained(0), m_evicted(0) {}
+
+size_t ColdSectorStores::budget() const {
+  return m_budget;
+}
+
+void ColdSectorStores::setBudget(size_t budget) {
+  m_budget = budget;
+  while (m_residentBytes > m_budget) {
+    m_residentBytes -= m_stores.begin()->second.size();
+    m_stores.removeFirst();
+    ++m_evicted;
+  }
+}
+
+ByteArray const* ColdSectorStores::ptr(ByteArray const& key) const {
+  return m_stores.ptr(key);
+}
+
+Maybe<ByteArray> ColdSectorStores::take(ByteArray const& key) {
+  if (auto store = m_stores.maybeTake(key)) {
+    m_residentBytes -= store->second.size();
+    return std::move(store->second);
+  }
+  return {};
+}
+
+void ColdSectorStores::update(ByteArray const& key, ByteArray const& data) {
+  if (auto store = m_stores.ptr(key)) {
+    m_residentBytes -= store->size();
+    m_residentBytes += data.size();
+    *store = data;
+  }
+}
+
+size_t ColdSectorStores::retain(ByteArray const& key, ByteArray const& data) {
+  take(key);
+  if (data.size() > m_budget)
+    return 0;
+
+  m_stores.add(key, data);
+  m_residentBytes += data.size();
+  ++m_retained;
+
+  size_t evicted = 0;
+  while (m_residentBytes > m_budget) {
+    m_residentBytes -= m_stores.begin()->second.size();
+    m_stores.removeFirst();
+    ++evicted;
+  }
+  m_evicted += evicted;
+  return evicted;
+}
+
+uint64_t ColdSectorStores::retainedCount() const {
+  return m_retained;
+}
+
+uint64_t ColdSectorStores::evictedCount() const {
+  return m_evicted;
+}
+
+size_t ColdSectorStores::residentStores() const {
+  return m_stores.size();
+}
+
+size_t ColdSectorStores::residentBytes() const {
+  return m_residentBytes;
+}
+
 WorldChunks WorldStorage::getWorldChunksUpdate(WorldChunks const& oldChunks, WorldChunks const& newChunks) {
   WorldChunks update;
   for (auto const& p : oldChunks) {
@@ -334,7 +405,7 @@ void WorldStorage::tick(float dt, String const* worldId) {
 
         if (!zombiesToStore.empty()) {
           EntitySectorStore sectorStore;
-          if (auto res = m_db.find(entitySectorKey(sector)))
+          if (auto res = findSectorStore(entitySectorKey(sector), false))
             sectorStore = readEntitySector(*res);
 
           UniqueIndexStore storedUniques;
@@ -345,14 +416,26 @@ void WorldStorage::tick(float dt, String const* worldId) {
               storedUniques.add(*uniqueId, {sector, entity->position()});
             sectorStore.append(entityFactory->storeVersionedEntity(entity));
           }
-          m_db.insert(entitySectorKey(sector), writeEntitySector(sectorStore));
+          insertSectorStore(entitySectorKey(sector), writeEntitySector(sectorStore));
           mergeSectorUniques(sector, storedUniques);
         }
       }
     }
     if (worldId) {
-      LogMap::set(strf("server_{}_storage", *worldId),
-        strf("{} active, {}/{} unloaded ({} held)", m_sectorMetadata.size(), unloaded, skipped + unloaded, skipped));
+      if (m_metricsWorldId != *worldId) {
+        m_metricsWorldId = *worldId;
+        MetricLabels labels = {{"world", m_metricsWorldId}};
+        m_activeSectorsMetric = Metrics::gauge("server_world_storage_active_sectors", "Sectors with loaded storage", labels);
+        m_heldSectorsMetric = Metrics::gauge("server_world_storage_held_sectors", "Expired sectors held loaded by keep-alive entities", labels);
+        m_unloadedSectorsMetric = Metrics::counter("server_world_storage_unloaded_sectors_total", "Sectors unloaded from storage", labels);
+        m_coldStoreBytesMetric = Metrics::gauge("server_world_storage_cold_store_bytes", "Compressed sector stores kept in memory", labels);
+        m_coldStoreLoadsMetric = Metrics::counter("server_world_storage_cold_store_loads_total", "Sector stores loaded from memory instead of the database", labels);
+        m_coldStoreEvictionsMetric = Metrics::counter("server_world_storage_cold_store_evictions_total", "Sector stores dropped from memory to stay within budget", labels);
+      }
+      m_activeSectorsMetric.set(m_sectorMetadata.size());
+      m_coldStoreBytesMetric.set(m_coldStores.residentBytes());
+      m_heldSectorsMetric.set(skipped);
+      m_unloadedSectorsMetric.increment(unloaded);
     }
   } catch (std::exception const& e) {
     m_db.rollback();
@@ -430,6 +513,21 @@ void WorldStorage::setFloatingDungeonWorld(bool floatingDungeonWorld) {
   m_floatingDungeonWorld = floatingDungeonWorld;
 }
 
+auto WorldStorage::coldStoreStatistics() const -> ColdStoreStatistics {
+  ColdStoreStatistics statistics;
+  statistics.retained = m_coldStores.retainedCount();
+  statistics.evicted = m_coldStores.evictedCount();
+  statistics.memoryLoads = m_coldStoreMemoryLoads;
+  statistics.databaseLoads = m_coldStoreDatabaseLoads;
+  statistics.residentStores = m_coldStores.residentStores();
+  statistics.residentBytes = m_coldStores.residentBytes();
+  return statistics;
+}
+
+void WorldStorage::setEntityLoadWorkerPool(WorkerPool* workerPool) {
+  m_entityLoadWorkerPool = workerPool;
+}
+
 WorldStorage::TileSectorStore::TileSectorStore()
   : tileSerializationVersion(ServerTile::CurrentSerializationVersion) {}
 
@@ -606,6 +704,10 @@ WorldStorage::WorldStorage() {
   auto storageConfig = Root::singleton().assets()->json("/worldstorage.config");
   m_sectorTimeToLive = jsonToVec2F(storageConfig.get("sectorTimeToLive"));
   m_generationQueueTimeToLive = storageConfig.getFloat("generationQueueTimeToLive");
+  m_coldStores.setBudget(storageConfig.optUInt("coldSectorStoreBudget").value(0));
+  m_coldStoreMemoryLoads = 0;
+  m_coldStoreDatabaseLoads = 0;
+  m_entityLoadWorkerPool = nullptr;
 }
 
 bool WorldStorage::belongsInSector(Sector const& sector, Vec2F const& position) const {
@@ -684,7 +786,7 @@ void WorldStorage::loadSectorToLevel(Sector const& sector, SectorLoadLevel targe
     }
 
     if (currentLoad == SectorLoadLevel::Tiles) {
-      if (auto res = m_db.find(tileSectorKey(sector))) {
+      if (auto res = findSectorStore(tileSectorKey(sector), true)) {
         TileSectorStore sectorStore = readTileSector(*res);
 
         m_tileArray->loadSector(sector, std::move(sectorStore.tiles));
@@ -700,15 +802,10 @@ void WorldStorage::loadSectorToLevel(Sector const& sector, SectorLoadLevel targe
 
     } else if (currentLoad == SectorLoadLevel::Entities) {
       List<EntityPtr> addedEntities;
-      if (auto res = m_db.find(entitySectorKey(sector))) {
-        EntitySectorStore sectorStore = readEntitySector(*res);
-        for (auto const& entityStore : sectorStore) {
-          try {
-            addedEntities.append(entityFactory->loadVersionedEntity(entityStore));
-          } catch (std::exception const& e) {
+      if (auto res = findSectorStore(entitySectorKey(sector), true)) {
+        addedEntities = entityFactory->loadVersionedEntities(readEntitySector(*res), [](VersionedJson const& entityStore, std::exception const& e) {
             Logger::warn("Failed to deserialize entity '{}'. {}", entityStore.toJson(), outputException(e, true));
-          }
-        }
+          }, m_entityLoadWorkerPool);
       }
 
       UniqueIndexStore readUniques;
@@ -775,7 +872,7 @@ bool WorldStorage::unloadSectorToLevel(Sector const& sector, SectorLoadLevel tar
       // not loaded, we need to load and merge with them, otherwise we should be
       // overwriting them.
       if (metadata.loadLevel < SectorLoadLevel::Entities) {
-        if (auto res = m_db.find(entitySectorKey(sector)))
+        if (auto res = findSectorStore(entitySectorKey(sector), false))
           sectorStore = readEntitySector(*res);
       }
 
@@ -788,7 +885,7 @@ bool WorldStorage::unloadSectorToLevel(Sector const& sector, SectorLoadLevel tar
           storedUniques.add(*uniqueId, {sector, position});
         sectorStore.append(entityFactory->storeVersionedEntity(entity));
       }
-      m_db.insert(entitySectorKey(sector), writeEntitySector(sectorStore));
+      retainSectorStore(entitySectorKey(sector), writeEntitySector(sectorStore));
       if (metadata.loadLevel < SectorLoadLevel::Entities)
         mergeSectorUniques(sector, storedUniques);
       else
@@ -806,7 +903,7 @@ bool WorldStorage::unloadSectorToLevel(Sector const& sector, SectorLoadLevel tar
       TileSectorStore sectorStore;
       sectorStore.tiles = m_tileArray->unloadSector(sector);
       sectorStore.generationLevel = metadata.generationLevel;
-      m_db.insert(tileSectorKey(sector), writeTileSector(sectorStore));
+      retainSectorStore(tileSectorKey(sector), writeTileSector(sectorStore));
       m_sectorMetadata.remove(sector);
       m_generatorFacade->sectorLoadLevelChanged(this, sector, SectorLoadLevel::None);
       return true;
@@ -841,7 +938,7 @@ void WorldStorage::syncSector(Sector const& sector) {
         sectorStore.append(entityFactory->storeVersionedEntity(entity));
       }
     }
-    m_db.insert(entitySectorKey(sector), writeEntitySector(sectorStore));
+    insertSectorStore(entitySectorKey(sector), writeEntitySector(sectorStore));
     updateSectorUniques(sector, storedUniques);
   }
 
@@ -849,7 +946,7 @@ void WorldStorage::syncSector(Sector const& sector) {
     TileSectorStore sectorStore;
     sectorStore.tiles = m_tileArray->copySector(sector);
     sectorStore.generationLevel = metadata.generationLevel;
-    m_db.insert(tileSectorKey(sector), writeTileSector(sectorStore));
+    insertSectorStore(tileSectorKey(sector), writeTileSector(sectorStore));
   }
 }
 
@@ -858,6 +955,36 @@ List<WorldStorage::Sector> WorldStorage::adjacentSectors(Sector const& sector) c
   return m_tileArray->validSectorsFor(tiles.padded(WorldSectorSize));
 }
 
+Maybe<ByteArray> WorldStorage::findSectorStore(ByteArray const& key, bool take) {
+  if (!take) {
+    if (auto store = m_coldStores.ptr(key))
+      return *store;
+    return m_db.find(key);
+  }
+
+  if (auto store = m_coldStores.take(key)) {
+    ++m_coldStoreMemoryLoads;
+    m_coldStoreLoadsMetric.increment();
+    return store;
+  }
+
+  auto store = m_db.find(key);
+  if (store)
+    ++m_coldStoreDatabaseLoads;
+  return store;
+}
+
+void WorldStorage::insertSectorStore(ByteArray const& key, ByteArray const& data) {
+  m_db.insert(key, data);
+  m_coldStores.update(key, data);
+}
+
+void WorldStorage::retainSectorStore(ByteArray const& key, ByteArray const& data) {
+  m_db.insert(key, data);
+  if (size_t evicted = m_coldStores.retain(key, data))
+    m_coldStoreEvictionsMetric.increment(evicted);
+}
+
 void WorldStorage::updateSectorUniques(Sector const& sector, UniqueIndexStore const& sectorUniques) {
   // If there was an old unique sector store here, then we need to remove all
   // the unique index entries for uniques that used to be in this sector but
@@ -7,12 +7,14 @@
 #include "StarWorldTiles.hpp"
 #include "StarRpcPromise.hpp"
 #include "StarBiomePlacement.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
 STAR_EXCEPTION(WorldStorageException, StarException);
 
 STAR_CLASS(EntityMap);
+STAR_CLASS(WorkerPool);
 STAR_STRUCT(WorldGeneratorFacade);
 STAR_CLASS(WorldStorage);
 
@@ -73,6 +75,43 @@ struct WorldGeneratorFacade {
   virtual RpcPromise<Vec2I> enqueuePlacement(List<BiomeItemDistribution> placements, Maybe<DungeonId> id) = 0;
 };
 
+// Compressed sector stores kept in memory by database key, up to a budget of
+// bytes.  Stores are evicted least recently retained first.
+class ColdSectorStores {
+public:
+  explicit ColdSectorStores(size_t budget = 0);
+
+  size_t budget() const;
+  void setBudget(size_t budget);
+
+  ByteArray const* ptr(ByteArray const& key) const;
+  // Removes and returns the store for the given key, if there is one.
+  Maybe<ByteArray> take(ByteArray const& key);
+  // Replaces the store for the given key if there is one, without changing
+  // when it was retained.
+  void update(ByteArray const& key, ByteArray const& data);
+  // Keeps the given store as the most recently retained one, replacing any
+  // store already kept for the key, then evicts stores until back within
+  // budget.  Stores larger than the whole budget are not kept.  Returns the
+  // number of stores evicted.
+  size_t retain(ByteArray const& key, ByteArray const& data);
+
+  // Total stores kept by retain() and dropped to stay within budget
+  uint64_t retainedCount() const;
+  uint64_t evictedCount() const;
+
+  size_t residentStores() const;
+  size_t residentBytes() const;
+
+private:
+  // Least recently retained first.
+  OrderedHashMap<ByteArray, ByteArray> m_stores;
+  size_t m_budget;
+  size_t m_residentBytes;
+  uint64_t m_retained;
+  uint64_t m_evicted;
+};
+
 // Handles paging entity and tile data in / out of disk backed storage for
 // WorldServer and triggers initial generation.  Ties tile sectors to entity
 // sectors, and allows for multiple stage generation of those sectors.  Sector
@@ -180,6 +219,31 @@ public:
   bool floatingDungeonWorld() const;
   void setFloatingDungeonWorld(bool floatingDungeonWorld);
 
+  // Tile and entity stores of recently unloaded sectors are kept compressed
+  // in memory, up to a memory budget, so that sectors reloaded soon after
+  // being unloaded do not have to be read back from the database.
+  struct ColdStoreStatistics {
+    // Stores kept in memory as their sector was unloaded
+    uint64_t retained = 0;
+    // Stores dropped from memory to stay within the memory budget
+    uint64_t evicted = 0;
+    // Stores read from memory and from the database respectively to load a
+    // sector.  Reads that only merge new entities into a stored sector are
+    // not counted.
+    uint64_t memoryLoads = 0;
+    uint64_t databaseLoads = 0;
+
+    size_t residentStores = 0;
+    size_t residentBytes = 0;
+  };
+
+  ColdStoreStatistics coldStoreStatistics() const;
+
+  // If set, stored entities in sectors being loaded are versioned and
+  // constructed on this pool.  They are still added to the world on the
+  // calling thread, in the order they were stored.
+  void setEntityLoadWorkerPool(WorkerPool* workerPool);
+
 private:
   enum class StoreType : uint8_t {
     Metadata = 0,
@@ -277,6 +341,19 @@ private:
   // one side because they are within range.
   List<Sector> adjacentSectors(Sector const& sector) const;
 
+  // Finds the given tile or entity sector store in the cold stores, falling
+  // back to the database.  If take is true, the store is being read to load
+  // its sector, so it is counted as a load and a store found in the cold
+  // stores is removed from them.
+  Maybe<ByteArray> findSectorStore(ByteArray const& key, bool take);
+  // Writes the given sector store to the database, and replaces the cold copy
+  // if there is one.
+  void insertSectorStore(ByteArray const& key, ByteArray const& data);
+  // Writes the given sector store to the database and keeps a copy in the
+  // cold stores, evicting the least recently retained stores if that goes
+  // over budget.
+  void retainSectorStore(ByteArray const& key, ByteArray const& data);
+
   // Replace the sector uniques for this sector with the given set
   void updateSectorUniques(Sector const& sector, UniqueIndexStore const& sectorUniques);
   // Merge the stored sector uniques for this sector with the given set
@@ -296,8 +373,23 @@ private:
   WorldGeneratorFacadePtr m_generatorFacade;
 
   bool m_floatingDungeonWorld;
+  WorkerPool* m_entityLoadWorkerPool;
 
   StableHashMap<Sector, SectorMetadata> m_sectorMetadata;
+
+  // Registered on the first tick given a world id
+  String m_metricsWorldId;
+  MetricGauge m_activeSectorsMetric;
+  MetricGauge m_heldSectorsMetric;
+  MetricCounter m_unloadedSectorsMetric;
+  MetricGauge m_coldStoreBytesMetric;
+  MetricCounter m_coldStoreLoadsMetric;
+  MetricCounter m_coldStoreEvictionsMetric;
+
+  ColdSectorStores m_coldStores;
+  uint64_t m_coldStoreMemoryLoads;
+  uint64_t m_coldStoreDatabaseLoads;
+
   OrderedHashMap<Sector, float> m_generationQueue;
   BTreeDatabase m_db;
 };
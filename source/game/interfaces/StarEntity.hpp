@@ -106,6 +106,10 @@ public:
 
   // All damage sources for this frame.
   virtual List<DamageSource> damageSources() const;
+  // Whether damageSources() or selfDamageNotifications() may currently return
+  // anything.  Checked every step to keep the index of entities that the
+  // DamageManager visits, so this must be cheap.  Default returns false.
+  virtual bool hasDamageSources() const;
 
   // Return the damage that would result from being hit by the given damage
   // source.  Will be called on master and slave entities.  Culling based on
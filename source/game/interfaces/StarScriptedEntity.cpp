@@ -0,0 +1,7 @@
+#include "StarScriptedEntity.hpp"
+
+namespace Star {
+
+void ScriptedEntity::setScriptUpdateDeltaScale(unsigned) {}
+
+}
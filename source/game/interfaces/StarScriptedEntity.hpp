@@ -17,6 +17,11 @@ public:
   // Execute the given code directly in the underlying context, return nothing
   // on failure.
   virtual Maybe<LuaValue> evalScript(String const& code) = 0;
+
+  // Multiplies the update delta of the entity's scripts, so that the world
+  // can update entities far away from every player less often.  Ignored by
+  // default.
+  virtual void setScriptUpdateDeltaScale(unsigned scale);
 };
 
 }
@@ -64,6 +64,9 @@ public:
   virtual EntityPtr closestEntity(Vec2F const& center, float radius, EntityFilter selector = {}) const = 0;
 
   virtual void forAllEntities(EntityCallback entityCallback) const = 0;
+  // Only the entities that may currently have damage sources or self damage
+  // notifications, see Entity::hasDamageSources.
+  virtual void forAllDamageSourceEntities(EntityCallback entityCallback) const = 0;
 
   // Query here is a fuzzy query based on metaBoundBox
   virtual void forEachEntity(RectF const& boundBox, EntityCallback entityCallback) const = 0;
@@ -622,6 +622,7 @@ List<Drawable> PaintingBeamTool::drawables() const {
   for (auto& entry : result) {
     if (entry.isImage()) {
       auto& image = entry.imagePart().image;
+      entry.imagePart().imageId = {};
       auto& color = m_colorKeys[m_colorIndex];
       if (size_t directives_start = color.find('?'); directives_start != NPos) {
         auto index      = color.substr(0, directives_start);
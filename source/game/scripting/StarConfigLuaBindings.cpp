@@ -8,6 +8,9 @@ LuaCallbacks LuaBindings::makeConfigCallbacks(function<Json(String const&, Json
   LuaCallbacks callbacks;
 
   callbacks.registerCallback("getParameter", getParameter);
+  callbacks.registerCallback("getParameterProxy", [getParameter](String const& name, Json const& def) {
+      return LuaJsonProxy(getParameter(name, def));
+    });
 
   return callbacks;
 }
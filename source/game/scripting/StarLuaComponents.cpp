@@ -7,6 +7,17 @@
 
 namespace Star {
 
+atomic<bool> LuaBaseComponent::s_functionHandleCounting = false;
+atomic<uint64_t> LuaBaseComponent::s_functionHandleHits = 0;
+atomic<uint64_t> LuaBaseComponent::s_functionHandleMisses = 0;
+
+LuaBaseComponent::FunctionHandle::FunctionHandle(String name)
+  : m_name(std::move(name)), m_component(nullptr), m_index(0) {}
+
+String const& LuaBaseComponent::FunctionHandle::name() const {
+  return m_name;
+}
+
 LuaBaseComponent::LuaBaseComponent() {
   addCallbacks("sb", LuaBindings::makeUtilityCallbacks());
   addCallbacks("root", LuaBindings::makeRootCallbacks());
@@ -90,11 +101,13 @@ bool LuaBaseComponent::init() {
 
   if (m_context->containsPath("init")) {
     try {
+      LuaAccountingScope accounting(m_context->engine());
       m_context->invokePath("init");
     } catch (LuaException const& e) {
       Logger::error("Exception while calling script init: {}", outputException(e, true));
       m_error = String(printException(e, false));
       m_context.reset();
+      releaseFunctions();
       return false;
     }
   }
@@ -106,6 +119,7 @@ void LuaBaseComponent::uninit() {
   if (m_context) {
     if (m_context->containsPath("uninit")) {
       try {
+        LuaAccountingScope accounting(m_context->engine());
         m_context->invokePath("uninit");
       } catch (LuaException const& e) {
         Logger::error("Exception while calling script uninit: {}", outputException(e, true));
@@ -115,6 +129,7 @@ void LuaBaseComponent::uninit() {
     contextShutdown();
     m_context.reset();
   }
+  releaseFunctions();
   for (auto p : m_threads) {
     p.second->stop();
   }
@@ -126,6 +141,18 @@ bool LuaBaseComponent::initialized() const {
   return m_context.isValid();
 }
 
+void LuaBaseComponent::setFunctionHandleCounting(bool enabled) {
+  s_functionHandleCounting.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t LuaBaseComponent::functionHandleHits() {
+  return s_functionHandleHits.load(std::memory_order_relaxed);
+}
+
+uint64_t LuaBaseComponent::functionHandleMisses() {
+  return s_functionHandleMisses.load(std::memory_order_relaxed);
+}
+
 Maybe<String> const& LuaBaseComponent::error() const {
   return m_error;
 }
@@ -149,6 +176,7 @@ void LuaBaseComponent::contextShutdown() {}
 
 void LuaBaseComponent::setError(String error) {
   m_context.reset();
+  releaseFunctions();
   m_error = std::move(error);
 }
 
@@ -161,6 +189,28 @@ bool LuaBaseComponent::checkInitialization() {
   return initialized();
 }
 
+LuaValue const& LuaBaseComponent::resolveFunction(FunctionHandle& function) {
+  if (function.m_component != this) {
+    function.m_component = this;
+    function.m_index = m_resolvedFunctions.size();
+    m_resolvedFunctions.append(LuaNil);
+  }
+
+  auto& resolved = m_resolvedFunctions[function.m_index];
+  bool hit = m_context->pathIs(function.m_name, resolved);
+  if (!hit)
+    resolved = m_context->getPath(function.m_name);
+  if (s_functionHandleCounting.load(std::memory_order_relaxed))
+    (hit ? s_functionHandleHits : s_functionHandleMisses).fetch_add(1, std::memory_order_relaxed);
+  return resolved;
+}
+
+void LuaBaseComponent::releaseFunctions() {
+  // Keeps the handle indexes, but not the closures of the released context
+  for (auto& resolved : m_resolvedFunctions)
+    resolved = LuaNil;
+}
+
 LuaCallbacks LuaBaseComponent::makeThreadsCallbacks() {
   LuaCallbacks callbacks;
   
@@ -28,11 +28,35 @@ STAR_CLASS(ScriptableThread);
 // Whenever an error is set, all function calls or eval will fail until the
 // error is cleared by re-initializing.
 //
+// Invokes are accounted to the engine's current LuaAccountingAttribution, if
+// script accounting is enabled.
+//
 // If 'autoReInit' is set, Monitors Root for reloads, and if a root reload
 // occurs, will automatically (on the next call to invoke) uninit and then
 // re-init the script before calling invoke.  'autoReInit' defaults to true.
 class LuaBaseComponent {
 public:
+  // Names a script function that is called often, such as every step.  The
+  // component keeps the function the name resolved to, and on every invoke
+  // only checks that the script has not rebound the name since, which is
+  // much cheaper than looking it up again.  Resolved functions are released
+  // when the context is.  A handle should only be used with one component.
+  class FunctionHandle {
+  public:
+    explicit FunctionHandle(String name);
+
+    String const& name() const;
+
+  private:
+    friend LuaBaseComponent;
+
+    String m_name;
+    // The component this handle was last invoked through, and the index of
+    // its resolved function there.
+    LuaBaseComponent const* m_component;
+    size_t m_index;
+  };
+
   LuaBaseComponent();
   // The LuaBaseComponent destructor does NOT call the 'unint' entry point in
   // the script.  In order to do so, uninit() must be called manually before
@@ -75,9 +99,20 @@ public:
   template <typename Ret = LuaValue, typename... V>
   Maybe<Ret> invoke(String const& name, V&&... args);
 
+  template <typename Ret = LuaValue, typename... V>
+  Maybe<Ret> invoke(FunctionHandle& function, V&&... args);
+
   template <typename Ret = LuaValue>
   Maybe<LuaValue> eval(String const& code);
 
+  // Process-wide counts of FunctionHandle invokes that reused the resolved
+  // function, or had to look the name up.  Only counted while counting is
+  // enabled, which is off by default to keep shared counters off the invoke
+  // path, and meant for benchmarks.
+  static void setFunctionHandleCounting(bool enabled);
+  static uint64_t functionHandleHits();
+  static uint64_t functionHandleMisses();
+
   // Returns last error, if there has been an error.  Errors can only be
   // cleared by re-initializing the context.
   Maybe<String> const& error() const;
@@ -97,12 +132,25 @@ protected:
 
 private:
   LuaCallbacks makeThreadsCallbacks();
-  
+
+  // Returns the function the handle names in the current context, resolving
+  // it again only if the script has rebound the name.  LuaNil if there is no
+  // such function.
+  LuaValue const& resolveFunction(FunctionHandle& function);
+  void releaseFunctions();
+
+  static atomic<bool> s_functionHandleCounting;
+  static atomic<uint64_t> s_functionHandleHits;
+  static atomic<uint64_t> s_functionHandleMisses;
+
   StringList m_scripts;
   StringMap<LuaCallbacks> m_callbacks;
   LuaRootPtr m_luaRoot;
   TrackerListenerPtr m_reloadTracker;
   Maybe<LuaContext> m_context;
+  // Indexed by FunctionHandle::m_index, LuaNil while unresolved.  A deque so
+  // that a function stays put while it runs, even if it resolves new handles.
+  Deque<LuaValue> m_resolvedFunctions;
   Maybe<String> m_error;
   
   StringMap<shared_ptr<ScriptableThread>> m_threads;
@@ -139,6 +187,17 @@ public:
   float updateDt() const;
   void setUpdateDelta(unsigned updateDelta);
 
+  // Multiplies the update delta, so that scripts far away from any player
+  // can be updated less often.  A new scale only takes effect right after
+  // the next script update, so the dt passed to every update always covers
+  // exactly the steps since the last one.  Entities can opt out of scaling
+  // with "scriptUpdateLod" : false in their config, and scripts with
+  // script.setUpdateLodEnabled(false).
+  unsigned updateDeltaScale() const;
+  void setUpdateDeltaScale(unsigned updateDeltaScale);
+  bool updateLodEnabled() const;
+  void setUpdateLodEnabled(bool enabled);
+
   // Returns true if the next update will call the internal script update
   // method.
   bool updateReady() const;
@@ -147,8 +206,15 @@ public:
   Maybe<Ret> update(V&&... args);
 
 private:
+  void applyUpdateDeltaScale();
+
+  LuaBaseComponent::FunctionHandle m_updateFunction;
   Periodic m_updatePeriodic;
   mutable float m_lastDt;
+  unsigned m_updateDelta;
+  unsigned m_updateDeltaScale;
+  unsigned m_pendingUpdateDeltaScale;
+  bool m_updateLodEnabled;
 };
 
 // Wraps a basic lua component so that world callbacks are added on init, and
@@ -197,6 +263,7 @@ Maybe<Ret> LuaBaseComponent::invoke(String const& name, V&&... args) {
     auto method = m_context->getPath(name);
     if (method == LuaNil)
       return {};
+    LuaAccountingScope accounting(m_context->engine());
     return m_context->luaTo<LuaFunction>(std::move(method)).invoke<Ret>(std::forward<V>(args)...);
   } catch (LuaException const& e) {
     Logger::error("Exception while invoking lua function '{}'. {}", name, outputException(e, true));
@@ -205,6 +272,26 @@ Maybe<Ret> LuaBaseComponent::invoke(String const& name, V&&... args) {
   }
 }
 
+template <typename Ret, typename... V>
+Maybe<Ret> LuaBaseComponent::invoke(FunctionHandle& function, V&&... args) {
+  if (!checkInitialization())
+    return {};
+
+  try {
+    auto const& method = resolveFunction(function);
+    if (method == LuaNil)
+      return {};
+    LuaAccountingScope accounting(m_context->engine());
+    if (auto luaFunction = method.template ptr<LuaFunction>())
+      return luaFunction->template invoke<Ret>(std::forward<V>(args)...);
+    return m_context->luaTo<LuaFunction>(method).template invoke<Ret>(std::forward<V>(args)...);
+  } catch (LuaException const& e) {
+    Logger::error("Exception while invoking lua function '{}'. {}", function.m_name, outputException(e, true));
+    setError(printException(e, false));
+    return {};
+  }
+}
+
 template <typename Ret>
 Maybe<LuaValue> LuaBaseComponent::eval(String const& code) {
   if (!checkInitialization())
@@ -247,7 +334,11 @@ void LuaStorableComponent<Base>::contextShutdown() {
 }
 
 template <typename Base>
-LuaUpdatableComponent<Base>::LuaUpdatableComponent() {
+LuaUpdatableComponent<Base>::LuaUpdatableComponent() : m_updateFunction("update") {
+  m_updateDelta = 1;
+  m_updateDeltaScale = 1;
+  m_pendingUpdateDeltaScale = 1;
+  m_updateLodEnabled = true;
   m_updatePeriodic.setStepCount(1);
 
   LuaCallbacks scriptCallbacks;
@@ -257,6 +348,9 @@ LuaUpdatableComponent<Base>::LuaUpdatableComponent() {
   scriptCallbacks.registerCallback("setUpdateDelta", [this](unsigned d) {
       setUpdateDelta(d);
     });
+  scriptCallbacks.registerCallback("setUpdateLodEnabled", [this](bool enabled) {
+      setUpdateLodEnabled(enabled);
+    });
 
   m_lastDt = GlobalTimestep * GlobalTimescale;
   Base::addCallbacks("script", std::move(scriptCallbacks));
@@ -264,7 +358,7 @@ LuaUpdatableComponent<Base>::LuaUpdatableComponent() {
 
 template <typename Base>
 unsigned LuaUpdatableComponent<Base>::updateDelta() const {
-  return m_updatePeriodic.stepCount();
+  return m_updateDelta;
 }
 
 template <typename Base>
@@ -281,7 +375,28 @@ float LuaUpdatableComponent<Base>::updateDt() const {
 
 template <typename Base>
 void LuaUpdatableComponent<Base>::setUpdateDelta(unsigned updateDelta) {
-  m_updatePeriodic.setStepCount(updateDelta);
+  m_updateDelta = updateDelta;
+  m_updatePeriodic.setStepCount(m_updateDelta * m_updateDeltaScale);
+}
+
+template <typename Base>
+unsigned LuaUpdatableComponent<Base>::updateDeltaScale() const {
+  return m_updateDeltaScale;
+}
+
+template <typename Base>
+void LuaUpdatableComponent<Base>::setUpdateDeltaScale(unsigned updateDeltaScale) {
+  m_pendingUpdateDeltaScale = max(updateDeltaScale, 1u);
+}
+
+template <typename Base>
+bool LuaUpdatableComponent<Base>::updateLodEnabled() const {
+  return m_updateLodEnabled;
+}
+
+template <typename Base>
+void LuaUpdatableComponent<Base>::setUpdateLodEnabled(bool enabled) {
+  m_updateLodEnabled = enabled;
 }
 
 template <typename Base>
@@ -295,7 +410,21 @@ Maybe<Ret> LuaUpdatableComponent<Base>::update(V&&... args) {
   if (!m_updatePeriodic.tick())
     return {};
 
-  return Base::template invoke<Ret>("update", std::forward<V>(args)...);
+  auto result = Base::template invoke<Ret>(m_updateFunction, std::forward<V>(args)...);
+  applyUpdateDeltaScale();
+  return result;
+}
+
+template <typename Base>
+void LuaUpdatableComponent<Base>::applyUpdateDeltaScale() {
+  unsigned scale = m_updateLodEnabled ? m_pendingUpdateDeltaScale : 1;
+  if (scale == m_updateDeltaScale)
+    return;
+
+  // Restart the period, the script has just been updated
+  m_updateDeltaScale = scale;
+  m_updatePeriodic = Periodic(m_updateDelta * m_updateDeltaScale);
+  m_updatePeriodic.tick();
 }
 
 template <typename Base>
@@ -349,6 +478,7 @@ Maybe<Json> LuaMessageHandlingComponent<Base>::handleMessage(
 
   if (auto handler = m_messageHandlers.ptr(message)) {
     try {
+      LuaAccountingScope accounting(Base::context()->engine());
       if (handler->localOnly) {
         if (!localMessage)
           return {};
@@ -44,6 +44,8 @@ void LuaRoot::restart() {
   m_luaEngine->setInstructionLimit(root.configuration()->get("scriptInstructionLimit").toUInt());
   m_luaEngine->setProfilingEnabled(root.configuration()->get("scriptProfilingEnabled").toBool());
   m_luaEngine->setInstructionMeasureInterval(root.configuration()->get("scriptInstructionMeasureInterval").toUInt());
+  m_luaEngine->setAccountingEnabled(root.configuration()->get("scriptAccountingEnabled").toBool(),
+      root.configuration()->get("scriptAccountingStackSampleInterval").toUInt());
 }
 
 void LuaRoot::shutdown() {
@@ -63,8 +63,10 @@ LuaCallbacks LuaBindings::makeNetworkedAnimatorCallbacks(NetworkedAnimator* netw
   callbacks.registerCallbackWithSignature<bool, String>(
       "hasTransformationGroup", bind(&NetworkedAnimator::hasTransformationGroup, networkedAnimator, _1));
 
-  callbacks.registerCallbackWithSignature<void, String, Vec2F>("translateTransformationGroup",
-      bind(&NetworkedAnimator::translateTransformationGroup, networkedAnimator, _1, _2));
+  callbacks.registerCallback("translateTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, Vec2F const& translation) {
+        networkedAnimator->translateTransformationGroup(transformationGroup, translation);
+      });
   callbacks.registerCallback("rotateTransformationGroup",
       [networkedAnimator](String const& transformationGroup, float rotation, Maybe<Vec2F> const& rotationCenter) {
         networkedAnimator->rotateTransformationGroup(transformationGroup, rotation, rotationCenter.value());
@@ -80,18 +82,27 @@ LuaCallbacks LuaBindings::makeNetworkedAnimatorCallbacks(NetworkedAnimator* netw
         else
           networkedAnimator->scaleTransformationGroup(transformationGroup, engine.luaTo<float>(scale), scaleCenter.value());
       });
-  callbacks.registerCallbackWithSignature<void, String, float, float, float, float, float, float>(
-      "transformTransformationGroup",
-      bind(&NetworkedAnimator::transformTransformationGroup, networkedAnimator, _1, _2, _3, _4, _5, _6, _7));
-  callbacks.registerCallbackWithSignature<void, String>(
-      "resetTransformationGroup", bind(&NetworkedAnimator::resetTransformationGroup, networkedAnimator, _1));
-  callbacks.registerCallbackWithSignature<void, String, Mat3F>(
-      "setTransformationGroup", bind(&NetworkedAnimator::setTransformationGroup, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<Mat3F, String>(
-      "getTransformationGroup", bind(&NetworkedAnimator::getTransformationGroup, networkedAnimator, _1));
-
-  callbacks.registerCallbackWithSignature<void, String, Vec2F>("translateLocalTransformationGroup",
-      bind(&NetworkedAnimator::translateLocalTransformationGroup, networkedAnimator, _1, _2));
+  callbacks.registerCallback("transformTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, float a, float b, float c, float d, float tx, float ty) {
+        networkedAnimator->transformTransformationGroup(transformationGroup, a, b, c, d, tx, ty);
+      });
+  callbacks.registerCallback("resetTransformationGroup",
+      [networkedAnimator](String const& transformationGroup) {
+        networkedAnimator->resetTransformationGroup(transformationGroup);
+      });
+  callbacks.registerCallback("setTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, Mat3F const& transform) {
+        networkedAnimator->setTransformationGroup(transformationGroup, transform);
+      });
+  callbacks.registerCallback("getTransformationGroup",
+      [networkedAnimator](String const& transformationGroup) {
+        return networkedAnimator->getTransformationGroup(transformationGroup);
+      });
+
+  callbacks.registerCallback("translateLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, Vec2F const& translation) {
+        networkedAnimator->translateLocalTransformationGroup(transformationGroup, translation);
+      });
   callbacks.registerCallback("rotateLocalTransformationGroup",
       [networkedAnimator](String const& transformationGroup, float rotation, Maybe<Vec2F> const& rotationCenter) {
         networkedAnimator->rotateLocalTransformationGroup(transformationGroup, rotation, rotationCenter.value());
@@ -107,15 +118,22 @@ LuaCallbacks LuaBindings::makeNetworkedAnimatorCallbacks(NetworkedAnimator* netw
         else
           networkedAnimator->scaleLocalTransformationGroup(transformationGroup, engine.luaTo<float>(scale), scaleCenter.value());
       });
-  callbacks.registerCallbackWithSignature<void, String, float, float, float, float, float, float>(
-      "transformLocalTransformationGroup",
-      bind(&NetworkedAnimator::transformLocalTransformationGroup, networkedAnimator, _1, _2, _3, _4, _5, _6, _7));
-  callbacks.registerCallbackWithSignature<void, String>(
-      "resetLocalTransformationGroup", bind(&NetworkedAnimator::resetLocalTransformationGroup, networkedAnimator, _1));
-  callbacks.registerCallbackWithSignature<void, String, Mat3F>(
-      "setLocalTransformationGroup", bind(&NetworkedAnimator::setLocalTransformationGroup, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<Mat3F, String>(
-      "getLocalTransformationGroup", bind(&NetworkedAnimator::getLocalTransformationGroup, networkedAnimator, _1));
+  callbacks.registerCallback("transformLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, float a, float b, float c, float d, float tx, float ty) {
+        networkedAnimator->transformLocalTransformationGroup(transformationGroup, a, b, c, d, tx, ty);
+      });
+  callbacks.registerCallback("resetLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup) {
+        networkedAnimator->resetLocalTransformationGroup(transformationGroup);
+      });
+  callbacks.registerCallback("setLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, Mat3F const& transform) {
+        networkedAnimator->setLocalTransformationGroup(transformationGroup, transform);
+      });
+  callbacks.registerCallback("getLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup) {
+        return networkedAnimator->getLocalTransformationGroup(transformationGroup);
+      });
 
 
   callbacks.registerCallbackWithSignature<void, String, bool>(
@@ -163,9 +181,15 @@ LuaCallbacks LuaBindings::makeNetworkedAnimatorCallbacks(NetworkedAnimator* netw
 
   callbacks.registerCallbackWithSignature<void, String, bool>(
       "setEffectActive", bind(&NetworkedAnimator::setEffectEnabled, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<Maybe<Vec2F>, String, String>("partPoint", bind(&NetworkedAnimator::partPoint, networkedAnimator, _1, _2));
+  callbacks.registerCallback("partPoint",
+      [networkedAnimator](String const& partName, String const& propertyName) {
+        return networkedAnimator->partPoint(partName, propertyName);
+      });
   callbacks.registerCallbackWithSignature<Maybe<PolyF>, String, String>("partPoly", bind(&NetworkedAnimator::partPoly, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<Json, String, String, Maybe<String>, Maybe<String>, Maybe<int>>("partProperty", bind(&NetworkedAnimator::partProperty, networkedAnimator, _1, _2, _3, _4, _5));
+  callbacks.registerCallback("partProperty",
+      [networkedAnimator](String const& partName, String const& propertyName, Maybe<String> const& stateType, Maybe<String> const& state, Maybe<int> const& frame) {
+        return networkedAnimator->partProperty(partName, propertyName, stateType, state, frame);
+      });
   callbacks.registerCallbackWithSignature<Json, String, String>("partNextProperty", bind(&NetworkedAnimator::partNextProperty, networkedAnimator, _1, _2));
 
   callbacks.registerCallback("transformPoint", [networkedAnimator] (Vec2F point, String const& part) -> Vec2F {
@@ -176,10 +200,14 @@ LuaCallbacks LuaBindings::makeNetworkedAnimatorCallbacks(NetworkedAnimator* netw
       return poly;
     });
 
-  callbacks.registerCallbackWithSignature<void, String, List<Drawable>>(
-      "addPartDrawables", bind(&NetworkedAnimator::addPartDrawables, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<void, String, List<Drawable>>(
-      "setPartDrawables", bind(&NetworkedAnimator::setPartDrawables, networkedAnimator, _1, _2));
+  callbacks.registerCallback("addPartDrawables",
+      [networkedAnimator](String const& partName, List<Drawable> const& drawables) {
+        networkedAnimator->addPartDrawables(partName, drawables);
+      });
+  callbacks.registerCallback("setPartDrawables",
+      [networkedAnimator](String const& partName, List<Drawable> const& drawables) {
+        networkedAnimator->setPartDrawables(partName, drawables);
+      });
   callbacks.registerCallback("addPartJsonDrawables",
     [networkedAnimator](String const& part, JsonArray drawablesConfig) {
       networkedAnimator->addPartDrawables(part, drawablesConfig.transformed([](Json config) -> Drawable {
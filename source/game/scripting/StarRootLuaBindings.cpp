@@ -44,6 +44,7 @@ LuaCallbacks LuaBindings::makeRootCallbacks() {
   callbacks.registerCallbackWithSignature<Image, String>("assetImage", bind(RootCallbacks::assetImage, root, _1));
   callbacks.registerCallbackWithSignature<Json, String>("assetFrames", bind(RootCallbacks::assetFrames, root, _1));
   callbacks.registerCallbackWithSignature<Json, String>("assetJson", bind(RootCallbacks::assetJson, root, _1));
+  callbacks.registerCallbackWithSignature<LuaJsonProxy, String>("assetJsonProxy", bind(RootCallbacks::assetJsonProxy, root, _1));
   callbacks.registerCallbackWithSignature<Json, String, Json>("makeCurrentVersionedJson", bind(RootCallbacks::makeCurrentVersionedJson, root, _1, _2));
   callbacks.registerCallbackWithSignature<Json, Json, String>("loadVersionedJson", bind(RootCallbacks::loadVersionedJson, root, _1, _2));
   callbacks.registerCallbackWithSignature<double, String, double>("evalFunction", bind(RootCallbacks::evalFunction, root, _1, _2));
@@ -387,6 +388,10 @@ Json LuaBindings::RootCallbacks::assetJson(Root* root, String const& path) {
   return root->assets()->json(path);
 }
 
+LuaJsonProxy LuaBindings::RootCallbacks::assetJsonProxy(Root* root, String const& path) {
+  return LuaJsonProxy(root->assets()->json(path));
+}
+
 Json LuaBindings::RootCallbacks::makeCurrentVersionedJson(Root* root, String const& identifier, Json const& content) {
   return root->versioningDatabase()->makeCurrentVersionedJson(identifier, content).toJson();
 }
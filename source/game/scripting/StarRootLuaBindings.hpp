@@ -17,6 +17,7 @@ namespace LuaBindings {
     Image assetImage(Root* root, String const& path);
     Json assetFrames(Root* root, String const& path);
     Json assetJson(Root* root, String const& path);
+    LuaJsonProxy assetJsonProxy(Root* root, String const& path);
     Json makeCurrentVersionedJson(Root* root, String const& identifier, Json const& content);
     Json loadVersionedJson(Root* root, Json const& versionedJson, String const& expectedIdentifier);
     double evalFunction(Root* root, String const& arg1, double arg2);
@@ -8,6 +8,7 @@
 #include "StarJsonExtra.hpp"
 #include "StarLogging.hpp"
 #include "StarAssets.hpp"
+#include "StarMetrics.hpp"
 
 namespace Star {
 
@@ -83,10 +84,15 @@ void ScriptableThread::run() {
     double updateMeasureWindow = m_parameters.getDouble("updateMeasureWindow",0.5);
     TickRateApproacher tickApproacher(1.0f / m_timestep, updateMeasureWindow);
 
+    MetricLabels metricLabels = {{"thread", m_name}};
+    auto updateRateMetric = Metrics::gauge("server_script_thread_update_rate_hertz", "Scripted thread update rate", metricLabels);
+    auto luaMemoryMetric = Metrics::gauge("server_script_thread_lua_memory_bytes", "Memory used by the scripted thread Lua engine", metricLabels);
+
     while (!m_stop && !m_errorOccurred) {
-      LogMap::set(strf("lua_{}_update", m_name), strf("{:4.2f}Hz", tickApproacher.rate()));
+      updateRateMetric.set(tickApproacher.rate());
 
       update();
+      luaMemoryMetric.set(m_luaRoot->luaMemoryUsage());
       tickApproacher.setTargetTickRate(1.0f / m_timestep);
       tickApproacher.tick();
 
@@ -134,7 +140,6 @@ void ScriptableThread::update() {
     else
       message.promise.fail("Message not handled by thread");
   }
-  LogMap::set(strf("lua_{}_lua_mem", m_name), m_luaRoot->luaMemoryUsage());
 }
 
 LuaCallbacks ScriptableThread::makeThreadCallbacks() {
@@ -8,9 +8,15 @@ LuaCallbacks LuaBindings::makeScriptedAnimatorCallbacks(NetworkedAnimator* netwo
   LuaCallbacks callbacks;
 
   callbacks.registerCallback("animationParameter", getParameter);
-  callbacks.registerCallbackWithSignature<Maybe<Vec2F>, String, String>("partPoint", bind(&NetworkedAnimator::partPoint, networkedAnimator, _1, _2));
+  callbacks.registerCallback("partPoint",
+      [networkedAnimator](String const& partName, String const& propertyName) {
+        return networkedAnimator->partPoint(partName, propertyName);
+      });
   callbacks.registerCallbackWithSignature<Maybe<PolyF>, String, String>("partPoly", bind(&NetworkedAnimator::partPoly, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<Json, String, String, Maybe<String>, Maybe<String>, Maybe<int>>("partProperty", bind(&NetworkedAnimator::partProperty, networkedAnimator, _1, _2, _3, _4, _5));
+  callbacks.registerCallback("partProperty",
+      [networkedAnimator](String const& partName, String const& propertyName, Maybe<String> const& stateType, Maybe<String> const& state, Maybe<int> const& frame) {
+        return networkedAnimator->partProperty(partName, propertyName, stateType, state, frame);
+      });
   callbacks.registerCallbackWithSignature<Json, String, String>("partNextProperty", bind(&NetworkedAnimator::partNextProperty, networkedAnimator, _1, _2));
 
   callbacks.registerCallback("transformPoint", [networkedAnimator] (Vec2F point, String const& part) -> Vec2F {
@@ -51,8 +57,10 @@ LuaCallbacks LuaBindings::makeScriptedAnimatorCallbacks(NetworkedAnimator* netwo
   callbacks.registerCallbackWithSignature<bool, String>(
       "hasTransformationGroup", bind(&NetworkedAnimator::hasTransformationGroup, networkedAnimator, _1));
 
-  callbacks.registerCallbackWithSignature<void, String, Vec2F>("translateLocalTransformationGroup",
-      bind(&NetworkedAnimator::translateLocalTransformationGroup, networkedAnimator, _1, _2));
+  callbacks.registerCallback("translateLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, Vec2F const& translation) {
+        networkedAnimator->translateLocalTransformationGroup(transformationGroup, translation);
+      });
   callbacks.registerCallback("rotateLocalTransformationGroup",
       [networkedAnimator](String const& transformationGroup, float rotation, Maybe<Vec2F> const& rotationCenter) {
         networkedAnimator->rotateLocalTransformationGroup(transformationGroup, rotation, rotationCenter.value());
@@ -68,20 +76,31 @@ LuaCallbacks LuaBindings::makeScriptedAnimatorCallbacks(NetworkedAnimator* netwo
         else
           networkedAnimator->scaleLocalTransformationGroup(transformationGroup, engine.luaTo<float>(scale), scaleCenter.value());
       });
-  callbacks.registerCallbackWithSignature<void, String, float, float, float, float, float, float>(
-      "transformLocalTransformationGroup",
-      bind(&NetworkedAnimator::transformLocalTransformationGroup, networkedAnimator, _1, _2, _3, _4, _5, _6, _7));
-  callbacks.registerCallbackWithSignature<void, String>(
-      "resetLocalTransformationGroup", bind(&NetworkedAnimator::resetLocalTransformationGroup, networkedAnimator, _1));
-  callbacks.registerCallbackWithSignature<void, String, Mat3F>(
-      "setLocalTransformationGroup", bind(&NetworkedAnimator::setLocalTransformationGroup, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<Mat3F, String>(
-      "getLocalTransformationGroup", bind(&NetworkedAnimator::getLocalTransformationGroup, networkedAnimator, _1));
-
-  callbacks.registerCallbackWithSignature<void, String, List<Drawable>>(
-      "addPartDrawables", bind(&NetworkedAnimator::addPartDrawables, networkedAnimator, _1, _2));
-  callbacks.registerCallbackWithSignature<void, String, List<Drawable>>(
-      "setPartDrawables", bind(&NetworkedAnimator::setPartDrawables, networkedAnimator, _1, _2));
+  callbacks.registerCallback("transformLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, float a, float b, float c, float d, float tx, float ty) {
+        networkedAnimator->transformLocalTransformationGroup(transformationGroup, a, b, c, d, tx, ty);
+      });
+  callbacks.registerCallback("resetLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup) {
+        networkedAnimator->resetLocalTransformationGroup(transformationGroup);
+      });
+  callbacks.registerCallback("setLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup, Mat3F const& transform) {
+        networkedAnimator->setLocalTransformationGroup(transformationGroup, transform);
+      });
+  callbacks.registerCallback("getLocalTransformationGroup",
+      [networkedAnimator](String const& transformationGroup) {
+        return networkedAnimator->getLocalTransformationGroup(transformationGroup);
+      });
+
+  callbacks.registerCallback("addPartDrawables",
+      [networkedAnimator](String const& partName, List<Drawable> const& drawables) {
+        networkedAnimator->addPartDrawables(partName, drawables);
+      });
+  callbacks.registerCallback("setPartDrawables",
+      [networkedAnimator](String const& partName, List<Drawable> const& drawables) {
+        networkedAnimator->setPartDrawables(partName, drawables);
+      });
   callbacks.registerCallback("addPartJsonDrawables",
     [networkedAnimator](String const& part, JsonArray drawablesConfig) {
       networkedAnimator->addPartDrawables(part, drawablesConfig.transformed([](Json config) -> Drawable {
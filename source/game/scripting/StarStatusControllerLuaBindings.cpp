@@ -8,22 +8,38 @@ namespace Star {
 LuaCallbacks LuaBindings::makeStatusControllerCallbacks(StatusController* statController) {
   LuaCallbacks callbacks;
 
+  // Scripts pass stat names, so the stat getters look each name up in the
+  // interned name table once per call and then read the stat by id.  Names
+  // that are not in the table are never added to it, and are only looked up
+  // by name in case the table was full when the stat set saw them.
   callbacks.registerCallbackWithSignature<Json, String, Json>(
       "statusProperty", bind(StatusControllerCallbacks::statusProperty, statController, _1, _2));
   callbacks.registerCallbackWithSignature<void, String, Json>(
       "setStatusProperty", bind(StatusControllerCallbacks::setStatusProperty, statController, _1, _2));
-  callbacks.registerCallbackWithSignature<float, String>(
-      "stat", bind(StatusControllerCallbacks::stat, statController, _1));
-  callbacks.registerCallbackWithSignature<bool, String>(
-      "statPositive", bind(StatusControllerCallbacks::statPositive, statController, _1));
+  callbacks.registerCallback("stat", [statController](String const& statName) -> float {
+      if (auto statId = findStatName(statName))
+        return statController->stat(*statId);
+      return statController->stat(statName);
+    });
+  callbacks.registerCallback("statPositive", [statController](String const& statName) -> bool {
+      if (auto statId = findStatName(statName))
+        return statController->statPositive(*statId);
+      return statController->statPositive(statName);
+    });
   callbacks.registerCallbackWithSignature<StringList>(
       "resourceNames", bind(StatusControllerCallbacks::resourceNames, statController));
   callbacks.registerCallbackWithSignature<bool, String>(
       "isResource", bind(StatusControllerCallbacks::isResource, statController, _1));
-  callbacks.registerCallbackWithSignature<float, String>(
-      "resource", bind(StatusControllerCallbacks::resource, statController, _1));
-  callbacks.registerCallbackWithSignature<bool, String>(
-      "resourcePositive", bind(StatusControllerCallbacks::resourcePositive, statController, _1));
+  callbacks.registerCallback("resource", [statController](String const& statName) -> float {
+      if (auto statId = findStatName(statName))
+        return statController->resource(*statId);
+      return statController->resource(statName);
+    });
+  callbacks.registerCallback("resourcePositive", [statController](String const& statName) -> bool {
+      if (auto statId = findStatName(statName))
+        return statController->resourcePositive(*statId);
+      return statController->resourcePositive(statName);
+    });
   callbacks.registerCallbackWithSignature<void, String, float>(
       "setResource", bind(StatusControllerCallbacks::setResource, statController, _1, _2));
   callbacks.registerCallbackWithSignature<void, String, float>(
@@ -99,14 +115,6 @@ void LuaBindings::StatusControllerCallbacks::setStatusProperty(
   statController->setStatusProperty(arg1, arg2);
 }
 
-float LuaBindings::StatusControllerCallbacks::stat(StatusController* statController, String const& arg1) {
-  return statController->stat(arg1);
-}
-
-bool LuaBindings::StatusControllerCallbacks::statPositive(StatusController* statController, String const& arg1) {
-  return statController->statPositive(arg1);
-}
-
 StringList LuaBindings::StatusControllerCallbacks::resourceNames(StatusController* statController) {
   return statController->resourceNames();
 }
@@ -115,14 +123,6 @@ bool LuaBindings::StatusControllerCallbacks::isResource(StatusController* statCo
   return statController->isResource(arg1);
 }
 
-float LuaBindings::StatusControllerCallbacks::resource(StatusController* statController, String const& arg1) {
-  return statController->resource(arg1);
-}
-
-bool LuaBindings::StatusControllerCallbacks::resourcePositive(StatusController* statController, String const& arg1) {
-  return statController->resourcePositive(arg1);
-}
-
 void LuaBindings::StatusControllerCallbacks::setResource(
     StatusController* statController, String const& arg1, float arg2) {
   statController->setResource(arg1, arg2);
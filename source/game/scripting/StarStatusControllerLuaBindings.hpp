@@ -13,12 +13,8 @@ namespace LuaBindings {
   namespace StatusControllerCallbacks {
     Json statusProperty(StatusController* statController, String const& arg1, Json const& arg2);
     void setStatusProperty(StatusController* statController, String const& arg1, Json const& arg2);
-    float stat(StatusController* statController, String const& arg1);
-    bool statPositive(StatusController* statController, String const& arg1);
     StringList resourceNames(StatusController* statController);
     bool isResource(StatusController* statController, String const& arg1);
-    float resource(StatusController* statController, String const& arg1);
-    bool resourcePositive(StatusController* statController, String const& arg1);
     void setResource(StatusController* statController, String const& arg1, float arg2);
     void modifyResource(StatusController* statController, String const& arg1, float arg2);
     float giveResource(StatusController* statController, String const& resourceName, float amount);
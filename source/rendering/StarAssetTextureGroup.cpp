@@ -25,22 +25,37 @@ bool AssetTextureGroup::textureLoaded(AssetPath const& imagePath) const {
   return m_textureMap.contains(imagePath);
 }
 
+TexturePtr AssetTextureGroup::loadTexture(AssetPathId const& imageId) {
+  return loadTexture(imageId, false);
+}
+
+TexturePtr AssetTextureGroup::tryTexture(AssetPathId const& imageId) {
+  return loadTexture(imageId, true);
+}
+
+bool AssetTextureGroup::textureLoaded(AssetPathId const& imageId) const {
+  return m_textureIdMap.contains(imageId);
+}
+
 void AssetTextureGroup::cleanup(int64_t textureTimeout) {
   if (m_reloadTracker->pullTriggered()) {
     m_textureMap.clear();
+    m_textureIdMap.clear();
     m_textureDeduplicationMap.clear();
 
   } else {
     int64_t time = Time::monotonicMilliseconds();
 
     List<Texture const*> liveTextures;
-    filter(m_textureMap, [&](auto const& pair) {
-        if (time - pair.second.second < textureTimeout) {
-          liveTextures.append(pair.second.first.get());
-          return true;
-        }
-        return false;
-      });
+    auto isLive = [&](auto const& pair) {
+      if (time - pair.second.second < textureTimeout) {
+        liveTextures.append(pair.second.first.get());
+        return true;
+      }
+      return false;
+    };
+    filter(m_textureMap, isLive);
+    filter(m_textureIdMap, isLive);
 
     liveTextures.sort();
 
@@ -67,19 +82,44 @@ TexturePtr AssetTextureGroup::loadTexture(AssetPath const& imagePath, bool tryTe
   if (!image)
     return {};
 
+  auto texture = imageTexture(image);
+  m_textureMap.add(imagePath, {texture, Time::monotonicMilliseconds()});
+  return texture;
+}
+
+TexturePtr AssetTextureGroup::loadTexture(AssetPathId const& imageId, bool tryTexture) {
+  if (auto p = m_textureIdMap.ptr(imageId)) {
+    p->second = Time::monotonicMilliseconds();
+    return p->first;
+  }
+
+  auto assets = Root::singleton().assets();
+
+  ImageConstPtr image;
+  if (tryTexture)
+    image = assets->tryImage(imageId);
+  else
+    image = assets->image(imageId);
+
+  if (!image)
+    return {};
+
+  auto texture = imageTexture(image);
+  m_textureIdMap.add(imageId, {texture, Time::monotonicMilliseconds()});
+  return texture;
+}
+
+TexturePtr AssetTextureGroup::imageTexture(ImageConstPtr const& image) {
   // Assets will return the same image ptr if two different asset paths point
   // to the same underlying cached image.  We should not make duplicate entries
   // in the texture group for these, so we keep track of the image pointers
   // returned to deduplicate them.
-  if (auto existingTexture = m_textureDeduplicationMap.value(image)) {
-    m_textureMap.add(imagePath, {existingTexture, Time::monotonicMilliseconds()});
+  if (auto existingTexture = m_textureDeduplicationMap.value(image))
     return existingTexture;
-  } else {
-    auto texture = m_textureGroup->create(*image);
-    m_textureMap.add(imagePath, {texture, Time::monotonicMilliseconds()});
-    m_textureDeduplicationMap.add(image, texture);
-    return texture;
-  }
+
+  auto texture = m_textureGroup->create(*image);
+  m_textureDeduplicationMap.add(image, texture);
+  return texture;
 }
 
 }
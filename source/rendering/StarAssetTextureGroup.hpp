@@ -29,6 +29,11 @@ public:
   // Has the texture been loaded?
   bool textureLoaded(AssetPath const& imagePath) const;
 
+  // As above, for an interned path, which is found without hashing the path.
+  TexturePtr loadTexture(AssetPathId const& imageId);
+  TexturePtr tryTexture(AssetPathId const& imageId);
+  bool textureLoaded(AssetPathId const& imageId) const;
+
   // Frees textures that haven't been used in more than 'textureTimeout' time.
   // If Root has been reloaded, will simply clear the texture group.
   void cleanup(int64_t textureTimeout);
@@ -38,9 +43,15 @@ private:
   // if the texture is not loaded, and queues it, otherwise loads texture
   // immediately
   TexturePtr loadTexture(AssetPath const& imagePath, bool tryTexture);
+  TexturePtr loadTexture(AssetPathId const& imageId, bool tryTexture);
+
+  // Returns the texture for the given image, creating it unless another path
+  // already loaded the same image.
+  TexturePtr imageTexture(ImageConstPtr const& image);
 
   TextureGroupPtr m_textureGroup;
   HashMap<AssetPath, pair<TexturePtr, int64_t>> m_textureMap;
+  HashMap<AssetPathId, pair<TexturePtr, int64_t>> m_textureIdMap;
   HashMap<ImageConstPtr, TexturePtr> m_textureDeduplicationMap;
   TrackerListenerPtr m_reloadTracker;
 };
@@ -34,7 +34,7 @@ void DrawablePainter::drawDrawable(Drawable const& drawable) {
     primitives.emplace_back(std::in_place_type_t<RenderPoly>(), poly.vertexes(), color, 0.0f);
 
   } else if (auto imagePart = drawable.part.ptr<Drawable::ImagePart>()) {
-    TexturePtr texture = m_textureGroup->loadTexture(imagePart->image);
+    TexturePtr texture = imagePart->imageId ? m_textureGroup->loadTexture(imagePart->imageId) : m_textureGroup->loadTexture(imagePart->image);
 
     Vec2F position = drawable.position;
     Vec2F textureSize(texture->size());
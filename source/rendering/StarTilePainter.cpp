@@ -7,9 +7,17 @@
 #include "StarAssets.hpp"
 #include "StarRoot.hpp"
 #include "StarTileDrawer.hpp"
+#include "StarLogging.hpp"
 
 namespace Star {
 
+// Chunk build threads are shared by every TilePainter in the process, and are
+// started by the first one that uses them.
+static WorkerPool& chunkBuildWorkerPool(unsigned threadCount) {
+  static WorkerPool workerPool("TerrainChunkWorkerPool", threadCount);
+  return workerPool;
+}
+
 TilePainter::TilePainter(RendererPtr renderer) : TileDrawer() {
   m_renderer = std::move(renderer);
   m_textureGroup = m_renderer->createTextureGroup(TextureGroupSize::Large);
@@ -17,11 +25,14 @@ TilePainter::TilePainter(RendererPtr renderer) : TileDrawer() {
   auto& root = Root::singleton();
   auto assets = root.assets();
 
-  m_terrainChunkCache.setTimeToLive(assets->json("/rendering.config:chunkCacheTimeout").toInt());
-  m_terrainChunkCache.setTimeSmear(m_terrainChunkCache.timeToLive() / 4);
+  m_chunkCache.setTimeToLive(assets->json("/rendering.config:chunkCacheTimeout").toInt());
+  m_chunkCache.setTimeSmear(m_chunkCache.timeToLive() / 4);
+
+  m_cameraPan = Vec2F();
 
-  m_liquidChunkCache.setTimeToLive(assets->json("/rendering.config:chunkCacheTimeout").toInt());
-  m_liquidChunkCache.setTimeSmear(m_liquidChunkCache.timeToLive() / 4);
+  m_workerPool = nullptr;
+  if (unsigned buildThreads = assets->json("/rendering.config").getUInt("chunkBuildThreads", 0))
+    m_workerPool = &chunkBuildWorkerPool(buildThreads);
 
   m_textureCache.setTimeToLive(assets->json("/rendering.config:textureTimeout").toInt());
 
@@ -35,6 +46,17 @@ TilePainter::TilePainter(RendererPtr renderer) : TileDrawer() {
   }
 }
 
+TilePainter::~TilePainter() {
+  // Chunk builds reference the painter, so they must all be done
+  for (auto& pair : m_buildingChunks) {
+    try {
+      pair.second.build.get();
+    } catch (std::exception const& e) {
+      Logger::error("TilePainter: Exception caught building terrain chunk: {}", outputException(e, true));
+    }
+  }
+}
+
 void TilePainter::adjustLighting(WorldRenderData& renderData) const {
   RectI lightRange = RectI::withSize(renderData.lightMinPosition, Vec2I(renderData.lightMap.size()));
   forEachRenderTile(renderData, lightRange, [&](Vec2I const& pos, RenderTile const& tile) {
@@ -60,9 +82,41 @@ void TilePainter::setup(WorldCamera const& camera, WorldRenderData& renderData)
     m_cameraPan = renderData.geometry.diff(cameraCenter, *m_lastCameraCenter);
   m_lastCameraCenter = cameraCenter;
 
+  collectBuiltChunks();
+
+  if (renderData.tilesReset) {
+    m_chunkCache.clear();
+    for (auto& pair : m_buildingChunks) {
+      pair.second.terrainValid = false;
+      pair.second.liquidValid = false;
+    }
+  }
+  invalidateChunks(renderData.geometry, renderData.changedTerrainRegions, true);
+  invalidateChunks(renderData.geometry, renderData.changedLiquidRegions, false);
+
   //Kae: Padded by one to fix culling issues with certain tile pieces at chunk borders, such as grass.
   RectI chunkRange = RectI::integral(RectF(camera.worldTileRect().padded(1)).scaled(1.0f / RenderChunkSize));
 
+  if (m_workerPool) {
+    // Every visible chunk that needs building is started on the worker pool
+    // before waiting on any of them, along with the chunks just outside of
+    // the view in the direction that the camera is moving.
+    RectI prefetchRange = chunkRange;
+    if (m_cameraPan[0] > 0)
+      prefetchRange.setXMax(prefetchRange.xMax() + 1);
+    else if (m_cameraPan[0] < 0)
+      prefetchRange.setXMin(prefetchRange.xMin() - 1);
+    if (m_cameraPan[1] > 0)
+      prefetchRange.setYMax(prefetchRange.yMax() + 1);
+    else if (m_cameraPan[1] < 0)
+      prefetchRange.setYMin(prefetchRange.yMin() - 1);
+
+    for (int x = prefetchRange.xMin(); x < prefetchRange.xMax(); ++x) {
+      for (int y = prefetchRange.yMin(); y < prefetchRange.yMax(); ++y)
+        prefetchChunk(renderData, {x, y});
+    }
+  }
+
   size_t chunks = chunkRange.volume();
   m_pendingTerrainChunks.resize(chunks);
   m_pendingLiquidChunks.resize(chunks);
@@ -71,8 +125,9 @@ void TilePainter::setup(WorldCamera const& camera, WorldRenderData& renderData)
   for (int x = chunkRange.xMin(); x < chunkRange.xMax(); ++x) {
     for (int y = chunkRange.yMin(); y < chunkRange.yMax(); ++y) {
       size_t index = i++;
-      m_pendingTerrainChunks[index] = getTerrainChunk(renderData, {x, y});
-      m_pendingLiquidChunks [index] =  getLiquidChunk(renderData, {x, y});
+      auto const& chunk = getChunk(renderData, {x, y});
+      m_pendingTerrainChunks[index] = chunk.terrain;
+      m_pendingLiquidChunks [index] = chunk.liquid;
     }
   }
 }
@@ -108,8 +163,7 @@ void TilePainter::cleanup() {
   m_pendingLiquidChunks.clear();
 
   m_textureCache.cleanup();
-  m_terrainChunkCache.cleanup();
-  m_liquidChunkCache.cleanup();
+  m_chunkCache.cleanup();
 }
 
 size_t TilePainter::TextureKeyHash::operator()(TextureKey const& key) const {
@@ -119,11 +173,15 @@ size_t TilePainter::TextureKeyHash::operator()(TextureKey const& key) const {
     return hashOf(key.typeIndex(), key.get<AssetTextureKey>());
 }
 
+RectI TilePainter::chunkTileRange(Vec2I chunkIndex) {
+  return RectI::withSize(chunkIndex * RenderChunkSize, Vec2I::filled(RenderChunkSize));
+}
+
 TilePainter::ChunkHash TilePainter::terrainChunkHash(WorldRenderData& renderData, Vec2I chunkIndex) {
   //XXHash3 hasher;
   static ByteArray buffer;
   buffer.clear();
-  RectI tileRange = RectI::withSize(chunkIndex * RenderChunkSize, Vec2I::filled(RenderChunkSize)).padded(MaterialRenderProfileMaxNeighborDistance);
+  RectI tileRange = chunkTileRange(chunkIndex).padded(MaterialRenderProfileMaxNeighborDistance);
   forEachRenderTile(renderData, tileRange, [&](Vec2I const&, RenderTile const& renderTile) {
     //renderTile.hashPushTerrain(hasher);
     buffer.append((char*)&renderTile, offsetof(RenderTile, liquidId));
@@ -135,7 +193,7 @@ TilePainter::ChunkHash TilePainter::terrainChunkHash(WorldRenderData& renderData
 
 TilePainter::ChunkHash TilePainter::liquidChunkHash(WorldRenderData& renderData, Vec2I chunkIndex) {
   ///XXHash3 hasher;
-  RectI tileRange = RectI::withSize(chunkIndex * RenderChunkSize, Vec2I::filled(RenderChunkSize)).padded(MaterialRenderProfileMaxNeighborDistance);
+  RectI tileRange = chunkTileRange(chunkIndex).padded(MaterialRenderProfileMaxNeighborDistance);
   static ByteArray buffer;
   buffer.clear();
 
@@ -148,6 +206,53 @@ TilePainter::ChunkHash TilePainter::liquidChunkHash(WorldRenderData& renderData,
   return XXH3_64bits(buffer.ptr(), buffer.size());
 }
 
+bool TilePainter::chunkTilesAvailable(WorldRenderData const& renderData, Vec2I chunkIndex) {
+  RectI tileRange = chunkTileRange(chunkIndex).padded(MaterialRenderProfileMaxNeighborDistance);
+  RectI indexRect = RectI::withSize(renderData.geometry.diff(tileRange.min(), renderData.tileMinPosition), tileRange.size());
+  return RectI::withSize(Vec2I(), Vec2I(renderData.tiles.size())).contains(indexRect);
+}
+
+WorldRenderData TilePainter::chunkRenderData(WorldRenderData const& renderData, Vec2I chunkIndex) {
+  RectI tileRange = chunkTileRange(chunkIndex).padded(MaterialRenderProfileMaxNeighborDistance);
+
+  WorldRenderData chunkData;
+  chunkData.geometry = renderData.geometry;
+  chunkData.tileMinPosition = tileRange.min();
+  chunkData.tiles.resize(Array2S(tileRange.size()), DefaultRenderTile);
+  forEachRenderTile(renderData, tileRange, [&](Vec2I const& pos, RenderTile const& renderTile) {
+    chunkData.tiles(Vec2S(pos - tileRange.min())) = renderTile;
+  });
+  return chunkData;
+}
+
+void TilePainter::invalidateChunks(WorldGeometry const& geometry, List<RectI> const& changedRegions, bool terrain) {
+  int worldWidth = geometry.width();
+  for (auto const& region : changedRegions) {
+    // Chunk indexes are not wrapped, so the same tiles can be cached under a
+    // chunk index on either side of the world wrap.
+    for (int wrapOffset : {-worldWidth, 0, worldWidth}) {
+      RectI tileRange = region.padded(MaterialRenderProfileMaxNeighborDistance).translated({wrapOffset, 0});
+      RectI chunkRange = RectI::integral(RectF(tileRange).scaled(1.0f / RenderChunkSize));
+      for (int x = chunkRange.xMin(); x < chunkRange.xMax(); ++x) {
+        for (int y = chunkRange.yMin(); y < chunkRange.yMax(); ++y) {
+          if (auto chunk = m_chunkCache.ptr({x, y})) {
+            if (terrain)
+              chunk->terrain.reset();
+            else
+              chunk->liquid.reset();
+          }
+          if (auto building = m_buildingChunks.ptr({x, y})) {
+            if (terrain)
+              building->terrainValid = false;
+            else
+              building->liquidValid = false;
+          }
+        }
+      }
+    }
+  }
+}
+
 void TilePainter::renderTerrainChunks(WorldCamera const& camera, TerrainLayer terrainLayer) {
   Map<QuadZLevel, List<RenderBufferPtr>> zOrderBuffers;
   for (auto const& chunk : m_pendingTerrainChunks) {
@@ -168,64 +273,168 @@ void TilePainter::renderTerrainChunks(WorldCamera const& camera, TerrainLayer te
   m_renderer->flush();
 }
 
-shared_ptr<TilePainter::TerrainChunk const> TilePainter::getTerrainChunk(WorldRenderData& renderData, Vec2I chunkIndex) {
-  pair<Vec2I, ChunkHash> chunkKey = {chunkIndex, terrainChunkHash(renderData, chunkIndex)};
-  return m_terrainChunkCache.get(chunkKey, [&](auto const&) {
-      HashMap<TerrainLayer, HashMap<QuadZLevel, List<RenderPrimitive>>> terrainPrimitives;
-
-      RectI tileRange = RectI::withSize(chunkIndex * RenderChunkSize, Vec2I::filled(RenderChunkSize));
-      for (int x = tileRange.xMin(); x < tileRange.xMax(); ++x) {
-        for (int y = tileRange.yMin(); y < tileRange.yMax(); ++y) {
-          bool occluded = this->produceTerrainPrimitives(terrainPrimitives[TerrainLayer::Foreground], TerrainLayer::Foreground, {x, y}, renderData);
-          occluded = this->produceTerrainPrimitives(terrainPrimitives[TerrainLayer::Midground], TerrainLayer::Midground, {x, y}, renderData) || occluded;
-          if (!occluded)
-            this->produceTerrainPrimitives(terrainPrimitives[TerrainLayer::Background], TerrainLayer::Background, {x, y}, renderData);
-        }
-      }
-
-      auto chunk = make_shared<TerrainChunk>();
+void TilePainter::prefetchChunk(WorldRenderData const& renderData, Vec2I chunkIndex) {
+  if (m_buildingChunks.contains(chunkIndex) || !chunkTilesAvailable(renderData, chunkIndex))
+    return;
 
-      for (auto& layerPair : terrainPrimitives) {
-        for (auto& zLevelPair : layerPair.second) {
-          auto rb = m_renderer->createRenderBuffer();
-          rb->set(zLevelPair.second);
-          (*chunk)[layerPair.first][zLevelPair.first] = std::move(rb);
-        }
-      }
+  bool terrain = true;
+  bool liquid = true;
+  if (auto chunk = m_chunkCache.ptr(chunkIndex)) {
+    terrain = !chunk->terrain || chunk->terrainHash;
+    liquid = !chunk->liquid || chunk->liquidHash;
+  }
+  if (!terrain && !liquid)
+    return;
 
-      return chunk;
+  auto chunkData = make_shared<WorldRenderData>(chunkRenderData(renderData, chunkIndex));
+  auto build = m_workerPool->addProducer<ChunkBuild>([this, chunkData, chunkIndex, terrain, liquid]() {
+      return buildChunk(*chunkData, chunkIndex, terrain, liquid);
     });
+  m_buildingChunks.add(chunkIndex, BuildingChunk{std::move(build), terrain, liquid});
 }
 
-shared_ptr<TilePainter::LiquidChunk const> TilePainter::getLiquidChunk(WorldRenderData& renderData, Vec2I chunkIndex) {
-  pair<Vec2I, ChunkHash> chunkKey = {chunkIndex, liquidChunkHash(renderData, chunkIndex)};
-  return m_liquidChunkCache.get(chunkKey, [&](auto const&) {
-      HashMap<LiquidId, List<RenderPrimitive>> liquidPrimitives;
+void TilePainter::collectBuiltChunks() {
+  List<Vec2I> built;
+  for (auto const& pair : m_buildingChunks) {
+    if (pair.second.build.done())
+      built.append(pair.first);
+  }
+  for (auto const& chunkIndex : built)
+    finishBuildingChunk(chunkIndex);
+}
+
+void TilePainter::finishBuildingChunk(Vec2I chunkIndex) {
+  auto building = m_buildingChunks.take(chunkIndex);
+  ChunkBuild build = std::move(building.build.get());
+  if (!building.terrainValid)
+    build.terrain.reset();
+  if (!building.liquidValid)
+    build.liquid.reset();
+  finishChunk(chunkIndex, std::move(build), {}, {});
+}
 
-      RectI tileRange = RectI::withSize(chunkIndex * RenderChunkSize, Vec2I::filled(RenderChunkSize));
-      for (int x = tileRange.xMin(); x < tileRange.xMax(); ++x) {
-        for (int y = tileRange.yMin(); y < tileRange.yMax(); ++y)
-          this->produceLiquidPrimitives(liquidPrimitives, {x, y}, renderData);
+TilePainter::CachedChunk const& TilePainter::getChunk(WorldRenderData& renderData, Vec2I chunkIndex) {
+  if (m_buildingChunks.contains(chunkIndex))
+    finishBuildingChunk(chunkIndex);
+
+  Maybe<ChunkHash> terrainHash;
+  Maybe<ChunkHash> liquidHash;
+  if (!chunkTilesAvailable(renderData, chunkIndex)) {
+    terrainHash = terrainChunkHash(renderData, chunkIndex);
+    liquidHash = liquidChunkHash(renderData, chunkIndex);
+  }
+
+  bool terrain = true;
+  bool liquid = true;
+  if (auto chunk = m_chunkCache.ptr(chunkIndex)) {
+    terrain = !chunk->terrain || (chunk->terrainHash && chunk->terrainHash != terrainHash);
+    liquid = !chunk->liquid || (chunk->liquidHash && chunk->liquidHash != liquidHash);
+  }
+  if (terrain || liquid)
+    finishChunk(chunkIndex, buildChunk(renderData, chunkIndex, terrain, liquid), terrainHash, liquidHash);
+
+  return *m_chunkCache.ptr(chunkIndex);
+}
+
+TilePainter::ChunkBuild TilePainter::buildChunk(WorldRenderData const& renderData, Vec2I chunkIndex, bool terrain, bool liquid) const {
+  auto materialDatabase = Root::singleton().materialDatabase();
+  RectI tileRange = chunkTileRange(chunkIndex);
+
+  ChunkBuild build;
+  if (terrain) {
+    build.terrain.emplace();
+    auto& terrainQuads = *build.terrain;
+    for (int x = tileRange.xMin(); x < tileRange.xMax(); ++x) {
+      for (int y = tileRange.yMin(); y < tileRange.yMax(); ++y) {
+        bool occluded = produceTerrainQuads(terrainQuads[TerrainLayer::Foreground], materialDatabase, TerrainLayer::Foreground, {x, y}, renderData);
+        occluded = produceTerrainQuads(terrainQuads[TerrainLayer::Midground], materialDatabase, TerrainLayer::Midground, {x, y}, renderData) || occluded;
+        if (!occluded)
+          produceTerrainQuads(terrainQuads[TerrainLayer::Background], materialDatabase, TerrainLayer::Background, {x, y}, renderData);
       }
+    }
+  }
+
+  if (liquid) {
+    build.liquid.emplace();
+    auto& liquidPrimitives = *build.liquid;
+    for (int x = tileRange.xMin(); x < tileRange.xMax(); ++x) {
+      for (int y = tileRange.yMin(); y < tileRange.yMax(); ++y)
+        produceLiquidPrimitives(liquidPrimitives, {x, y}, renderData);
+    }
+  }
 
-      auto chunk = make_shared<LiquidChunk>();
+  return build;
+}
+
+void TilePainter::finishChunk(Vec2I chunkIndex, ChunkBuild build, Maybe<ChunkHash> terrainHash, Maybe<ChunkHash> liquidHash) {
+  auto& cachedChunk = m_chunkCache.get(chunkIndex, [](auto const&) { return CachedChunk(); });
+
+  if (build.terrain) {
+    auto chunk = make_shared<TerrainChunk>();
+
+    List<RenderPrimitive> primitives;
+    for (auto& layerPair : *build.terrain) {
+      for (auto& zLevelPair : layerPair.second) {
+        primitives.clear();
+        for (auto const& quad : zLevelPair.second) {
+          TexturePtr texture = quadTexture(quad);
+          RectF textureCoords = quad.piece ? quad.textureCoords : RectF::withSize(Vec2F(), Vec2F(texture->size()));
+          RectF worldCoords = RectF::withSize(quad.position, textureCoords.size() / TilePixels);
+          primitives.emplace_back(std::in_place_type_t<RenderQuad>(), std::move(texture),
+              worldCoords  .min(),
+              textureCoords.min(),
+              Vec2F(  worldCoords.xMax(),   worldCoords.yMin()),
+              Vec2F(textureCoords.xMax(), textureCoords.yMin()),
+              worldCoords  .max(),
+              textureCoords.max(),
+              Vec2F(  worldCoords.xMin(),   worldCoords.yMax()),
+              Vec2F(textureCoords.xMin(), textureCoords.yMax()),
+              quad.color, 1.0f);
+        }
 
-      for (auto& p : liquidPrimitives) {
         auto rb = m_renderer->createRenderBuffer();
-        rb->set(p.second);
-        chunk->set(p.first, std::move(rb));
+        rb->set(primitives);
+        (*chunk)[layerPair.first][zLevelPair.first] = std::move(rb);
       }
+    }
 
-      return chunk;
-    });
+    cachedChunk.terrain = std::move(chunk);
+    cachedChunk.terrainHash = terrainHash;
+  }
+
+  if (build.liquid) {
+    auto chunk = make_shared<LiquidChunk>();
+
+    for (auto& p : *build.liquid) {
+      auto rb = m_renderer->createRenderBuffer();
+      rb->set(p.second);
+      chunk->set(p.first, std::move(rb));
+    }
+
+    cachedChunk.liquid = std::move(chunk);
+    cachedChunk.liquidHash = liquidHash;
+  }
 }
 
-bool TilePainter::produceTerrainPrimitives(HashMap<QuadZLevel, List<RenderPrimitive>>& primitives,
-    TerrainLayer terrainLayer, Vec2I const& pos, WorldRenderData const& renderData) {
-  auto& root = Root::singleton();
-  auto assets = Root::singleton().assets();
-  auto materialDatabase = root.materialDatabase();
+TexturePtr TilePainter::quadTexture(TerrainQuad const& quad) {
+  return m_textureCache.get(quad.textureKey, [&](auto const&) {
+      auto assets = Root::singleton().assets();
+      if (auto pieceKey = quad.textureKey.ptr<MaterialPieceTextureKey>()) {
+        MaterialHue hue = get<2>(*pieceKey);
+        AssetPath texture = (hue == 0) ? quad.piece->texture : strf("{}?hueshift={}", quad.piece->texture, materialHueToDegrees(hue));
+
+        if (quad.directives)
+          texture.directives += quad.directives;
 
+        return m_textureGroup->create(*assets->image(texture));
+      }
+
+      return m_textureGroup->create(*assets->image(quad.textureKey.get<AssetTextureKey>()));
+    });
+}
+
+bool TilePainter::produceTerrainQuads(HashMap<QuadZLevel, List<TerrainQuad>>& quads, MaterialDatabaseConstPtr const& materialDatabase,
+    TerrainLayer terrainLayer, Vec2I const& pos, WorldRenderData const& renderData) const {
   RenderTile const& tile = getRenderTile(renderData, pos);
 
   MaterialId material = EmptyMaterialId;
@@ -264,17 +473,6 @@ bool TilePainter::produceTerrainPrimitives(HashMap<QuadZLevel, List<RenderPrimit
   if (terrainLayer == (isBlock ? TerrainLayer::Midground : TerrainLayer::Foreground))
     return false;
 
-  auto getPieceTexture = [this, assets](MaterialId material, MaterialRenderPieceConstPtr const& piece, MaterialHue hue, Directives const* directives, bool mod) {
-    return m_textureCache.get(MaterialPieceTextureKey(material, piece->pieceId, hue, mod), [&](auto const&) {
-        AssetPath texture = (hue == 0) ? piece->texture : strf("{}?hueshift={}", piece->texture, materialHueToDegrees(hue));
-
-        if (directives)
-          texture.directives += *directives;
-
-        return m_textureGroup->create(*assets->image(texture));
-      });
-  };
-
   auto materialRenderProfile = materialDatabase->materialRenderProfile(material);
   auto modRenderProfile = materialDatabase->modRenderProfile(mod);
 
@@ -282,84 +480,53 @@ bool TilePainter::produceTerrainPrimitives(HashMap<QuadZLevel, List<RenderPrimit
     occlude = materialRenderProfile->occludesBehind;
     auto materialColorVariant = materialRenderProfile->colorVariants > 0 ? colorVariant % materialRenderProfile->colorVariants : 0;
     uint32_t variance = staticRandomU32(renderData.geometry.xwrap(pos[0]), pos[1], (int)terrainLayer, "main");
-    auto& quadList = primitives[materialZLevel(materialRenderProfile->zLevel, material, materialHue, materialColorVariant)];
+    auto& quadList = quads[materialZLevel(materialRenderProfile->zLevel, material, materialHue, materialColorVariant)];
 
     MaterialPieceResultList pieces;
     determineMatchingPieces(pieces, &occlude, materialDatabase, materialRenderProfile->mainMatchList, renderData, pos,
         terrainLayer == TerrainLayer::Background ? TileLayer::Background : TileLayer::Foreground, false);
-    Directives const* directives = materialRenderProfile->colorDirectives.empty()
-      ? nullptr
-      : &materialRenderProfile->colorDirectives.wrap(materialColorVariant);
+    Directives directives = materialRenderProfile->colorDirectives.empty()
+      ? Directives()
+      : materialRenderProfile->colorDirectives.wrap(materialColorVariant);
     for (auto const& piecePair : pieces) {
-      TexturePtr texture = getPieceTexture(material, piecePair.first, materialHue, directives, false);
       auto variant = piecePair.first->variants.ptr(materialColorVariant);
       if (!variant) variant = piecePair.first->variants.ptr(0);
       if (!variant) continue;
-      RectF textureCoords = variant->wrap(variance);
-      RectF worldCoords = RectF::withSize(piecePair.second / TilePixels + Vec2F(pos), textureCoords.size() / TilePixels);
-      quadList.emplace_back(std::in_place_type_t<RenderQuad>(), std::move(texture),
-          worldCoords  .min(),
-          textureCoords.min(),
-          Vec2F(  worldCoords.xMax(),   worldCoords.yMin()),
-          Vec2F(textureCoords.xMax(), textureCoords.yMin()),
-          worldCoords  .max(),
-          textureCoords.max(),
-          Vec2F(  worldCoords.xMin(),   worldCoords.yMax()),
-          Vec2F(textureCoords.xMin(), textureCoords.yMax()),
-          color, 1.0f);
+      quadList.append(TerrainQuad{MaterialPieceTextureKey(material, piecePair.first->pieceId, materialHue, false),
+          piecePair.first, directives, piecePair.second / TilePixels + Vec2F(pos), variant->wrap(variance), color});
     }
   }
 
   if (modRenderProfile) {
     auto modColorVariant = modRenderProfile->colorVariants > 0 ? colorVariant % modRenderProfile->colorVariants : 0;
     uint32_t variance = staticRandomU32(renderData.geometry.xwrap(pos[0]), pos[1], (int)terrainLayer, "mod");
-    auto& quadList = primitives[modZLevel(modRenderProfile->zLevel, mod, modHue, modColorVariant)];
+    auto& quadList = quads[modZLevel(modRenderProfile->zLevel, mod, modHue, modColorVariant)];
 
     MaterialPieceResultList pieces;
     determineMatchingPieces(pieces, &occlude, materialDatabase, modRenderProfile->mainMatchList, renderData, pos,
         terrainLayer == TerrainLayer::Background ? TileLayer::Background : TileLayer::Foreground, true);
-    Directives const* directives = modRenderProfile->colorDirectives.empty()
-      ? nullptr
-      : &modRenderProfile->colorDirectives.wrap(modColorVariant);
+    Directives directives = modRenderProfile->colorDirectives.empty()
+      ? Directives()
+      : modRenderProfile->colorDirectives.wrap(modColorVariant);
     for (auto const& piecePair : pieces) {
-      auto texture = getPieceTexture(mod, piecePair.first, modHue, directives, true);
       auto variant = piecePair.first->variants.ptr(modColorVariant);
       if (!variant) variant = piecePair.first->variants.ptr(0);
       if (!variant) continue;
-      auto& textureCoords = variant->wrap(variance);
-      RectF worldCoords = RectF::withSize(piecePair.second / TilePixels + Vec2F(pos), textureCoords.size() / TilePixels);
-      quadList.emplace_back(std::in_place_type_t<RenderQuad>(), std::move(texture),
-          worldCoords.min(), textureCoords.min(),
-          Vec2F(worldCoords.xMax(), worldCoords.yMin()), Vec2F(textureCoords.xMax(), textureCoords.yMin()),
-          worldCoords.max(), textureCoords.max(),
-          Vec2F(worldCoords.xMin(), worldCoords.yMax()), Vec2F(textureCoords.xMin(), textureCoords.yMax()),
-        color, 1.0f);
+      quadList.append(TerrainQuad{MaterialPieceTextureKey(mod, piecePair.first->pieceId, modHue, true),
+          piecePair.first, directives, piecePair.second / TilePixels + Vec2F(pos), variant->wrap(variance), color});
     }
   }
 
   if (materialRenderProfile && damageLevel > 0 && isBlock) {
-    auto& quadList = primitives[damageZLevel()];
     auto const& crackingImage = materialRenderProfile->damageImage(damageLevel, damageType);
-
-    TexturePtr texture = m_textureCache.get(AssetTextureKey(crackingImage.first),
-        [&](auto const&) { return m_textureGroup->create(*assets->image(crackingImage.first)); });
-
-    Vec2F textureSize(texture->size());
-    RectF textureCoords = RectF::withSize(Vec2F(), textureSize);
-    RectF worldCoords = RectF::withSize(crackingImage.second / TilePixels + Vec2F(pos), textureCoords.size() / TilePixels);
-
-    quadList.emplace_back(std::in_place_type_t<RenderQuad>(), std::move(texture),
-        worldCoords.min(), textureCoords.min(),
-        Vec2F(worldCoords.xMax(), worldCoords.yMin()), Vec2F(textureCoords.xMax(), textureCoords.yMin()),
-        worldCoords.max(), textureCoords.max(),
-        Vec2F(worldCoords.xMin(), worldCoords.yMax()), Vec2F(textureCoords.xMin(), textureCoords.yMax()),
-      color, 1.0f);
+    quads[damageZLevel()].append(TerrainQuad{AssetTextureKey(crackingImage.first),
+        {}, {}, crackingImage.second / TilePixels + Vec2F(pos), RectF(), color});
   }
 
   return occlude;
 }
 
-void TilePainter::produceLiquidPrimitives(HashMap<LiquidId, List<RenderPrimitive>>& primitives, Vec2I const& pos, WorldRenderData const& renderData) {
+void TilePainter::produceLiquidPrimitives(LiquidChunkPrimitives& primitives, Vec2I const& pos, WorldRenderData const& renderData) const {
   RenderTile const& tile = getRenderTile(renderData, pos);
 
   float drawLevel = liquidDrawLevel(byteToFloat(tile.liquidLevel));
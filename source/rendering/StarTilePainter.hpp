@@ -6,6 +6,7 @@
 #include "StarRenderer.hpp"
 #include "StarWorldCamera.hpp"
 #include "StarTileDrawer.hpp"
+#include "StarWorkerPool.hpp"
 
 namespace Star {
 
@@ -16,18 +17,20 @@ STAR_CLASS(TilePainter);
 class TilePainter : public TileDrawer {
 public:
   // The rendered tiles are split and cached in chunks of RenderChunkSize x
-  // RenderChunkSize.  This means that, around the border, there may be as many
-  // as RenderChunkSize - 1 tiles rendered outside of the viewing area from
-  // chunk alignment.  In addition to this, there is also a region around each
-  // tile that is used for neighbor based rendering rules which has a max of
-  // MaterialRenderProfileMaxNeighborDistance.  If the given tile data does not
-  // extend RenderChunkSize + MaterialRenderProfileMaxNeighborDistance - 1
-  // around the viewing area, then border chunks can continuously change hash,
-  // and will be recomputed too often.
+  // RenderChunkSize.  Cached chunks are kept until the render data reports
+  // that tiles within them, or within MaterialRenderProfileMaxNeighborDistance
+  // of them, have changed.  Around the border there may be as many as
+  // RenderChunkSize tiles rendered outside of the viewing area from chunk
+  // alignment, and the next RenderChunkSize tiles are prefetched in the
+  // direction the camera is moving.  If the given tile data does not cover
+  // these and their neighbor region, then border chunks are built from
+  // incomplete data and have to be checked against a hash of their tiles
+  // every frame.
   static unsigned const RenderChunkSize = 16;
-  static unsigned const BorderTileSize = RenderChunkSize + MaterialRenderProfileMaxNeighborDistance - 1;
+  static unsigned const BorderTileSize = 2 * RenderChunkSize + MaterialRenderProfileMaxNeighborDistance;
 
   TilePainter(RendererPtr renderer);
+  ~TilePainter();
 
   // Adjusts lighting levels for liquids.
   void adjustLighting(WorldRenderData& renderData) const;
@@ -70,21 +73,80 @@ private:
     size_t operator()(TextureKey const& key) const;
   };
 
+  // Textures can only be created on the render thread, so terrain is first
+  // produced as quads that only know the key of their texture.
+  struct TerrainQuad {
+    TextureKey textureKey;
+    // The material or mod piece the quad is textured with, or null if the
+    // quad covers the whole of an asset image.
+    MaterialRenderPieceConstPtr piece;
+    Directives directives;
+    Vec2F position;
+    RectF textureCoords;
+    Vec4B color;
+  };
+
+  typedef HashMap<TerrainLayer, HashMap<QuadZLevel, List<TerrainQuad>>> TerrainChunkQuads;
+  typedef HashMap<LiquidId, List<RenderPrimitive>> LiquidChunkPrimitives;
+
+  struct ChunkBuild {
+    Maybe<TerrainChunkQuads> terrain;
+    Maybe<LiquidChunkPrimitives> liquid;
+  };
+
+  struct CachedChunk {
+    shared_ptr<TerrainChunk const> terrain;
+    shared_ptr<LiquidChunk const> liquid;
+    // Set for parts built while some of the tiles they depend on were not in
+    // the render data.  These are built again whenever the hash of their
+    // tiles changes, rather than only when their tiles change.
+    Maybe<ChunkHash> terrainHash;
+    Maybe<ChunkHash> liquidHash;
+  };
+
+  struct BuildingChunk {
+    WorkerPoolPromise<ChunkBuild> build;
+    // Cleared if tiles in the chunk change while it is being built, the
+    // result is then thrown away.
+    bool terrainValid;
+    bool liquidValid;
+  };
+
   // chunkIndex here is the index of the render chunk such that chunkIndex *
   // RenderChunkSize results in the coordinate of the lower left most tile in
   // the render chunk.
 
+  static RectI chunkTileRange(Vec2I chunkIndex);
   static ChunkHash terrainChunkHash(WorldRenderData& renderData, Vec2I chunkIndex);
   static ChunkHash liquidChunkHash(WorldRenderData& renderData, Vec2I chunkIndex);
 
+  // True if every tile that the chunk depends on is in the render data
+  static bool chunkTilesAvailable(WorldRenderData const& renderData, Vec2I chunkIndex);
+  // Copies the tiles that the chunk depends on, so that it can be built while
+  // the render data is filled for the next frame
+  static WorldRenderData chunkRenderData(WorldRenderData const& renderData, Vec2I chunkIndex);
+
+  void invalidateChunks(WorldGeometry const& geometry, List<RectI> const& changedRegions, bool terrain);
+
   void renderTerrainChunks(WorldCamera const& camera, TerrainLayer terrainLayer);
 
-  shared_ptr<TerrainChunk const> getTerrainChunk(WorldRenderData& renderData, Vec2I chunkIndex);
-  shared_ptr<LiquidChunk const> getLiquidChunk(WorldRenderData& renderData, Vec2I chunkIndex);
+  // Starts building the parts of the chunk that are missing on the worker
+  // pool, if all of the tiles it depends on are available
+  void prefetchChunk(WorldRenderData const& renderData, Vec2I chunkIndex);
+  // Moves the chunks that have finished building into the cache
+  void collectBuiltChunks();
+  void finishBuildingChunk(Vec2I chunkIndex);
+  CachedChunk const& getChunk(WorldRenderData& renderData, Vec2I chunkIndex);
+
+  // May be called from any thread
+  ChunkBuild buildChunk(WorldRenderData const& renderData, Vec2I chunkIndex, bool terrain, bool liquid) const;
+  void finishChunk(Vec2I chunkIndex, ChunkBuild build, Maybe<ChunkHash> terrainHash, Maybe<ChunkHash> liquidHash);
+
+  TexturePtr quadTexture(TerrainQuad const& quad);
 
-  bool produceTerrainPrimitives(HashMap<QuadZLevel, List<RenderPrimitive>>& primitives,
-      TerrainLayer terrainLayer, Vec2I const& pos, WorldRenderData const& renderData);
-  void produceLiquidPrimitives(HashMap<LiquidId, List<RenderPrimitive>>& primitives, Vec2I const& pos, WorldRenderData const& renderData);
+  bool produceTerrainQuads(HashMap<QuadZLevel, List<TerrainQuad>>& quads, MaterialDatabaseConstPtr const& materialDatabase,
+      TerrainLayer terrainLayer, Vec2I const& pos, WorldRenderData const& renderData) const;
+  void produceLiquidPrimitives(LiquidChunkPrimitives& primitives, Vec2I const& pos, WorldRenderData const& renderData) const;
 
   float liquidDrawLevel(float liquidLevel) const;
 
@@ -94,8 +156,9 @@ private:
   TextureGroupPtr m_textureGroup;
 
   HashTtlCache<TextureKey, TexturePtr, TextureKeyHash> m_textureCache;
-  HashTtlCache<pair<Vec2I, ChunkHash>, shared_ptr<TerrainChunk const>> m_terrainChunkCache;
-  HashTtlCache<pair<Vec2I, ChunkHash>, shared_ptr<LiquidChunk const>> m_liquidChunkCache;
+  HashTtlCache<Vec2I, CachedChunk> m_chunkCache;
+  HashMap<Vec2I, BuildingChunk> m_buildingChunks;
+  WorkerPool* m_workerPool;
 
   List<shared_ptr<TerrainChunk const>> m_pendingTerrainChunks;
   List<shared_ptr<LiquidChunk const>> m_pendingLiquidChunks;
@@ -310,8 +310,13 @@ void WorldPainter::drawDrawable(Drawable drawable) {
   // pre-load is not done on every tick because it's expensive to look up images with long paths
   if (RectF::withSize(Vec2F(), Vec2F(m_camera.screenSize())).intersects(drawable.boundBox(false)))
     m_drawablePainter->drawDrawable(drawable);
-  else if (drawable.isImage() && Random::randf() < m_preloadTextureChance)
-    m_assets->tryImage(drawable.imagePart().image);
+  else if (drawable.isImage() && Random::randf() < m_preloadTextureChance) {
+    auto const& imagePart = drawable.imagePart();
+    if (imagePart.imageId)
+      m_assets->tryImage(imagePart.imageId);
+    else
+      m_assets->tryImage(imagePart.image);
+  }
 }
 
 void WorldPainter::drawDrawableSet(List<Drawable>& drawables) {
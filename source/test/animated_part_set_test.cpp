@@ -0,0 +1,103 @@
+#include "StarAnimatedPartSet.hpp"
+#include "StarJsonExtra.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+Json animatedPartSetTestConfig() {
+  return Json::parse(R"JSON(
+    {
+      "stateTypes" : {
+        "body" : {
+          "priority" : 1,
+          "default" : "idle",
+          "states" : {
+            "idle" : { "frames" : 1, "cycle" : 1.0 },
+            "walk" : {
+              "frames" : 4,
+              "cycle" : 1.0,
+              "mode" : "loop",
+              "frameProperties" : { "stepSound" : [ "a", "b", "c", "d" ] }
+            }
+          }
+        }
+      },
+      "parts" : {
+        "legs" : {
+          "properties" : { "zLevel" : 1, "image" : "legs.png:<frame>" },
+          "partStates" : {
+            "body" : {
+              "walk" : {
+                "properties" : { "image" : "legs.png:walk.<frame>" },
+                "frameProperties" : { "offset" : [ [0, 0], [0, 1], [0, 2], [0, 3] ] }
+              }
+            }
+          }
+        },
+        "head" : {
+          "properties" : { "zLevel" : 2, "image" : "head.png" }
+        }
+      }
+    }
+  )JSON");
+}
+
+TEST(AnimatedPartSetTest, PartIndices) {
+  AnimatedPartSet parts(animatedPartSetTestConfig(), 0);
+
+  EXPECT_EQ(parts.partNames(), StringList({"head", "legs"}));
+  EXPECT_EQ(parts.partIndex("head"), Maybe<size_t>(0));
+  EXPECT_EQ(parts.partIndex("legs"), Maybe<size_t>(1));
+  EXPECT_FALSE(parts.partIndex("arms"));
+
+  EXPECT_EQ(&parts.activePart(1), &parts.activePart("legs"));
+  EXPECT_EQ(parts.activePart(1).partName, "legs");
+}
+
+TEST(AnimatedPartSetTest, PropertiesOnlyRebuiltOnChange) {
+  AnimatedPartSet parts(animatedPartSetTestConfig(), 0);
+  size_t legs = *parts.partIndex("legs");
+
+  EXPECT_EQ(parts.activePart(legs).properties.get("image"), "legs.png:<frame>");
+  uint64_t propertiesVersion = parts.activePart(legs).propertiesVersion;
+  uint64_t statesVersion = parts.activeStatesVersion();
+
+  // Advancing time without changing the frame leaves the properties alone.
+  parts.update(0.1f);
+  EXPECT_EQ(parts.activePart(legs).propertiesVersion, propertiesVersion);
+  EXPECT_EQ(parts.activeStatesVersion(), statesVersion);
+
+  parts.setActiveState("body", "walk");
+  auto const& walking = parts.activePart(legs);
+  EXPECT_NE(walking.propertiesVersion, propertiesVersion);
+  EXPECT_NE(parts.activeStatesVersion(), statesVersion);
+  EXPECT_EQ(walking.properties.get("image"), "legs.png:walk.<frame>");
+  EXPECT_EQ(jsonToVec2F(walking.properties.get("offset")), Vec2F(0, 0));
+  EXPECT_EQ(walking.activeState->properties.get("stepSound"), "a");
+  EXPECT_EQ(walking.nextProperties.get("offset"), JsonArray({0, 1}));
+
+  propertiesVersion = walking.propertiesVersion;
+  statesVersion = parts.activeStatesVersion();
+  parts.update(0.1f);
+  EXPECT_EQ(parts.activePart(legs).propertiesVersion, propertiesVersion);
+  EXPECT_EQ(parts.activeStatesVersion(), statesVersion);
+
+  parts.update(0.2f);
+  auto const& nextFrame = parts.activePart(legs);
+  EXPECT_NE(nextFrame.propertiesVersion, propertiesVersion);
+  EXPECT_NE(parts.activeStatesVersion(), statesVersion);
+  EXPECT_EQ(jsonToVec2F(nextFrame.properties.get("offset")), Vec2F(0, 1));
+  EXPECT_EQ(nextFrame.activeState->properties.get("stepSound"), "b");
+
+  // Looping back around to the first frame rebuilds the same properties the
+  // first frame had.
+  parts.update(0.8f);
+  EXPECT_EQ(parts.activePart(legs).activeState->frame, 0u);
+  EXPECT_EQ(jsonToVec2F(parts.activePart(legs).properties.get("offset")), Vec2F(0, 0));
+  EXPECT_EQ(parts.activeState("body").properties.get("stepSound"), "a");
+
+  parts.setActiveState("body", "idle");
+  EXPECT_EQ(parts.activePart(legs).properties.get("image"), "legs.png:<frame>");
+  EXPECT_FALSE(parts.activePart(legs).properties.contains("offset"));
+}
@@ -1,4 +1,9 @@
 #include "StarAssets.hpp"
+#include "StarBuffer.hpp"
+#include "StarDataStreamDevices.hpp"
+#include "StarImage.hpp"
+#include "StarImageMetadataIndex.hpp"
+#include "StarMemoryAssetSource.hpp"
 
 #include "gtest/gtest.h"
 
@@ -22,3 +27,73 @@ TEST(AssetsTest, All) {
   EXPECT_EQ(
       AssetPath::relativeTo("/foo/bar/baz:baf?whoa?there", "thing:sub?directive"), "/foo/bar/thing:sub?directive");
 }
+
+TEST(AssetsTest, ImageMetadataIndex) {
+  Image image(5, 4);
+  image.fill(Vec4B(0, 0, 0, 0));
+  image.set(1, 1, Vec4B(255, 0, 0, 255));
+  image.set(3, 2, Vec4B(0, 255, 0, 1));
+
+  auto buffer = make_shared<Buffer>();
+  image.writePng(buffer);
+
+  MemoryAssetSource source("test");
+  source.set("/image.png", buffer->data());
+  source.set("/notanimage.png", ByteArray("garbage", 7));
+  source.set("/other.config", ByteArray("{}", 2));
+
+  auto builtIndex = ImageMetadataIndex::build(source, source.assetPaths());
+  ByteArray serialized = DataStreamBuffer::serialize(builtIndex);
+
+  // Opened in place, the index only reads the occupancy when it is asked for
+  ByteArray prefixed("prefix", 6);
+  prefixed.append(serialized);
+  auto device = make_shared<Buffer>(prefixed);
+  auto openedIndex = ImageMetadataIndex::open(device, 6);
+  EXPECT_EQ(DataStreamBuffer::serialize(openedIndex), serialized);
+
+  for (auto const& index : List<ImageMetadataIndex>{DataStreamBuffer::deserialize<ImageMetadataIndex>(serialized), openedIndex}) {
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_EQ(index.image("/notanimage.png"), nullptr);
+
+    auto metadata = index.image("/image.png");
+    ASSERT_NE(metadata, nullptr);
+    EXPECT_EQ(metadata->size, Vec2U(5, 4));
+    EXPECT_EQ(metadata->nonEmptyRegion, RectU(1, 1, 4, 3));
+
+    auto occupancy = index.occupancy(*metadata);
+    for (unsigned y = 0; y < 4; ++y) {
+      for (unsigned x = 0; x < 5; ++x)
+        EXPECT_EQ(occupancy.occupied(x, y), image.get(x, y)[3] > 0);
+    }
+    EXPECT_EQ(occupancy.nonEmptySubRegion(RectU(2, 0, 5, 4)), RectU(1, 2, 2, 3));
+    EXPECT_TRUE(occupancy.nonEmptySubRegion(RectU(0, 3, 5, 4)).isNull());
+  }
+}
+
+TEST(AssetsTest, AssetPathId) {
+  size_t initialCount = AssetPathId::internedCount();
+
+  AssetPath path("/foo/bar.png:1?hueshift=20");
+  auto id = AssetPathId::intern(path);
+  EXPECT_TRUE((bool)id);
+  EXPECT_NE(id.value(), 0u);
+  EXPECT_EQ(id.path(), path);
+  EXPECT_EQ(AssetPathId::intern(AssetPath("/foo/bar.png:1?hueshift=20")), id);
+
+  auto other = AssetPathId::intern(AssetPath("/foo/bar.png:1"));
+  EXPECT_NE(other, id);
+  EXPECT_NE(other.value(), id.value());
+  EXPECT_EQ(AssetPathId::internedCount(), initialCount + 2);
+
+  // Paths leave the table once no id refers to them, and their numbers are
+  // reused
+  uint32_t otherValue = other.value();
+  other = AssetPathId();
+  EXPECT_EQ(AssetPathId::internedCount(), initialCount + 1);
+  EXPECT_EQ(AssetPathId::intern(AssetPath("/foo/baz.png")).value(), otherValue);
+  EXPECT_EQ(AssetPathId::internedCount(), initialCount + 1);
+
+  EXPECT_FALSE((bool)AssetPathId());
+  EXPECT_EQ(AssetPathId().value(), 0u);
+}
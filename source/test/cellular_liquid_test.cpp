@@ -0,0 +1,162 @@
+#include "StarCellularLiquid.hpp"
+#include "StarWorkerPool.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+namespace {
+  // A closed box that wraps horizontally, by default at a width that does not
+  // line up with the engine's working chunks.
+  class TestLiquidWorld : public CellularLiquidWorld<uint8_t> {
+  public:
+    TestLiquidWorld(int width = 45, int height = 12) : width(width), height(height), levels(width * height, 0.0f) {}
+
+    Vec2I uniqueLocation(Vec2I const& location) const override {
+      return {pmod(location[0], width), location[1]};
+    }
+
+    CellularLiquidCell<uint8_t> cell(Vec2I const& location) const override {
+      if (location[1] <= 0 || location[1] >= height - 1)
+        return CellularLiquidCollisionCell();
+      float level = levels[index(location)];
+      return CellularLiquidFlowCell<uint8_t>{level > 0.0f ? 1 : Maybe<uint8_t>(), level, 0.0f};
+    }
+
+    void setFlow(Vec2I const& location, CellularLiquidFlowCell<uint8_t> const& flow) override {
+      levels[index(location)] = flow.liquid ? flow.level : 0.0f;
+    }
+
+    size_t index(Vec2I const& location) const {
+      return location[1] * width + pmod(location[0], width);
+    }
+
+    float total() const {
+      float total = 0.0f;
+      for (float level : levels)
+        total += level;
+      return total;
+    }
+
+    int width;
+    int height;
+    List<float> levels;
+  };
+
+  LiquidCellEngineParameters testParameters() {
+    LiquidCellEngineParameters parameters;
+    parameters.lateralMoveFactor = 0.5f;
+    parameters.spreadOverfillUpFactor = 0.5f;
+    parameters.spreadOverfillLateralFactor = 0.5f;
+    parameters.spreadOverfillDownFactor = 0.5f;
+    parameters.pressureEqualizeFactor = 0.4f;
+    parameters.pressureMoveFactor = 0.01f;
+    parameters.maximumPressureLevelImbalance = 0.1f;
+    parameters.minimumLivenPressureChange = 0.001f;
+    parameters.minimumLivenLevelChange = 0.001f;
+    parameters.minimumLiquidLevel = 0.001f;
+    parameters.interactTransformationLevel = 0.1f;
+    return parameters;
+  }
+}
+
+TEST(CellularLiquidTest, FlowAcrossWrap) {
+  auto simulate = [](uint64_t seed) {
+    auto world = make_shared<TestLiquidWorld>();
+    for (int y = 1; y < world->height - 1; ++y)
+      world->levels[world->index({world->width - 1, y})] = 1.0f;
+
+    LiquidCellEngine<uint8_t> engine(testParameters(), world);
+    engine.setRandomSeed(seed);
+    engine.visitRegion(RectI(0, 0, world->width, world->height));
+    for (int i = 0; i < 200; ++i)
+      engine.update();
+    return world;
+  };
+
+  auto world = simulate(1);
+  // The column collapses, spreading across the wrap boundary, and liquid is
+  // only lost to trimming of very low levels.
+  EXPECT_GT(world->levels[world->index({0, 1})], 0.0f);
+  EXPECT_GT(world->levels[world->index({world->width - 2, 1})], 0.0f);
+  EXPECT_EQ(world->levels[world->index({world->width - 1, world->height - 2})], 0.0f);
+  EXPECT_NEAR(world->total(), world->height - 2, 0.5f);
+
+  EXPECT_EQ(simulate(1)->levels, world->levels);
+}
+
+TEST(CellularLiquidTest, ParallelRegions) {
+  // Blocks of liquid spaced far enough apart to start out as separate regions,
+  // with enough cells between them for the update to need several batches.
+  size_t const Blocks = 16;
+  int const BlockWidth = 8;
+  auto simulate = [&](WorkerPool* workerPool, size_t* maxBatches = nullptr) {
+    auto world = make_shared<TestLiquidWorld>(Blocks * BlockWidth * 2, 24);
+    for (int x = 0; x < world->width; x += BlockWidth * 2) {
+      for (int y = 1; y < world->height - 1; ++y) {
+        for (int i = 0; i < BlockWidth; ++i)
+          world->levels[world->index({x + i, y})] = 1.0f;
+      }
+    }
+
+    LiquidCellEngine<uint8_t> engine(testParameters(), world);
+    engine.setRandomSeed(1);
+    engine.setWorkerPool(workerPool);
+    engine.visitRegion(RectI(0, 0, world->width, world->height));
+    for (int i = 0; i < 100; ++i) {
+      engine.update();
+      if (maxBatches)
+        *maxBatches = max(*maxBatches, engine.parallelBatches());
+    }
+    return world;
+  };
+
+  WorkerPool singlePool("CellularLiquidTest", 1);
+  WorkerPool multiPool("CellularLiquidTest", 4);
+  size_t maxBatches = 0;
+  auto world = simulate(&multiPool, &maxBatches);
+  EXPECT_GT(maxBatches, 1u);
+
+  // The blocks merge once they spread towards each other.
+  for (int x = 0; x < world->width; ++x)
+    EXPECT_GT(world->levels[world->index({x, 1})], 0.0f);
+
+  // The result only depends on the seed, not on the number of threads.
+  EXPECT_EQ(simulate(&singlePool)->levels, world->levels);
+  EXPECT_EQ(simulate(&multiPool)->levels, world->levels);
+
+  // Parallel updates pick spread directions from different random streams, so
+  // they only match a serial update up to that noise.
+  auto serialWorld = simulate(nullptr);
+  EXPECT_NEAR(world->total(), serialWorld->total(), 0.5f);
+  for (size_t i = 0; i < world->levels.size(); ++i)
+    EXPECT_NEAR(world->levels[i], serialWorld->levels[i], 0.1f);
+}
+
+TEST(CellularLiquidTest, DrainedFloodFreesChunks) {
+  auto world = make_shared<TestLiquidWorld>(512, 128);
+  for (int x = 0; x < world->width; ++x) {
+    for (int y = 1; y < world->height - 1; ++y)
+      world->levels[world->index({x, y})] = 0.5f;
+  }
+
+  WorkerPool workerPool("CellularLiquidTest", 2);
+  for (WorkerPool* pool : {(WorkerPool*)nullptr, &workerPool}) {
+    LiquidCellEngine<uint8_t> engine(testParameters(), world);
+    engine.setWorkerPool(pool);
+    engine.visitRegion(RectI(0, 0, world->width, world->height));
+    engine.update();
+    size_t floodChunks = engine.pooledChunks();
+    EXPECT_GT(floodChunks, 64u);
+
+    // Take the liquid away, the engine finds every cell empty and goes idle.
+    auto levels = world->levels;
+    world->levels = List<float>(world->levels.size(), 0.0f);
+    for (int i = 0; i < 5; ++i)
+      engine.update();
+    EXPECT_EQ(engine.activeCells(), 0u);
+    EXPECT_LT(engine.pooledChunks(), floodChunks);
+    EXPECT_LE(engine.pooledChunks(), 32u);
+    world->levels = levels;
+  }
+}
@@ -0,0 +1,53 @@
+#include "StarRoot.hpp"
+#include "StarEntityFactory.hpp"
+#include "StarItemDrop.hpp"
+#include "StarItem.hpp"
+#include "StarWorkerPool.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+TEST(EntityFactoryTest, ParallelVersionedEntityLoad) {
+  auto entityFactory = Root::singleton().entityFactory();
+
+  // Enough stores for several load batches, with a few that cannot be loaded
+  // spread among them.
+  List<VersionedJson> stores;
+  List<int> expectedIndexes;
+  List<int> expectedFailures;
+  for (int i = 0; i < 100; ++i) {
+    if (i % 7 == 3) {
+      stores.append(VersionedJson{"NotAnEntity", 1, JsonObject{{"testIndex", i}}, {}});
+      expectedFailures.append(i);
+    } else {
+      auto itemDrop = ItemDrop::createRandomizedDrop(ItemDescriptor("perfectlygenericitem", 1, JsonObject{{"testIndex", i}}), Vec2F());
+      stores.append(entityFactory->storeVersionedEntity(itemDrop));
+      expectedIndexes.append(i);
+    }
+  }
+
+  auto load = [&](WorkerPool* workerPool) {
+    // The error handler is called from the pool's threads
+    Mutex failuresMutex;
+    List<int> failures;
+    auto entities = entityFactory->loadVersionedEntities(stores, [&](VersionedJson const& store, std::exception const&) {
+        MutexLocker locker(failuresMutex);
+        failures.append(store.content.getInt("testIndex"));
+      }, workerPool);
+
+    List<int> indexes;
+    for (auto const& entity : entities)
+      indexes.append(as<ItemDrop>(entity)->item()->parameters().getInt("testIndex"));
+    return make_pair(indexes, failures.sorted());
+  };
+
+  auto serial = load(nullptr);
+  EXPECT_EQ(serial.first, expectedIndexes);
+  EXPECT_EQ(serial.second, expectedFailures);
+
+  WorkerPool workerPool("EntityFactoryTest", 4);
+  auto parallel = load(&workerPool);
+  EXPECT_EQ(parallel.first, expectedIndexes);
+  EXPECT_EQ(parallel.second, expectedFailures);
+}
@@ -117,3 +117,39 @@ TEST(ItemTest, ConstructItems) {
   for (auto itemName : itemDatabase->allItems())
     ItemPtr item = itemDatabase->item(ItemDescriptor(itemName, 1));
 }
+
+TEST(ItemTest, ItemParametersOverlayConfig) {
+  auto itemDatabase = Root::singleton().itemDatabase();
+  ItemPtr plainItem = itemDatabase->item(ItemDescriptor("perfectlygenericitem", 1));
+  ItemPtr renamedItem = itemDatabase->item(ItemDescriptor("perfectlygenericitem", 1, JsonObject{{"shortdescription", "Renamed Item"}}));
+
+  EXPECT_EQ(renamedItem->friendlyName(), "Renamed Item");
+  EXPECT_NE(plainItem->friendlyName(), "Renamed Item");
+  EXPECT_EQ(renamedItem->config(), plainItem->config());
+  EXPECT_EQ(renamedItem->config().getString("shortdescription"), plainItem->friendlyName());
+}
+
+TEST(ItemTest, PrototypeReleasedWhenUnused) {
+  // A database of our own, so that nothing else holds its items
+  auto itemDatabase = make_shared<ItemDatabase>();
+  ItemPtr plainItem = itemDatabase->item(ItemDescriptor("perfectlygenericitem", 1));
+  ItemPtr renamedItem = itemDatabase->item(ItemDescriptor("perfectlygenericitem", 1, JsonObject{{"shortdescription", "Renamed Item"}}));
+
+  // Both items share the prototype held by the database
+  EXPECT_TRUE(itemDatabase->hasCachedPrototype("perfectlygenericitem"));
+  EXPECT_FALSE(plainItem->config().unique());
+  itemDatabase->cleanup();
+  itemDatabase->cleanup();
+  EXPECT_TRUE(itemDatabase->hasCachedPrototype("perfectlygenericitem"));
+
+  // Once only the database holds it, it is dropped by the cleanup after next
+  plainItem.reset();
+  renamedItem.reset();
+  itemDatabase->cleanup();
+  itemDatabase->cleanup();
+  EXPECT_FALSE(itemDatabase->hasCachedPrototype("perfectlygenericitem"));
+
+  ItemPtr reloadedItem = itemDatabase->item(ItemDescriptor("perfectlygenericitem", 1));
+  EXPECT_TRUE(itemDatabase->hasCachedPrototype("perfectlygenericitem"));
+  EXPECT_FALSE(reloadedItem->config().unique());
+}
@@ -2,6 +2,7 @@
 #include "StarFile.hpp"
 #include "StarJsonPatch.hpp"
 #include "StarJsonPath.hpp"
+#include "StarJsonBuilder.hpp"
 
 #include "gtest/gtest.h"
 
@@ -701,3 +702,28 @@ TEST(JsonTest, MergeQuery) {
   testIdentical("fiz");
   testIdentical("nothing");
 }
+
+TEST(JsonTest, StringPool) {
+  String document = "{\"a\" : \"shared\", \"b\" : [\"shared\", \"other\"], \"c\" : {\"shared\" : \"shared\"}}";
+
+  JsonStringPool pool;
+  Json json1 = inputUtf32Json<String::const_iterator>(document.begin(), document.end(), JsonParseType::Top);
+  Json json2 = inputUtf8Json(document.utf8().begin(), document.utf8().end(), JsonParseType::Top, &pool);
+  Json json3 = inputUtf8Json(document.utf8().begin(), document.utf8().end(), JsonParseType::Top, &pool);
+  EXPECT_EQ(json1, json2);
+  EXPECT_EQ(json2, json3);
+  EXPECT_EQ(pool.size(), 2u);
+
+  EXPECT_EQ(json2.get("a").stringPtr(), json2.get("b").get(0).stringPtr());
+  EXPECT_EQ(json2.get("a").stringPtr(), json3.query("c.shared").stringPtr());
+  EXPECT_NE(json1.get("a").stringPtr(), json2.get("a").stringPtr());
+
+  json2 = {};
+  pool.cleanup();
+  EXPECT_EQ(pool.size(), 2u);
+  json3 = {};
+  pool.cleanup();
+  EXPECT_EQ(pool.size(), 0u);
+
+  EXPECT_THROW(Json::parseJson("{\"a\" : 1, \"a\" : 2}"), JsonParsingException);
+}
@@ -0,0 +1,60 @@
+#include "StarLightLevelCache.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+TEST(LightLevelCacheTest, LightSourceChanges) {
+  Json lightingConfig = JsonObject{
+      {"spreadPasses", 3},
+      {"spreadMaxAir", 15},
+      {"spreadMaxObstacle", 4},
+      {"pointMaxAir", 30},
+      {"pointMaxObstacle", 8},
+      {"pointObstacleBoost", 0.5}
+    };
+
+  Vec2F lightPosition(40, 40);
+  float lightIntensity = 1.0f;
+
+  auto cellSetter = [&](CellularLightIntensityCalculator& calculator) {
+    RectI region = calculator.calculationRegion();
+    for (int x = region.xMin(); x < region.xMax(); ++x) {
+      for (int y = region.yMin(); y < region.yMax(); ++y)
+        calculator.setCell({x, y}, {0.0f, false});
+    }
+    if (region.contains(Vec2I::floor(lightPosition)))
+      calculator.addSpreadLight(lightPosition, lightIntensity);
+  };
+  auto lightHasher = [&](RectI const& region) -> size_t {
+    if (!region.contains(Vec2I::floor(lightPosition)))
+      return 0;
+    return hashOf(lightPosition, lightIntensity);
+  };
+
+  LightLevelCache cache(WorldGeometry(256, 256), lightingConfig, cellSetter, lightHasher);
+  cache.setStalenessBudget(1000.0);
+  cache.update(0.0);
+
+  float initialLevel = cache.lightLevel({40, 40});
+  EXPECT_GT(initialLevel, 0.5f);
+  float farLevel = cache.lightLevel({200, 200});
+  EXPECT_EQ(cache.cachedSectorCount(), 2u);
+
+  // Nothing changed, so both sectors are kept
+  cache.update(1.0);
+  EXPECT_EQ(cache.cachedSectorCount(), 2u);
+
+  // Changing the light only drops the sector around it
+  lightIntensity = 0.25f;
+  cache.update(2.0);
+  EXPECT_EQ(cache.cachedSectorCount(), 1u);
+  EXPECT_LT(cache.lightLevel({40, 40}), initialLevel);
+  EXPECT_EQ(cache.lightLevel({200, 200}), farLevel);
+
+  // Moving the light away darkens where it was
+  lightPosition = Vec2F(120, 120);
+  cache.update(3.0);
+  EXPECT_LT(cache.lightLevel({40, 40}), 0.01f);
+  EXPECT_GT(cache.lightLevel({120, 120}), 0.1f);
+}
@@ -412,3 +412,86 @@ TEST(LuaJsonTest, IntFloat) {
   EXPECT_EQ(context.invokePath<String>("printNumber", 1.0), "1.0");
   EXPECT_EQ(context.invokePath<String>("printNumber", 1), "1");
 }
+
+TEST(LuaJsonTest, Proxy) {
+  auto engine = LuaEngine::create();
+  auto context = engine->createContext();
+
+  Json config = Json::parse(R"JSON({"a" : {"b" : [1, 2, null, 4]}, "c" : "str", "d" : null})JSON");
+  context.setPath("config", LuaJsonProxy(config));
+
+  context.load(R"SCRIPT(
+      function read()
+        local b = config.a.b
+        local sum = 0
+        for i, v in ipairs(b) do
+          sum = sum + v
+        end
+        return {config.c, config.d == nil, #b, sum, b[4]}
+      end
+
+      function keys()
+        local count = 0
+        for k, v in pairs(config) do
+          count = count + 1
+        end
+        local indexes = 0
+        for k, v in pairs(config.a.b) do
+          indexes = indexes + k
+        end
+        return {count, indexes}
+      end
+
+      function write()
+        local b = config.a.b
+        b[3] = 3
+        b[6] = 6
+        config.c = "changed"
+        return config
+      end
+
+      function grow()
+        config.a.b[1000000000] = 1
+      end
+
+      function detach()
+        local b = config.a.b
+        config.a = {b = "replaced"}
+        b[1] = 100
+        return config
+      end
+
+      function fill(n)
+        config.list = {0}
+        config.named = {}
+        for i = 1, n do
+          config.list[i] = i
+          config.named["k" .. i] = i
+        end
+      end
+    )SCRIPT");
+
+  EXPECT_EQ(context.invokePath<Json>("read"), Json::parse(R"JSON(["str", true, 4, 3, 4])JSON"));
+  EXPECT_EQ(context.invokePath<Json>("keys"), Json::parse("[2, 7]"));
+
+  EXPECT_EQ(context.invokePath<Json>("write"), Json::parse(R"JSON({"a" : {"b" : [1, 2, 3, 4, null, 6]}, "c" : "changed", "d" : null})JSON"));
+  // Writes only affect the proxy, never the Json it was created from.
+  EXPECT_EQ(config.query("a.b[2]"), Json());
+
+  EXPECT_THROW(context.invokePath("grow"), LuaException);
+  EXPECT_EQ(context.getPath<Json>("config").query("a.b").size(), 6u);
+
+  EXPECT_EQ(context.invokePath<Json>("detach"), Json::parse(R"JSON({"a" : {"b" : "replaced"}, "c" : "changed", "d" : null})JSON"));
+
+  // Writes after the proxy was converted back leave the converted Json alone
+  context.invokePath("fill", 1000);
+  Json filled = context.getPath<Json>("config");
+  context.invokePath("fill", 2000);
+  Json refilled = context.getPath<Json>("config");
+  EXPECT_EQ(filled.get("list").size(), 1000u);
+  EXPECT_EQ(filled.get("named").size(), 1000u);
+  EXPECT_EQ(refilled.get("list").size(), 2000u);
+  EXPECT_EQ(refilled.get("list").getInt(1999), 2000);
+  EXPECT_EQ(refilled.get("named").getInt("k2000"), 2000);
+  EXPECT_EQ(refilled.get("c"), "changed");
+}
@@ -355,6 +355,15 @@ TEST(LuaTest, PathTest) {
 
   luaContext.setPath("new.table.value", LuaInt(5));
   EXPECT_EQ(luaContext.getPath("new.table.value"), LuaInt(5));
+
+  LuaValue test = luaContext.getPath("test");
+  EXPECT_TRUE(luaContext.pathIs("test", test));
+  EXPECT_TRUE(luaContext.pathIs("foo.bar.baz", LuaInt(1)));
+  EXPECT_TRUE(luaContext.pathIs("foo.nothing.at.all", LuaNil));
+  EXPECT_FALSE(luaContext.pathIs("foo.bar", LuaNil));
+
+  luaContext.eval("test = function() return 0 end");
+  EXPECT_FALSE(luaContext.pathIs("test", test));
 }
 
 TEST(LuaTest, CallbackTest) {
@@ -836,3 +845,71 @@ TEST(LuaTest, ProfilingTest) {
   EXPECT_TRUE(names.contains("function2"));
   EXPECT_TRUE(names.contains("function3"));
 }
+
+TEST(LuaTest, AccountingTest) {
+  auto luaEngine = LuaEngine::create();
+  luaEngine->setAccountingEnabled(true, 1);
+  luaEngine->setInstructionMeasureInterval(1000);
+
+  auto context = luaEngine->createContext();
+  context.eval(R"SCRIPT(
+      function spin()
+        local t = {}
+        for i = 1, 10000 do
+          t[i] = tostring(i)
+        end
+      end
+    )SCRIPT");
+
+  {
+    auto outer = luaEngine->accountingScope("monster:#1");
+    context.invokePath("spin");
+    auto inner = luaEngine->accountingScope("world:test");
+    context.invokePath("spin");
+  }
+  context.invokePath("spin");
+
+  auto accounting = luaEngine->accounting();
+  EXPECT_EQ(accounting.keys().sorted(), StringList({"monster:#1", "world:test"}));
+
+  auto const& entry = accounting.get("monster:#1");
+  EXPECT_EQ(entry.calls, 1u);
+  EXPECT_GT(entry.instructions, 0u);
+  EXPECT_GT(entry.allocatedBytes, 0u);
+  EXPECT_GT(entry.time, 0.0);
+  EXPECT_FALSE(entry.stackSamples.empty());
+  for (auto const& p : entry.stackSamples)
+    EXPECT_TRUE(p.first.beginsWith("?@[string \"...\"]:2"));
+
+  luaEngine->resetAccounting();
+  EXPECT_TRUE(luaEngine->accounting().empty());
+
+  {
+    LuaAccountingScope unattributed(*luaEngine);
+    context.invokePath("spin");
+  }
+  EXPECT_TRUE(luaEngine->accounting().empty());
+
+  {
+    auto attribution = luaEngine->accountingAttribution(make_shared<String const>("npc:villager"));
+    for (int i = 0; i < 2; ++i) {
+      LuaAccountingScope scope(*luaEngine);
+      context.invokePath("spin");
+    }
+  }
+  {
+    LuaAccountingScope unattributed(*luaEngine);
+    context.invokePath("spin");
+  }
+  accounting = luaEngine->accounting();
+  EXPECT_EQ(accounting.keys(), StringList({"npc:villager"}));
+  EXPECT_EQ(accounting.get("npc:villager").calls, 2u);
+
+  luaEngine->resetAccounting();
+  luaEngine->setAccountingEnabled(false);
+  {
+    auto scope = luaEngine->accountingScope("monster:#1");
+    context.invokePath("spin");
+  }
+  EXPECT_TRUE(luaEngine->accounting().empty());
+}
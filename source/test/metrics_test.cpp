@@ -0,0 +1,58 @@
+#include "StarMetrics.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+TEST(MetricsTest, Registry) {
+  auto counter = Metrics::counter("test_requests_total", "Requests handled", {{"world", "a"}});
+  counter.increment();
+  counter.increment(2);
+  EXPECT_EQ(counter.value(), 3u);
+
+  // Registering again shares the same metric
+  auto sameCounter = Metrics::counter("test_requests_total", "Requests handled", {{"world", "a"}});
+  sameCounter.increment();
+  EXPECT_EQ(counter.value(), 4u);
+
+  EXPECT_THROW(Metrics::gauge("test_requests_total", "", {{"world", "b"}}), MetricsException);
+
+  auto gauge = Metrics::gauge("test_entities", "Loaded entities");
+  gauge.set(10);
+  gauge.add(-2.5);
+  EXPECT_EQ(gauge.value(), 7.5);
+
+  MetricGauge unregistered;
+  unregistered.set(5);
+  EXPECT_EQ(unregistered.value(), 0.0);
+
+  auto histogram = Metrics::histogram("test_tick_seconds", "Tick time", {0.01, 0.02, 0.04});
+  for (int i = 0; i < 10; ++i)
+    histogram.observe(0.015);
+  histogram.observe(0.005);
+  histogram.observe(1.0);
+
+  String text = Metrics::prometheusText();
+  EXPECT_TRUE(text.contains("# TYPE test_requests_total counter\ntest_requests_total{world=\"a\"} 4\n"));
+  EXPECT_TRUE(text.contains("# HELP test_entities Loaded entities\n# TYPE test_entities gauge\ntest_entities 7.5\n"));
+  EXPECT_TRUE(text.contains("test_tick_seconds_bucket{le=\"0.01\"} 1\n"));
+  EXPECT_TRUE(text.contains("test_tick_seconds_bucket{le=\"0.02\"} 11\n"));
+  EXPECT_TRUE(text.contains("test_tick_seconds_bucket{le=\"+Inf\"} 12\n"));
+  EXPECT_TRUE(text.contains("test_tick_seconds_count 12\n"));
+
+  for (auto const& metric : Metrics::snapshot()) {
+    if (metric.name == "test_tick_seconds") {
+      EXPECT_EQ(metric.count, 12u);
+      EXPECT_NEAR(metric.value, 1.155, 0.0001);
+      double median = metric.quantile(0.5);
+      EXPECT_GT(median, 0.01);
+      EXPECT_LT(median, 0.02);
+      EXPECT_EQ(metric.quantile(1.0), 0.04);
+    }
+  }
+
+  // Metrics are dropped once every handle is gone
+  counter = {};
+  sameCounter = {};
+  EXPECT_FALSE(Metrics::prometheusText().contains("test_requests_total"));
+}
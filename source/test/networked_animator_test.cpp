@@ -0,0 +1,48 @@
+#include "StarNetworkedAnimator.hpp"
+#include "StarJson.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+Json networkedAnimatorTestConfig() {
+  return Json::parse(R"JSON(
+    {
+      "globalTagDefaults" : { "color" : "default" },
+      "animatedParts" : {
+        "stateTypes" : {},
+        "parts" : {
+          "body" : {
+            "properties" : { "centered" : false, "image" : "/test/body.png:<color>" }
+          }
+        }
+      }
+    }
+  )JSON");
+}
+
+TEST(NetworkedAnimatorTest, SameGlobalTagKeepsDrawablesCached) {
+  NetworkedAnimator animator(networkedAnimatorTestConfig());
+  animator.setGlobalTag("color", String("red"));
+
+  auto drawables = animator.drawables();
+  ASSERT_EQ(drawables.size(), 1u);
+  EXPECT_EQ(AssetPath::join(drawables[0].imagePart().image), "/test/body.png:red");
+
+  uint64_t tagsVersion = animator.tagsVersion();
+  for (int i = 0; i < 3; ++i) {
+    animator.setGlobalTag("color", String("red"));
+    animator.setPartTag("body", "unused", {});
+    animator.removeGlobalTag("missing");
+    EXPECT_EQ(animator.tagsVersion(), tagsVersion);
+    auto cached = animator.drawables();
+    ASSERT_EQ(cached.size(), 1u);
+    EXPECT_EQ(cached[0].imagePart().image, drawables[0].imagePart().image);
+  }
+
+  animator.setGlobalTag("color", String("blue"));
+  EXPECT_NE(animator.tagsVersion(), tagsVersion);
+  drawables = animator.drawables();
+  ASSERT_EQ(drawables.size(), 1u);
+  EXPECT_EQ(AssetPath::join(drawables[0].imagePart().image), "/test/body.png:blue");
+}
@@ -0,0 +1,39 @@
+#include "StarEntityRenderingTypes.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+static Set<Vec2I> regionPositions(List<RectI> const& regions) {
+  Set<Vec2I> positions;
+  for (auto const& region : regions) {
+    EXPECT_EQ(region.size(), Vec2I(1, 1));
+    positions.add(region.min());
+  }
+  return positions;
+}
+
+TEST(PreviewTileTest, ChangedRegions) {
+  List<PreviewTile> none;
+  List<PreviewTile> first = {PreviewTile({1, 2}, true, 5, 0, true), PreviewTile({3, 4}, 7)};
+  List<PreviewTile> moved = {PreviewTile({1, 3}, true, 5, 0, true), PreviewTile({3, 4}, 7)};
+  List<PreviewTile> recolored = {PreviewTile({1, 2}, true, 6, 0, true), PreviewTile({3, 4}, 7)};
+
+  // Unchanged previews leave the render chunks alone
+  EXPECT_TRUE(previewTileChangedRegions(none, none).empty());
+  EXPECT_TRUE(previewTileChangedRegions(first, first).empty());
+
+  // Appearing and disappearing previews dirty every tile they cover
+  EXPECT_EQ(regionPositions(previewTileChangedRegions(none, first)), Set<Vec2I>({{1, 2}, {3, 4}}));
+  EXPECT_EQ(regionPositions(previewTileChangedRegions(first, none)), Set<Vec2I>({{1, 2}, {3, 4}}));
+
+  // Moving previews dirty both the old and the new tiles
+  EXPECT_EQ(regionPositions(previewTileChangedRegions(first, moved)), Set<Vec2I>({{1, 2}, {1, 3}, {3, 4}}));
+
+  // As do previews that change material in place
+  EXPECT_EQ(regionPositions(previewTileChangedRegions(first, recolored)), Set<Vec2I>({{1, 2}, {3, 4}}));
+
+  // Light only previews are never drawn into the render tiles
+  List<PreviewTile> light = {PreviewTile({8, 8}, true, Vec3B(255, 0, 0), true)};
+  EXPECT_TRUE(regionPositions(previewTileChangedRegions(none, light)).empty());
+}
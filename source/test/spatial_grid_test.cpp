@@ -0,0 +1,88 @@
+#include "StarSpatialGrid2D.hpp"
+#include "StarSpatialHash2D.hpp"
+#include "StarRandom.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+namespace {
+  typedef SpatialHash2D<int, float, int> TestSpatialHash;
+  typedef SpatialGrid2D<int, float, int> TestSpatialGrid;
+
+  Vec2F const TestWorldSize = {2048.0f, 1024.0f};
+
+  // Entity-like bound boxes, some of them split across the horizontal wrap
+  // like WorldGeometry::splitRect does, and some sticking out of the top and
+  // bottom of the world.
+  List<RectF> randomRects(RandomSource& random) {
+    Vec2F position(random.randf() * TestWorldSize[0], random.randf() * (TestWorldSize[1] + 64.0f) - 32.0f);
+    Vec2F size(random.randf() * 40.0f, random.randf() * 40.0f);
+    RectF rect = RectF::withSize(position, size);
+    if (rect.xMax() > TestWorldSize[0])
+      return {RectF(rect.xMin(), rect.yMin(), TestWorldSize[0], rect.yMax()), RectF(0, rect.yMin(), rect.xMax() - TestWorldSize[0], rect.yMax())};
+    return {rect};
+  }
+
+  template <typename SpatialMap>
+  List<int> sortedQuery(SpatialMap const& map, List<RectF> const& rects) {
+    List<int> values;
+    map.forEach(rects, [&values](int value) {
+        values.append(value);
+      });
+    return values.sorted();
+  }
+}
+
+TEST(SpatialGridTest, MatchesSpatialHash) {
+  RandomSource random(4321);
+
+  TestSpatialHash hash(16.0f);
+  TestSpatialGrid grid(16.0f, TestWorldSize);
+
+  for (int i = 0; i < 10000; ++i) {
+    auto rects = randomRects(random);
+    hash.set(i, rects, i);
+    grid.set(i, rects, i);
+  }
+  EXPECT_EQ(grid.size(), 10000u);
+
+  auto checkQueries = [&]() {
+    for (int i = 0; i < 500; ++i) {
+      auto rects = randomRects(random);
+      auto hashResult = sortedQuery(hash, rects);
+      auto gridResult = sortedQuery(grid, rects);
+      EXPECT_EQ(hashResult, gridResult);
+      // No duplicates
+      EXPECT_EQ(gridResult.size(), HashSet<int>::from(gridResult).size());
+    }
+
+    // A query covering the whole world finds everything exactly once
+    List<RectF> everything = {RectF(-100.0f, -100.0f, TestWorldSize[0] + 100.0f, TestWorldSize[1] + 100.0f)};
+    EXPECT_EQ(sortedQuery(grid, everything), sortedQuery(hash, everything));
+    EXPECT_EQ(sortedQuery(grid, everything).size(), grid.size());
+  };
+
+  checkQueries();
+
+  // Move entries both a little, staying in their cells, and a lot
+  for (int i = 0; i < 10000; i += 2) {
+    auto rects = i % 4 == 0 ? randomRects(random) : List<RectF>{grid.entries().get(i).rects.first().translated(Vec2F(0.01f, 0.0f))};
+    hash.set(i, rects);
+    grid.set(i, rects);
+  }
+
+  checkQueries();
+
+  for (int i = 0; i < 10000; i += 3) {
+    EXPECT_EQ(hash.remove(i), grid.remove(i));
+  }
+  EXPECT_EQ(hash.size(), grid.size());
+  EXPECT_FALSE(grid.contains(0));
+  EXPECT_EQ(grid.remove(0), Maybe<int>());
+
+  checkQueries();
+
+  grid.setSectorSize(32.0f);
+  checkQueries();
+}
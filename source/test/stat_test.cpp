@@ -1,9 +1,13 @@
 #include "StarStatCollection.hpp"
+#include "StarRandom.hpp"
 
 #include "gtest/gtest.h"
 
 using namespace Star;
 
+// Interned before any test can fill the name table
+static StatId const PowerMultiplierStat = *internStatName("powerMultiplier");
+
 bool withinAmount(float value, float target, float amount) {
   return fabs(value - target) <= amount;
 }
@@ -81,3 +85,83 @@ TEST(StatTest, Set) {
   EXPECT_TRUE(withinAmount(stats.statEffectiveValue("TempStat"), 0.0f, 0.0001f));
   EXPECT_FALSE(stats.isEffectiveStat("TempStat"));
 }
+
+TEST(StatTest, IncrementalModifiers) {
+  StatSet stats;
+  stats.addStat("maxHealth", 100.0f);
+  stats.addStat("powerMultiplier", 1.0f);
+  stats.addStat("protection", 0.0f);
+  stats.addResource("health", String("maxHealth"));
+
+  EXPECT_EQ(findStatName("powerMultiplier"), PowerMultiplierStat);
+  EXPECT_EQ(internedStatName(PowerMultiplierStat), "powerMultiplier");
+  EXPECT_EQ(findStatName("neverInternedStatName"), Maybe<StatId>());
+
+  // Churn modifier groups, and check that every stat always matches a set
+  // built from scratch with the same groups.
+  StringList statNames = {"maxHealth", "powerMultiplier", "protection", "modifierOnly"};
+  RandomSource random(1234);
+  List<StatModifierGroupId> groupIds;
+  for (int i = 0; i < 500; ++i) {
+    List<StatModifier> modifiers;
+    for (int j = random.randInt(0, 3); j > 0; --j) {
+      String const& statName = random.randFrom(statNames);
+      float value = random.randf(0.0f, 2.0f);
+      int type = random.randInt(0, 2);
+      if (type == 0)
+        modifiers.append(StatValueModifier{statName, value});
+      else if (type == 1)
+        modifiers.append(StatBaseMultiplier{statName, value});
+      else
+        modifiers.append(StatEffectiveMultiplier{statName, value});
+    }
+
+    int action = random.randInt(0, 2);
+    if (action == 0 || groupIds.empty())
+      groupIds.append(stats.addStatModifierGroup(modifiers));
+    else if (action == 1)
+      stats.setStatModifierGroup(random.randFrom(groupIds), modifiers);
+    else
+      stats.removeStatModifierGroup(groupIds.takeAt(random.randUInt(groupIds.size() - 1)));
+
+    StatSet fresh;
+    fresh.addStat("maxHealth", 100.0f);
+    fresh.addStat("powerMultiplier", 1.0f);
+    fresh.addStat("protection", 0.0f);
+    fresh.setAllStatModifierGroups(stats.allStatModifierGroups());
+
+    for (auto const& statName : statNames) {
+      EXPECT_EQ(stats.statEffectiveValue(statName), fresh.statEffectiveValue(statName));
+      EXPECT_EQ(stats.isEffectiveStat(statName), fresh.isEffectiveStat(statName));
+    }
+    EXPECT_EQ(stats.statEffectiveValue(PowerMultiplierStat), stats.statEffectiveValue("powerMultiplier"));
+    EXPECT_EQ(stats.resourceMaxValue("health"), Maybe<float>(stats.statEffectiveValue("maxHealth")));
+  }
+
+  stats.clearStatModifiers();
+  EXPECT_FALSE(stats.isEffectiveStat("modifierOnly"));
+  EXPECT_EQ(stats.statEffectiveValue("maxHealth"), 100.0f);
+  EXPECT_EQ(stats.effectiveStatNames().sorted(), StringList({"maxHealth", "powerMultiplier", "protection"}));
+}
+
+TEST(StatTest, FullNameTable) {
+  // Once the name table is full, sets keep the names they see on their own.
+  for (int i = 0; internStatName(strf("fullNameTableFiller{}", i)); ++i) {}
+  EXPECT_EQ(internStatName("uninternedStat"), Maybe<StatId>());
+
+  StatSet stats;
+  stats.addStat("uninternedStat", 10.0f);
+  stats.addResource("uninternedResource", String("uninternedStat"));
+  auto groupId = stats.addStatModifierGroup({StatValueModifier{"uninternedModifier", 2.0f}, StatBaseMultiplier{"uninternedStat", 1.5f}});
+  EXPECT_EQ(stats.statEffectiveValue("uninternedStat"), 15.0f);
+  EXPECT_EQ(stats.statEffectiveValue("uninternedModifier"), 2.0f);
+  EXPECT_EQ(stats.resourceMaxValue("uninternedResource"), Maybe<float>(15.0f));
+  EXPECT_EQ(stats.effectiveStatNames().sorted(), StringList({"uninternedModifier", "uninternedStat"}));
+  EXPECT_EQ(stats.resourceNames(), StringList({"uninternedResource"}));
+  EXPECT_EQ(findStatName("uninternedStat"), Maybe<StatId>());
+
+  stats.removeStatModifierGroup(groupId);
+  EXPECT_EQ(stats.statEffectiveValue("uninternedStat"), 10.0f);
+  EXPECT_FALSE(stats.isEffectiveStat("uninternedModifier"));
+  EXPECT_EQ(stats.effectiveStatNames(), StringList({"uninternedStat"}));
+}
@@ -0,0 +1,309 @@
+#include "StarWireProcessor.hpp"
+#include "StarWireEntity.hpp"
+#include "StarWorldServer.hpp"
+#include "StarEntityMap.hpp"
+#include "StarFile.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+namespace {
+  // A wire entity with one input and one output.  Sources ignore their input
+  // and output whatever they are set to, gates output whether any of their
+  // input connections is on.
+  class TestWireEntity : public WireEntity {
+  public:
+    TestWireEntity(Vec2I tilePosition, Maybe<bool> sourceState)
+      : m_tilePosition(tilePosition), m_sourceState(sourceState), m_output(sourceState.value(false)), m_evaluations(0) {}
+
+    EntityType entityType() const override {
+      return EntityType::Object;
+    }
+
+    RectF metaBoundBox() const override {
+      return RectF(0, 0, 1, 1);
+    }
+
+    Vec2I tilePosition() const override {
+      return m_tilePosition;
+    }
+
+    void setTilePosition(Vec2I const& pos) override {
+      m_tilePosition = pos;
+    }
+
+    bool checkBroken() override {
+      return false;
+    }
+
+    size_t nodeCount(WireDirection) const override {
+      return 1;
+    }
+
+    Vec2I nodePosition(WireNode) const override {
+      return m_tilePosition;
+    }
+
+    List<WireConnection> connectionsForNode(WireNode wireNode) const override {
+      return wireNode.direction == WireDirection::Input ? m_inputs : m_outputs;
+    }
+
+    bool nodeState(WireNode wireNode) const override {
+      return wireNode.direction == WireDirection::Output && m_output;
+    }
+
+    Color nodeColor(WireNode) const override {
+      return Color::White;
+    }
+
+    String nodeIcon(WireNode) const override {
+      return {};
+    }
+
+    void addNodeConnection(WireNode wireNode, WireConnection nodeConnection) override {
+      auto& connections = wireNode.direction == WireDirection::Input ? m_inputs : m_outputs;
+      connections.append(nodeConnection);
+    }
+
+    void removeNodeConnection(WireNode wireNode, WireConnection nodeConnection) override {
+      auto& connections = wireNode.direction == WireDirection::Input ? m_inputs : m_outputs;
+      connections.remove(nodeConnection);
+    }
+
+    void evaluate(WireCoordinator* coordinator) override {
+      ++m_evaluations;
+      if (m_sourceState) {
+        m_output = *m_sourceState;
+      } else {
+        m_output = false;
+        for (auto const& connection : m_inputs)
+          m_output |= coordinator->readInputConnection(connection);
+      }
+    }
+
+    void setSourceState(bool state) {
+      m_sourceState = state;
+      m_output = state;
+    }
+
+    bool output() const {
+      return m_output;
+    }
+
+    size_t evaluations() const {
+      return m_evaluations;
+    }
+
+  private:
+    Vec2I m_tilePosition;
+    Maybe<bool> m_sourceState;
+    bool m_output;
+    List<WireConnection> m_inputs;
+    List<WireConnection> m_outputs;
+    size_t m_evaluations;
+  };
+  typedef shared_ptr<TestWireEntity> TestWireEntityPtr;
+
+  struct TestGeneratorFacade : WorldGeneratorFacade {
+    void generateSectorLevel(WorldStorage*, Sector const&, SectorGenerationLevel) override {}
+    void sectorLoadLevelChanged(WorldStorage*, Sector const&, SectorLoadLevel) override {}
+    void terraformSector(WorldStorage*, Sector const&) override {}
+    void initEntity(WorldStorage*, EntityId, EntityPtr const&) override {}
+
+    void destructEntity(WorldStorage*, EntityPtr const& entity) override {
+      entity->uninit();
+    }
+
+    bool entityKeepAlive(WorldStorage*, EntityPtr const&) const override {
+      return false;
+    }
+
+    bool entityPersistent(WorldStorage*, EntityPtr const&) const override {
+      return false;
+    }
+
+    RpcPromise<Vec2I> enqueuePlacement(List<BiomeItemDistribution>, Maybe<DungeonId>) override {
+      return RpcPromise<Vec2I>::createFailed("Not supported");
+    }
+  };
+
+  // Wire entities placed directly into a world storage, with every sector
+  // they are in already loaded.
+  class TestWiring {
+  public:
+    TestWiring(World* world)
+      : m_world(world), m_storage(make_shared<WorldStorage>(Vec2U(256, 256), File::ephemeralFile(), make_shared<TestGeneratorFacade>())) {}
+
+    ~TestWiring() {
+      for (auto const& p : m_entities)
+        remove(p.first);
+    }
+
+    WorldStoragePtr const& storage() const {
+      return m_storage;
+    }
+
+    TestWireEntityPtr add(Vec2I const& position, Maybe<bool> sourceState = {}) {
+      m_storage->loadSector(*m_storage->sectorForPosition(position));
+      auto entity = make_shared<TestWireEntity>(position, sourceState);
+      entity->init(m_world, m_storage->entityMap()->reserveEntityId(), EntityMode::Master);
+      m_storage->entityMap()->addEntity(entity);
+      m_entities[position] = entity;
+      return entity;
+    }
+
+    void remove(Vec2I const& position) {
+      auto entity = m_entities.get(position);
+      if (entity->inWorld()) {
+        m_storage->entityMap()->removeEntity(entity->entityId());
+        entity->uninit();
+      }
+    }
+
+    TestWireEntityPtr const& get(Vec2I const& position) const {
+      return m_entities.get(position);
+    }
+
+    void connect(Vec2I const& output, Vec2I const& input) {
+      get(output)->addNodeConnection({WireDirection::Output, 0}, {input, 0});
+      get(input)->addNodeConnection({WireDirection::Input, 0}, {output, 0});
+    }
+
+    void disconnect(Vec2I const& output, Vec2I const& input) {
+      get(output)->removeNodeConnection({WireDirection::Output, 0}, {input, 0});
+      get(input)->removeNodeConnection({WireDirection::Input, 0}, {output, 0});
+    }
+
+    // Output of every entity still in the world
+    Map<Vec2I, bool> outputs() const {
+      Map<Vec2I, bool> outputs;
+      for (auto const& p : m_entities) {
+        if (p.second->inWorld())
+          outputs[p.first] = p.second->output();
+      }
+      return outputs;
+    }
+
+  private:
+    World* m_world;
+    WorldStoragePtr m_storage;
+    Map<Vec2I, TestWireEntityPtr> m_entities;
+  };
+
+  // Processes until no entity is evaluated any more
+  void settle(WireProcessor& processor) {
+    for (int i = 0; i < 16; ++i) {
+      processor.process();
+      if (processor.lastEvaluatedCount() == 0)
+        return;
+    }
+    FAIL() << "Wire processor did not settle";
+  }
+}
+
+TEST(WireProcessorTest, IncrementalUpdates) {
+  // Entities only need some world to be initialized in
+  WorldServer world(Vec2U(256, 256), File::ephemeralFile());
+
+  // Two separate networks: a source driving a chain of two gates, and a
+  // source driving a single gate.
+  Vec2I source1(10, 10), gate1(12, 10), gate2(14, 10);
+  Vec2I source2(100, 100), gate3(102, 100);
+
+  TestWiring wiring(&world);
+  wiring.add(source1, true);
+  wiring.add(gate1);
+  wiring.add(gate2);
+  wiring.connect(source1, gate1);
+  wiring.connect(gate1, gate2);
+  wiring.add(source2, false);
+  wiring.add(gate3);
+  wiring.connect(source2, gate3);
+
+  // Entities that already exist are picked up on construction
+  WireProcessor processor(wiring.storage());
+  processor.process();
+  EXPECT_EQ(processor.wireEntityCount(), 5u);
+  EXPECT_EQ(processor.networkCount(), 2u);
+  EXPECT_EQ(processor.lastEvaluatedCount(), 5u);
+  settle(processor);
+  EXPECT_TRUE(wiring.get(gate2)->output());
+  EXPECT_FALSE(wiring.get(gate3)->output());
+
+  // Nothing changed, so nothing is evaluated
+  processor.process();
+  EXPECT_EQ(processor.lastEvaluatedCount(), 0u);
+
+  // A changed output only evaluates the entities reading from it, one step
+  // at a time down the chain
+  wiring.get(source1)->setSourceState(false);
+  processor.process();
+  EXPECT_EQ(processor.lastEvaluatedCount(), 1u);
+  EXPECT_FALSE(wiring.get(gate1)->output());
+  EXPECT_TRUE(wiring.get(gate2)->output());
+  processor.process();
+  EXPECT_EQ(processor.lastEvaluatedCount(), 1u);
+  EXPECT_FALSE(wiring.get(gate2)->output());
+  processor.process();
+  EXPECT_EQ(processor.lastEvaluatedCount(), 0u);
+
+  wiring.get(source1)->setSourceState(true);
+  settle(processor);
+  EXPECT_TRUE(wiring.get(gate2)->output());
+
+  size_t source2Evaluations = wiring.get(source2)->evaluations();
+  size_t gate3Evaluations = wiring.get(gate3)->evaluations();
+
+  // Disconnecting the two gates splits the first network, and only its
+  // entities are evaluated again
+  wiring.disconnect(gate1, gate2);
+  processor.wiresChanged(gate1);
+  processor.wiresChanged(gate2);
+  processor.process();
+  EXPECT_EQ(processor.networkCount(), 3u);
+  EXPECT_EQ(processor.lastEvaluatedCount(), 3u);
+  EXPECT_FALSE(wiring.get(gate2)->output());
+  settle(processor);
+
+  // A wire entity added later joins the world on the next step
+  Vec2I gate4(16, 10);
+  wiring.add(gate4);
+  wiring.connect(gate2, gate4);
+  processor.wireEntityAdded(wiring.get(gate4));
+  processor.wiresChanged(gate2);
+  processor.process();
+  EXPECT_EQ(processor.wireEntityCount(), 6u);
+  EXPECT_EQ(processor.networkCount(), 3u);
+  EXPECT_EQ(processor.lastEvaluatedCount(), 2u);
+  settle(processor);
+
+  // Removing the first gate drops it from the source's network, and the
+  // source's connection to it is removed
+  wiring.remove(gate1);
+  processor.process();
+  EXPECT_EQ(processor.wireEntityCount(), 5u);
+  EXPECT_EQ(processor.networkCount(), 3u);
+  EXPECT_EQ(processor.lastEvaluatedCount(), 1u);
+  EXPECT_TRUE(wiring.get(source1)->connectionsForNode({WireDirection::Output, 0}).empty());
+  settle(processor);
+
+  // The untouched network was never evaluated again
+  EXPECT_EQ(wiring.get(source2)->evaluations(), source2Evaluations);
+  EXPECT_EQ(wiring.get(gate3)->evaluations(), gate3Evaluations);
+
+  // The outputs match the same wiring built from scratch
+  TestWiring rebuilt(&world);
+  rebuilt.add(source1, true);
+  rebuilt.add(gate2);
+  rebuilt.add(gate4);
+  rebuilt.connect(gate2, gate4);
+  rebuilt.add(source2, false);
+  rebuilt.add(gate3);
+  rebuilt.connect(source2, gate3);
+
+  WireProcessor rebuiltProcessor(rebuilt.storage());
+  settle(rebuiltProcessor);
+  EXPECT_EQ(rebuiltProcessor.networkCount(), processor.networkCount());
+  EXPECT_EQ(rebuilt.outputs(), wiring.outputs());
+}
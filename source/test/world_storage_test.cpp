@@ -0,0 +1,53 @@
+#include "StarWorldStorage.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Star;
+
+TEST(WorldStorageTest, ColdSectorStoresBudget) {
+  ColdSectorStores stores(10);
+  ByteArray a = ByteArray::fromCString("aaaa");
+  ByteArray b = ByteArray::fromCString("bbbb");
+  ByteArray c = ByteArray::fromCString("cccc");
+
+  EXPECT_EQ(stores.retain(a, a), 0u);
+  EXPECT_EQ(stores.retain(b, b), 0u);
+  EXPECT_EQ(stores.residentStores(), 2u);
+  EXPECT_EQ(stores.residentBytes(), 8u);
+
+  // Retaining again replaces the store and makes it the most recently
+  // retained one.
+  EXPECT_EQ(stores.retain(a, ByteArray::fromCString("aaa")), 0u);
+  EXPECT_EQ(stores.residentBytes(), 7u);
+
+  // Going over budget evicts the least recently retained store first.
+  EXPECT_EQ(stores.retain(c, c), 1u);
+  EXPECT_FALSE(stores.ptr(b));
+  ASSERT_TRUE(stores.ptr(a));
+  EXPECT_EQ(*stores.ptr(a), ByteArray::fromCString("aaa"));
+  EXPECT_EQ(stores.residentStores(), 2u);
+  EXPECT_EQ(stores.residentBytes(), 7u);
+  EXPECT_EQ(stores.retainedCount(), 4u);
+  EXPECT_EQ(stores.evictedCount(), 1u);
+
+  // Updating only replaces stores that are already kept.
+  stores.update(b, b);
+  EXPECT_FALSE(stores.ptr(b));
+  stores.update(c, ByteArray::fromCString("cc"));
+  EXPECT_EQ(stores.residentBytes(), 5u);
+
+  EXPECT_EQ(stores.take(c), ByteArray::fromCString("cc"));
+  EXPECT_FALSE(stores.take(c));
+  EXPECT_EQ(stores.residentStores(), 1u);
+  EXPECT_EQ(stores.residentBytes(), 3u);
+
+  // Stores larger than the whole budget are never kept.
+  EXPECT_EQ(stores.retain(b, ByteArray(11, 'b')), 0u);
+  EXPECT_FALSE(stores.ptr(b));
+  EXPECT_EQ(stores.residentBytes(), 3u);
+
+  stores.setBudget(0);
+  EXPECT_EQ(stores.residentStores(), 0u);
+  EXPECT_EQ(stores.residentBytes(), 0u);
+  EXPECT_EQ(stores.evictedCount(), 2u);
+}
@@ -15,6 +15,7 @@ int main(int argc, char** argv) {
     optParse.addParameter("c", "configFile", OptionParser::Optional, "JSON file with ignore lists and ordering info");
     optParse.addSwitch("s", "Enable server mode");
     optParse.addSwitch("v", "Verbose, list each file added");
+    optParse.addSwitch("i", "Include an image metadata index, implied by server mode");
     optParse.addArgument("assets folder path", OptionParser::Required, "Path to the assets to be packed");
     optParse.addArgument("output filename", OptionParser::Required, "Output pak file");
 
@@ -67,7 +68,8 @@ int main(int argc, char** argv) {
 
     outputFilename = File::relativeTo(File::fullPath(File::dirName(outputFilename)), File::baseName(outputFilename));
     DirectoryAssetSource directorySource(assetsFolderPath, ignoreFiles);
-    PackedAssetSource::build(directorySource, outputFilename, extensionOrdering, progressCallback);
+    bool includeImageMetadata = opts.switches.contains("i") || opts.switches.contains("s");
+    PackedAssetSource::build(directorySource, outputFilename, extensionOrdering, progressCallback, includeImageMetadata);
 
     coutf("Output packed assets to {} in {}s\n", outputFilename, Time::monotonicTime() - startTime);
     return 0;
@@ -0,0 +1,122 @@
+#include "StarLexicalCast.hpp"
+#include "StarLogging.hpp"
+#include "StarRootLoader.hpp"
+#include "StarCelestialDatabase.hpp"
+#include "StarWorkerPool.hpp"
+#include "StarRandom.hpp"
+#include "StarTime.hpp"
+
+using namespace Star;
+
+// Simulates several players scrolling the navigation map of a fresh universe
+// at once.  Every step each client signals the region it is looking at, and
+// its celestial requests are answered on a worker pool the way UniverseServer
+// answers them.  Reports how long requests took from being sent to being
+// answered.
+int main(int argc, char** argv) {
+  try {
+    RootLoader rootLoader({{}, {}, {}, LogLevel::Error, false, {}});
+    rootLoader.addParameter("clients", "count", OptionParser::Optional, "number of clients browsing the map, default 8");
+    rootLoader.addParameter("steps", "steps", OptionParser::Optional, "number of steps each client scrolls, default 100");
+    rootLoader.addParameter("threads", "count", OptionParser::Optional, "threads answering client requests, default 4");
+    rootLoader.addParameter("view", "size", OptionParser::Optional, "width and height of the region each client views, default 100");
+    rootLoader.addParameter("scroll", "distance", OptionParser::Optional, "distance each client scrolls per step, default 10");
+    rootLoader.addSwitch("noprefetch", "do not prefetch chunks around requested chunks");
+    RootUPtr root;
+    OptionParser::Options options;
+    tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
+
+    auto parameter = [&](String const& name, auto defaultValue) {
+      if (auto value = options.parameters.maybe(name))
+        return lexicalCast<decltype(defaultValue)>(value->first());
+      return defaultValue;
+    };
+
+    unsigned clientCount = parameter("clients", 8u);
+    unsigned steps = parameter("steps", 100u);
+    unsigned threadCount = parameter("threads", 4u);
+    int viewSize = parameter("view", 100);
+    int scrollDistance = parameter("scroll", 10);
+
+    WorkerPool workerPool("CelestialBenchmark", threadCount);
+    CelestialMasterDatabase masterDatabase;
+    if (options.switches.contains("noprefetch"))
+      masterDatabase.setChunkPrefetchRadius(0);
+
+    struct Client {
+      CelestialSlaveDatabasePtr database;
+      Vec2I position;
+      Vec2I direction;
+      List<pair<double, WorkerPoolPromise<pair<CelestialResponse, double>>>> pendingRequests;
+    };
+
+    RandomSource random(0);
+    List<Client> clients;
+    for (unsigned i = 0; i < clientCount; ++i) {
+      Client client;
+      client.database = make_shared<CelestialSlaveDatabase>(masterDatabase.baseInformation());
+      client.position = Vec2I(random.randInt(-1000, 1000), random.randInt(-1000, 1000));
+      client.direction = Vec2I(random.randInt(-1, 1), random.randInt(-1, 1));
+      if (client.direction == Vec2I())
+        client.direction = Vec2I(1, 0);
+      clients.append(std::move(client));
+    }
+
+    List<double> latencies;
+    auto collectResponses = [&](Client& client) {
+      List<CelestialResponse> responses;
+      client.pendingRequests.filter([&](auto const& request) {
+          if (!request.second.poll())
+            return true;
+          auto const& result = request.second.get();
+          latencies.append(result.second - request.first);
+          responses.append(result.first);
+          return false;
+        });
+      client.database->pushResponses(std::move(responses));
+    };
+
+    double start = Time::monotonicTime();
+    for (unsigned step = 0; step < steps; ++step) {
+      for (auto& client : clients) {
+        collectResponses(client);
+
+        // Change direction now and then, the way a player looks around.
+        if (random.randf() < 0.1f)
+          client.direction = Vec2I(random.randInt(-1, 1), random.randInt(-1, 1));
+        client.position += client.direction * scrollDistance;
+        client.database->signalRegion(RectI::withCenter(client.position, Vec2I::filled(viewSize)));
+
+        for (auto const& request : client.database->pullRequests()) {
+          client.pendingRequests.append({Time::monotonicTime(), workerPool.addProducer<pair<CelestialResponse, double>>([&masterDatabase, request]() {
+              auto response = masterDatabase.respondToRequest(request);
+              return make_pair(std::move(response), Time::monotonicTime());
+            })});
+        }
+      }
+      masterDatabase.cleanupAndCommit();
+      Thread::sleep(16);
+    }
+
+    for (auto& client : clients) {
+      for (auto& request : client.pendingRequests)
+        request.second.get();
+      collectResponses(client);
+    }
+    double totalTime = Time::monotonicTime() - start;
+
+    sort(latencies);
+    double meanLatency = latencies.empty() ? 0.0 : sum(latencies) / latencies.size();
+    auto percentile = [&](double p) {
+      return latencies.empty() ? 0.0 : latencies[min<size_t>(latencies.size() - 1, latencies.size() * p)];
+    };
+    coutf("Answered {} requests from {} clients in {}s\n", latencies.size(), clientCount, totalTime);
+    coutf("Request latency mean {}ms, median {}ms, 95th percentile {}ms, max {}ms\n",
+        meanLatency * 1000, percentile(0.5) * 1000, percentile(0.95) * 1000, percentile(1.0) * 1000);
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
@@ -0,0 +1,96 @@
+#include "StarLexicalCast.hpp"
+#include "StarLogging.hpp"
+#include "StarRootLoader.hpp"
+#include "StarWorldServer.hpp"
+#include "StarWorldTemplate.hpp"
+#include "StarMonsterDatabase.hpp"
+#include "StarMonster.hpp"
+#include "StarProjectileDatabase.hpp"
+#include "StarProjectile.hpp"
+
+using namespace Star;
+
+// Fills a region of a dungeon world with monsters and a dense cloud of slow,
+// long lived, piercing projectiles that can damage them, and times world
+// updates while the damage manager hit tests every projectile every step.
+int main(int argc, char** argv) {
+  try {
+    RootLoader rootLoader({{}, {}, {}, LogLevel::Error, false, {}});
+    rootLoader.addArgument("dungeon", OptionParser::Required, "name of the dungeon to spawn in the world to benchmark");
+    rootLoader.addParameter("seed", "seed", OptionParser::Optional, "world seed used to create the WorldTemplate");
+    rootLoader.addParameter("steps", "steps", OptionParser::Optional, "number of steps to run the world for, defaults to 600");
+    rootLoader.addParameter("projectile", "type", OptionParser::Optional, "projectile type to spawn, default 'standardbullet'");
+    rootLoader.addParameter("projectiles", "count", OptionParser::Optional, "number of projectiles, default 2,000");
+    rootLoader.addParameter("monster", "type", OptionParser::Optional, "monster type to spawn as targets, default 'gleap'");
+    rootLoader.addParameter("monsters", "count", OptionParser::Optional, "number of target monsters, default 500");
+    rootLoader.addParameter("size", "size", OptionParser::Optional, "width and height of the region everything is spawned in, default 200");
+    RootUPtr root;
+    OptionParser::Options options;
+    tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
+
+    coutf("Fully loading root...");
+    root->fullyLoad();
+    coutf(" done\n");
+
+    auto parameter = [&](String const& name, auto defaultValue) {
+      if (auto value = options.parameters.maybe(name))
+        return lexicalCast<decltype(defaultValue)>(value->first());
+      return defaultValue;
+    };
+
+    String dungeon = options.arguments.first();
+    uint64_t worldSeed = parameter("seed", Random::randu64());
+    uint64_t steps = parameter("steps", (uint64_t)600);
+    String projectileType = options.parameters.maybe("projectile").apply([](StringList p) { return p.first(); }).value("standardbullet");
+    int projectileCount = parameter("projectiles", 2000);
+    String monsterType = options.parameters.maybe("monster").apply([](StringList p) { return p.first(); }).value("gleap");
+    int monsterCount = parameter("monsters", 500);
+    int size = parameter("size", 200);
+
+    auto worldTemplate = make_shared<WorldTemplate>(generateFloatingDungeonWorldParameters(dungeon), SkyParameters(), worldSeed);
+    WorldServer worldServer(worldTemplate, File::ephemeralFile());
+
+    Vec2I origin = Vec2I(worldServer.geometry().size()) / 2 - Vec2I::filled(size / 2);
+    RectI region = RectI::withSize(origin, Vec2I::filled(size));
+    worldServer.generateRegion(region);
+
+    RandomSource random(worldSeed);
+    auto randomPosition = [&]() {
+      return Vec2F(region.min()) + Vec2F(random.randf(), random.randf()) * (float)size;
+    };
+
+    auto monsterDatabase = root->monsterDatabase();
+    for (int i = 0; i < monsterCount; ++i) {
+      auto monster = monsterDatabase->createMonster(monsterDatabase->randomMonster(monsterType), 1.0f);
+      monster->setPosition(randomPosition());
+      worldServer.addEntity(monster);
+    }
+
+    auto projectileDatabase = root->projectileDatabase();
+    Json projectileParameters = JsonObject{
+      {"speed", 0.5f},
+      {"timeToLive", 1.0e6f},
+      {"piercing", true},
+      {"damageTeam", JsonObject{{"type", "friendly"}}}
+    };
+    for (int i = 0; i < projectileCount; ++i) {
+      auto projectile = projectileDatabase->createProjectile(projectileType, projectileParameters);
+      projectile->setInitialPosition(randomPosition());
+      projectile->setInitialDirection(Vec2F::withAngle(random.randf() * 2 * Constants::pi));
+      worldServer.addEntity(projectile);
+    }
+    coutf("Spawned {} '{}' monsters and {} '{}' projectiles\n", monsterCount, monsterType, projectileCount, projectileType);
+
+    coutf("Starting world simulation for {} steps\n", steps);
+    double start = Time::monotonicTime();
+    for (uint64_t j = 0; j < steps; ++j)
+      worldServer.update(ServerGlobalTimestep * GlobalTimescale);
+    double totalTime = Time::monotonicTime() - start;
+    coutf("Finished {} steps in {} seconds, {}ms per step\n", steps, totalTime, totalTime / steps * 1000.0);
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
@@ -0,0 +1,94 @@
+#include "StarLexicalCast.hpp"
+#include "StarLogging.hpp"
+#include "StarRootLoader.hpp"
+#include "StarEntityFactory.hpp"
+#include "StarObjectDatabase.hpp"
+#include "StarObject.hpp"
+#include "StarItemDatabase.hpp"
+#include "StarItemBag.hpp"
+#include "StarItem.hpp"
+#include "StarWorkerPool.hpp"
+#include "StarTime.hpp"
+
+using namespace Star;
+
+// Builds the stored entities of a dense base sector, every container object
+// in the assets over and over with every slot filled, and times loading them
+// the way WorldStorage does when the sector is loaded, once on the calling
+// thread and once on an entity load worker pool.
+int main(int argc, char** argv) {
+  try {
+    RootLoader rootLoader({{}, {}, {}, LogLevel::Error, false, {}});
+    rootLoader.addParameter("entities", "count", OptionParser::Optional, "number of containers in the sector, default 256");
+    rootLoader.addParameter("threads", "count", OptionParser::Optional, "entity load worker threads, default 4");
+    rootLoader.addParameter("repeat", "repeat", OptionParser::Optional, "number of times to load the sector, default 5");
+    RootUPtr root;
+    OptionParser::Options options;
+    tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
+
+    auto parameter = [&](String const& name, auto defaultValue) {
+      if (auto value = options.parameters.maybe(name))
+        return lexicalCast<decltype(defaultValue)>(value->first());
+      return defaultValue;
+    };
+
+    unsigned entityCount = parameter("entities", 256u);
+    unsigned threadCount = parameter("threads", 4u);
+    unsigned repeat = parameter("repeat", 5u);
+
+    auto entityFactory = root->entityFactory();
+    auto objectDatabase = root->objectDatabase();
+    auto itemDatabase = root->itemDatabase();
+
+    StringList containers;
+    for (auto const& objectName : objectDatabase->allObjects()) {
+      if (objectDatabase->getConfig(objectName)->type == "container")
+        containers.append(objectName);
+    }
+    if (containers.empty())
+      throw StarException("No container objects found in assets");
+    containers.sort();
+
+    StringList itemNames = itemDatabase->allItems();
+    itemNames.sort();
+
+    RandomSource random(0);
+    List<VersionedJson> sectorStore;
+    while (sectorStore.size() < entityCount) {
+      auto object = objectDatabase->createObject(containers[sectorStore.size() % containers.size()]);
+      ItemBag items(object->configValue("slotCount").toUInt());
+      for (size_t i = 0; i < items.size(); ++i) {
+        try {
+          items.setItem(i, itemDatabase->item(ItemDescriptor(random.randFrom(itemNames), 1)));
+        } catch (std::exception const&) {}
+      }
+
+      auto store = entityFactory->storeVersionedEntity(object);
+      store.content = store.content.set("items", items.diskStore());
+      sectorStore.append(std::move(store));
+    }
+
+    auto errorHandler = [](VersionedJson const&, std::exception const& e) {
+      cerrf("Failed to load entity: {}\n", outputException(e, false));
+    };
+
+    WorkerPool workerPool("EntityLoadBenchmark", threadCount);
+    for (unsigned i = 0; i < repeat; ++i) {
+      double start = Time::monotonicTime();
+      size_t serialCount = entityFactory->loadVersionedEntities(sectorStore, errorHandler).size();
+      double serialTime = Time::monotonicTime() - start;
+
+      start = Time::monotonicTime();
+      size_t parallelCount = entityFactory->loadVersionedEntities(sectorStore, errorHandler, &workerPool).size();
+      double parallelTime = Time::monotonicTime() - start;
+
+      coutf("Loaded {} entities in {}ms serially, {} entities in {}ms on {} threads\n",
+          serialCount, serialTime * 1000, parallelCount, parallelTime * 1000, threadCount);
+    }
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
@@ -0,0 +1,74 @@
+#include "StarFile.hpp"
+#include "StarLexicalCast.hpp"
+#include "StarLogging.hpp"
+#include "StarRootLoader.hpp"
+#include "StarAssets.hpp"
+#include "StarImageMetadataDatabase.hpp"
+#include "StarObjectDatabase.hpp"
+#include "StarTime.hpp"
+
+using namespace Star;
+
+// Peak resident set size of the process in kB, where the platform makes it
+// easy to find.
+Maybe<uint64_t> peakResidentSize() {
+  if (!File::exists("/proc/self/status"))
+    return {};
+  for (auto const& line : File::readFileString("/proc/self/status").splitLines()) {
+    if (line.beginsWith("VmHWM:"))
+      return lexicalCast<uint64_t>(line.substr(6).trim().split(" ").first());
+  }
+  return {};
+}
+
+// Times answering the image size, non empty region and image spaces of every
+// orientation image of every object, the way object placement and world
+// generation do.  Run once against packed assets built with and without
+// asset_packer's image metadata index to compare.
+int main(int argc, char** argv) {
+  try {
+    RootLoader rootLoader({{}, {}, {}, LogLevel::Error, false, {}});
+    rootLoader.addParameter("repeat", "repeat", OptionParser::Optional, "number of times to query every image, default 3");
+    RootUPtr root;
+    OptionParser::Options options;
+    tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
+
+    unsigned repeat = 3;
+    if (auto value = options.parameters.maybe("repeat"))
+      repeat = lexicalCast<unsigned>(value->first());
+
+    double start = Time::monotonicTime();
+    auto imageMetadataDatabase = root->imageMetadataDatabase();
+    auto objectDatabase = root->objectDatabase();
+    coutf("Loaded image metadata and object databases in {}s\n", Time::monotonicTime() - start);
+
+    List<AssetPath> imagePaths;
+    for (auto const& objectName : objectDatabase->allObjects()) {
+      for (auto const& orientation : objectDatabase->getConfig(objectName)->orientations) {
+        for (auto const& layer : orientation->imageLayers) {
+          if (layer.isImage())
+            imagePaths.append(AssetPath::join(layer.imagePart().image).replaceTags(StringMap<String>(), true, "default"));
+        }
+      }
+    }
+
+    for (unsigned i = 0; i < repeat; ++i) {
+      size_t totalSpaces = 0;
+      start = Time::monotonicTime();
+      for (auto const& path : imagePaths) {
+        imageMetadataDatabase->imageSize(path);
+        imageMetadataDatabase->nonEmptyRegion(path);
+        totalSpaces += imageMetadataDatabase->imageSpaces(path, Vec2F(), 0.5f, false).size();
+      }
+      coutf("Queried {} object images in {}s, {} total spaces\n", imagePaths.size(), Time::monotonicTime() - start, totalSpaces);
+    }
+
+    if (auto rss = peakResidentSize())
+      coutf("Peak resident size {}kB\n", *rss);
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
@@ -0,0 +1,76 @@
+#include "StarLexicalCast.hpp"
+#include "StarLogging.hpp"
+#include "StarRootLoader.hpp"
+#include "StarWorldServer.hpp"
+#include "StarWorldTemplate.hpp"
+
+using namespace Star;
+
+// Times world updates that each make many light level queries at random
+// positions around the middle of a dungeon world, once with the light level
+// cache enabled and once calculating every query separately.
+int main(int argc, char** argv) {
+  try {
+    RootLoader rootLoader({{}, {}, {}, LogLevel::Error, false, {}});
+    rootLoader.addArgument("dungeon", OptionParser::Required, "name of the dungeon to spawn in the world to benchmark");
+    rootLoader.addParameter("seed", "seed", OptionParser::Optional, "world seed used to create the WorldTemplate");
+    rootLoader.addParameter("steps", "steps", OptionParser::Optional, "number of steps to run the world for, defaults to 200");
+    rootLoader.addParameter("queries", "queries", OptionParser::Optional, "number of light level queries made each step, default 10,000");
+    rootLoader.addParameter("size", "size", OptionParser::Optional, "width and height of the queried region, default 256");
+    rootLoader.addParameter("staleness", "seconds", OptionParser::Optional, "staleness budget of the cached run, default 0.5");
+    RootUPtr root;
+    OptionParser::Options options;
+    tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
+
+    coutf("Fully loading root...");
+    root->fullyLoad();
+    coutf(" done\n");
+
+    auto parameter = [&](String const& name, auto defaultValue) {
+      if (auto value = options.parameters.maybe(name))
+        return lexicalCast<decltype(defaultValue)>(value->first());
+      return defaultValue;
+    };
+
+    String dungeon = options.arguments.first();
+    uint64_t worldSeed = parameter("seed", Random::randu64());
+    uint64_t steps = parameter("steps", (uint64_t)200);
+    size_t queries = parameter("queries", (size_t)10000);
+    int size = parameter("size", 256);
+    double staleness = parameter("staleness", 0.5);
+
+    auto worldTemplate = make_shared<WorldTemplate>(generateFloatingDungeonWorldParameters(dungeon), SkyParameters(), worldSeed);
+    WorldServer worldServer(worldTemplate, File::ephemeralFile());
+
+    Vec2I origin = Vec2I(worldServer.geometry().size()) / 2 - Vec2I::filled(size / 2);
+    RectI region = RectI::withSize(origin, Vec2I::filled(size));
+    worldServer.generateRegion(region);
+
+    auto run = [&](double stalenessBudget) {
+      worldServer.setLightLevelStalenessBudget(stalenessBudget);
+      RandomSource random(worldSeed);
+      List<Vec2F> positions(queries);
+      double total = 0.0;
+
+      double start = Time::monotonicTime();
+      for (uint64_t j = 0; j < steps; ++j) {
+        for (auto& position : positions)
+          position = Vec2F(region.min()) + Vec2F(random.randf(), random.randf()) * (float)size;
+        for (float level : worldServer.lightLevels(positions))
+          total += level;
+        worldServer.update(ServerGlobalTimestep * GlobalTimescale);
+      }
+      double totalTime = Time::monotonicTime() - start;
+      coutf("Staleness budget {}: finished {} steps in {} seconds, {}ms per step, average light level {}\n",
+          stalenessBudget, steps, totalTime, totalTime / steps * 1000.0, total / (steps * queries));
+    };
+
+    run(staleness);
+    run(0.0);
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
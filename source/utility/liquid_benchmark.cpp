@@ -0,0 +1,160 @@
+#include "StarCellularLiquid.hpp"
+#include "StarLexicalCast.hpp"
+#include "StarTime.hpp"
+#include "StarPerlin.hpp"
+#include "StarWorkerPool.hpp"
+
+using namespace Star;
+
+// Simulates a large flooded cave, wrapping horizontally like a real world,
+// with a lava pool and a few liquid sources to exercise interactions.  Prints
+// a checksum of the final liquid state so that different engine
+// implementations can be checked against each other.
+class BenchmarkLiquidWorld : public CellularLiquidWorld<uint8_t> {
+public:
+  BenchmarkLiquidWorld(int width, int height, uint64_t seed)
+    : m_width(width), m_height(height), m_cells(width * height) {
+    PerlinF caveNoise(PerlinType::Perlin, 3, 0.02f, 1.0f, 0.0f, 2.0f, 2.0f, seed);
+    for (int x = 0; x < m_width; ++x) {
+      for (int y = 0; y < m_height; ++y) {
+        auto& cell = m_cells[index({x, y})];
+        bool edge = y == 0 || y == m_height - 1;
+        if (edge || caveNoise.get(x, y) > 0.15f) {
+          cell = CellularLiquidCollisionCell();
+        } else if (y < m_height / 2) {
+          uint8_t liquid = (x > m_width / 2 && x < m_width / 2 + m_width / 8) ? 2 : 1;
+          cell = CellularLiquidFlowCell<uint8_t>{liquid, 1.0f, 1.0f};
+        } else {
+          cell = CellularLiquidFlowCell<uint8_t>{{}, 0.0f, 0.0f};
+        }
+      }
+    }
+
+    for (int x = m_width / 16; x < m_width; x += m_width / 8) {
+      for (int y = m_height - 2; y > 0; --y) {
+        auto& cell = m_cells[index({x, y})];
+        if (cell.is<CellularLiquidFlowCell<uint8_t>>()) {
+          cell = CellularLiquidSourceCell<uint8_t>{1, 1.0f};
+          break;
+        }
+      }
+    }
+  }
+
+  Vec2I uniqueLocation(Vec2I const& location) const override {
+    return {pmod(location[0], m_width), location[1]};
+  }
+
+  CellularLiquidCell<uint8_t> cell(Vec2I const& location) const override {
+    if (location[1] < 0 || location[1] >= m_height)
+      return CellularLiquidCollisionCell();
+    return m_cells[index(location)];
+  }
+
+  void setFlow(Vec2I const& location, CellularLiquidFlowCell<uint8_t> const& flow) override {
+    m_cells[index(location)] = flow;
+  }
+
+  void liquidInteraction(Vec2I const&, uint8_t, Vec2I const&, uint8_t) override {
+    ++interactions;
+  }
+
+  void liquidCollision(Vec2I const&, uint8_t, Vec2I const&) override {
+    ++collisions;
+  }
+
+  uint64_t checksum() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t v) {
+      hash ^= v;
+      hash *= 1099511628211ULL;
+    };
+    for (auto const& cell : m_cells) {
+      if (auto flow = cell.ptr<CellularLiquidFlowCell<uint8_t>>()) {
+        uint32_t level, pressure;
+        memcpy(&level, &flow->level, sizeof(level));
+        memcpy(&pressure, &flow->pressure, sizeof(pressure));
+        mix(flow->liquid.value(0));
+        mix(level);
+        mix(pressure);
+      }
+    }
+    mix(interactions);
+    mix(collisions);
+    return hash;
+  }
+
+  uint64_t interactions = 0;
+  uint64_t collisions = 0;
+
+private:
+  size_t index(Vec2I const& location) const {
+    return location[1] * m_width + pmod(location[0], m_width);
+  }
+
+  int m_width;
+  int m_height;
+  List<CellularLiquidCell<uint8_t>> m_cells;
+};
+
+int main(int argc, char** argv) {
+  try {
+    unsigned steps = 100;
+    int width = 1024;
+    int height = 256;
+    uint64_t seed = 1234;
+    unsigned threads = 0;
+
+    if (argc > 1)
+      steps = lexicalCast<unsigned>(argv[1]);
+    if (argc > 2)
+      width = lexicalCast<int>(argv[2]);
+    if (argc > 3)
+      height = lexicalCast<int>(argv[3]);
+    if (argc > 4)
+      seed = lexicalCast<uint64_t>(argv[4]);
+    if (argc > 5)
+      threads = lexicalCast<unsigned>(argv[5]);
+
+    LiquidCellEngineParameters parameters;
+    parameters.lateralMoveFactor = 0.5f;
+    parameters.spreadOverfillUpFactor = 0.5f;
+    parameters.spreadOverfillLateralFactor = 0.5f;
+    parameters.spreadOverfillDownFactor = 0.5f;
+    parameters.pressureEqualizeFactor = 0.4f;
+    parameters.pressureMoveFactor = 0.01f;
+    parameters.maximumPressureLevelImbalance = 0.1f;
+    parameters.minimumLivenPressureChange = 0.001f;
+    parameters.minimumLivenLevelChange = 0.001f;
+    parameters.minimumLiquidLevel = 0.01f;
+    parameters.interactTransformationLevel = 0.1f;
+
+    auto world = make_shared<BenchmarkLiquidWorld>(width, height, seed);
+    LiquidCellEngine<uint8_t> engine(parameters, world);
+    engine.setRandomSeed(seed);
+    WorkerPool workerPool("LiquidBenchmark");
+    if (threads != 0) {
+      workerPool.start(threads);
+      engine.setWorkerPool(&workerPool);
+    }
+    engine.visitRegion(RectI(0, 0, width, height));
+
+    coutf("simulating {} steps of a {}x{} flooded cave with {} worker threads\n", steps, width, height, threads);
+
+    double start = Time::monotonicTime();
+    size_t totalActive = 0;
+    for (unsigned i = 0; i < steps; ++i) {
+      engine.update();
+      totalActive += engine.activeCells();
+    }
+    double time = Time::monotonicTime() - start;
+
+    coutf("{:.3f}s total, {:.3f}ms per step, {:.0f} average active cells\n", time, time / steps * 1000.0, (double)totalActive / steps);
+    coutf("{} interactions, {} collisions, checksum {:016x}\n", world->interactions, world->collisions, world->checksum());
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
@@ -0,0 +1,106 @@
+#include "StarLexicalCast.hpp"
+#include "StarLogging.hpp"
+#include "StarRootLoader.hpp"
+#include "StarWorldServer.hpp"
+#include "StarWorldTemplate.hpp"
+#include "StarObjectDatabase.hpp"
+#include "StarObject.hpp"
+#include "StarMaterialDatabase.hpp"
+
+using namespace Star;
+
+// Builds a large logic circuit out of rings of single input, single output
+// gates in a dungeon world, and times world updates while it runs.  Rings with
+// an odd number of inverting gates oscillate forever, rings with an even
+// number settle down and stay idle, which exercises both busy and quiet
+// networks.
+int main(int argc, char** argv) {
+  try {
+    RootLoader rootLoader({{}, {}, {}, LogLevel::Error, false, {}});
+    rootLoader.addArgument("dungeon", OptionParser::Required, "name of the dungeon to spawn in the world to benchmark");
+    rootLoader.addParameter("seed", "seed", OptionParser::Optional, "world seed used to create the WorldTemplate");
+    rootLoader.addParameter("steps", "steps", OptionParser::Optional, "number of steps to run the world for, defaults to 2,000");
+    rootLoader.addParameter("gate", "object", OptionParser::Optional, "inverting gate object to build the rings from, default 'notswitch'");
+    rootLoader.addParameter("material", "material", OptionParser::Optional, "material to mount the gates on, default 'dirt'");
+    rootLoader.addParameter("rings", "ring count", OptionParser::Optional, "number of rings of gates, default 64");
+    rootLoader.addParameter("ringsize", "ring size", OptionParser::Optional, "number of gates in each ring, default 64");
+    rootLoader.addParameter("oscillating", "ring count", OptionParser::Optional, "how many of the rings have an odd number of gates and oscillate, default 8");
+    RootUPtr root;
+    OptionParser::Options options;
+    tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
+
+    coutf("Fully loading root...");
+    root->fullyLoad();
+    coutf(" done\n");
+
+    auto parameter = [&](String const& name, auto defaultValue) {
+      if (auto value = options.parameters.maybe(name))
+        return lexicalCast<decltype(defaultValue)>(value->first());
+      return defaultValue;
+    };
+
+    String dungeon = options.arguments.first();
+    uint64_t worldSeed = parameter("seed", Random::randu64());
+    uint64_t steps = parameter("steps", (uint64_t)2000);
+    String gate = options.parameters.maybe("gate").apply([](StringList p) { return p.first(); }).value("notswitch");
+    String material = options.parameters.maybe("material").apply([](StringList p) { return p.first(); }).value("dirt");
+    int rings = parameter("rings", 64);
+    int ringSize = parameter("ringsize", 64);
+    int oscillating = parameter("oscillating", 8);
+
+    auto worldTemplate = make_shared<WorldTemplate>(generateFloatingDungeonWorldParameters(dungeon), SkyParameters(), worldSeed);
+    WorldServer worldServer(worldTemplate, File::ephemeralFile());
+    worldServer.setTileProtectionEnabled(false);
+
+    // Each gate sits on its own floor tile in front of a solid background, in
+    // rows three tiles apart.
+    Vec2I spacing(3, 3);
+    Vec2I origin = Vec2I(worldServer.geometry().size()) / 2 - Vec2I(ringSize * spacing[0], rings * spacing[1]) / 2;
+    RectI region = RectI::withSize(origin - Vec2I(1, 1), Vec2I(ringSize * spacing[0], rings * spacing[1]) + Vec2I(2, 2));
+    worldServer.generateRegion(region);
+
+    auto materialId = root->materialDatabase()->materialId(material);
+    TileModificationList modifications;
+    for (int x = region.xMin(); x < region.xMax(); ++x) {
+      for (int y = region.yMin(); y < region.yMax(); ++y) {
+        modifications.append({{x, y}, PlaceMaterial{TileLayer::Background, materialId, {}, TileCollisionOverride::None}});
+        if (pmod(y - origin[1], spacing[1]) == spacing[1] - 1)
+          modifications.append({{x, y}, PlaceMaterial{TileLayer::Foreground, materialId, {}, TileCollisionOverride::None}});
+      }
+    }
+    worldServer.forceApplyTileModifications(modifications, true);
+
+    auto objectDatabase = root->objectDatabase();
+    size_t gateCount = 0;
+    for (int r = 0; r < rings; ++r) {
+      int size = r < oscillating ? ringSize - 1 : ringSize;
+      List<Vec2I> positions;
+      for (int i = 0; i < size; ++i) {
+        Vec2I position = origin + Vec2I(i * spacing[0], r * spacing[1]);
+        auto object = objectDatabase->createObject(gate);
+        object->setTilePosition(position);
+        worldServer.addEntity(object);
+        positions.append(position);
+      }
+      for (int i = 0; i < size; ++i)
+        worldServer.wire(positions[i], 0, positions[(i + 1) % size], 0);
+      gateCount += size;
+    }
+    coutf("Built {} rings from {} '{}' gates, {} of them oscillating\n", rings, gateCount, gate, oscillating);
+
+    coutf("Starting world simulation for {} steps\n", steps);
+    double start = Time::monotonicTime();
+    for (uint64_t j = 0; j < steps; ++j) {
+      if (j % 120 == 0)
+        worldServer.signalRegion(region);
+      worldServer.update(ServerGlobalTimestep * GlobalTimescale);
+    }
+    double totalTime = Time::monotonicTime() - start;
+    coutf("Finished {} steps in {} seconds, {}ms per step\n", steps, totalTime, totalTime / steps * 1000.0);
+
+    return 0;
+  } catch (std::exception const& e) {
+    cerrf("Exception caught: {}\n", outputException(e, true));
+    return 1;
+  }
+}
@@ -3,6 +3,9 @@
 #include "StarRootLoader.hpp"
 #include "StarWorldServer.hpp"
 #include "StarWorldTemplate.hpp"
+#include "StarMonsterDatabase.hpp"
+#include "StarMonster.hpp"
+#include "StarLuaComponents.hpp"
 
 using namespace Star;
 
@@ -16,8 +19,12 @@ int main(int argc, char** argv) {
     rootLoader.addParameter("signalevery", "signal steps", OptionParser::Optional, "number of steps to wait between scanning and signaling all entities to stay alive, default 120");
     rootLoader.addParameter("reportevery", "report steps", OptionParser::Optional, "number of steps between each progress report, default 0 (do not report progress)");
     rootLoader.addParameter("fidelity", "server fidelity", OptionParser::Optional, "fidelity to run the server with, default high");
+    rootLoader.addParameter("monsters", "monster count", OptionParser::Optional, "number of monsters to spawn across the world before each run, default 0");
+    rootLoader.addParameter("monstertype", "monster type", OptionParser::Optional, "type of monster to spawn with 'monsters', default 'poptop'");
     rootLoader.addSwitch("profiling", "whether to use lua profiling, prints the profile with info logging");
     rootLoader.addSwitch("unsafe", "enables unsafe lua libraries");
+    rootLoader.addParameter("clients", "client count", OptionParser::Optional, "number of simulated client windows spread across the world, scripts far from all of them update less often, default 1");
+    rootLoader.addSwitch("nolod", "update every script at its full rate, regardless of the distance to the simulated client windows");
     RootUPtr root;
     OptionParser::Options options;
     tie(root, options) = rootLoader.commandInitOrDie(argc, argv);
@@ -59,11 +66,46 @@ int main(int argc, char** argv) {
     if (options.parameters.contains("reportevery"))
       reportEvery = lexicalCast<uint64_t>(options.parameters.get("reportevery").first());
 
+    uint64_t monsterCount = 0;
+    if (options.parameters.contains("monsters"))
+      monsterCount = lexicalCast<uint64_t>(options.parameters.get("monsters").first());
+
+    String monsterType = "poptop";
+    if (options.parameters.contains("monstertype"))
+      monsterType = options.parameters.get("monstertype").first();
+
+    uint64_t clientCount = 1;
+    if (options.parameters.contains("clients"))
+      clientCount = lexicalCast<uint64_t>(options.parameters.get("clients").first());
+
     double sumTime = 0.0;
     for (uint64_t i = 0; i < times; ++i) {
       WorldServer worldServer(worldTemplate, File::ephemeralFile());
 
-      coutf("Starting world simulation for {} steps\n", steps);
+      // Roughly the window of a 1080p client at the default zoom, evenly
+      // spaced along the middle of the world.
+      Vec2F worldSize = Vec2F(worldServer.geometry().size());
+      List<RectF> clientWindows;
+      for (uint64_t j = 0; j < clientCount; ++j)
+        clientWindows.append(RectF::withCenter(Vec2F(worldSize[0] * (j + 0.5f) / clientCount, worldSize[1] / 2), Vec2F(120, 68)));
+      worldServer.setScriptUpdateLodWindows(clientWindows);
+      worldServer.setScriptUpdateLodEnabled(!options.switches.contains("nolod"));
+
+      if (monsterCount != 0) {
+        auto monsterDatabase = root->monsterDatabase();
+        for (uint64_t j = 0; j < monsterCount; ++j) {
+          auto monster = monsterDatabase->createMonster(monsterDatabase->randomMonster(monsterType));
+          monster->setPosition(Vec2F(Random::randf() * worldSize[0], Random::randf() * worldSize[1]));
+          worldServer.addEntity(monster);
+        }
+        coutf("Spawned {} monsters of type '{}'\n", monsterCount, monsterType);
+      }
+
+      coutf("Starting world simulation for {} steps with {} simulated clients, script update lod {}\n",
+            steps, clientCount, worldServer.scriptUpdateLodEnabled() ? "enabled" : "disabled");
+      LuaBaseComponent::setFunctionHandleCounting(true);
+      uint64_t functionHits = LuaBaseComponent::functionHandleHits();
+      uint64_t functionMisses = LuaBaseComponent::functionHandleMisses();
       double start = Time::monotonicTime();
       double lastReport = Time::monotonicTime();
       uint64_t entityCount = 0;
@@ -86,6 +128,8 @@ int main(int argc, char** argv) {
       double totalTime = Time::monotonicTime() - start;
       coutf("Finished run of running dungeon world '{}' with seed {} for {} steps in {} seconds, average FPS: {}\n",
             dungeon, worldSeed, steps, totalTime, steps / totalTime);
+      coutf("Script function handle hits: {}, misses: {}\n",
+            LuaBaseComponent::functionHandleHits() - functionHits, LuaBaseComponent::functionHandleMisses() - functionMisses);
       sumTime += totalTime;
     }
 